@@ -22,6 +22,7 @@
 #include "Common/Data/Convert/ColorConvNEON.h"
 #include "Common/Common.h"
 #include "Common/CPUDetect.h"
+#include "Common/Math/CrossSIMD.h"
 
 #ifdef _M_SSE
 #include <emmintrin.h>
@@ -295,6 +296,58 @@ void ConvertRGBA8888ToRGB888(u8 *dst, const u32 *src, u32 numPixels) {
 	}
 }
 
+// These are written once for u32 (one pixel) and Vec4U32 (four), for the tails of the SSE paths
+// and for other hosts.
+struct Expand565 {
+	template <typename T>
+	static T Convert(const T &c) {
+		T r = c & T(0x1F);
+		T g = (c >> 5) & T(0x3F);
+		T b = (c >> 11) & T(0x1F);
+		r = (r << 3) | (r >> 2);
+		g = (g << 2) | (g >> 4);
+		b = (b << 3) | (b >> 2);
+		return r | (g << 8) | (b << 16) | T(0xFF000000);
+	}
+};
+
+struct Expand5551 {
+	template <typename T>
+	static T Convert(const T &c) {
+		T r = c & T(0x1F);
+		T g = (c >> 5) & T(0x1F);
+		T b = (c >> 10) & T(0x1F);
+		r = (r << 3) | (r >> 2);
+		g = (g << 3) | (g >> 2);
+		b = (b << 3) | (b >> 2);
+		// All ones when the bit is set.
+		T a = T(0) - (c >> 15);
+		return r | (g << 8) | (b << 16) | (a << 24);
+	}
+};
+
+struct Expand4444 {
+	template <typename T>
+	static T Convert(const T &c) {
+		T nibbles = (c & T(0xF)) | ((c & T(0xF0)) << 4) | ((c & T(0xF00)) << 8) | ((c & T(0xF000)) << 12);
+		return nibbles | (nibbles << 4);
+	}
+};
+
+template <typename Converter>
+static void Convert16To8888(u32 *dst, const u16 *src, u32 start, u32 numPixels) {
+	u32 x = start;
+#if defined(_M_SSE) || PPSSPP_ARCH(ARM_NEON)
+	// Without real vectors, the plain loop below is faster.
+	for (; x + 4 <= numPixels; x += 4) {
+		Converter::Convert(Vec4U32::LoadU16(src + x)).Store(dst + x);
+	}
+#endif
+	for (; x < numPixels; ++x) {
+		dst[x] = Converter::Convert((u32)src[x]);
+	}
+}
+
 void ConvertRGB565ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 #ifdef _M_SSE
 	const __m128i mask5 = _mm_set1_epi16(0x001f);
@@ -304,11 +357,8 @@ void ConvertRGB565ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 	const __m128i *srcp = (const __m128i *)src;
 	__m128i *dstp = (__m128i *)dst32;
 	u32 sseChunks = numPixels / 8;
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst32 & 0xF)) {
-		sseChunks = 0;
-	}
 	for (u32 i = 0; i < sseChunks; ++i) {
-		const __m128i c = _mm_load_si128(&srcp[i]);
+		const __m128i c = _mm_loadu_si128(&srcp[i]);
 
 		// Swizzle, resulting in RR00 RR00.
 		__m128i r = _mm_and_si128(c, mask5);
@@ -331,22 +381,15 @@ void ConvertRGB565ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 		// Now combine them, RRGG RRGG and BBAA BBAA, and then interleave.
 		const __m128i rg = _mm_or_si128(r, g);
 		const __m128i ba = _mm_or_si128(b, a);
-		_mm_store_si128(&dstp[i * 2 + 0], _mm_unpacklo_epi16(rg, ba));
-		_mm_store_si128(&dstp[i * 2 + 1], _mm_unpackhi_epi16(rg, ba));
+		_mm_storeu_si128(&dstp[i * 2 + 0], _mm_unpacklo_epi16(rg, ba));
+		_mm_storeu_si128(&dstp[i * 2 + 1], _mm_unpackhi_epi16(rg, ba));
 	}
 	u32 i = sseChunks * 8;
 #else
 	u32 i = 0;
 #endif
 
-	u8 *dst = (u8 *)dst32;
-	for (u32 x = i; x < numPixels; x++) {
-		u16 col = src[x];
-		dst[x * 4] = Convert5To8((col) & 0x1f);
-		dst[x * 4 + 1] = Convert6To8((col >> 5) & 0x3f);
-		dst[x * 4 + 2] = Convert5To8((col >> 11) & 0x1f);
-		dst[x * 4 + 3] = 255;
-	}
+	Convert16To8888<Expand565>(dst32, src, i, numPixels);
 }
 
 void ConvertRGBA5551ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
@@ -357,11 +400,8 @@ void ConvertRGBA5551ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 	const __m128i *srcp = (const __m128i *)src;
 	__m128i *dstp = (__m128i *)dst32;
 	u32 sseChunks = numPixels / 8;
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst32 & 0xF)) {
-		sseChunks = 0;
-	}
 	for (u32 i = 0; i < sseChunks; ++i) {
-		const __m128i c = _mm_load_si128(&srcp[i]);
+		const __m128i c = _mm_loadu_si128(&srcp[i]);
 
 		// Swizzle, resulting in RR00 RR00.
 		__m128i r = _mm_and_si128(c, mask5);
@@ -385,22 +425,15 @@ void ConvertRGBA5551ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 		// Now combine them, RRGG RRGG and BBAA BBAA, and then interleave.
 		const __m128i rg = _mm_or_si128(r, g);
 		const __m128i ba = _mm_or_si128(b, a);
-		_mm_store_si128(&dstp[i * 2 + 0], _mm_unpacklo_epi16(rg, ba));
-		_mm_store_si128(&dstp[i * 2 + 1], _mm_unpackhi_epi16(rg, ba));
+		_mm_storeu_si128(&dstp[i * 2 + 0], _mm_unpacklo_epi16(rg, ba));
+		_mm_storeu_si128(&dstp[i * 2 + 1], _mm_unpackhi_epi16(rg, ba));
 	}
 	u32 i = sseChunks * 8;
 #else
 	u32 i = 0;
 #endif
 
-	u8 *dst = (u8 *)dst32;
-	for (u32 x = i; x < numPixels; x++) {
-		u16 col = src[x];
-		dst[x * 4] = Convert5To8((col) & 0x1f);
-		dst[x * 4 + 1] = Convert5To8((col >> 5) & 0x1f);
-		dst[x * 4 + 2] = Convert5To8((col >> 10) & 0x1f);
-		dst[x * 4 + 3] = (col >> 15) ? 255 : 0;
-	}
+	Convert16To8888<Expand5551>(dst32, src, i, numPixels);
 }
 
 void ConvertRGBA4444ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
@@ -410,11 +443,8 @@ void ConvertRGBA4444ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 	const __m128i *srcp = (const __m128i *)src;
 	__m128i *dstp = (__m128i *)dst32;
 	u32 sseChunks = numPixels / 8;
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst32 & 0xF)) {
-		sseChunks = 0;
-	}
 	for (u32 i = 0; i < sseChunks; ++i) {
-		const __m128i c = _mm_load_si128(&srcp[i]);
+		const __m128i c = _mm_loadu_si128(&srcp[i]);
 
 		// Let's just grab R000 R000, without swizzling yet.
 		__m128i r = _mm_and_si128(c, mask4);
@@ -434,22 +464,15 @@ void ConvertRGBA4444ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 		ba = _mm_or_si128(ba, _mm_slli_epi16(ba, 4));
 
 		// And then we can store.
-		_mm_store_si128(&dstp[i * 2 + 0], _mm_unpacklo_epi16(rg, ba));
-		_mm_store_si128(&dstp[i * 2 + 1], _mm_unpackhi_epi16(rg, ba));
+		_mm_storeu_si128(&dstp[i * 2 + 0], _mm_unpacklo_epi16(rg, ba));
+		_mm_storeu_si128(&dstp[i * 2 + 1], _mm_unpackhi_epi16(rg, ba));
 	}
 	u32 i = sseChunks * 8;
 #else
 	u32 i = 0;
 #endif
 
-	u8 *dst = (u8 *)dst32;
-	for (u32 x = i; x < numPixels; x++) {
-		u16 col = src[x];
-		dst[x * 4] = Convert4To8(col & 0xf);
-		dst[x * 4 + 1] = Convert4To8((col >> 4) & 0xf);
-		dst[x * 4 + 2] = Convert4To8((col >> 8) & 0xf);
-		dst[x * 4 + 3] = Convert4To8(col >> 12);
-	}
+	Convert16To8888<Expand4444>(dst32, src, i, numPixels);
 }
 
 void ConvertBGR565ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
@@ -0,0 +1,1609 @@
+// Copyright (c) 2022- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include "ppsspp_config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Common/Log.h"
+#include "Common/MemoryUtil.h"
+#include "Common/LoongArch64Emitter.h"
+
+namespace LoongArch64Gen {
+
+static inline bool IsGPR(LoongArch64Reg r) {
+	return r < F_BASE;
+}
+
+static inline bool IsFPR(LoongArch64Reg r) {
+	return r >= F_BASE && r < V_BASE;
+}
+
+static inline bool IsVPR(LoongArch64Reg r) {
+	return r >= V_BASE && r < V_BASE + 32;
+}
+
+static inline bool FitsSigned(s64 v, int bits) {
+	return v >= -(1LL << (bits - 1)) && v < (1LL << (bits - 1));
+}
+
+// Maps a lane size in bits to the 2-bit size field most LSX ops use.
+static inline u32 LaneSizeIndex(int size) {
+	switch (size) {
+	case 8: return 0;
+	case 16: return 1;
+	case 32: return 2;
+	case 64: return 3;
+	default:
+		_dbg_assert_msg_(false, "Bad lane size %d", size);
+		return 0;
+	}
+}
+
+void LoongArch64Emitter::SetCodePointer(const u8 *ptr, u8 *writePtr) {
+	code_ = writePtr;
+	lastCacheFlushEnd_ = writePtr;
+}
+
+const u8 *LoongArch64Emitter::GetCodePointer() const {
+	return code_;
+}
+
+void LoongArch64Emitter::ReserveCodeSpace(u32 bytes) {
+	for (u32 i = 0; i < bytes / 4; ++i) {
+		BREAK(0);
+	}
+}
+
+const u8 *LoongArch64Emitter::AlignCode16() {
+	ReserveCodeSpace((-(intptr_t)code_) & 15);
+	return code_;
+}
+
+const u8 *LoongArch64Emitter::AlignCodePage() {
+	// LoongArch kernels commonly use 16K pages, so don't assume 4K.
+	const intptr_t pageSize = GetMemoryProtectPageSize();
+	ReserveCodeSpace((-(intptr_t)code_) & (pageSize - 1));
+	return code_;
+}
+
+const u8 *LoongArch64Emitter::GetCodePtr() const {
+	return code_;
+}
+
+u8 *LoongArch64Emitter::GetWritableCodePtr() {
+	return code_;
+}
+
+void LoongArch64Emitter::FlushIcache() {
+	FlushIcacheSection(lastCacheFlushEnd_, code_);
+	lastCacheFlushEnd_ = code_;
+}
+
+void LoongArch64Emitter::FlushIcacheSection(u8 *start, u8 *end) {
+#if PPSSPP_ARCH(LOONGARCH64)
+	__builtin___clear_cache((char *)start, (char *)end);
+#endif
+}
+
+void LoongArch64Emitter::BREAK(u32 code) {
+	// 0000 0000 0010 1010 0 ccccccccccccccc
+	_dbg_assert_msg_(code <= 0x7fff, "Bad emitter arguments");
+	Write32(0x002A0000 | (code & 0x7FFF));
+}
+
+void LoongArch64Emitter::SYSCALL(u32 code) {
+	// 0000 0000 0010 1011 0 ccccccccccccccc
+	_dbg_assert_msg_(code <= 0x7fff, "Bad emitter arguments");
+	Write32(0x002B0000 | (code & 0x7FFF));
+}
+
+void LoongArch64Emitter::DBAR(u32 hint) {
+	_dbg_assert_msg_(hint <= 0x7fff, "Bad emitter arguments");
+	Write32(0x38720000 | (hint & 0x7FFF));
+}
+
+void LoongArch64Emitter::IBAR(u32 hint) {
+	_dbg_assert_msg_(hint <= 0x7fff, "Bad emitter arguments");
+	Write32(0x38728000 | (hint & 0x7FFF));
+}
+
+FixupBranch LoongArch64Emitter::B() {
+	// 010100 iiiiiiiiiiiiiiii IIIIIIIIII (fix up)
+	FixupBranch b = MakeFixupBranch(BRANCH_26);
+	Write32(0x50000000);
+	return b;
+}
+
+void LoongArch64Emitter::B(const void *func) {
+	SetJumpTarget(B(), func);
+}
+
+FixupBranch LoongArch64Emitter::BL() {
+	// 010101 iiiiiiiiiiiiiiii IIIIIIIIII (fix up)
+	FixupBranch b = MakeFixupBranch(BRANCH_26);
+	Write32(0x54000000);
+	return b;
+}
+
+void LoongArch64Emitter::BL(const void *func) {
+	SetJumpTarget(BL(), func);
+}
+
+FixupBranch LoongArch64Emitter::BEQ(LoongArch64Reg rj, LoongArch64Reg rd) {
+	// 010110 iiiiiiiiiiiiiiii jjjjj ddddd (fix up)
+	_dbg_assert_msg_(IsGPR(rj) && IsGPR(rd), "Bad emitter arguments");
+	FixupBranch b = MakeFixupBranch(BRANCH_16);
+	EncodeR2(0x58000000, rd, rj);
+	return b;
+}
+
+void LoongArch64Emitter::BEQ(LoongArch64Reg rj, LoongArch64Reg rd, const void *func) {
+	SetJumpTarget(BEQ(rj, rd), func);
+}
+
+FixupBranch LoongArch64Emitter::BNE(LoongArch64Reg rj, LoongArch64Reg rd) {
+	// 010111 iiiiiiiiiiiiiiii jjjjj ddddd (fix up)
+	_dbg_assert_msg_(IsGPR(rj) && IsGPR(rd), "Bad emitter arguments");
+	FixupBranch b = MakeFixupBranch(BRANCH_16);
+	EncodeR2(0x5C000000, rd, rj);
+	return b;
+}
+
+void LoongArch64Emitter::BNE(LoongArch64Reg rj, LoongArch64Reg rd, const void *func) {
+	SetJumpTarget(BNE(rj, rd), func);
+}
+
+FixupBranch LoongArch64Emitter::BLT(LoongArch64Reg rj, LoongArch64Reg rd) {
+	// 011000 iiiiiiiiiiiiiiii jjjjj ddddd (fix up)
+	_dbg_assert_msg_(IsGPR(rj) && IsGPR(rd), "Bad emitter arguments");
+	FixupBranch b = MakeFixupBranch(BRANCH_16);
+	EncodeR2(0x60000000, rd, rj);
+	return b;
+}
+
+void LoongArch64Emitter::BLT(LoongArch64Reg rj, LoongArch64Reg rd, const void *func) {
+	SetJumpTarget(BLT(rj, rd), func);
+}
+
+FixupBranch LoongArch64Emitter::BGE(LoongArch64Reg rj, LoongArch64Reg rd) {
+	// 011001 iiiiiiiiiiiiiiii jjjjj ddddd (fix up)
+	_dbg_assert_msg_(IsGPR(rj) && IsGPR(rd), "Bad emitter arguments");
+	FixupBranch b = MakeFixupBranch(BRANCH_16);
+	EncodeR2(0x64000000, rd, rj);
+	return b;
+}
+
+void LoongArch64Emitter::BGE(LoongArch64Reg rj, LoongArch64Reg rd, const void *func) {
+	SetJumpTarget(BGE(rj, rd), func);
+}
+
+FixupBranch LoongArch64Emitter::BLTU(LoongArch64Reg rj, LoongArch64Reg rd) {
+	// 011010 iiiiiiiiiiiiiiii jjjjj ddddd (fix up)
+	_dbg_assert_msg_(IsGPR(rj) && IsGPR(rd), "Bad emitter arguments");
+	FixupBranch b = MakeFixupBranch(BRANCH_16);
+	EncodeR2(0x68000000, rd, rj);
+	return b;
+}
+
+void LoongArch64Emitter::BLTU(LoongArch64Reg rj, LoongArch64Reg rd, const void *func) {
+	SetJumpTarget(BLTU(rj, rd), func);
+}
+
+FixupBranch LoongArch64Emitter::BGEU(LoongArch64Reg rj, LoongArch64Reg rd) {
+	// 011011 iiiiiiiiiiiiiiii jjjjj ddddd (fix up)
+	_dbg_assert_msg_(IsGPR(rj) && IsGPR(rd), "Bad emitter arguments");
+	FixupBranch b = MakeFixupBranch(BRANCH_16);
+	EncodeR2(0x6C000000, rd, rj);
+	return b;
+}
+
+void LoongArch64Emitter::BGEU(LoongArch64Reg rj, LoongArch64Reg rd, const void *func) {
+	SetJumpTarget(BGEU(rj, rd), func);
+}
+
+FixupBranch LoongArch64Emitter::BEQZ(LoongArch64Reg rj) {
+	// 010000 iiiiiiiiiiiiiiii jjjjj IIIII (fix up)
+	_dbg_assert_msg_(IsGPR(rj), "Bad emitter arguments");
+	FixupBranch b = MakeFixupBranch(BRANCH_21);
+	EncodeR2(0x40000000, 0, rj);
+	return b;
+}
+
+void LoongArch64Emitter::BEQZ(LoongArch64Reg rj, const void *func) {
+	SetJumpTarget(BEQZ(rj), func);
+}
+
+FixupBranch LoongArch64Emitter::BNEZ(LoongArch64Reg rj) {
+	// 010001 iiiiiiiiiiiiiiii jjjjj IIIII (fix up)
+	_dbg_assert_msg_(IsGPR(rj), "Bad emitter arguments");
+	FixupBranch b = MakeFixupBranch(BRANCH_21);
+	EncodeR2(0x44000000, 0, rj);
+	return b;
+}
+
+void LoongArch64Emitter::BNEZ(LoongArch64Reg rj, const void *func) {
+	SetJumpTarget(BNEZ(rj), func);
+}
+
+FixupBranch LoongArch64Emitter::BCEQZ(LoongArch64CFReg cj) {
+	// 010010 iiiiiiiiiiiiiiii 00ccc IIIII (fix up)
+	_dbg_assert_msg_(cj <= FCC7, "Bad emitter arguments");
+	FixupBranch b = MakeFixupBranch(BRANCH_21);
+	Write32(0x48000000 | ((cj & 7) << 5));
+	return b;
+}
+
+void LoongArch64Emitter::BCEQZ(LoongArch64CFReg cj, const void *func) {
+	SetJumpTarget(BCEQZ(cj), func);
+}
+
+FixupBranch LoongArch64Emitter::BCNEZ(LoongArch64CFReg cj) {
+	// 010010 iiiiiiiiiiiiiiii 01ccc IIIII (fix up)
+	_dbg_assert_msg_(cj <= FCC7, "Bad emitter arguments");
+	FixupBranch b = MakeFixupBranch(BRANCH_21);
+	Write32(0x48000100 | ((cj & 7) << 5));
+	return b;
+}
+
+void LoongArch64Emitter::BCNEZ(LoongArch64CFReg cj, const void *func) {
+	SetJumpTarget(BCNEZ(cj), func);
+}
+
+void LoongArch64Emitter::JIRL(LoongArch64Reg rd, LoongArch64Reg rj, s32 offset) {
+	// 010011 iiiiiiiiiiiiiiii jjjjj ddddd
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && (offset & 3) == 0 && FitsSigned(offset >> 2, 16), "Bad emitter arguments");
+	EncodeRI16(0x4C000000, rd, rj, (u32)(offset >> 2));
+}
+
+void LoongArch64Emitter::SetJumpTarget(const FixupBranch &branch) {
+	SetJumpTarget(branch, code_);
+}
+
+bool LoongArch64Emitter::BInRange(const void *func) {
+	return BInRange(code_, func, BRANCH_26);
+}
+
+bool LoongArch64Emitter::JInRange(const void *func) {
+	// Reachable with PCADDU18I + JIRL.
+	ptrdiff_t distance = (intptr_t)func - (intptr_t)code_;
+	return FitsSigned(distance, 38);
+}
+
+void LoongArch64Emitter::SetJumpTarget(const FixupBranch &branch, const void *dst) {
+	const intptr_t srcp = (intptr_t)branch.ptr;
+	const intptr_t dstp = (intptr_t)dst;
+	u32 *fixup = (u32 *)branch.ptr;
+
+	_dbg_assert_msg_((dstp & 3) == 0, "Destination should be aligned");
+	_dbg_assert_msg_(BInRange(branch.ptr, dst, branch.type), "Destination is too far away (%p -> %p)", branch.ptr, dst);
+
+	// Unlike MIPS, the distance is in words from the branch itself.
+	u32 distance = (u32)((dstp - srcp) >> 2);
+	switch (branch.type) {
+	case BRANCH_16:
+		*fixup = (*fixup & 0xFC0003FF) | ((distance & 0xFFFF) << 10);
+		break;
+	case BRANCH_21:
+		*fixup = (*fixup & 0xFC0003E0) | ((distance & 0xFFFF) << 10) | ((distance >> 16) & 0x1F);
+		break;
+	case BRANCH_26:
+		*fixup = (*fixup & 0xFC000000) | ((distance & 0xFFFF) << 10) | ((distance >> 16) & 0x3FF);
+		break;
+	}
+}
+
+bool LoongArch64Emitter::BInRange(const void *src, const void *dst, FixupBranchType type) {
+	const intptr_t srcp = (intptr_t)src;
+	const intptr_t dstp = (intptr_t)dst;
+
+	ptrdiff_t distance = (dstp - srcp) >> 2;
+	switch (type) {
+	case BRANCH_16: return FitsSigned(distance, 16);
+	case BRANCH_21: return FitsSigned(distance, 21);
+	case BRANCH_26: return FitsSigned(distance, 26);
+	}
+	return false;
+}
+
+FixupBranch LoongArch64Emitter::MakeFixupBranch(FixupBranchType type) {
+	FixupBranch b;
+	b.ptr = code_;
+	b.type = type;
+	return b;
+}
+
+void LoongArch64Emitter::QuickCallFunction(LoongArch64Reg scratchreg, const void *func) {
+	_dbg_assert_msg_(IsGPR(scratchreg), "Bad emitter arguments");
+	if (BInRange(func)) {
+		BL(func);
+	} else if (JInRange(func)) {
+		// PCADDU18I adds imm << 18 to PC, and JIRL covers the remaining 18 bits (signed.)
+		s64 distance = (intptr_t)func - (intptr_t)code_;
+		s64 hi = (distance + (1 << 17)) >> 18;
+		s64 lo = distance - (hi << 18);
+		PCADDU18I(scratchreg, (s32)hi);
+		JIRL(R_RA, scratchreg, (s32)lo);
+	} else {
+		MOVP2R(scratchreg, func);
+		JALR(scratchreg);
+	}
+}
+
+void LoongArch64Emitter::ADD_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00100000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::ADD_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00108000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::SUB_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00110000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::SUB_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00118000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::ADDI_W(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(imm, 12), "Bad emitter arguments");
+	EncodeRI12(0x02800000, rd, rj, (u32)imm);
+}
+
+void LoongArch64Emitter::ADDI_D(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(imm, 12), "Bad emitter arguments");
+	EncodeRI12(0x02C00000, rd, rj, (u32)imm);
+}
+
+void LoongArch64Emitter::ADDU16I_D(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeRI16(0x10000000, rd, rj, (u32)imm);
+}
+
+void LoongArch64Emitter::ALSL_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk, u8 sa) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk) && sa >= 1 && sa <= 4, "Bad emitter arguments");
+	EncodeR3(0x00040000 | ((sa - 1) << 15), rd, rj, rk);
+}
+
+void LoongArch64Emitter::ALSL_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk, u8 sa) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk) && sa >= 1 && sa <= 4, "Bad emitter arguments");
+	EncodeR3(0x00060000 | ((sa - 1) << 15), rd, rj, rk);
+}
+
+void LoongArch64Emitter::ALSL_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk, u8 sa) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk) && sa >= 1 && sa <= 4, "Bad emitter arguments");
+	EncodeR3(0x002C0000 | ((sa - 1) << 15), rd, rj, rk);
+}
+
+void LoongArch64Emitter::LU12I_W(LoongArch64Reg rd, s32 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && FitsSigned(imm, 20), "Bad emitter arguments");
+	EncodeRI20(0x14000000, rd, (u32)imm);
+}
+
+void LoongArch64Emitter::LU32I_D(LoongArch64Reg rd, s32 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && FitsSigned(imm, 20), "Bad emitter arguments");
+	EncodeRI20(0x16000000, rd, (u32)imm);
+}
+
+void LoongArch64Emitter::LU52I_D(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(imm, 12), "Bad emitter arguments");
+	EncodeRI12(0x03000000, rd, rj, (u32)imm);
+}
+
+void LoongArch64Emitter::PCADDI(LoongArch64Reg rd, s32 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && FitsSigned(imm, 20), "Bad emitter arguments");
+	EncodeRI20(0x18000000, rd, (u32)imm);
+}
+
+void LoongArch64Emitter::PCALAU12I(LoongArch64Reg rd, s32 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && FitsSigned(imm, 20), "Bad emitter arguments");
+	EncodeRI20(0x1A000000, rd, (u32)imm);
+}
+
+void LoongArch64Emitter::PCADDU12I(LoongArch64Reg rd, s32 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && FitsSigned(imm, 20), "Bad emitter arguments");
+	EncodeRI20(0x1C000000, rd, (u32)imm);
+}
+
+void LoongArch64Emitter::PCADDU18I(LoongArch64Reg rd, s32 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && FitsSigned(imm, 20), "Bad emitter arguments");
+	EncodeRI20(0x1E000000, rd, (u32)imm);
+}
+
+void LoongArch64Emitter::SLT(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00120000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::SLTU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00128000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::SLTI(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(imm, 12), "Bad emitter arguments");
+	EncodeRI12(0x02000000, rd, rj, (u32)imm);
+}
+
+void LoongArch64Emitter::SLTUI(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(imm, 12), "Bad emitter arguments");
+	EncodeRI12(0x02400000, rd, rj, (u32)imm);
+}
+
+void LoongArch64Emitter::MASKEQZ(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00130000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MASKNEZ(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00138000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::NOR(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00140000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::AND(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00148000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::OR(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00150000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::XOR(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00158000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::ORN(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00160000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::ANDN(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00168000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::ANDI(LoongArch64Reg rd, LoongArch64Reg rj, u16 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && imm <= 0xFFF, "Bad emitter arguments");
+	EncodeRI12(0x03400000, rd, rj, imm);
+}
+
+void LoongArch64Emitter::ORI(LoongArch64Reg rd, LoongArch64Reg rj, u16 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && imm <= 0xFFF, "Bad emitter arguments");
+	EncodeRI12(0x03800000, rd, rj, imm);
+}
+
+void LoongArch64Emitter::XORI(LoongArch64Reg rd, LoongArch64Reg rj, u16 imm) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && imm <= 0xFFF, "Bad emitter arguments");
+	EncodeRI12(0x03C00000, rd, rj, imm);
+}
+
+void LoongArch64Emitter::SLL_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00170000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::SRL_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00178000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::SRA_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00180000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::SLL_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00188000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::SRL_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00190000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::SRA_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00198000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::ROTR_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x001B0000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::ROTR_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x001B8000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::SLLI_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && sa <= 0x1F, "Bad emitter arguments");
+	EncodeR3(0x00408000, rd, rj, sa);
+}
+
+void LoongArch64Emitter::SRLI_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && sa <= 0x1F, "Bad emitter arguments");
+	EncodeR3(0x00448000, rd, rj, sa);
+}
+
+void LoongArch64Emitter::SRAI_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && sa <= 0x1F, "Bad emitter arguments");
+	EncodeR3(0x00488000, rd, rj, sa);
+}
+
+void LoongArch64Emitter::ROTRI_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && sa <= 0x1F, "Bad emitter arguments");
+	EncodeR3(0x004C8000, rd, rj, sa);
+}
+
+void LoongArch64Emitter::SLLI_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && sa <= 0x3F, "Bad emitter arguments");
+	Write32(0x00410000 | ((sa & 0x3F) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+}
+
+void LoongArch64Emitter::SRLI_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && sa <= 0x3F, "Bad emitter arguments");
+	Write32(0x00450000 | ((sa & 0x3F) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+}
+
+void LoongArch64Emitter::SRAI_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && sa <= 0x3F, "Bad emitter arguments");
+	Write32(0x00490000 | ((sa & 0x3F) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+}
+
+void LoongArch64Emitter::ROTRI_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && sa <= 0x3F, "Bad emitter arguments");
+	Write32(0x004D0000 | ((sa & 0x3F) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+}
+
+void LoongArch64Emitter::EXT_W_H(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00005800, rd, rj);
+}
+
+void LoongArch64Emitter::EXT_W_B(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00005C00, rd, rj);
+}
+
+void LoongArch64Emitter::CLO_W(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00001000, rd, rj);
+}
+
+void LoongArch64Emitter::CLZ_W(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00001400, rd, rj);
+}
+
+void LoongArch64Emitter::CTO_W(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00001800, rd, rj);
+}
+
+void LoongArch64Emitter::CTZ_W(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00001C00, rd, rj);
+}
+
+void LoongArch64Emitter::CLO_D(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00002000, rd, rj);
+}
+
+void LoongArch64Emitter::CLZ_D(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00002400, rd, rj);
+}
+
+void LoongArch64Emitter::CTO_D(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00002800, rd, rj);
+}
+
+void LoongArch64Emitter::CTZ_D(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00002C00, rd, rj);
+}
+
+void LoongArch64Emitter::REVB_2H(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00003000, rd, rj);
+}
+
+void LoongArch64Emitter::REVB_4H(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00003400, rd, rj);
+}
+
+void LoongArch64Emitter::REVB_2W(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00003800, rd, rj);
+}
+
+void LoongArch64Emitter::REVB_D(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00003C00, rd, rj);
+}
+
+void LoongArch64Emitter::REVH_2W(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00004000, rd, rj);
+}
+
+void LoongArch64Emitter::REVH_D(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00004400, rd, rj);
+}
+
+void LoongArch64Emitter::BITREV_4B(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00004800, rd, rj);
+}
+
+void LoongArch64Emitter::BITREV_8B(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00004C00, rd, rj);
+}
+
+void LoongArch64Emitter::BITREV_W(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00005000, rd, rj);
+}
+
+void LoongArch64Emitter::BITREV_D(LoongArch64Reg rd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x00005400, rd, rj);
+}
+
+void LoongArch64Emitter::BSTRINS_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 msb, u8 lsb) {
+	// 00000000011 mmmmm 0 lllll jjjjj ddddd
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && msb <= 31 && lsb <= msb, "Bad emitter arguments");
+	Write32(0x00600000 | ((msb & 0x1F) << 16) | ((lsb & 0x1F) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+}
+
+void LoongArch64Emitter::BSTRPICK_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 msb, u8 lsb) {
+	// 00000000011 mmmmm 1 lllll jjjjj ddddd
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && msb <= 31 && lsb <= msb, "Bad emitter arguments");
+	Write32(0x00608000 | ((msb & 0x1F) << 16) | ((lsb & 0x1F) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+}
+
+void LoongArch64Emitter::BSTRINS_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 msb, u8 lsb) {
+	// 0000000010 mmmmmm llllll jjjjj ddddd
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && msb <= 63 && lsb <= msb, "Bad emitter arguments");
+	Write32(0x00800000 | ((msb & 0x3F) << 16) | ((lsb & 0x3F) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+}
+
+void LoongArch64Emitter::BSTRPICK_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 msb, u8 lsb) {
+	// 0000000011 mmmmmm llllll jjjjj ddddd
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && msb <= 63 && lsb <= msb, "Bad emitter arguments");
+	Write32(0x00C00000 | ((msb & 0x3F) << 16) | ((lsb & 0x3F) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+}
+
+void LoongArch64Emitter::MUL_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x001C0000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MULH_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x001C8000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MULH_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x001D0000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MUL_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x001D8000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MULH_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x001E0000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MULH_DU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x001E8000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MULW_D_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x001F0000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MULW_D_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x001F8000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::DIV_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00200000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MOD_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00208000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::DIV_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00210000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MOD_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00218000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::DIV_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00220000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MOD_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00228000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::DIV_DU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00230000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MOD_DU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x00238000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::LD_B(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x28000000, rd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::LD_H(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x28400000, rd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::LD_W(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x28800000, rd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::LD_D(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x28C00000, rd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::ST_B(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x29000000, rd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::ST_H(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x29400000, rd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::ST_W(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x29800000, rd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::ST_D(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x29C00000, rd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::LD_BU(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x2A000000, rd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::LD_HU(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x2A400000, rd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::LD_WU(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x2A800000, rd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::LDPTR_W(LoongArch64Reg rd, LoongArch64Reg rj, s32 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && (offset & 3) == 0 && FitsSigned(offset >> 2, 14), "Bad emitter arguments");
+	EncodeRI14(0x24000000, rd, rj, (u32)(offset >> 2));
+}
+
+void LoongArch64Emitter::STPTR_W(LoongArch64Reg rd, LoongArch64Reg rj, s32 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && (offset & 3) == 0 && FitsSigned(offset >> 2, 14), "Bad emitter arguments");
+	EncodeRI14(0x25000000, rd, rj, (u32)(offset >> 2));
+}
+
+void LoongArch64Emitter::LDPTR_D(LoongArch64Reg rd, LoongArch64Reg rj, s32 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && (offset & 3) == 0 && FitsSigned(offset >> 2, 14), "Bad emitter arguments");
+	EncodeRI14(0x26000000, rd, rj, (u32)(offset >> 2));
+}
+
+void LoongArch64Emitter::STPTR_D(LoongArch64Reg rd, LoongArch64Reg rj, s32 offset) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && (offset & 3) == 0 && FitsSigned(offset >> 2, 14), "Bad emitter arguments");
+	EncodeRI14(0x27000000, rd, rj, (u32)(offset >> 2));
+}
+
+void LoongArch64Emitter::LDX_B(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38000000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::LDX_H(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38040000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::LDX_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38080000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::LDX_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x380C0000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::STX_B(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38100000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::STX_H(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38140000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::STX_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38180000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::STX_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x381C0000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::LDX_BU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38200000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::LDX_HU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38240000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::LDX_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsGPR(rd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38280000, rd, rj, rk);
+}
+
+void LoongArch64Emitter::MOVI2R(LoongArch64Reg reg, u32 imm) {
+	_dbg_assert_msg_(IsGPR(reg), "Bad emitter arguments");
+
+	s32 simm = (s32)imm;
+	if (FitsSigned(simm, 12)) {
+		ADDI_W(reg, R_ZERO, (s16)simm);
+	} else if (imm <= 0xFFF) {
+		ORI(reg, R_ZERO, (u16)imm);
+	} else {
+		// LU12I.W sign extends, which is exactly what we want for a 32-bit value.
+		LU12I_W(reg, simm >> 12);
+		if ((imm & 0xFFF) != 0)
+			ORI(reg, reg, imm & 0xFFF);
+	}
+}
+
+void LoongArch64Emitter::MOVI2R(LoongArch64Reg reg, u64 imm) {
+	_dbg_assert_msg_(IsGPR(reg), "Bad emitter arguments");
+
+	// Start with the low 32 bits, which get sign extended.
+	s64 value = (s64)(s32)(u32)imm;
+	MOVI2R(reg, (u32)imm);
+	if ((u64)value == imm)
+		return;
+
+	// LU32I.D sets bits 32-51, and sign extends bit 51 to the top.
+	if (((imm >> 32) & 0xFFFFF) != (((u64)value >> 32) & 0xFFFFF)) {
+		LU32I_D(reg, (s32)((s64)(imm << 12) >> 44));
+		value = (s64)(imm << 12) >> 12;
+	}
+	if ((u64)value != imm) {
+		LU52I_D(reg, reg, (s16)((s64)imm >> 52));
+	}
+}
+
+void LoongArch64Emitter::FADD_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x01008000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FADD_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x01010000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FSUB_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x01028000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FSUB_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x01030000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FMUL_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x01048000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FMUL_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x01050000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FDIV_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x01068000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FDIV_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x01070000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FMAX_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x01088000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FMAX_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x01090000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FMIN_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x010A8000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FMIN_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x010B0000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FCOPYSIGN_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR3(0x01128000, fd, fj, fk);
+}
+
+void LoongArch64Emitter::FABS_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01140400, fd, fj);
+}
+
+void LoongArch64Emitter::FABS_D(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01140800, fd, fj);
+}
+
+void LoongArch64Emitter::FNEG_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01141400, fd, fj);
+}
+
+void LoongArch64Emitter::FNEG_D(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01141800, fd, fj);
+}
+
+void LoongArch64Emitter::FSQRT_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01144400, fd, fj);
+}
+
+void LoongArch64Emitter::FSQRT_D(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01144800, fd, fj);
+}
+
+void LoongArch64Emitter::FRECIP_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01145400, fd, fj);
+}
+
+void LoongArch64Emitter::FRSQRT_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01146400, fd, fj);
+}
+
+void LoongArch64Emitter::FMOV_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01149400, fd, fj);
+}
+
+void LoongArch64Emitter::FMOV_D(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01149800, fd, fj);
+}
+
+void LoongArch64Emitter::FMADD_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk) && IsFPR(fa), "Bad emitter arguments");
+	EncodeR4(0x08100000, fd, fj, fk, fa);
+}
+
+void LoongArch64Emitter::FMADD_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk) && IsFPR(fa), "Bad emitter arguments");
+	EncodeR4(0x08200000, fd, fj, fk, fa);
+}
+
+void LoongArch64Emitter::FMSUB_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk) && IsFPR(fa), "Bad emitter arguments");
+	EncodeR4(0x08500000, fd, fj, fk, fa);
+}
+
+void LoongArch64Emitter::FMSUB_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk) && IsFPR(fa), "Bad emitter arguments");
+	EncodeR4(0x08600000, fd, fj, fk, fa);
+}
+
+void LoongArch64Emitter::FNMADD_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk) && IsFPR(fa), "Bad emitter arguments");
+	EncodeR4(0x08900000, fd, fj, fk, fa);
+}
+
+void LoongArch64Emitter::FNMADD_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk) && IsFPR(fa), "Bad emitter arguments");
+	EncodeR4(0x08A00000, fd, fj, fk, fa);
+}
+
+void LoongArch64Emitter::FNMSUB_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk) && IsFPR(fa), "Bad emitter arguments");
+	EncodeR4(0x08D00000, fd, fj, fk, fa);
+}
+
+void LoongArch64Emitter::FNMSUB_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk) && IsFPR(fa), "Bad emitter arguments");
+	EncodeR4(0x08E00000, fd, fj, fk, fa);
+}
+
+void LoongArch64Emitter::FCMP_COND_S(LoongArch64CFReg cd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64FCond cond) {
+	// 000011000001 ccccc kkkkk jjjjj 00ddd
+	_dbg_assert_msg_(cd <= FCC7 && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR4(0x0C100000, cd & 7, fj, fk, cond);
+}
+
+void LoongArch64Emitter::FCMP_COND_D(LoongArch64CFReg cd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64FCond cond) {
+	// 000011000010 ccccc kkkkk jjjjj 00ddd
+	_dbg_assert_msg_(cd <= FCC7 && IsFPR(fj) && IsFPR(fk), "Bad emitter arguments");
+	EncodeR4(0x0C200000, cd & 7, fj, fk, cond);
+}
+
+void LoongArch64Emitter::FSEL(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64CFReg ca) {
+	// 00001101000000 aaa kkkkk jjjjj ddddd
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj) && IsFPR(fk) && ca <= FCC7, "Bad emitter arguments");
+	EncodeR4(0x0D000000, fd, fj, fk, ca & 7);
+}
+
+void LoongArch64Emitter::FCVT_S_D(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01191800, fd, fj);
+}
+
+void LoongArch64Emitter::FCVT_D_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x01192400, fd, fj);
+}
+
+void LoongArch64Emitter::FTINTRM_W_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x011A0400, fd, fj);
+}
+
+void LoongArch64Emitter::FTINTRP_W_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x011A4400, fd, fj);
+}
+
+void LoongArch64Emitter::FTINTRZ_W_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x011A8400, fd, fj);
+}
+
+void LoongArch64Emitter::FTINTRNE_W_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x011AC400, fd, fj);
+}
+
+void LoongArch64Emitter::FTINT_W_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x011B0400, fd, fj);
+}
+
+void LoongArch64Emitter::FFINT_S_W(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x011D1000, fd, fj);
+}
+
+void LoongArch64Emitter::FFINT_D_W(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x011D2000, fd, fj);
+}
+
+void LoongArch64Emitter::FRINT_S(LoongArch64Reg fd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x011E4400, fd, fj);
+}
+
+void LoongArch64Emitter::MOVGR2FR_W(LoongArch64Reg fd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x0114A400, fd, rj);
+}
+
+void LoongArch64Emitter::MOVGR2FR_D(LoongArch64Reg fd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsFPR(fd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x0114A800, fd, rj);
+}
+
+void LoongArch64Emitter::MOVFR2GR_S(LoongArch64Reg rd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x0114B400, rd, fj);
+}
+
+void LoongArch64Emitter::MOVFR2GR_D(LoongArch64Reg rd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(IsGPR(rd) && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x0114B800, rd, fj);
+}
+
+void LoongArch64Emitter::MOVGR2FCSR(LoongArch64FCSR fcsr, LoongArch64Reg rj) {
+	_dbg_assert_msg_(fcsr <= FCSR3 && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x0114C000, fcsr, rj);
+}
+
+void LoongArch64Emitter::MOVFCSR2GR(LoongArch64Reg rd, LoongArch64FCSR fcsr) {
+	_dbg_assert_msg_(IsGPR(rd) && fcsr <= FCSR3, "Bad emitter arguments");
+	EncodeR2(0x0114C800, rd, fcsr);
+}
+
+void LoongArch64Emitter::MOVFR2CF(LoongArch64CFReg cd, LoongArch64Reg fj) {
+	_dbg_assert_msg_(cd <= FCC7 && IsFPR(fj), "Bad emitter arguments");
+	EncodeR2(0x0114D000, cd & 7, fj);
+}
+
+void LoongArch64Emitter::MOVCF2FR(LoongArch64Reg fd, LoongArch64CFReg cj) {
+	_dbg_assert_msg_(IsFPR(fd) && cj <= FCC7, "Bad emitter arguments");
+	EncodeR2(0x0114D400, fd, cj & 7);
+}
+
+void LoongArch64Emitter::MOVGR2CF(LoongArch64CFReg cd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(cd <= FCC7 && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x0114D800, cd & 7, rj);
+}
+
+void LoongArch64Emitter::MOVCF2GR(LoongArch64Reg rd, LoongArch64CFReg cj) {
+	_dbg_assert_msg_(IsGPR(rd) && cj <= FCC7, "Bad emitter arguments");
+	EncodeR2(0x0114DC00, rd, cj & 7);
+}
+
+void LoongArch64Emitter::FLD_S(LoongArch64Reg fd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsFPR(fd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x2B000000, fd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::FST_S(LoongArch64Reg fd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsFPR(fd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x2B400000, fd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::FLD_D(LoongArch64Reg fd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsFPR(fd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x2B800000, fd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::FST_D(LoongArch64Reg fd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsFPR(fd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x2BC00000, fd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::FLDX_S(LoongArch64Reg fd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38300000, fd, rj, rk);
+}
+
+void LoongArch64Emitter::FLDX_D(LoongArch64Reg fd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38340000, fd, rj, rk);
+}
+
+void LoongArch64Emitter::FSTX_S(LoongArch64Reg fd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38380000, fd, rj, rk);
+}
+
+void LoongArch64Emitter::FSTX_D(LoongArch64Reg fd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsFPR(fd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x383C0000, fd, rj, rk);
+}
+
+void LoongArch64Emitter::VLD(LoongArch64Reg vd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsVPR(vd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x2C000000, vd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::VST(LoongArch64Reg vd, LoongArch64Reg rj, s16 offset) {
+	_dbg_assert_msg_(IsVPR(vd) && IsGPR(rj) && FitsSigned(offset, 12), "Bad emitter arguments");
+	EncodeRI12(0x2C400000, vd, rj, (u32)offset);
+}
+
+void LoongArch64Emitter::VLDX(LoongArch64Reg vd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38400000, vd, rj, rk);
+}
+
+void LoongArch64Emitter::VSTX(LoongArch64Reg vd, LoongArch64Reg rj, LoongArch64Reg rk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsGPR(rj) && IsGPR(rk), "Bad emitter arguments");
+	EncodeR3(0x38440000, vd, rj, rk);
+}
+
+void LoongArch64Emitter::VLDREPL(int size, LoongArch64Reg vd, LoongArch64Reg rj, s16 offset) {
+	// The opcode shrinks as the scaled offset field shrinks: si12, si11, si10, si9.
+	u32 index = LaneSizeIndex(size);
+	int shift = (int)index;
+	_dbg_assert_msg_(IsVPR(vd) && IsGPR(rj) && (offset & ((1 << shift) - 1)) == 0 && FitsSigned(offset >> shift, 12 - shift), "Bad emitter arguments");
+	u32 opcode = 0x30800000 >> index;
+	u32 imm = ((u32)(offset >> shift)) & ((1 << (12 - shift)) - 1);
+	Write32(opcode | (imm << 10) | ((rj & 0x1F) << 5) | (vd & 0x1F));
+}
+
+void LoongArch64Emitter::VEncodeSized3(u32 opcode, int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(opcode | (LaneSizeIndex(size) << 15), vd, vj, vk);
+}
+
+void LoongArch64Emitter::VEncodeSizedShift(u32 opcode, int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 shift) {
+	// A leading one bit marks the lane size, followed by a 3-6 bit shift amount.
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && shift < size, "Bad emitter arguments");
+	u32 marker = 1 << (13 + LaneSizeIndex(size));
+	EncodeR3(opcode | marker, vd, vj, shift & (size - 1));
+}
+
+void LoongArch64Emitter::VEncodeLaneIndex(u32 opcode, int size, u32 rd, u32 rj, u8 index) {
+	// A run of one bits marks the lane size, followed by a 1-4 bit lane index.
+	static const u32 markers[4] = { 0x8000, 0xC000, 0xE000, 0xF000 };
+	u32 sizeIndex = LaneSizeIndex(size);
+	_dbg_assert_msg_(index < 128 / size, "Bad emitter arguments");
+	Write32(opcode | markers[sizeIndex] | ((index & (128 / size - 1)) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+}
+
+void LoongArch64Emitter::VADD(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x700A0000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSUB(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x700C0000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSADD(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70460000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSSUB(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70480000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSADD_U(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x704A0000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSSUB_U(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x704C0000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VMUL(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70840000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VMAX(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70700000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VMIN(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70720000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VMAX_U(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70740000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VMIN_U(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70760000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSEQ(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70000000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSLE(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70020000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSLT(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70060000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSLL(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70E80000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSRL(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70EA0000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSRA(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x70EC0000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSLLI(int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 shift) {
+	VEncodeSizedShift(0x732C0000, size, vd, vj, shift);
+}
+
+void LoongArch64Emitter::VSRLI(int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 shift) {
+	VEncodeSizedShift(0x73300000, size, vd, vj, shift);
+}
+
+void LoongArch64Emitter::VSRAI(int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 shift) {
+	VEncodeSizedShift(0x73340000, size, vd, vj, shift);
+}
+
+void LoongArch64Emitter::VPACKEV(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x71160000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VPACKOD(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x71180000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VILVL(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x711A0000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VILVH(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x711C0000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VPICKEV(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x711E0000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VPICKOD(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	VEncodeSized3(0x71200000, size, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VSHUF4I(int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 imm) {
+	// 011100111001 ss iiiiiiii jjjjj ddddd
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	Write32(0x73900000 | (LaneSizeIndex(size) << 18) | (imm << 10) | ((vj & 0x1F) << 5) | (vd & 0x1F));
+}
+
+void LoongArch64Emitter::VAND_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x71260000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VOR_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x71268000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VXOR_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x71270000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VNOR_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x71278000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VANDN_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x71280000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VORN_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x71288000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VANDI_B(LoongArch64Reg vd, LoongArch64Reg vj, u8 imm) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	Write32(0x73D00000 | (imm << 10) | ((vj & 0x1F) << 5) | (vd & 0x1F));
+}
+
+void LoongArch64Emitter::VORI_B(LoongArch64Reg vd, LoongArch64Reg vj, u8 imm) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	Write32(0x73D40000 | (imm << 10) | ((vj & 0x1F) << 5) | (vd & 0x1F));
+}
+
+void LoongArch64Emitter::VXORI_B(LoongArch64Reg vd, LoongArch64Reg vj, u8 imm) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	Write32(0x73D80000 | (imm << 10) | ((vj & 0x1F) << 5) | (vd & 0x1F));
+}
+
+void LoongArch64Emitter::VNORI_B(LoongArch64Reg vd, LoongArch64Reg vj, u8 imm) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	Write32(0x73DC0000 | (imm << 10) | ((vj & 0x1F) << 5) | (vd & 0x1F));
+}
+
+void LoongArch64Emitter::VBITSEL_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk) && IsVPR(va), "Bad emitter arguments");
+	EncodeR4(0x0D100000, vd, vj, vk, va);
+}
+
+void LoongArch64Emitter::VSHUF_B(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk) && IsVPR(va), "Bad emitter arguments");
+	EncodeR4(0x0D500000, vd, vj, vk, va);
+}
+
+void LoongArch64Emitter::VFADD_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x71308000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VFSUB_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x71328000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VFMUL_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x71388000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VFDIV_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x713A8000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VFMAX_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x713C8000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VFMIN_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR3(0x713E8000, vd, vj, vk);
+}
+
+void LoongArch64Emitter::VFMADD_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk) && IsVPR(va), "Bad emitter arguments");
+	EncodeR4(0x09100000, vd, vj, vk, va);
+}
+
+void LoongArch64Emitter::VFMSUB_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk) && IsVPR(va), "Bad emitter arguments");
+	EncodeR4(0x09500000, vd, vj, vk, va);
+}
+
+void LoongArch64Emitter::VFNMADD_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk) && IsVPR(va), "Bad emitter arguments");
+	EncodeR4(0x09900000, vd, vj, vk, va);
+}
+
+void LoongArch64Emitter::VFNMSUB_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk) && IsVPR(va), "Bad emitter arguments");
+	EncodeR4(0x09D00000, vd, vj, vk, va);
+}
+
+void LoongArch64Emitter::VFSQRT_S(LoongArch64Reg vd, LoongArch64Reg vj) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	EncodeR2(0x729CE400, vd, vj);
+}
+
+void LoongArch64Emitter::VFRECIP_S(LoongArch64Reg vd, LoongArch64Reg vj) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	EncodeR2(0x729CF400, vd, vj);
+}
+
+void LoongArch64Emitter::VFRSQRT_S(LoongArch64Reg vd, LoongArch64Reg vj) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	EncodeR2(0x729D0400, vd, vj);
+}
+
+void LoongArch64Emitter::VFFINT_S_W(LoongArch64Reg vd, LoongArch64Reg vj) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	EncodeR2(0x729E0000, vd, vj);
+}
+
+void LoongArch64Emitter::VFTINT_W_S(LoongArch64Reg vd, LoongArch64Reg vj) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	EncodeR2(0x729E3000, vd, vj);
+}
+
+void LoongArch64Emitter::VFTINTRZ_W_S(LoongArch64Reg vd, LoongArch64Reg vj) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	EncodeR2(0x729E4000, vd, vj);
+}
+
+void LoongArch64Emitter::VFCMP_COND_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64FCond cond) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj) && IsVPR(vk), "Bad emitter arguments");
+	EncodeR4(0x0C500000, vd, vj, vk, cond);
+}
+
+void LoongArch64Emitter::VREPLGR2VR(int size, LoongArch64Reg vd, LoongArch64Reg rj) {
+	_dbg_assert_msg_(IsVPR(vd) && IsGPR(rj), "Bad emitter arguments");
+	EncodeR2(0x729F0000 | (LaneSizeIndex(size) << 10), vd, rj);
+}
+
+void LoongArch64Emitter::VINSGR2VR(int size, LoongArch64Reg vd, LoongArch64Reg rj, u8 index) {
+	_dbg_assert_msg_(IsVPR(vd) && IsGPR(rj), "Bad emitter arguments");
+	VEncodeLaneIndex(0x72EB0000, size, vd, rj, index);
+}
+
+void LoongArch64Emitter::VPICKVE2GR(int size, LoongArch64Reg rd, LoongArch64Reg vj, u8 index) {
+	_dbg_assert_msg_(IsGPR(rd) && IsVPR(vj), "Bad emitter arguments");
+	VEncodeLaneIndex(0x72EF0000, size, rd, vj, index);
+}
+
+void LoongArch64Emitter::VPICKVE2GR_U(int size, LoongArch64Reg rd, LoongArch64Reg vj, u8 index) {
+	_dbg_assert_msg_(IsGPR(rd) && IsVPR(vj), "Bad emitter arguments");
+	VEncodeLaneIndex(0x72F30000, size, rd, vj, index);
+}
+
+void LoongArch64Emitter::VREPLVEI(int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 index) {
+	_dbg_assert_msg_(IsVPR(vd) && IsVPR(vj), "Bad emitter arguments");
+	VEncodeLaneIndex(0x72F70000, size, vd, vj, index);
+}
+
+void LoongArch64CodeBlock::PoisonMemory(int offset) {
+	u32 *ptr = (u32 *)(region + offset);
+	u32 *maxptr = (u32 *)(region + region_size - offset);
+	// If our memory isn't a multiple of u32 then this won't write the last remaining bytes with anything
+	// Less than optimal, but there would be nothing we could do but throw a runtime warning anyway.
+	// LoongArch64: 0x002a0000 = break 0
+	while (ptr < maxptr)
+		*ptr++ = 0x002A0000;
+}
+
+}
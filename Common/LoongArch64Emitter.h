@@ -0,0 +1,550 @@
+// Copyright (c) 2022- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "Common/CodeBlock.h"
+#include "Common/Common.h"
+
+namespace LoongArch64Gen {
+
+enum LoongArch64Reg {
+	R_ZERO = 0,
+	R_RA = 1,
+	R_TP = 2,
+	R_SP = 3,
+
+	A0 = 4, A1, A2, A3, A4, A5, A6, A7,
+	T0 = 12, T1, T2, T3, T4, T5, T6, T7, T8,
+	// Reserved by the ABI (sometimes called u0.)  Don't touch.
+	R_X = 21,
+	R_FP = 22,
+	S0 = 23, S1, S2, S3, S4, S5, S6, S7, S8,
+
+	// The FPU registers.  These are also the low 64 bits of the LSX registers.
+	F_BASE = 32,
+	F0 = 32, F1, F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12, F13, F14, F15,
+	F16, F17, F18, F19, F20, F21, F22, F23, F24, F25, F26, F27, F28, F29, F30, F31,
+
+	// LSX 128-bit vector registers.
+	V_BASE = 64,
+	V0 = 64, V1, V2, V3, V4, V5, V6, V7, V8, V9, V10, V11, V12, V13, V14, V15,
+	V16, V17, V18, V19, V20, V21, V22, V23, V24, V25, V26, V27, V28, V29, V30, V31,
+
+	INVALID_REG = 0xFFFFFFFF
+};
+
+// Floating point condition flag registers, written by FCMP/VFCMP-style ops and read by BCEQZ/BCNEZ/FSEL.
+enum LoongArch64CFReg {
+	FCC0 = 0, FCC1, FCC2, FCC3, FCC4, FCC5, FCC6, FCC7,
+};
+
+// Floating point control and status registers (only FCSR0 is a full register, the rest are views.)
+enum LoongArch64FCSR {
+	FCSR0 = 0, FCSR1, FCSR2, FCSR3,
+};
+
+// Condition codes for FCMP.cond.S/D and VFCMP.cond.S/D.
+// The C variants are quiet, the S variants signal on any NaN.
+enum LoongArch64FCond {
+	FCOND_CAF = 0x00,
+	FCOND_SAF = 0x01,
+	FCOND_CLT = 0x02,
+	FCOND_SLT = 0x03,
+	FCOND_CEQ = 0x04,
+	FCOND_SEQ = 0x05,
+	FCOND_CLE = 0x06,
+	FCOND_SLE = 0x07,
+	FCOND_CUN = 0x08,
+	FCOND_SUN = 0x09,
+	FCOND_CULT = 0x0A,
+	FCOND_SULT = 0x0B,
+	FCOND_CUEQ = 0x0C,
+	FCOND_SUEQ = 0x0D,
+	FCOND_CULE = 0x0E,
+	FCOND_SULE = 0x0F,
+	FCOND_CNE = 0x10,
+	FCOND_SNE = 0x11,
+	FCOND_COR = 0x14,
+	FCOND_SOR = 0x15,
+	FCOND_CUNE = 0x18,
+	FCOND_SUNE = 0x19,
+};
+
+enum {
+	// All 32 except: ZERO, RA, TP, SP, and the reserved R21.  The rest are only convention.
+	NUMGPRs = 32 - 5,
+	NUMFPRs = 32,
+};
+
+enum FixupBranchType {
+	// 16-bit signed word offset from the branch (BEQ, BNE, BLT, BGE, BLTU, BGEU.)  +/- 128 KB.
+	BRANCH_16,
+	// 21-bit signed word offset from the branch (BEQZ, BNEZ, BCEQZ, BCNEZ.)  +/- 4 MB.
+	BRANCH_21,
+	// 26-bit signed word offset from the branch (B, BL.)  +/- 128 MB.
+	BRANCH_26,
+};
+
+// Unlike MIPS, there are no delay slots to worry about.
+struct FixupBranch {
+	u8 *ptr;
+	FixupBranchType type;
+};
+
+class LoongArch64Emitter {
+public:
+	LoongArch64Emitter() : code_(0), lastCacheFlushEnd_(0) {
+	}
+	LoongArch64Emitter(u8 *code_ptr) : code_(code_ptr), lastCacheFlushEnd_(code_ptr) {
+		SetCodePointer(code_ptr, code_ptr);
+	}
+	virtual ~LoongArch64Emitter() {
+	}
+
+	void SetCodePointer(const u8 *ptr, u8 *writePtr);
+	const u8 *GetCodePointer() const;
+
+	void ReserveCodeSpace(u32 bytes);
+	const u8 *AlignCode16();
+	const u8 *AlignCodePage();
+	const u8 *GetCodePtr() const;
+	u8 *GetWritableCodePtr();
+	void FlushIcache();
+	void FlushIcacheSection(u8 *start, u8 *end);
+
+	// 15 bits valid in code.
+	void BREAK(u32 code);
+	void SYSCALL(u32 code);
+	void DBAR(u32 hint);
+	void IBAR(u32 hint);
+
+	void NOP() {
+		ANDI(R_ZERO, R_ZERO, 0);
+	}
+	void MOVE(LoongArch64Reg rd, LoongArch64Reg rj) {
+		OR(rd, rj, R_ZERO);
+	}
+
+	// Branches.  Note that the operand order follows the assembler: BEQ(rj, rd) branches if rj == rd.
+	FixupBranch B();
+	void B(const void *func);
+	FixupBranch BL();
+	void BL(const void *func);
+	FixupBranch BEQ(LoongArch64Reg rj, LoongArch64Reg rd);
+	void BEQ(LoongArch64Reg rj, LoongArch64Reg rd, const void *func);
+	FixupBranch BNE(LoongArch64Reg rj, LoongArch64Reg rd);
+	void BNE(LoongArch64Reg rj, LoongArch64Reg rd, const void *func);
+	FixupBranch BLT(LoongArch64Reg rj, LoongArch64Reg rd);
+	void BLT(LoongArch64Reg rj, LoongArch64Reg rd, const void *func);
+	FixupBranch BGE(LoongArch64Reg rj, LoongArch64Reg rd);
+	void BGE(LoongArch64Reg rj, LoongArch64Reg rd, const void *func);
+	FixupBranch BLTU(LoongArch64Reg rj, LoongArch64Reg rd);
+	void BLTU(LoongArch64Reg rj, LoongArch64Reg rd, const void *func);
+	FixupBranch BGEU(LoongArch64Reg rj, LoongArch64Reg rd);
+	void BGEU(LoongArch64Reg rj, LoongArch64Reg rd, const void *func);
+	FixupBranch BEQZ(LoongArch64Reg rj);
+	void BEQZ(LoongArch64Reg rj, const void *func);
+	FixupBranch BNEZ(LoongArch64Reg rj);
+	void BNEZ(LoongArch64Reg rj, const void *func);
+	FixupBranch BCEQZ(LoongArch64CFReg cj);
+	void BCEQZ(LoongArch64CFReg cj, const void *func);
+	FixupBranch BCNEZ(LoongArch64CFReg cj);
+	void BCNEZ(LoongArch64CFReg cj, const void *func);
+
+	// Offset is in bytes, and must be a multiple of 4.
+	void JIRL(LoongArch64Reg rd, LoongArch64Reg rj, s32 offset);
+	void JR(LoongArch64Reg rj) {
+		JIRL(R_ZERO, rj, 0);
+	}
+	void JALR(LoongArch64Reg rj) {
+		JIRL(R_RA, rj, 0);
+	}
+	void RET() {
+		JR(R_RA);
+	}
+
+	void SetJumpTarget(const FixupBranch &branch);
+	// Also used to patch already emitted branches, i.e. when linking blocks.
+	static void SetJumpTarget(const FixupBranch &branch, const void *dst);
+	static bool BInRange(const void *src, const void *dst, FixupBranchType type);
+	bool BInRange(const void *func);
+	bool JInRange(const void *func);
+
+	// Uses BL when in range, otherwise builds the address in scratchreg.
+	void QuickCallFunction(LoongArch64Reg scratchreg, const void *func);
+	template <typename T> void QuickCallFunction(LoongArch64Reg scratchreg, T func) {
+		QuickCallFunction(scratchreg, (const void *)func);
+	}
+
+	// Integer arithmetic.  All .W ops sign extend their 32-bit result to 64 bits.
+	void ADD_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void ADD_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void SUB_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void SUB_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	// Immediates are 12-bit signed.
+	void ADDI_W(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm);
+	void ADDI_D(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm);
+	// 16-bit signed, shifted left by 16.
+	void ADDU16I_D(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm);
+	// rd = (rj << sa) + rk, sa is 1-4.
+	void ALSL_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk, u8 sa);
+	void ALSL_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk, u8 sa);
+	void ALSL_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk, u8 sa);
+
+	// 20-bit signed immediates, placed at bits 12-31 (sign extended), 32-51, and 12-31 of PC.
+	void LU12I_W(LoongArch64Reg rd, s32 imm);
+	void LU32I_D(LoongArch64Reg rd, s32 imm);
+	// 12-bit immediate, placed at bits 52-63 of rj.
+	void LU52I_D(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm);
+	void PCADDI(LoongArch64Reg rd, s32 imm);
+	void PCALAU12I(LoongArch64Reg rd, s32 imm);
+	void PCADDU12I(LoongArch64Reg rd, s32 imm);
+	void PCADDU18I(LoongArch64Reg rd, s32 imm);
+
+	void SLT(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void SLTU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void SLTI(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm);
+	// Note: very importantly, *sign* extends imm before an unsigned compare.
+	void SLTUI(LoongArch64Reg rd, LoongArch64Reg rj, s16 imm);
+
+	// rd = rk == 0 ? 0 : rj, and the inverse.
+	void MASKEQZ(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void MASKNEZ(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+
+	void AND(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void OR(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void XOR(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void NOR(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void ANDN(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void ORN(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	// Immediates are 12-bit unsigned (zero extended.)
+	void ANDI(LoongArch64Reg rd, LoongArch64Reg rj, u16 imm);
+	void ORI(LoongArch64Reg rd, LoongArch64Reg rj, u16 imm);
+	void XORI(LoongArch64Reg rd, LoongArch64Reg rj, u16 imm);
+
+	void SLL_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void SRL_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void SRA_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void ROTR_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void SLL_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void SRL_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void SRA_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void ROTR_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void SLLI_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa);
+	void SRLI_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa);
+	void SRAI_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa);
+	void ROTRI_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa);
+	void SLLI_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa);
+	void SRLI_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa);
+	void SRAI_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa);
+	void ROTRI_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 sa);
+
+	void EXT_W_B(LoongArch64Reg rd, LoongArch64Reg rj);
+	void EXT_W_H(LoongArch64Reg rd, LoongArch64Reg rj);
+	void CLO_W(LoongArch64Reg rd, LoongArch64Reg rj);
+	void CLZ_W(LoongArch64Reg rd, LoongArch64Reg rj);
+	void CTO_W(LoongArch64Reg rd, LoongArch64Reg rj);
+	void CTZ_W(LoongArch64Reg rd, LoongArch64Reg rj);
+	void CLO_D(LoongArch64Reg rd, LoongArch64Reg rj);
+	void CLZ_D(LoongArch64Reg rd, LoongArch64Reg rj);
+	void CTO_D(LoongArch64Reg rd, LoongArch64Reg rj);
+	void CTZ_D(LoongArch64Reg rd, LoongArch64Reg rj);
+	void REVB_2H(LoongArch64Reg rd, LoongArch64Reg rj);
+	void REVB_4H(LoongArch64Reg rd, LoongArch64Reg rj);
+	void REVB_2W(LoongArch64Reg rd, LoongArch64Reg rj);
+	void REVB_D(LoongArch64Reg rd, LoongArch64Reg rj);
+	void REVH_2W(LoongArch64Reg rd, LoongArch64Reg rj);
+	void REVH_D(LoongArch64Reg rd, LoongArch64Reg rj);
+	void BITREV_4B(LoongArch64Reg rd, LoongArch64Reg rj);
+	void BITREV_8B(LoongArch64Reg rd, LoongArch64Reg rj);
+	void BITREV_W(LoongArch64Reg rd, LoongArch64Reg rj);
+	void BITREV_D(LoongArch64Reg rd, LoongArch64Reg rj);
+
+	// Bit field insert (rd[msb:lsb] = rj[msb-lsb:0]) and extract (rd = zext(rj[msb:lsb])).
+	void BSTRINS_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 msb, u8 lsb);
+	void BSTRPICK_W(LoongArch64Reg rd, LoongArch64Reg rj, u8 msb, u8 lsb);
+	void BSTRINS_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 msb, u8 lsb);
+	void BSTRPICK_D(LoongArch64Reg rd, LoongArch64Reg rj, u8 msb, u8 lsb);
+
+	void MUL_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void MULH_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void MULH_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void MUL_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void MULH_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void MULH_DU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	// 32x32 -> 64 bit multiplies.
+	void MULW_D_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void MULW_D_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	// Note: division by zero does not trap, but the result is undefined.
+	void DIV_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void MOD_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void DIV_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void MOD_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void DIV_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void MOD_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void DIV_DU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void MOD_DU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+
+	// Loads and stores, with a 12-bit signed offset.
+	void LD_B(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset);
+	void LD_H(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset);
+	void LD_W(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset);
+	void LD_D(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset);
+	void LD_BU(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset);
+	void LD_HU(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset);
+	void LD_WU(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset);
+	void ST_B(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset);
+	void ST_H(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset);
+	void ST_W(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset);
+	void ST_D(LoongArch64Reg rd, LoongArch64Reg rj, s16 offset);
+	// Offset is in bytes, must be a multiple of 4, and fits 16 bits signed after the shift.
+	void LDPTR_W(LoongArch64Reg rd, LoongArch64Reg rj, s32 offset);
+	void LDPTR_D(LoongArch64Reg rd, LoongArch64Reg rj, s32 offset);
+	void STPTR_W(LoongArch64Reg rd, LoongArch64Reg rj, s32 offset);
+	void STPTR_D(LoongArch64Reg rd, LoongArch64Reg rj, s32 offset);
+	// Register + register addressing.
+	void LDX_B(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void LDX_H(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void LDX_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void LDX_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void LDX_BU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void LDX_HU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void LDX_WU(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void STX_B(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void STX_H(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void STX_W(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void STX_D(LoongArch64Reg rd, LoongArch64Reg rj, LoongArch64Reg rk);
+
+	void MOVI2R(LoongArch64Reg reg, u64 val);
+	void MOVI2R(LoongArch64Reg reg, s64 val) {
+		MOVI2R(reg, (u64)val);
+	}
+	// Sign extends to 64 bits, as the .W ops do.
+	void MOVI2R(LoongArch64Reg reg, u32 val);
+	void MOVI2R(LoongArch64Reg reg, s32 val) {
+		MOVI2R(reg, (u32)val);
+	}
+	template <class T> void MOVP2R(LoongArch64Reg reg, T *val) {
+		MOVI2R(reg, (u64)(intptr_t)(const void *)val);
+	}
+
+	// FPU.  Registers are F0-F31.
+	void FADD_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FADD_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FSUB_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FSUB_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FMUL_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FMUL_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FDIV_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FDIV_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FMAX_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FMAX_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FMIN_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FMIN_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+	void FCOPYSIGN_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk);
+
+	void FABS_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FABS_D(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FNEG_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FNEG_D(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FSQRT_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FSQRT_D(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FRECIP_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FRSQRT_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FMOV_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FMOV_D(LoongArch64Reg fd, LoongArch64Reg fj);
+
+	// fd = fj * fk + fa, and friends.
+	void FMADD_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa);
+	void FMADD_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa);
+	void FMSUB_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa);
+	void FMSUB_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa);
+	void FNMADD_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa);
+	void FNMADD_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa);
+	void FNMSUB_S(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa);
+	void FNMSUB_D(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64Reg fa);
+
+	void FCMP_COND_S(LoongArch64CFReg cd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64FCond cond);
+	void FCMP_COND_D(LoongArch64CFReg cd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64FCond cond);
+	// fd = ca ? fk : fj
+	void FSEL(LoongArch64Reg fd, LoongArch64Reg fj, LoongArch64Reg fk, LoongArch64CFReg ca);
+
+	void FCVT_S_D(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FCVT_D_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FTINTRM_W_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FTINTRP_W_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FTINTRZ_W_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FTINTRNE_W_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	// Uses the rounding mode in FCSR.
+	void FTINT_W_S(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FFINT_S_W(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FFINT_D_W(LoongArch64Reg fd, LoongArch64Reg fj);
+	void FRINT_S(LoongArch64Reg fd, LoongArch64Reg fj);
+
+	void MOVGR2FR_W(LoongArch64Reg fd, LoongArch64Reg rj);
+	void MOVGR2FR_D(LoongArch64Reg fd, LoongArch64Reg rj);
+	void MOVFR2GR_S(LoongArch64Reg rd, LoongArch64Reg fj);
+	void MOVFR2GR_D(LoongArch64Reg rd, LoongArch64Reg fj);
+	void MOVGR2FCSR(LoongArch64FCSR fcsr, LoongArch64Reg rj);
+	void MOVFCSR2GR(LoongArch64Reg rd, LoongArch64FCSR fcsr);
+	void MOVFR2CF(LoongArch64CFReg cd, LoongArch64Reg fj);
+	void MOVCF2FR(LoongArch64Reg fd, LoongArch64CFReg cj);
+	void MOVGR2CF(LoongArch64CFReg cd, LoongArch64Reg rj);
+	void MOVCF2GR(LoongArch64Reg rd, LoongArch64CFReg cj);
+
+	void FLD_S(LoongArch64Reg fd, LoongArch64Reg rj, s16 offset);
+	void FLD_D(LoongArch64Reg fd, LoongArch64Reg rj, s16 offset);
+	void FST_S(LoongArch64Reg fd, LoongArch64Reg rj, s16 offset);
+	void FST_D(LoongArch64Reg fd, LoongArch64Reg rj, s16 offset);
+	void FLDX_S(LoongArch64Reg fd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void FLDX_D(LoongArch64Reg fd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void FSTX_S(LoongArch64Reg fd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void FSTX_D(LoongArch64Reg fd, LoongArch64Reg rj, LoongArch64Reg rk);
+
+	// LSX.  Registers are V0-V31.  Where an op has a lane size, it's given in bits (8, 16, 32, or 64.)
+	void VLD(LoongArch64Reg vd, LoongArch64Reg rj, s16 offset);
+	void VST(LoongArch64Reg vd, LoongArch64Reg rj, s16 offset);
+	void VLDX(LoongArch64Reg vd, LoongArch64Reg rj, LoongArch64Reg rk);
+	void VSTX(LoongArch64Reg vd, LoongArch64Reg rj, LoongArch64Reg rk);
+	// Offset is in bytes and must be aligned to the lane size.
+	void VLDREPL(int size, LoongArch64Reg vd, LoongArch64Reg rj, s16 offset);
+
+	void VADD(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSUB(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSADD(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSSUB(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSADD_U(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSSUB_U(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VMUL(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VMAX(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VMIN(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VMAX_U(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VMIN_U(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSEQ(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSLT(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSLE(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSLL(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSRL(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSRA(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSLLI(int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 shift);
+	void VSRLI(int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 shift);
+	void VSRAI(int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 shift);
+	void VILVL(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VILVH(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VPICKEV(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VPICKOD(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VPACKEV(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VPACKOD(int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VSHUF4I(int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 imm);
+
+	void VAND_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VOR_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VXOR_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VNOR_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VANDN_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VORN_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VANDI_B(LoongArch64Reg vd, LoongArch64Reg vj, u8 imm);
+	void VORI_B(LoongArch64Reg vd, LoongArch64Reg vj, u8 imm);
+	void VXORI_B(LoongArch64Reg vd, LoongArch64Reg vj, u8 imm);
+	void VNORI_B(LoongArch64Reg vd, LoongArch64Reg vj, u8 imm);
+	// vd = (va & vk) | (~va & vj), bitwise.
+	void VBITSEL_V(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va);
+	void VSHUF_B(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va);
+	void VMOV(LoongArch64Reg vd, LoongArch64Reg vj) {
+		VOR_V(vd, vj, vj);
+	}
+
+	void VFADD_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VFSUB_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VFMUL_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VFDIV_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VFMAX_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VFMIN_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VFMADD_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va);
+	void VFMSUB_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va);
+	void VFNMADD_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va);
+	void VFNMSUB_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64Reg va);
+	void VFSQRT_S(LoongArch64Reg vd, LoongArch64Reg vj);
+	void VFRECIP_S(LoongArch64Reg vd, LoongArch64Reg vj);
+	void VFRSQRT_S(LoongArch64Reg vd, LoongArch64Reg vj);
+	void VFFINT_S_W(LoongArch64Reg vd, LoongArch64Reg vj);
+	void VFTINT_W_S(LoongArch64Reg vd, LoongArch64Reg vj);
+	void VFTINTRZ_W_S(LoongArch64Reg vd, LoongArch64Reg vj);
+	// Each lane is set to all ones or all zeros.
+	void VFCMP_COND_S(LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk, LoongArch64FCond cond);
+
+	// Lane moves between GPRs and vectors.
+	void VREPLGR2VR(int size, LoongArch64Reg vd, LoongArch64Reg rj);
+	void VINSGR2VR(int size, LoongArch64Reg vd, LoongArch64Reg rj, u8 index);
+	void VPICKVE2GR(int size, LoongArch64Reg rd, LoongArch64Reg vj, u8 index);
+	void VPICKVE2GR_U(int size, LoongArch64Reg rd, LoongArch64Reg vj, u8 index);
+	void VREPLVEI(int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 index);
+
+protected:
+	inline void Write32(u32 value) {
+		*code32_++ = value;
+	}
+
+	// Common instruction formats.  Register numbers are masked, so F/V regs may be passed directly.
+	void EncodeR2(u32 opcode, u32 rd, u32 rj) {
+		Write32(opcode | ((rj & 0x1F) << 5) | (rd & 0x1F));
+	}
+	void EncodeR3(u32 opcode, u32 rd, u32 rj, u32 rk) {
+		Write32(opcode | ((rk & 0x1F) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+	}
+	void EncodeR4(u32 opcode, u32 rd, u32 rj, u32 rk, u32 ra) {
+		Write32(opcode | ((ra & 0x1F) << 15) | ((rk & 0x1F) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+	}
+	void EncodeRI12(u32 opcode, u32 rd, u32 rj, u32 imm) {
+		Write32(opcode | ((imm & 0xFFF) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+	}
+	void EncodeRI14(u32 opcode, u32 rd, u32 rj, u32 imm) {
+		Write32(opcode | ((imm & 0x3FFF) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+	}
+	void EncodeRI16(u32 opcode, u32 rd, u32 rj, u32 imm) {
+		Write32(opcode | ((imm & 0xFFFF) << 10) | ((rj & 0x1F) << 5) | (rd & 0x1F));
+	}
+	void EncodeRI20(u32 opcode, u32 rd, u32 imm) {
+		Write32(opcode | ((imm & 0xFFFFF) << 5) | (rd & 0x1F));
+	}
+
+	void VEncodeSized3(u32 opcode, int size, LoongArch64Reg vd, LoongArch64Reg vj, LoongArch64Reg vk);
+	void VEncodeSizedShift(u32 opcode, int size, LoongArch64Reg vd, LoongArch64Reg vj, u8 shift);
+	void VEncodeLaneIndex(u32 opcode, int size, u32 rd, u32 rj, u8 index);
+
+	FixupBranch MakeFixupBranch(FixupBranchType type);
+
+private:
+	union {
+		u8 *code_;
+		u32 *code32_;
+	};
+	u8 *lastCacheFlushEnd_;
+};
+
+// Everything that needs to generate machine code should inherit from this.
+// You get memory management for free, plus, you can use all the ADDI_D etc functions without
+// having to prefix them with gen-> or something similar.
+class LoongArch64CodeBlock : public CodeBlock<LoongArch64Emitter> {
+public:
+	void PoisonMemory(int offset) override;
+};
+
+};
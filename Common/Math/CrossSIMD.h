@@ -0,0 +1,240 @@
+#pragma once
+
+// Minimal 4 x 32-bit integer and float vectors, for code that should be vectorized on any host.
+// SSE2 and NEON are used directly, anything else (LoongArch, MIPS, ...) gets plain loops
+// that the compiler can vectorize by itself.
+//
+// The operators are picked so generic code can be written once as a template, and
+// instantiated with both u32 (one lane) and Vec4U32 (four lanes.)  Shifts are logical.
+// Float comparisons give a Vec4U32 mask, all ones where true, for Select().
+
+#include <cmath>
+
+#include "ppsspp_config.h"
+#include "Common/Common.h"
+
+#if defined(_M_SSE)
+#include <emmintrin.h>
+#elif PPSSPP_ARCH(ARM_NEON)
+#if defined(_MSC_VER) && PPSSPP_ARCH(ARM64)
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
+#if defined(_M_SSE)
+
+struct Vec4U32 {
+	__m128i v;
+
+	Vec4U32() {}
+	explicit Vec4U32(u32 splat) : v(_mm_set1_epi32((int)splat)) {}
+	explicit Vec4U32(__m128i vec) : v(vec) {}
+
+	static Vec4U32 Zero() { return Vec4U32(_mm_setzero_si128()); }
+	static Vec4U32 Load(const u32 *src) { return Vec4U32(_mm_loadu_si128((const __m128i *)src)); }
+	static Vec4U32 Load(const int *src) { return Vec4U32(_mm_loadu_si128((const __m128i *)src)); }
+	// Zero extends four u16s.
+	static Vec4U32 LoadU16(const u16 *src) { return Vec4U32(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128())); }
+	void Store(u32 *dst) const { _mm_storeu_si128((__m128i *)dst, v); }
+
+	Vec4U32 operator +(const Vec4U32 &other) const { return Vec4U32(_mm_add_epi32(v, other.v)); }
+	Vec4U32 operator -(const Vec4U32 &other) const { return Vec4U32(_mm_sub_epi32(v, other.v)); }
+	Vec4U32 operator &(const Vec4U32 &other) const { return Vec4U32(_mm_and_si128(v, other.v)); }
+	Vec4U32 operator |(const Vec4U32 &other) const { return Vec4U32(_mm_or_si128(v, other.v)); }
+	Vec4U32 operator <<(int shift) const { return Vec4U32(_mm_sll_epi32(v, _mm_cvtsi32_si128(shift))); }
+	Vec4U32 operator >>(int shift) const { return Vec4U32(_mm_srl_epi32(v, _mm_cvtsi32_si128(shift))); }
+	Vec4U32 operator *(const Vec4U32 &other) const {
+		// No pmulld before SSE4.1, so multiply the even and odd lanes separately.
+		__m128i even = _mm_mul_epu32(v, other.v);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(v, 32), _mm_srli_epi64(other.v, 32));
+		return Vec4U32(_mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0))));
+	}
+
+	// Sums of each of the four vectors' lanes, one per lane of the result.
+	static Vec4U32 HorizontalSums(const Vec4U32 &a, const Vec4U32 &b, const Vec4U32 &c, const Vec4U32 &d) {
+		__m128i ab0 = _mm_unpacklo_epi32(a.v, b.v);
+		__m128i ab1 = _mm_unpackhi_epi32(a.v, b.v);
+		__m128i cd0 = _mm_unpacklo_epi32(c.v, d.v);
+		__m128i cd1 = _mm_unpackhi_epi32(c.v, d.v);
+		__m128i sum01 = _mm_add_epi32(_mm_unpacklo_epi64(ab0, cd0), _mm_unpackhi_epi64(ab0, cd0));
+		__m128i sum23 = _mm_add_epi32(_mm_unpacklo_epi64(ab1, cd1), _mm_unpackhi_epi64(ab1, cd1));
+		return Vec4U32(_mm_add_epi32(sum01, sum23));
+	}
+};
+
+struct Vec4F32 {
+	__m128 v;
+
+	Vec4F32() {}
+	explicit Vec4F32(float splat) : v(_mm_set1_ps(splat)) {}
+	explicit Vec4F32(__m128 vec) : v(vec) {}
+
+	static Vec4F32 Zero() { return Vec4F32(_mm_setzero_ps()); }
+	static Vec4F32 Load(const float *src) { return Vec4F32(_mm_loadu_ps(src)); }
+	void Store(float *dst) const { _mm_storeu_ps(dst, v); }
+
+	Vec4F32 operator +(const Vec4F32 &other) const { return Vec4F32(_mm_add_ps(v, other.v)); }
+	Vec4F32 operator -(const Vec4F32 &other) const { return Vec4F32(_mm_sub_ps(v, other.v)); }
+	Vec4F32 operator *(const Vec4F32 &other) const { return Vec4F32(_mm_mul_ps(v, other.v)); }
+	Vec4F32 operator /(const Vec4F32 &other) const { return Vec4F32(_mm_div_ps(v, other.v)); }
+
+	Vec4U32 CompareEq(const Vec4F32 &other) const { return Vec4U32(_mm_castps_si128(_mm_cmpeq_ps(v, other.v))); }
+	Vec4U32 CompareLt(const Vec4F32 &other) const { return Vec4U32(_mm_castps_si128(_mm_cmplt_ps(v, other.v))); }
+	Vec4U32 CompareGt(const Vec4F32 &other) const { return Vec4U32(_mm_castps_si128(_mm_cmpgt_ps(v, other.v))); }
+	Vec4U32 CompareGe(const Vec4F32 &other) const { return Vec4U32(_mm_castps_si128(_mm_cmpge_ps(v, other.v))); }
+
+	static Vec4F32 Sqrt(const Vec4F32 &a) { return Vec4F32(_mm_sqrt_ps(a.v)); }
+	static Vec4F32 Select(const Vec4U32 &mask, const Vec4F32 &ifTrue, const Vec4F32 &ifFalse) {
+		const __m128 m = _mm_castsi128_ps(mask.v);
+		return Vec4F32(_mm_or_ps(_mm_and_ps(m, ifTrue.v), _mm_andnot_ps(m, ifFalse.v)));
+	}
+};
+
+#elif PPSSPP_ARCH(ARM_NEON)
+
+struct Vec4U32 {
+	uint32x4_t v;
+
+	Vec4U32() {}
+	explicit Vec4U32(u32 splat) : v(vdupq_n_u32(splat)) {}
+	explicit Vec4U32(uint32x4_t vec) : v(vec) {}
+
+	static Vec4U32 Zero() { return Vec4U32(vdupq_n_u32(0)); }
+	static Vec4U32 Load(const u32 *src) { return Vec4U32(vld1q_u32(src)); }
+	static Vec4U32 Load(const int *src) { return Vec4U32(vreinterpretq_u32_s32(vld1q_s32(src))); }
+	static Vec4U32 LoadU16(const u16 *src) { return Vec4U32(vmovl_u16(vld1_u16(src))); }
+	void Store(u32 *dst) const { vst1q_u32(dst, v); }
+
+	Vec4U32 operator +(const Vec4U32 &other) const { return Vec4U32(vaddq_u32(v, other.v)); }
+	Vec4U32 operator -(const Vec4U32 &other) const { return Vec4U32(vsubq_u32(v, other.v)); }
+	Vec4U32 operator &(const Vec4U32 &other) const { return Vec4U32(vandq_u32(v, other.v)); }
+	Vec4U32 operator |(const Vec4U32 &other) const { return Vec4U32(vorrq_u32(v, other.v)); }
+	Vec4U32 operator <<(int shift) const { return Vec4U32(vshlq_u32(v, vdupq_n_s32(shift))); }
+	Vec4U32 operator >>(int shift) const { return Vec4U32(vshlq_u32(v, vdupq_n_s32(-shift))); }
+	Vec4U32 operator *(const Vec4U32 &other) const { return Vec4U32(vmulq_u32(v, other.v)); }
+
+	static Vec4U32 HorizontalSums(const Vec4U32 &a, const Vec4U32 &b, const Vec4U32 &c, const Vec4U32 &d) {
+		uint32x4x2_t ab = vtrnq_u32(a.v, b.v);
+		uint32x4x2_t cd = vtrnq_u32(c.v, d.v);
+		uint32x4_t s0 = vaddq_u32(ab.val[0], ab.val[1]);
+		uint32x4_t s1 = vaddq_u32(cd.val[0], cd.val[1]);
+		// s0 = a01 b01 a23 b23, s1 = c01 d01 c23 d23.
+		uint32x4_t lo = vcombine_u32(vget_low_u32(s0), vget_low_u32(s1));
+		uint32x4_t hi = vcombine_u32(vget_high_u32(s0), vget_high_u32(s1));
+		return Vec4U32(vaddq_u32(lo, hi));
+	}
+};
+
+struct Vec4F32 {
+	float32x4_t v;
+
+	Vec4F32() {}
+	explicit Vec4F32(float splat) : v(vdupq_n_f32(splat)) {}
+	explicit Vec4F32(float32x4_t vec) : v(vec) {}
+
+	static Vec4F32 Zero() { return Vec4F32(vdupq_n_f32(0.0f)); }
+	static Vec4F32 Load(const float *src) { return Vec4F32(vld1q_f32(src)); }
+	void Store(float *dst) const { vst1q_f32(dst, v); }
+
+	Vec4F32 operator +(const Vec4F32 &other) const { return Vec4F32(vaddq_f32(v, other.v)); }
+	Vec4F32 operator -(const Vec4F32 &other) const { return Vec4F32(vsubq_f32(v, other.v)); }
+	Vec4F32 operator *(const Vec4F32 &other) const { return Vec4F32(vmulq_f32(v, other.v)); }
+#if PPSSPP_ARCH(ARM64)
+	Vec4F32 operator /(const Vec4F32 &other) const { return Vec4F32(vdivq_f32(v, other.v)); }
+#else
+	// ARMv7 NEON only has estimates, which wouldn't match scalar code.
+	Vec4F32 operator /(const Vec4F32 &other) const {
+		float a[4], b[4];
+		Store(a);
+		other.Store(b);
+		for (int i = 0; i < 4; ++i)
+			a[i] /= b[i];
+		return Load(a);
+	}
+#endif
+
+	Vec4U32 CompareEq(const Vec4F32 &other) const { return Vec4U32(vceqq_f32(v, other.v)); }
+	Vec4U32 CompareLt(const Vec4F32 &other) const { return Vec4U32(vcltq_f32(v, other.v)); }
+	Vec4U32 CompareGt(const Vec4F32 &other) const { return Vec4U32(vcgtq_f32(v, other.v)); }
+	Vec4U32 CompareGe(const Vec4F32 &other) const { return Vec4U32(vcgeq_f32(v, other.v)); }
+
+#if PPSSPP_ARCH(ARM64)
+	static Vec4F32 Sqrt(const Vec4F32 &a) { return Vec4F32(vsqrtq_f32(a.v)); }
+#else
+	static Vec4F32 Sqrt(const Vec4F32 &a) {
+		float r[4];
+		a.Store(r);
+		for (int i = 0; i < 4; ++i)
+			r[i] = sqrtf(r[i]);
+		return Load(r);
+	}
+#endif
+	static Vec4F32 Select(const Vec4U32 &mask, const Vec4F32 &ifTrue, const Vec4F32 &ifFalse) {
+		return Vec4F32(vbslq_f32(mask.v, ifTrue.v, ifFalse.v));
+	}
+};
+
+#else
+
+struct Vec4U32 {
+	u32 v[4];
+
+	Vec4U32() {}
+	explicit Vec4U32(u32 splat) { for (int i = 0; i < 4; ++i) v[i] = splat; }
+
+	static Vec4U32 Zero() { return Vec4U32(0U); }
+	static Vec4U32 Load(const u32 *src) { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = src[i]; return r; }
+	static Vec4U32 Load(const int *src) { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = (u32)src[i]; return r; }
+	static Vec4U32 LoadU16(const u16 *src) { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = src[i]; return r; }
+	void Store(u32 *dst) const { for (int i = 0; i < 4; ++i) dst[i] = v[i]; }
+
+	Vec4U32 operator +(const Vec4U32 &other) const { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] + other.v[i]; return r; }
+	Vec4U32 operator -(const Vec4U32 &other) const { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] - other.v[i]; return r; }
+	Vec4U32 operator &(const Vec4U32 &other) const { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] & other.v[i]; return r; }
+	Vec4U32 operator |(const Vec4U32 &other) const { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] | other.v[i]; return r; }
+	Vec4U32 operator <<(int shift) const { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] << shift; return r; }
+	Vec4U32 operator >>(int shift) const { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] >> shift; return r; }
+	Vec4U32 operator *(const Vec4U32 &other) const { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] * other.v[i]; return r; }
+
+	static Vec4U32 HorizontalSums(const Vec4U32 &a, const Vec4U32 &b, const Vec4U32 &c, const Vec4U32 &d) {
+		Vec4U32 r;
+		r.v[0] = a.v[0] + a.v[1] + a.v[2] + a.v[3];
+		r.v[1] = b.v[0] + b.v[1] + b.v[2] + b.v[3];
+		r.v[2] = c.v[0] + c.v[1] + c.v[2] + c.v[3];
+		r.v[3] = d.v[0] + d.v[1] + d.v[2] + d.v[3];
+		return r;
+	}
+};
+
+struct Vec4F32 {
+	float v[4];
+
+	Vec4F32() {}
+	explicit Vec4F32(float splat) { for (int i = 0; i < 4; ++i) v[i] = splat; }
+
+	static Vec4F32 Zero() { return Vec4F32(0.0f); }
+	static Vec4F32 Load(const float *src) { Vec4F32 r; for (int i = 0; i < 4; ++i) r.v[i] = src[i]; return r; }
+	void Store(float *dst) const { for (int i = 0; i < 4; ++i) dst[i] = v[i]; }
+
+	Vec4F32 operator +(const Vec4F32 &other) const { Vec4F32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] + other.v[i]; return r; }
+	Vec4F32 operator -(const Vec4F32 &other) const { Vec4F32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] - other.v[i]; return r; }
+	Vec4F32 operator *(const Vec4F32 &other) const { Vec4F32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] * other.v[i]; return r; }
+	Vec4F32 operator /(const Vec4F32 &other) const { Vec4F32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] / other.v[i]; return r; }
+
+	Vec4U32 CompareEq(const Vec4F32 &other) const { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] == other.v[i] ? 0xFFFFFFFF : 0; return r; }
+	Vec4U32 CompareLt(const Vec4F32 &other) const { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] < other.v[i] ? 0xFFFFFFFF : 0; return r; }
+	Vec4U32 CompareGt(const Vec4F32 &other) const { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] > other.v[i] ? 0xFFFFFFFF : 0; return r; }
+	Vec4U32 CompareGe(const Vec4F32 &other) const { Vec4U32 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] >= other.v[i] ? 0xFFFFFFFF : 0; return r; }
+
+	static Vec4F32 Sqrt(const Vec4F32 &a) { Vec4F32 r; for (int i = 0; i < 4; ++i) r.v[i] = sqrtf(a.v[i]); return r; }
+	static Vec4F32 Select(const Vec4U32 &mask, const Vec4F32 &ifTrue, const Vec4F32 &ifFalse) {
+		Vec4F32 r;
+		for (int i = 0; i < 4; ++i)
+			r.v[i] = mask.v[i] ? ifTrue.v[i] : ifFalse.v[i];
+		return r;
+	}
+};
+
+#endif
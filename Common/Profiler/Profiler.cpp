@@ -1,6 +1,8 @@
 // Ultra-lightweight category profiler with history.
 
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <mutex>
 #include <map>
 #include <string>
@@ -11,6 +13,9 @@
 
 #include "Common/Render/DrawBuffer.h"
 
+#include "Common/File/FileUtil.h"
+#include "Common/File/Path.h"
+#include "Common/StringUtils.h"
 #include "Common/TimeUtil.h"
 #include "Common/Profiler/Profiler.h"
 #include "Common/Log.h"
@@ -21,9 +26,10 @@
 // iOS did not support C++ thread_local before iOS 9
 #define MAX_THREADS 1     // Can be any number, represents concurrent threads calling the profiler.
 #else
-#define MAX_THREADS 4     // Can be any number, represents concurrent threads calling the profiler.
+#define MAX_THREADS 32    // Can be any number, represents concurrent threads calling the profiler.
 #endif
 #define HISTORY_SIZE 128 // Must be power of 2
+#define TRACE_SIZE 65536 // Must be power of 2, events kept per thread while tracing.
 
 #ifndef _DEBUG
 // If the compiler can collapse identical strings, we don't even need the strcmp.
@@ -59,10 +65,31 @@ static std::mutex threadsLock;
 static CategoryFrame *history;
 #if MAX_THREADS > 1
 thread_local int profilerThreadId = -1;
+thread_local char profilerThreadName[32];
 #else
 static int profilerThreadId = 0;
+static char profilerThreadName[32];
 #endif
 
+struct TraceEvent {
+	double start;
+	float duration;
+	// -1 for the end of a frame.
+	int category;
+};
+
+// Only the owning thread writes, the exporter reads up to written.
+struct TraceThread {
+	std::atomic<TraceEvent *> events;
+	std::atomic<uint32_t> written;
+	char name[32];
+};
+
+static std::atomic<bool> traceEnabled;
+static TraceThread traceThreads[MAX_THREADS];
+// Start of the open scope at each depth, 0.0 if it began before tracing did.
+static double traceScopeStart[MAX_THREADS][MAX_DEPTH];
+
 void internal_profiler_init() {
 	memset(&profiler, 0, sizeof(profiler));
 #if MAX_THREADS == 1
@@ -86,6 +113,7 @@ static int internal_profiler_find_thread() {
 	if (threadIdAfterLast < MAX_THREADS) {
 		thread_id = threadIdAfterLast++;
 		profilerThreadId = thread_id;
+		truncate_cpy(traceThreads[thread_id].name, profilerThreadName);
 		return thread_id;
 	}
 
@@ -119,6 +147,23 @@ int internal_profiler_find_cat(const char *category_name, bool create_missing) {
 	return -1;
 }
 
+static void internal_profiler_trace(int thread_id, double start, double end, int category) {
+	// Threads past MAX_THREADS share an id, and would race on the ring.
+	if (thread_id != profilerThreadId)
+		return;
+
+	TraceThread &trace = traceThreads[thread_id];
+	TraceEvent *events = trace.events.load(std::memory_order_relaxed);
+	if (!events) {
+		events = new TraceEvent[TRACE_SIZE];
+		trace.events.store(events, std::memory_order_release);
+	}
+
+	uint32_t pos = trace.written.load(std::memory_order_relaxed);
+	events[pos & (TRACE_SIZE - 1)] = TraceEvent{ start, (float)(end - start), category };
+	trace.written.store(pos + 1, std::memory_order_release);
+}
+
 // Suspend, also used to prepare for leaving.
 static void internal_profiler_suspend(int thread_id, int category, double now) {
 	double diff = now - profiler.eventStart[thread_id][category];
@@ -151,6 +196,9 @@ int internal_profiler_enter(const char *category_name, int *out_thread_id) {
 		DEBUG_LOG(SYSTEM, "profiler: recursive enter (%i - %s)", category, category_name);
 	}
 
+	if (depth < MAX_DEPTH)
+		traceScopeStart[thread_id][depth] = traceEnabled ? time_now_d() : 0.0;
+
 	depth++;
 	profiler.parentCategory[thread_id][depth] = category;
 
@@ -175,6 +223,9 @@ void internal_profiler_leave(int thread_id, int category) {
 	depth--;
 	_assert_msg_(depth >= 0, "Profiler enter/leave mismatch!");
 
+	if (traceEnabled && depth < MAX_DEPTH && traceScopeStart[thread_id][depth] != 0.0)
+		internal_profiler_trace(thread_id, traceScopeStart[thread_id][depth], now, category);
+
 	int parent = profiler.parentCategory[thread_id][depth];
 	// When there's recursion, we don't suspend or resume.
 	if (parent != category) {
@@ -192,6 +243,8 @@ void internal_profiler_end_frame() {
 	int thread_id = internal_profiler_find_thread();
 	_assert_msg_(profiler.depth[thread_id] == 0, "Can't be inside a profiler scope at end of frame!");
 	profiler.curFrameStart = time_now_d();
+	if (traceEnabled)
+		internal_profiler_trace(thread_id, profiler.curFrameStart, profiler.curFrameStart, -1);
 	profiler.historyPos++;
 	profiler.historyPos &= (HISTORY_SIZE - 1);
 	memset(&history[MAX_THREADS * profiler.historyPos], 0, sizeof(CategoryFrame) * MAX_THREADS);
@@ -264,3 +317,77 @@ void Profiler_GetHistory(int category, int thread, float *data, int count) {
 		data[i] = history[MAX_THREADS * x + thread].time_taken[category];
 	}
 }
+
+void Profiler_SetThreadName(const char *name) {
+	truncate_cpy(profilerThreadName, name);
+	if (profilerThreadId != -1)
+		truncate_cpy(traceThreads[profilerThreadId].name, name);
+}
+
+void Profiler_StartTrace() {
+	for (int i = 0; i < MAX_THREADS; i++)
+		traceThreads[i].written = 0;
+	traceEnabled = true;
+}
+
+void Profiler_StopTrace() {
+	traceEnabled = false;
+}
+
+static void WriteJSONString(FILE *f, const char *str) {
+	fputc('"', f);
+	for (const char *p = str; *p; ++p) {
+		if (*p == '"' || *p == '\\')
+			fputc('\\', f);
+		if ((unsigned char)*p >= 0x20)
+			fputc(*p, f);
+	}
+	fputc('"', f);
+}
+
+bool Profiler_ExportTrace(const Path &filename) {
+	FILE *f = File::OpenCFile(filename, "wb");
+	if (!f) {
+		ERROR_LOG(SYSTEM, "Could not open %s to write the trace", filename.c_str());
+		return false;
+	}
+
+	// Chrome trace event format, timestamps in microseconds.
+	fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"PPSSPP\"}}");
+	for (int i = 0; i < threadIdAfterLast; i++) {
+		TraceThread &trace = traceThreads[i];
+		fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", i);
+		char name[32];
+		if (trace.name[0])
+			truncate_cpy(name, trace.name);
+		else
+			snprintf(name, sizeof(name), "Thread %d", i);
+		WriteJSONString(f, name);
+		fprintf(f, "}}");
+
+		const TraceEvent *events = trace.events.load(std::memory_order_acquire);
+		uint32_t written = trace.written.load(std::memory_order_acquire);
+		if (!events || written == 0)
+			continue;
+		uint32_t first = written > TRACE_SIZE ? written - TRACE_SIZE : 0;
+		if (first != 0)
+			WARN_LOG(SYSTEM, "Trace ring for %s overflowed, keeping the last %d events", name, TRACE_SIZE);
+
+		for (uint32_t pos = first; pos != written; ++pos) {
+			const TraceEvent &ev = events[pos & (TRACE_SIZE - 1)];
+			if (ev.category == -1) {
+				fprintf(f, ",\n{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"p\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", i, ev.start * 1000000.0);
+				continue;
+			}
+			fprintf(f, ",\n{\"name\":");
+			WriteJSONString(f, Profiler_GetCategoryName(ev.category));
+			fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", i, ev.start * 1000000.0, ev.duration * 1000000.0);
+		}
+	}
+	fprintf(f, "\n]}\n");
+
+	bool success = ferror(f) == 0;
+	fclose(f);
+	return success;
+}
@@ -7,6 +7,7 @@
 #ifdef USE_PROFILER
 
 class DrawBuffer;
+class Path;
 
 void internal_profiler_init();
 void internal_profiler_end_frame();
@@ -22,6 +23,14 @@ void Profiler_GetSlowestThreads(int *data, int count);
 void Profiler_GetSlowestHistory(int category, int *slowestThreads, float *data, int count);
 void Profiler_GetHistory(int category, int thread, float *data, int count);
 
+// Tracing keeps every scope (and frame end) in a ring buffer per thread, for export as
+// Chrome trace event JSON, which chrome://tracing and ui.perfetto.dev can open.
+void Profiler_SetThreadName(const char *name);
+void Profiler_StartTrace();
+void Profiler_StopTrace();
+// Best called once the traced threads are idle, after Profiler_StopTrace().
+bool Profiler_ExportTrace(const Path &filename);
+
 class ProfileThis {
 public:
 	ProfileThis(const char *category) {
@@ -38,11 +47,13 @@ class ProfileThis {
 #define PROFILE_INIT() internal_profiler_init();
 #define PROFILE_THIS_SCOPE(cat) ProfileThis _profile_scoped(cat);
 #define PROFILE_END_FRAME() internal_profiler_end_frame();
+#define PROFILE_THREAD_NAME(name) Profiler_SetThreadName(name);
 
 #else
 
 #define PROFILE_INIT()
 #define PROFILE_THIS_SCOPE(cat)
 #define PROFILE_END_FRAME()
+#define PROFILE_THREAD_NAME(name)
 
 #endif
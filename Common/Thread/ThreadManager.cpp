@@ -8,6 +8,7 @@
 #include <atomic>
 
 #include "Common/Log.h"
+#include "Common/Profiler/Profiler.h"
 #include "Common/Thread/ThreadUtil.h"
 #include "Common/Thread/ThreadManager.h"
 
@@ -61,10 +62,13 @@ void ThreadManager::Teardown() {
 	global_->threads_.clear();
 }
 
+static thread_local bool isPoolThread = false;
+
 static void WorkerThreadFunc(GlobalThreadContext *global, ThreadContext *thread) {
 	char threadName[16];
 	snprintf(threadName, sizeof(threadName), "PoolWorker %d", thread->index);
 	SetCurrentThreadName(threadName);
+	isPoolThread = true;
 	while (!thread->cancelled) {
 		Task *task = nullptr;
 
@@ -91,6 +95,7 @@ static void WorkerThreadFunc(GlobalThreadContext *global, ThreadContext *thread)
 		// The task itself takes care of notifying anyone waiting on it. Not the
 		// responsibility of the ThreadManager (although it could be!).
 		if (task) {
+			PROFILE_THIS_SCOPE("pool_task");
 			task->Run();
 			delete task;
 		}
@@ -171,6 +176,10 @@ int ThreadManager::GetNumLooperThreads() const {
 	return numComputeThreads_;
 }
 
+bool ThreadManager::IsPoolThread() {
+	return isPoolThread;
+}
+
 void ThreadManager::TryCancelTask(uint64_t taskID) {
 	// Do nothing
 }
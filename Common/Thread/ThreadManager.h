@@ -57,6 +57,9 @@ class ThreadManager {
 	// for I/O bounds tasks, that can be run concurrently with those.
 	int GetNumLooperThreads() const;
 
+	// True on the pool's worker threads.  Tasks there shouldn't wait for other tasks, which may be queued behind them.
+	static bool IsPoolThread();
+
 private:
 	GlobalThreadContext *global_ = nullptr;
 
@@ -20,6 +20,7 @@
 #include <cstdint>
 
 #include "Common/Log.h"
+#include "Common/Profiler/Profiler.h"
 #include "Common/Thread/ThreadUtil.h"
 
 #if PPSSPP_PLATFORM(ANDROID) || PPSSPP_PLATFORM(LINUX)
@@ -137,6 +138,7 @@ void SetCurrentThreadName(const char* threadName) {
 #ifdef TLS_SUPPORTED
 	curThreadName = threadName;
 #endif
+	PROFILE_THREAD_NAME(threadName);
 }
 
 void AssertCurrentThreadName(const char *threadName) {
@@ -115,6 +115,9 @@ struct Config {
 	bool bHideSlowWarnings;
 	bool bHideStateWarnings;
 	bool bPreloadFunctions;
+	bool bIRThreadedInterpreter;
+	bool bIRDiskCache;
+	bool bIRBackgroundCompile;
 	uint32_t uJitDisableFlags;
 
 	bool bSeparateSASThread;
@@ -123,6 +126,8 @@ struct Config {
 	int iLockedCPUSpeed;
 	bool bAutoSaveSymbolMap;
 	bool bCacheFullIsoInRam;
+	bool bDiscReadAhead;
+	bool bMemoryMapFiles;
 	int iRemoteISOPort;
 	std::string sLastRemoteISOServer;
 	int iLastRemoteISOPort;
@@ -156,6 +161,7 @@ struct Config {
 	std::string sMicDevice;
 
 	bool bSoftwareRendering;
+	bool bSoftwareRendererBinning;  // tiles the software renderer's draws across threads
 	bool bHardwareTransform; // only used in the GLES backend
 	bool bSoftwareSkinning;  // may speed up some games
 	bool bVendorBugChecksEnabled;
@@ -189,6 +195,7 @@ struct Config {
 	bool bVertexCache;
 	bool bTextureBackoffCache;
 	bool bTextureSecondaryCache;
+	bool bTextureDedupCache;
 	bool bVertexDecoderJit;
 	bool bFullScreen;
 	bool bFullScreenMulti;
@@ -198,6 +205,7 @@ struct Config {
 	bool bReplaceTextures;
 	bool bSaveNewTextures;
 	bool bIgnoreTextureFilenames;
+	int iReplacementTextureRAMBudget;  // MB of decoded replacement textures kept in RAM.
 	int iTexScalingLevel; // 0 = auto, 1 = off, 2 = 2x, ..., 5 = 5x
 	int iTexScalingType; // 0 = xBRZ, 1 = Hybrid
 	bool bTexDeposterize;
@@ -207,6 +215,7 @@ struct Config {
 	int iMaxRecent;
 	int iCurrentStateSlot;
 	int iRewindFlipFrequency;
+	int iRewindMaxMemoryMB;
 	bool bUISound;
 	bool bEnableStateUndo;
 	std::string sStateLoadUndoGame;
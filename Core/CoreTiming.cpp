@@ -15,16 +15,17 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
 #include <atomic>
 #include <cstdio>
-#include <mutex>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/Profiler/Profiler.h"
 
 #include "Common/Serialize/Serializer.h"
-#include "Common/Serialize/SerializeList.h"
+#include "Common/Serialize/SerializeFuncs.h"
 #include "Core/CoreTiming.h"
 #include "Core/Core.h"
 #include "Core/Config.h"
@@ -54,24 +55,58 @@ static std::set<int> usedEventTypes;
 static std::set<int> restoredEventTypes;
 static int nextEventTypeRestoreId = -1;
 
+// This is what save states contain, in list order.
 struct BaseEvent {
 	s64 time;
 	u64 userdata;
 	int type;
 };
 
-typedef LinkedListItem<BaseEvent> Event;
+struct Event {
+	s64 time;
+	u64 userdata;
+	int type;
+	// Position in eventHeap, kept current so any event can be removed in O(log n).
+	int heapIndex;
+	// Breaks ties in time, so events run in the order they were scheduled.
+	u64 order;
+};
 
-Event *first;
-Event *tsFirst;
-Event *tsLast;
+struct EventKey {
+	int type;
+	u64 userdata;
 
-// event pools
-Event *eventPool = 0;
-Event *eventTsPool = 0;
-int allocatedTsEvents = 0;
-// Optimization to skip MoveEvents when possible.
-std::atomic<u32> hasTsEvents;
+	bool operator ==(const EventKey &other) const {
+		return type == other.type && userdata == other.userdata;
+	}
+};
+
+struct EventKeyHash {
+	size_t operator()(const EventKey &k) const {
+		return std::hash<u64>()(k.userdata * 0x9E3779B97F4A7C15ULL ^ (u64)(u32)k.type);
+	}
+};
+
+// Pending events live in slots, and the heap orders slot indices by (time, order).
+static std::vector<Event> eventSlots;
+static std::vector<int> freeEventSlots;
+static std::vector<int> eventHeap;
+static std::unordered_multimap<EventKey, int, EventKeyHash> eventsByKey;
+// Number of pending events per type, for IsScheduled() and RemoveEvent().
+static std::vector<int> eventTypeCounts;
+static u64 nextEventOrder;
+
+// Events scheduled from other threads, newest first.  Producers push with a CAS, and the
+// CPU thread takes the whole stack at once, so there's no ABA problem.
+struct ThreadsafeEvent {
+	BaseEvent event;
+	ThreadsafeEvent *next;
+};
+
+static std::atomic<ThreadsafeEvent *> tsHead;
+// Threadsafe events taken off tsHead but not yet moved into the heap, oldest first.
+// Only touched on the CPU thread.
+static std::vector<BaseEvent> tsPending;
 
 // Downcount has been moved to currentMIPS, to save a couple of clocks in every ARM JIT block
 // as we can already reach that structure through a register.
@@ -82,8 +117,6 @@ s64 idledCycles;
 s64 lastGlobalTimeTicks;
 s64 lastGlobalTimeUs;
 
-static std::mutex externalEventLock;
-
 std::vector<MHzChangeCallback> mhzChangeCallbacks;
 
 void FireMhzChange() {
@@ -130,39 +163,114 @@ u64 GetGlobalTimeUs() {
 	return lastGlobalTimeUs + usSinceLast;
 }
 
-Event* GetNewEvent()
-{
-	if(!eventPool)
-		return new Event;
+static inline bool EventBefore(int a, int b) {
+	const Event &ea = eventSlots[a];
+	const Event &eb = eventSlots[b];
+	return ea.time < eb.time || (ea.time == eb.time && ea.order < eb.order);
+}
 
-	Event* ev = eventPool;
-	eventPool = ev->next;
-	return ev;
+static void HeapSet(int pos, int slot) {
+	eventHeap[pos] = slot;
+	eventSlots[slot].heapIndex = pos;
 }
 
-Event* GetNewTsEvent()
-{
-	allocatedTsEvents++;
+static void HeapSiftUp(int pos) {
+	int slot = eventHeap[pos];
+	while (pos > 0) {
+		int parent = (pos - 1) / 2;
+		if (!EventBefore(slot, eventHeap[parent]))
+			break;
+		HeapSet(pos, eventHeap[parent]);
+		pos = parent;
+	}
+	HeapSet(pos, slot);
+}
 
-	if(!eventTsPool)
-		return new Event;
+static void HeapSiftDown(int pos) {
+	const int size = (int)eventHeap.size();
+	int slot = eventHeap[pos];
+	while (true) {
+		int child = pos * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && EventBefore(eventHeap[child + 1], eventHeap[child]))
+			child++;
+		if (!EventBefore(eventHeap[child], slot))
+			break;
+		HeapSet(pos, eventHeap[child]);
+		pos = child;
+	}
+	HeapSet(pos, slot);
+}
 
-	Event* ev = eventTsPool;
-	eventTsPool = ev->next;
-	return ev;
+static const Event *FirstEvent() {
+	return eventHeap.empty() ? nullptr : &eventSlots[eventHeap[0]];
 }
 
-void FreeEvent(Event* ev)
-{
-	ev->next = eventPool;
-	eventPool = ev;
+static void AddEventToQueue(s64 time, int event_type, u64 userdata) {
+	int slot;
+	if (freeEventSlots.empty()) {
+		slot = (int)eventSlots.size();
+		eventSlots.push_back(Event{});
+	} else {
+		slot = freeEventSlots.back();
+		freeEventSlots.pop_back();
+	}
+
+	Event &ev = eventSlots[slot];
+	ev.time = time;
+	ev.userdata = userdata;
+	ev.type = event_type;
+	ev.order = nextEventOrder++;
+
+	eventHeap.push_back(slot);
+	HeapSiftUp((int)eventHeap.size() - 1);
+	eventsByKey.emplace(EventKey{ event_type, userdata }, slot);
+	if (event_type >= (int)eventTypeCounts.size())
+		eventTypeCounts.resize(event_type + 1);
+	eventTypeCounts[event_type]++;
 }
 
-void FreeTsEvent(Event* ev)
-{
-	ev->next = eventTsPool;
-	eventTsPool = ev;
-	allocatedTsEvents--;
+static void RemoveEventFromQueue(int slot) {
+	Event &ev = eventSlots[slot];
+
+	auto range = eventsByKey.equal_range(EventKey{ ev.type, ev.userdata });
+	for (auto it = range.first; it != range.second; ++it) {
+		if (it->second == slot) {
+			eventsByKey.erase(it);
+			break;
+		}
+	}
+	eventTypeCounts[ev.type]--;
+
+	int pos = ev.heapIndex;
+	int last = eventHeap.back();
+	eventHeap.pop_back();
+	if (last != slot) {
+		HeapSet(pos, last);
+		if (pos > 0 && EventBefore(last, eventHeap[(pos - 1) / 2]))
+			HeapSiftUp(pos);
+		else
+			HeapSiftDown(pos);
+	}
+	freeEventSlots.push_back(slot);
+}
+
+// Takes everything other threads have scheduled so far, and appends it to tsPending.
+static void TakeThreadsafeEvents() {
+	ThreadsafeEvent *head = tsHead.exchange(nullptr, std::memory_order_acquire);
+	if (!head)
+		return;
+
+	size_t start = tsPending.size();
+	while (head) {
+		ThreadsafeEvent *next = head->next;
+		tsPending.push_back(head->event);
+		delete head;
+		head = next;
+	}
+	// The stack is newest first.
+	std::reverse(tsPending.begin() + start, tsPending.end());
 }
 
 int RegisterEvent(const char *name, TimedCallback callback) {
@@ -208,7 +316,7 @@ void RestoreRegisterEvent(int &event_type, const char *name, TimedCallback callb
 }
 
 void UnregisterAllEvents() {
-	_dbg_assert_msg_(first == nullptr, "Unregistering events with events pending - this isn't good.");
+	_dbg_assert_msg_(eventHeap.empty(), "Unregistering events with events pending - this isn't good.");
 	event_types.clear();
 	usedEventTypes.clear();
 	restoredEventTypes.clear();
@@ -222,7 +330,7 @@ void Init()
 	idledCycles = 0;
 	lastGlobalTimeTicks = 0;
 	lastGlobalTimeUs = 0;
-	hasTsEvents = 0;
+	nextEventOrder = 0;
 	mhzChangeCallbacks.clear();
 	CPU_HZ = initialHz;
 }
@@ -233,20 +341,9 @@ void Shutdown()
 	ClearPendingEvents();
 	UnregisterAllEvents();
 
-	while(eventPool)
-	{
-		Event *ev = eventPool;
-		eventPool = ev->next;
-		delete ev;
-	}
-
-	std::lock_guard<std::mutex> lk(externalEventLock);
-	while(eventTsPool)
-	{
-		Event *ev = eventTsPool;
-		eventTsPool = ev->next;
-		delete ev;
-	}
+	eventSlots.clear();
+	freeEventSlots.clear();
+	eventTypeCounts.clear();
 }
 
 u64 GetTicks()
@@ -264,19 +361,13 @@ u64 GetIdleTicks()
 // schedule things to be executed on the main thread.
 void ScheduleEvent_Threadsafe(s64 cyclesIntoFuture, int event_type, u64 userdata)
 {
-	std::lock_guard<std::mutex> lk(externalEventLock);
-	Event *ne = GetNewTsEvent();
-	ne->time = GetTicks() + cyclesIntoFuture;
-	ne->type = event_type;
-	ne->next = 0;
-	ne->userdata = userdata;
-	if(!tsFirst)
-		tsFirst = ne;
-	if(tsLast)
-		tsLast->next = ne;
-	tsLast = ne;
-
-	hasTsEvents.store(1, std::memory_order::memory_order_release);
+	ThreadsafeEvent *ne = new ThreadsafeEvent;
+	ne->event.time = GetTicks() + cyclesIntoFuture;
+	ne->event.type = event_type;
+	ne->event.userdata = userdata;
+	ne->next = tsHead.load(std::memory_order_relaxed);
+	while (!tsHead.compare_exchange_weak(ne->next, ne, std::memory_order_release, std::memory_order_relaxed))
+		continue;
 }
 
 // Same as ScheduleEvent_Threadsafe(0, ...) EXCEPT if we are already on the CPU thread
@@ -285,7 +376,6 @@ void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata)
 {
 	if(false) //Core::IsCPUThread())
 	{
-		std::lock_guard<std::mutex> lk(externalEventLock);
 		event_types[event_type].callback(userdata, 0);
 	}
 	else
@@ -294,30 +384,11 @@ void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata)
 
 void ClearPendingEvents()
 {
-	while (first)
-	{
-		Event *e = first->next;
-		FreeEvent(first);
-		first = e;
-	}
-}
-
-void AddEventToQueue(Event* ne)
-{
-	Event* prev = NULL;
-	Event** pNext = &first;
-	for(;;)
-	{
-		Event*& next = *pNext;
-		if(!next || ne->time < next->time)
-		{
-			ne->next = next;
-			next = ne;
-			break;
-		}
-		prev = next;
-		pNext = &prev->next;
-	}
+	eventHeap.clear();
+	eventsByKey.clear();
+	eventTypeCounts.clear();
+	freeEventSlots.clear();
+	eventSlots.clear();
 }
 
 // This must be run ONLY from within the cpu thread
@@ -325,53 +396,29 @@ void AddEventToQueue(Event* ne)
 // than Advance
 void ScheduleEvent(s64 cyclesIntoFuture, int event_type, u64 userdata)
 {
-	Event *ne = GetNewEvent();
-	ne->userdata = userdata;
-	ne->type = event_type;
-	ne->time = GetTicks() + cyclesIntoFuture;
-	AddEventToQueue(ne);
+	AddEventToQueue(GetTicks() + cyclesIntoFuture, event_type, userdata);
 }
 
 // Returns cycles left in timer.
 s64 UnscheduleEvent(int event_type, u64 userdata)
 {
 	s64 result = 0;
-	if (!first)
-		return result;
-	while(first)
-	{
-		if (first->type == event_type && first->userdata == userdata)
-		{
-			result = first->time - GetTicks();
-
-			Event *next = first->next;
-			FreeEvent(first);
-			first = next;
-		}
-		else
-		{
+	// Usually just one.  If not, report the last one to run, like the sorted list used to.
+	u64 latestOrder = 0;
+	bool found = false;
+	while (true) {
+		auto it = eventsByKey.find(EventKey{ event_type, userdata });
+		if (it == eventsByKey.end())
 			break;
-		}
-	}
-	if (!first)
-		return result;
-	Event *prev = first;
-	Event *ptr = prev->next;
-	while (ptr)
-	{
-		if (ptr->type == event_type && ptr->userdata == userdata)
-		{
-			result = ptr->time - GetTicks();
 
-			prev->next = ptr->next;
-			FreeEvent(ptr);
-			ptr = prev->next;
-		}
-		else
-		{
-			prev = ptr;
-			ptr = ptr->next;
+		const Event &ev = eventSlots[it->second];
+		s64 left = ev.time - GetTicks();
+		if (!found || left > result || (left == result && ev.order > latestOrder)) {
+			result = left;
+			latestOrder = ev.order;
+			found = true;
 		}
+		RemoveEventFromQueue(it->second);
 	}
 
 	return result;
@@ -380,51 +427,15 @@ s64 UnscheduleEvent(int event_type, u64 userdata)
 s64 UnscheduleThreadsafeEvent(int event_type, u64 userdata)
 {
 	s64 result = 0;
-	std::lock_guard<std::mutex> lk(externalEventLock);
-	if (!tsFirst)
-		return result;
-	while(tsFirst)
-	{
-		if (tsFirst->type == event_type && tsFirst->userdata == userdata)
-		{
-			result = tsFirst->time - GetTicks();
-
-			Event *next = tsFirst->next;
-			FreeTsEvent(tsFirst);
-			tsFirst = next;
-		}
-		else
-		{
-			break;
-		}
-	}
-	if (!tsFirst)
-	{
-		tsLast = NULL;
-		return result;
-	}
-
-	Event *prev = tsFirst;
-	Event *ptr = prev->next;
-	while (ptr)
-	{
-		if (ptr->type == event_type && ptr->userdata == userdata)
-		{
-			result = ptr->time - GetTicks();
-
-			prev->next = ptr->next;
-			if (ptr == tsLast)
-				tsLast = prev;
-			FreeTsEvent(ptr);
-			ptr = prev->next;
-		}
-		else
-		{
-			prev = ptr;
-			ptr = ptr->next;
-		}
-	}
-
+	TakeThreadsafeEvents();
+	auto matches = [&](const BaseEvent &ev) {
+		return ev.type == event_type && ev.userdata == userdata;
+	};
+	for (const BaseEvent &ev : tsPending) {
+		if (matches(ev))
+			result = ev.time - GetTicks();
+	}
+	tsPending.erase(std::remove_if(tsPending.begin(), tsPending.end(), matches), tsPending.end());
 	return result;
 }
 
@@ -434,97 +445,29 @@ void RegisterMHzChangeCallback(MHzChangeCallback callback) {
 
 bool IsScheduled(int event_type)
 {
-	if (!first)
-		return false;
-	Event *e = first;
-	while (e) {
-		if (e->type == event_type)
-			return true;
-		e = e->next;
-	}
-	return false;
+	return event_type >= 0 && event_type < (int)eventTypeCounts.size() && eventTypeCounts[event_type] != 0;
 }
 
 void RemoveEvent(int event_type)
 {
-	if (!first)
+	if (!IsScheduled(event_type))
 		return;
-	while(first)
-	{
-		if (first->type == event_type)
-		{
-			Event *next = first->next;
-			FreeEvent(first);
-			first = next;
-		}
-		else
-		{
-			break;
-		}
-	}
-	if (!first)
-		return;
-	Event *prev = first;
-	Event *ptr = prev->next;
-	while (ptr)
-	{
-		if (ptr->type == event_type)
-		{
-			prev->next = ptr->next;
-			FreeEvent(ptr);
-			ptr = prev->next;
-		}
-		else
-		{
-			prev = ptr;
-			ptr = ptr->next;
-		}
+
+	std::vector<int> matches;
+	for (int slot : eventHeap) {
+		if (eventSlots[slot].type == event_type)
+			matches.push_back(slot);
 	}
+	for (int slot : matches)
+		RemoveEventFromQueue(slot);
 }
 
 void RemoveThreadsafeEvent(int event_type)
 {
-	std::lock_guard<std::mutex> lk(externalEventLock);
-	if (!tsFirst)
-	{
-		return;
-	}
-	while(tsFirst)
-	{
-		if (tsFirst->type == event_type)
-		{
-			Event *next = tsFirst->next;
-			FreeTsEvent(tsFirst);
-			tsFirst = next;
-		}
-		else
-		{
-			break;
-		}
-	}
-	if (!tsFirst)
-	{
-		tsLast = NULL;
-		return;
-	}
-	Event *prev = tsFirst;
-	Event *ptr = prev->next;
-	while (ptr)
-	{
-		if (ptr->type == event_type)
-		{
-			prev->next = ptr->next;
-			if (ptr == tsLast)
-				tsLast = prev;
-			FreeTsEvent(ptr);
-			ptr = prev->next;
-		}
-		else
-		{
-			prev = ptr;
-			ptr = ptr->next;
-		}
-	}
+	TakeThreadsafeEvents();
+	tsPending.erase(std::remove_if(tsPending.begin(), tsPending.end(), [&](const BaseEvent &ev) {
+		return ev.type == event_type;
+	}), tsPending.end());
 }
 
 void RemoveAllEvents(int event_type)
@@ -536,16 +479,19 @@ void RemoveAllEvents(int event_type)
 //This raise only the events required while the fifo is processing data
 void ProcessFifoWaitEvents()
 {
-	while (first)
+	while (!eventHeap.empty())
 	{
-		if (first->time <= (s64)GetTicks())
+		const Event &first = eventSlots[eventHeap[0]];
+		if (first.time <= (s64)GetTicks())
 		{
 //			LOG(CPU, "[Scheduler] %s		 (%lld, %lld) ",
 //				first->name ? first->name : "?", (u64)GetTicks(), (u64)first->time);
-			Event* evt = first;
-			first = first->next;
-			event_types[evt->type].callback(evt->userdata, (int)(GetTicks() - evt->time));
-			FreeEvent(evt);
+			// The callback may schedule more events, so take it off the queue first.
+			const s64 time = first.time;
+			const u64 userdata = first.userdata;
+			const int type = first.type;
+			RemoveEventFromQueue(eventHeap[0]);
+			event_types[type].callback(userdata, (int)(GetTicks() - time));
 		}
 		else
 		{
@@ -556,27 +502,11 @@ void ProcessFifoWaitEvents()
 
 void MoveEvents()
 {
-	hasTsEvents.store(0, std::memory_order::memory_order_release);
-
-	std::lock_guard<std::mutex> lk(externalEventLock);
 	// Move events from async queue into main queue
-	while (tsFirst)
-	{
-		Event *next = tsFirst->next;
-		AddEventToQueue(tsFirst);
-		tsFirst = next;
-	}
-	tsLast = NULL;
-
-	// Move free events to threadsafe pool
-	while(allocatedTsEvents > 0 && eventPool)
-	{
-		Event *ev = eventPool;
-		eventPool = ev->next;
-		ev->next = eventTsPool;
-		eventTsPool = ev;
-		allocatedTsEvents--;
-	}
+	TakeThreadsafeEvents();
+	for (const BaseEvent &ev : tsPending)
+		AddEventToQueue(ev.time, ev.type, ev.userdata);
+	tsPending.clear();
 }
 
 void ForceCheck()
@@ -599,10 +529,11 @@ void Advance() {
 	globalTimer += cyclesExecuted;
 	currentMIPS->downcount = slicelength;
 
-	if (hasTsEvents.load(std::memory_order_acquire))
+	if (tsHead.load(std::memory_order_acquire) || !tsPending.empty())
 		MoveEvents();
 	ProcessFifoWaitEvents();
 
+	const Event *first = FirstEvent();
 	if (!first) {
 		// This should never happen in PPSSPP.
 		// WARN_LOG_REPORT(TIME, "WARNING - no events in queue. Setting currentMIPS->downcount to 10000");
@@ -622,11 +553,22 @@ void Advance() {
 	}
 }
 
+// Pending events, in the order they'll run.
+static std::vector<BaseEvent> SortedEvents() {
+	std::vector<int> slots = eventHeap;
+	std::sort(slots.begin(), slots.end(), EventBefore);
+	std::vector<BaseEvent> sorted;
+	sorted.reserve(slots.size());
+	for (int slot : slots) {
+		const Event &ev = eventSlots[slot];
+		sorted.push_back(BaseEvent{ ev.time, ev.userdata, ev.type });
+	}
+	return sorted;
+}
+
 void LogPendingEvents() {
-	Event *ptr = first;
-	while (ptr) {
-		//INFO_LOG(CPU, "PENDING: Now: %lld Pending: %lld Type: %d", globalTimer, ptr->time, ptr->type);
-		ptr = ptr->next;
+	for (const BaseEvent &ev : SortedEvents()) {
+		DEBUG_LOG(CPU, "PENDING: Now: %lld Pending: %lld Type: %d", (long long)globalTimer, (long long)ev.time, ev.type);
 	}
 }
 
@@ -635,6 +577,7 @@ void Idle(int maxIdle) {
 	if (maxIdle != 0 && cyclesDown > maxIdle)
 		cyclesDown = maxIdle;
 
+	const Event *first = FirstEvent();
 	if (first && cyclesDown > 0) {
 		int cyclesExecuted = slicelength - currentMIPS->downcount;
 		int cyclesNextEvent = (int) (first->time - globalTimer);
@@ -656,23 +599,20 @@ void Idle(int maxIdle) {
 }
 
 std::string GetScheduledEventsSummary() {
-	Event *ptr = first;
 	std::string text = "Scheduled events\n";
 	text.reserve(1000);
-	while (ptr) {
-		unsigned int t = ptr->type;
+	for (const BaseEvent &ev : SortedEvents()) {
+		unsigned int t = ev.type;
 		if (t >= event_types.size()) {
 			_dbg_assert_msg_(false, "Invalid event type %d", t);
-			ptr = ptr->next;
 			continue;
 		}
 		const char *name = event_types[t].name;
 		if (!name)
 			name = "[unknown]";
 		char temp[512];
-		sprintf(temp, "%s : %i %08x%08x\n", name, (int)ptr->time, (u32)(ptr->userdata >> 32), (u32)(ptr->userdata));
+		sprintf(temp, "%s : %i %08x%08x\n", name, (int)ev.time, (u32)(ev.userdata >> 32), (u32)(ev.userdata));
 		text += temp;
-		ptr = ptr->next;
 	}
 	return text;
 }
@@ -692,9 +632,36 @@ void Event_DoStateOld(PointerWrap &p, BaseEvent *ev)
 	usedEventTypes.insert(ev->type);
 }
 
-void DoState(PointerWrap &p) {
-	std::lock_guard<std::mutex> lk(externalEventLock);
+// Same format as DoLinkedList(), which older versions used: a 1 before each event, then a 0.
+static void DoEventList(PointerWrap &p, std::vector<BaseEvent> &events, void (*doEvent)(PointerWrap &, BaseEvent *)) {
+	if (p.mode == PointerWrap::MODE_READ) {
+		events.clear();
+		while (true) {
+			u8 shouldExist = 0;
+			Do(p, shouldExist);
+			if (shouldExist != 1) {
+				if (shouldExist != 0) {
+					WARN_LOG(SAVESTATE, "Savestate failure: incorrect item marker %d", shouldExist);
+					p.SetError(p.ERROR_FAILURE);
+				}
+				break;
+			}
+			BaseEvent ev;
+			doEvent(p, &ev);
+			events.push_back(ev);
+		}
+	} else {
+		for (BaseEvent &ev : events) {
+			u8 shouldExist = 1;
+			Do(p, shouldExist);
+			doEvent(p, &ev);
+		}
+		u8 shouldExist = 0;
+		Do(p, shouldExist);
+	}
+}
 
+void DoState(PointerWrap &p) {
 	auto s = p.Section("CoreTiming", 1, 3);
 	if (!s)
 		return;
@@ -717,12 +684,18 @@ void DoState(PointerWrap &p) {
 	usedEventTypes.clear();
 	restoredEventTypes.clear();
 
-	if (s >= 3) {
-		DoLinkedList<BaseEvent, GetNewEvent, FreeEvent, Event_DoState>(p, first, (Event **) NULL);
-		DoLinkedList<BaseEvent, GetNewTsEvent, FreeTsEvent, Event_DoState>(p, tsFirst, &tsLast);
-	} else {
-		DoLinkedList<BaseEvent, GetNewEvent, FreeEvent, Event_DoStateOld>(p, first, (Event **) NULL);
-		DoLinkedList<BaseEvent, GetNewTsEvent, FreeTsEvent, Event_DoStateOld>(p, tsFirst, &tsLast);
+	// Saved as sorted lists, like before the heap, so states still load both ways.
+	std::vector<BaseEvent> events;
+	if (p.mode != PointerWrap::MODE_READ)
+		events = SortedEvents();
+	TakeThreadsafeEvents();
+	auto doEvent = s >= 3 ? &Event_DoState : &Event_DoStateOld;
+	DoEventList(p, events, doEvent);
+	DoEventList(p, tsPending, doEvent);
+	if (p.mode == PointerWrap::MODE_READ) {
+		ClearPendingEvents();
+		for (const BaseEvent &ev : events)
+			AddEventToQueue(ev.time, ev.type, ev.userdata);
 	}
 
 	Do(p, CPU_HZ);
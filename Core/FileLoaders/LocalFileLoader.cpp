@@ -15,7 +15,9 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 
 #include "ppsspp_config.h"
 
@@ -23,6 +25,7 @@
 #include "Common/Log.h"
 #include "Common/File/FileUtil.h"
 #include "Common/File/DirListing.h"
+#include "Core/Config.h"
 #include "Core/FileLoaders/LocalFileLoader.h"
 
 #if PPSSPP_PLATFORM(ANDROID)
@@ -33,6 +36,7 @@
 #include "Common/CommonWindows.h"
 #else
 #include <fcntl.h>
+#include <sys/mman.h>
 #endif
 
 #ifndef _WIN32
@@ -48,6 +52,23 @@ void LocalFileLoader::DetectSizeFd() {
 	lseek(fd_, 0, SEEK_SET);
 #endif
 }
+
+void LocalFileLoader::MapFd() {
+	// Needs the address space for a whole disc image.  The Switch has no mmap.
+#if PPSSPP_ARCH(64BIT) && !PPSSPP_PLATFORM(SWITCH)
+	// A mapped file that goes away (say, on a network share) faults instead of failing a read,
+	// so this can be turned off.
+	if (!g_Config.bMemoryMapFiles || filesize_ == 0)
+		return;
+	void *map = mmap(nullptr, (size_t)filesize_, PROT_READ, MAP_SHARED, fd_, 0);
+	if (map == MAP_FAILED) {
+		VERBOSE_LOG(FILESYS, "Could not map %s, using reads", filename_.c_str());
+		return;
+	}
+	madvise(map, (size_t)filesize_, MADV_WILLNEED);
+	map_ = (const u8 *)map;
+#endif
+}
 #endif
 
 LocalFileLoader::LocalFileLoader(const Path &filename)
@@ -68,6 +89,7 @@ LocalFileLoader::LocalFileLoader(const Path &filename)
 		fd_ = fd;
 		isOpenedByFd_ = true;
 		DetectSizeFd();
+		MapFd();
 		return;
 	}
 #endif
@@ -80,6 +102,7 @@ LocalFileLoader::LocalFileLoader(const Path &filename)
 	}
 
 	DetectSizeFd();
+	MapFd();
 
 #else // _WIN32
 
@@ -107,6 +130,9 @@ LocalFileLoader::LocalFileLoader(const Path &filename)
 
 LocalFileLoader::~LocalFileLoader() {
 #ifndef _WIN32
+	if (map_) {
+		munmap((void *)map_, (size_t)filesize_);
+	}
 	if (fd_ != -1) {
 		close(fd_);
 	}
@@ -158,6 +184,17 @@ size_t LocalFileLoader::ReadAt(s64 absolutePos, size_t bytes, size_t count, void
 		return 0;
 	}
 
+#ifndef _WIN32
+	if (map_) {
+		if (absolutePos < 0 || (u64)absolutePos >= filesize_)
+			return 0;
+		// Like pread, copy a partial item at the end but don't count it.
+		size_t size = (size_t)std::min((u64)(bytes * count), filesize_ - absolutePos);
+		memcpy(data, map_ + absolutePos, size);
+		return size / bytes;
+	}
+#endif
+
 #if PPSSPP_PLATFORM(SWITCH)
 	// Toolchain has no fancy IO API.  We must lock.
 	std::lock_guard<std::mutex> guard(readLock_);
@@ -192,3 +229,11 @@ size_t LocalFileLoader::ReadAt(s64 absolutePos, size_t bytes, size_t count, void
 	return result == TRUE ? (size_t)read / bytes : -1;
 #endif
 }
+
+const u8 *LocalFileLoader::GetView(s64 absolutePos, size_t bytes) {
+#ifndef _WIN32
+	if (map_ && absolutePos >= 0 && (u64)absolutePos + bytes <= filesize_)
+		return map_ + absolutePos;
+#endif
+	return nullptr;
+}
@@ -39,11 +39,15 @@ class LocalFileLoader : public FileLoader {
 		return filename_;
 	}
 	virtual size_t ReadAt(s64 absolutePos, size_t bytes, size_t count, void *data, Flags flags = Flags::NONE) override;
+	const u8 *GetView(s64 absolutePos, size_t bytes) override;
 
 private:
 #ifndef _WIN32
 	void DetectSizeFd();
+	void MapFd();
 	int fd_ = -1;
+	// The whole file, when it could be mapped.  Reads then come straight from the page cache.
+	const u8 *map_ = nullptr;
 #else
 	HANDLE handle_ = 0;
 #endif
@@ -18,13 +18,19 @@
 #include <cstdio>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <functional>
+
+#include <zstd.h>
 
 #include "Common/Data/Text/I18n.h"
 #include "Common/File/FileUtil.h"
 #include "Common/Log.h"
 #include "Common/Swap.h"
+#include "Common/Thread/ParallelLoop.h"
 #include "Core/Loaders.h"
 #include "Core/Host.h"
+#include "Core/ThreadPools.h"
 #include "Core/FileSystems/BlockDevices.h"
 
 extern "C"
@@ -44,6 +50,8 @@ BlockDevice *constructBlockDevice(FileLoader *fileLoader) {
 	size_t size = fileLoader->ReadAt(0, 1, 4, buffer);
 	if (size == 4 && !memcmp(buffer, "CISO", 4))
 		return new CISOFileBlockDevice(fileLoader);
+	else if (size == 4 && !memcmp(buffer, "ZCSO", 4))
+		return new ZCSOFileBlockDevice(fileLoader);
 	else if (size == 4 && !memcmp(buffer, "\x00PBP", 4))
 		return new NPDRMDemoBlockDevice(fileLoader);
 	else
@@ -84,6 +92,11 @@ FileBlockDevice::~FileBlockDevice() {
 }
 
 bool FileBlockDevice::ReadBlock(int blockNumber, u8 *outPtr, bool uncached) {
+	if (const u8 *view = GetBlockView(blockNumber, 1)) {
+		memcpy(outPtr, view, 2048);
+		return true;
+	}
+
 	FileLoader::Flags flags = uncached ? FileLoader::Flags::HINT_UNCACHED : FileLoader::Flags::NONE;
 	if (fileLoader_->ReadAt((u64)blockNumber * (u64)GetBlockSize(), 1, 2048, outPtr, flags) != 2048) {
 		DEBUG_LOG(FILESYS, "Could not read 2048 bytes from block");
@@ -94,6 +107,11 @@ bool FileBlockDevice::ReadBlock(int blockNumber, u8 *outPtr, bool uncached) {
 }
 
 bool FileBlockDevice::ReadBlocks(u32 minBlock, int count, u8 *outPtr) {
+	if (const u8 *view = GetBlockView(minBlock, count)) {
+		memcpy(outPtr, view, 2048 * (size_t)count);
+		return true;
+	}
+
 	if (fileLoader_->ReadAt((u64)minBlock * (u64)GetBlockSize(), 2048, count, outPtr) != (size_t)count) {
 		ERROR_LOG(FILESYS, "Could not read %d bytes from block", 2048 * count);
 		return false;
@@ -101,6 +119,12 @@ bool FileBlockDevice::ReadBlocks(u32 minBlock, int count, u8 *outPtr) {
 	return true;
 }
 
+const u8 *FileBlockDevice::GetBlockView(u32 minBlock, int count) {
+	if (count < 0 || (u64)(minBlock + (u64)count) * GetBlockSize() > filesize_)
+		return nullptr;
+	return fileLoader_->GetView((u64)minBlock * (u64)GetBlockSize(), (size_t)count * GetBlockSize());
+}
+
 // .CSO format
 
 // compressed ISO(9660) header format
@@ -379,6 +403,380 @@ bool CISOFileBlockDevice::ReadBlocks(u32 minBlock, int count, u8 *outPtr) {
 	return true;
 }
 
+// .ZCSO format: the CSO v1 header and index, with zstd frames instead of raw deflate.
+// The high bit of an index entry still marks a frame stored uncompressed.
+
+// Below this many frames, a read isn't worth splitting across threads.
+static const u32 ZCSO_MIN_PARALLEL_FRAMES = 4;
+
+ZCSOFileBlockDevice::ZCSOFileBlockDevice(FileLoader *fileLoader)
+	: fileLoader_(fileLoader)
+{
+	CISO_H hdr;
+	size_t readSize = fileLoader->ReadAt(0, sizeof(CISO_H), 1, &hdr);
+	u64 totalSize = hdr.total_bytes;
+	frameSize_ = hdr.block_size;
+	if (readSize != 1 || memcmp(hdr.magic, "ZCSO", 4) != 0) {
+		ERROR_LOG(LOADER, "Invalid ZCSO!");
+		totalSize = 0;
+		frameSize_ = 0x800;
+	} else if ((frameSize_ & (frameSize_ - 1)) != 0 || frameSize_ < 0x800) {
+		ERROR_LOG(LOADER, "ZCSO frame size %i unsupported, must be a power of two of at least one sector", frameSize_);
+		totalSize = 0;
+		frameSize_ = 0x800;
+	}
+
+	for (u32 i = frameSize_; i > 0x800; i >>= 1)
+		++blockShift_;
+	indexShift_ = hdr.align;
+	numFrames_ = (u32)((totalSize + frameSize_ - 1) / frameSize_);
+	numBlocks_ = (u32)(totalSize / GetBlockSize());
+	VERBOSE_LOG(LOADER, "ZCSO numBlocks=%i numFrames=%i align=%i", numBlocks_, numFrames_, indexShift_);
+
+	const u32 indexSize = numFrames_ + 1;
+	std::vector<u32_le> indexTemp(indexSize);
+	index_.resize(indexSize);
+	if (fileLoader->ReadAt(sizeof(hdr), sizeof(u32_le), indexSize, &indexTemp[0]) != indexSize) {
+		NotifyReadError();
+		numBlocks_ = 0;
+	} else {
+		for (u32 i = 0; i < indexSize; i++)
+			index_[i] = indexTemp[i];
+	}
+
+	u64 fileSize = fileLoader->FileSize();
+	u64 expectedFileSize = (u64)(index_[indexSize - 1] & 0x7FFFFFFF) << indexShift_;
+	if (expectedFileSize > fileSize) {
+		ERROR_LOG(LOADER, "Expected ZCSO to at least be %lld bytes, but file is %lld bytes. File: '%s'",
+			expectedFileSize, fileSize, fileLoader->GetPath().c_str());
+		NotifyReadError();
+	}
+
+	frameCache_.resize(frameSize_);
+	frameCacheFrame_ = numFrames_;
+	edgeBuffer_.resize(frameSize_);
+	dctx_ = ZSTD_createDCtx();
+}
+
+ZCSOFileBlockDevice::~ZCSOFileBlockDevice() {
+	ZSTD_freeDCtx(dctx_);
+}
+
+bool ZCSOFileBlockDevice::DecodeFrame(ZSTD_DCtx *dctx, u32 frame, const u8 *src, size_t srcSize, u8 *dst) {
+	// Only the last frame of the image may be short.
+	const u64 frameStart = (u64)frame * frameSize_;
+	const size_t expected = (size_t)std::min((u64)numBlocks_ * GetBlockSize() - frameStart, (u64)frameSize_);
+	size_t written;
+	if (index_[frame] & 0x80000000) {
+		written = std::min(srcSize, (size_t)frameSize_);
+		memcpy(dst, src, written);
+	} else {
+		// The index is aligned, so there may be padding after the frame.
+		size_t frameBytes = ZSTD_findFrameCompressedSize(src, srcSize);
+		written = ZSTD_isError(frameBytes) ? frameBytes : ZSTD_decompressDCtx(dctx, dst, frameSize_, src, frameBytes);
+		if (ZSTD_isError(written)) {
+			ERROR_LOG(LOADER, "ZCSO frame %d: %s", frame, ZSTD_getErrorName(written));
+			memset(dst, 0, frameSize_);
+			return false;
+		}
+	}
+	if (written < expected) {
+		ERROR_LOG(LOADER, "ZCSO frame %d: size error %d != %d", frame, (int)written, frameSize_);
+		memset(dst, 0, frameSize_);
+		return false;
+	}
+	if (written < frameSize_)
+		memset(dst + written, 0, frameSize_ - written);
+	return true;
+}
+
+bool ZCSOFileBlockDevice::ReadBlock(int blockNumber, u8 *outPtr, bool uncached) {
+	FileLoader::Flags flags = uncached ? FileLoader::Flags::HINT_UNCACHED : FileLoader::Flags::NONE;
+	if ((u32)blockNumber >= numBlocks_) {
+		memset(outPtr, 0, GetBlockSize());
+		return false;
+	}
+
+	const u32 frame = blockNumber >> blockShift_;
+	const u32 frameOffset = (blockNumber & ((1 << blockShift_) - 1)) * GetBlockSize();
+	if (frameCacheFrame_ != frame) {
+		const u64 readPos = (u64)(index_[frame] & 0x7FFFFFFF) << indexShift_;
+		const u64 readEnd = (u64)(index_[frame + 1] & 0x7FFFFFFF) << indexShift_;
+		const size_t readSize = readEnd > readPos ? (size_t)(readEnd - readPos) : 0;
+		if (readBuffer_.size() < readSize)
+			readBuffer_.resize(readSize);
+
+		size_t got = readSize == 0 ? 0 : fileLoader_->ReadAt(readPos, 1, readSize, &readBuffer_[0], flags);
+		frameCacheFrame_ = numFrames_;
+		if (got != readSize || !DecodeFrame(dctx_, frame, readBuffer_.data(), readSize, &frameCache_[0])) {
+			NotifyReadError();
+			memset(outPtr, 0, GetBlockSize());
+			return false;
+		}
+		frameCacheFrame_ = frame;
+	}
+
+	memcpy(outPtr, &frameCache_[frameOffset], GetBlockSize());
+	return true;
+}
+
+bool ZCSOFileBlockDevice::ReadBlocks(u32 minBlock, int count, u8 *outPtr) {
+	if (count == 1) {
+		return ReadBlock(minBlock, outPtr);
+	}
+	if (minBlock >= numBlocks_) {
+		memset(outPtr, 0, GetBlockSize() * count);
+		return false;
+	}
+
+	const u32 lastBlock = std::min(minBlock + count, numBlocks_) - 1;
+	const u32 validBlocks = lastBlock + 1 - minBlock;
+	if (validBlocks < (u32)count) {
+		memset(outPtr + GetBlockSize() * validBlocks, 0, GetBlockSize() * (count - validBlocks));
+	}
+
+	// The frames are contiguous in the file, so read all of them in one go.
+	const u32 minFrame = minBlock >> blockShift_;
+	const u32 lastFrame = lastBlock >> blockShift_;
+	const u64 readStart = (u64)(index_[minFrame] & 0x7FFFFFFF) << indexShift_;
+	const u64 readEnd = (u64)(index_[lastFrame + 1] & 0x7FFFFFFF) << indexShift_;
+	const size_t readSize = readEnd > readStart ? (size_t)(readEnd - readStart) : 0;
+	if (readBuffer_.size() < readSize)
+		readBuffer_.resize(readSize);
+	size_t got = readSize == 0 ? 0 : fileLoader_->ReadAt(readStart, 1, readSize, &readBuffer_[0]);
+	if (got < readSize)
+		memset(&readBuffer_[got], 0, readSize - got);
+
+	// Only the first and last frames can be partial.  Those decode to the side and get copied,
+	// the last one into frameCache_ so a following ReadBlock() can use it.
+	const u32 blocksPerFrame = 1 << blockShift_;
+	frameCacheFrame_ = numFrames_;
+	std::atomic<bool> failed(false);
+	auto decodeFrames = [&](ZSTD_DCtx *dctx, int lower, int upper) {
+		for (u32 frame = (u32)lower; frame < (u32)upper; ++frame) {
+			const u32 frameBlock = frame << blockShift_;
+			const u32 firstBlock = std::max(frameBlock, minBlock);
+			const u32 endBlock = std::min(frameBlock + blocksPerFrame, lastBlock + 1);
+			u8 *dst = outPtr + (size_t)(firstBlock - minBlock) * GetBlockSize();
+
+			const u64 srcPos = ((u64)(index_[frame] & 0x7FFFFFFF) << indexShift_) - readStart;
+			const u64 srcEnd = ((u64)(index_[frame + 1] & 0x7FFFFFFF) << indexShift_) - readStart;
+			const size_t srcSize = srcEnd > srcPos ? (size_t)(srcEnd - srcPos) : 0;
+
+			const bool whole = endBlock - firstBlock == blocksPerFrame;
+			u8 *target = whole ? dst : (frame == lastFrame ? &frameCache_[0] : &edgeBuffer_[0]);
+			if (!DecodeFrame(dctx, frame, readBuffer_.data() + srcPos, srcSize, target)) {
+				failed = true;
+				memset(dst, 0, (endBlock - firstBlock) * GetBlockSize());
+			} else if (!whole) {
+				memcpy(dst, target + (firstBlock - frameBlock) * GetBlockSize(), (endBlock - firstBlock) * GetBlockSize());
+			}
+		}
+	};
+
+	const u32 numReadFrames = lastFrame - minFrame + 1;
+	if (numReadFrames >= ZCSO_MIN_PARALLEL_FRAMES && g_threadManager.GetNumLooperThreads() > 1) {
+		ParallelRangeLoop(&g_threadManager, [&](int lower, int upper) {
+			ZSTD_DCtx *dctx = ZSTD_createDCtx();
+			decodeFrames(dctx, lower, upper);
+			ZSTD_freeDCtx(dctx);
+		}, (int)minFrame, (int)lastFrame + 1, ZCSO_MIN_PARALLEL_FRAMES / 2);
+	} else {
+		decodeFrames(dctx_, (int)minFrame, (int)lastFrame + 1);
+	}
+
+	if (failed) {
+		NotifyReadError();
+		return false;
+	}
+	const u32 lastFrameBlocks = lastBlock + 1 - std::max(lastFrame << blockShift_, minBlock);
+	if (lastFrameBlocks != blocksPerFrame)
+		frameCacheFrame_ = lastFrame;
+	return true;
+}
+
+// Read ahead
+
+// For the debug stats, which only cover devices that exist, like the current game's disc.
+static std::mutex liveDevicesLock;
+static std::vector<PrefetchingBlockDevice *> liveDevices;
+
+class BlockPrefetchTask : public Task {
+public:
+	BlockPrefetchTask(std::function<void()> func) : func_(std::move(func)) {}
+	void Run() override {
+		func_();
+	}
+
+private:
+	std::function<void()> func_;
+};
+
+PrefetchingBlockDevice::PrefetchingBlockDevice(BlockDevice *inner)
+	: inner_(inner), numBlocks_(inner->GetNumBlocks()) {
+	std::lock_guard<std::mutex> guard(liveDevicesLock);
+	liveDevices.push_back(this);
+}
+
+PrefetchingBlockDevice::~PrefetchingBlockDevice() {
+	{
+		std::lock_guard<std::mutex> guard(liveDevicesLock);
+		liveDevices.erase(std::remove(liveDevices.begin(), liveDevices.end(), this), liveDevices.end());
+	}
+
+	// The tasks point at us, so let them finish.
+	std::unique_lock<std::mutex> guard(cacheMutex_);
+	cacheCond_.wait(guard, [&] { return pendingCount_ == 0; });
+	guard.unlock();
+	delete inner_;
+}
+
+u32 PrefetchingBlockDevice::ReadFromCache(std::unique_lock<std::mutex> &guard, u32 minBlock, u32 count, u8 *outPtr) {
+	u32 done = 0;
+	while (done < count) {
+		const u32 block = minBlock + done;
+		Extent *found = nullptr;
+		for (Extent &extent : extents_) {
+			if (extent.count != 0 && block >= extent.start && block < extent.start + extent.count) {
+				found = &extent;
+				break;
+			}
+		}
+		if (!found)
+			break;
+		if (found->pending) {
+			// On a pool thread (like an async read), the prefetch task may be queued behind us.
+			// Let the caller read it uncached then, otherwise waiting beats reading it twice.
+			if (ThreadManager::IsPoolThread())
+				break;
+			cacheCond_.wait(guard, [&] { return !found->pending; });
+			continue;
+		}
+
+		const u32 n = std::min(count - done, found->start + found->count - block);
+		memcpy(outPtr + (size_t)done * GetBlockSize(), &found->data[(size_t)(block - found->start) * GetBlockSize()], (size_t)n * GetBlockSize());
+		found->lastUse = ++useCounter_;
+		done += n;
+	}
+	return done;
+}
+
+bool PrefetchingBlockDevice::ReadBlock(int blockNumber, u8 *outPtr, bool uncached) {
+	if (!uncached && (u32)blockNumber < numBlocks_) {
+		std::unique_lock<std::mutex> guard(cacheMutex_);
+		if (ReadFromCache(guard, blockNumber, 1, outPtr) == 1) {
+			hits_++;
+			return true;
+		}
+	}
+
+	misses_++;
+	std::lock_guard<std::mutex> guard(innerMutex_);
+	return inner_->ReadBlock(blockNumber, outPtr, uncached);
+}
+
+bool PrefetchingBlockDevice::ReadBlocks(u32 minBlock, int count, u8 *outPtr) {
+	if (const u8 *view = inner_->GetBlockView(minBlock, count)) {
+		memcpy(outPtr, view, (size_t)count * GetBlockSize());
+		return true;
+	}
+
+	u32 done = 0;
+	if (minBlock < numBlocks_) {
+		std::unique_lock<std::mutex> guard(cacheMutex_);
+		done = ReadFromCache(guard, minBlock, std::min((u32)count, numBlocks_ - minBlock), outPtr);
+	}
+	hits_ += done;
+	if (done == (u32)count)
+		return true;
+
+	misses_ += count - done;
+	std::lock_guard<std::mutex> guard(innerMutex_);
+	return inner_->ReadBlocks(minBlock + done, count - done, outPtr + (size_t)done * GetBlockSize());
+}
+
+void PrefetchingBlockDevice::Prefetch(u32 minBlock, int count) {
+	if (count <= 0 || minBlock >= numBlocks_ || g_threadManager.GetNumLooperThreads() == 0)
+		return;
+	count = std::min((u32)count, numBlocks_ - minBlock);
+	if (inner_->GetBlockView(minBlock, count))
+		return;
+
+	std::lock_guard<std::mutex> guard(cacheMutex_);
+	// Skip what's already cached or on the way.  Keep going once half of it is, so the
+	// next extent is ready by the time the reader gets there.
+	u32 start = minBlock;
+	bool advanced = true;
+	while (advanced) {
+		advanced = false;
+		for (const Extent &extent : extents_) {
+			if (extent.count != 0 && start >= extent.start && start < extent.start + extent.count) {
+				start = extent.start + extent.count;
+				advanced = true;
+			}
+		}
+	}
+	if (start - minBlock >= (u32)count / 2 || start >= numBlocks_)
+		return;
+
+	// Replace the least recently used extent that isn't being filled.
+	Extent *victim = nullptr;
+	for (Extent &extent : extents_) {
+		if (!extent.pending && (!victim || extent.lastUse < victim->lastUse))
+			victim = &extent;
+	}
+	if (!victim)
+		return;
+
+	victim->start = start;
+	victim->count = std::min((u32)count, numBlocks_ - start);
+	victim->lastUse = ++useCounter_;
+	victim->pending = true;
+	pendingCount_++;
+	g_threadManager.EnqueueTask(new BlockPrefetchTask([this, victim] {
+		RunPrefetch(victim);
+	}), TaskType::IO_BLOCKING);
+}
+
+void PrefetchingBlockDevice::RunPrefetch(Extent *extent) {
+	// Only this task touches the extent while it's pending.
+	std::vector<u8> data((size_t)extent->count * GetBlockSize());
+	bool success;
+	{
+		std::lock_guard<std::mutex> guard(innerMutex_);
+		success = inner_->ReadBlocks(extent->start, extent->count, &data[0]);
+	}
+	reads_ += extent->count;
+
+	std::lock_guard<std::mutex> guard(cacheMutex_);
+	extent->data = std::move(data);
+	if (!success)
+		extent->count = 0;
+	extent->pending = false;
+	pendingCount_--;
+	cacheCond_.notify_all();
+}
+
+void PrefetchingBlockDevice::GetDebugStats(char *stats, size_t bufsize) {
+	u64 hits = 0, misses = 0, reads = 0;
+	{
+		std::lock_guard<std::mutex> guard(liveDevicesLock);
+		if (liveDevices.empty()) {
+			// Read ahead is off, or nothing is loaded.
+			if (bufsize)
+				stats[0] = '\0';
+			return;
+		}
+		for (const PrefetchingBlockDevice *device : liveDevices) {
+			hits += device->hits_;
+			misses += device->misses_;
+			reads += device->reads_;
+		}
+	}
+	snprintf(stats, bufsize, "Disc read ahead: %llu hits, %llu misses (%0.1f%%), %llu blocks prefetched\n",
+		(unsigned long long)hits, (unsigned long long)misses, hits + misses ? 100.0 * hits / (hits + misses) : 0.0, (unsigned long long)reads);
+}
+
 NPDRMDemoBlockDevice::NPDRMDemoBlockDevice(FileLoader *fileLoader)
 	: fileLoader_(fileLoader)
 {
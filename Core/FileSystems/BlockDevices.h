@@ -19,16 +19,21 @@
 
 // Abstractions around read-only blockdevices, such as PSP UMD discs.
 // CISOFileBlockDevice implements compressed iso images, CISO format.
+// ZCSOFileBlockDevice is the same layout with zstd frames, decoded in parallel on big reads.
 //
 // The ISOFileSystemReader reads from a BlockDevice, so it automatically works
 // with CISO images.
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Core/ELF/PBPReader.h"
 
 class FileLoader;
+struct ZSTD_DCtx_s;
 
 class BlockDevice {
 public:
@@ -46,6 +51,11 @@ class BlockDevice {
 	int GetBlockSize() const { return 2048;}  // forced, it cannot be changed by subclasses
 	virtual u32 GetNumBlocks() = 0;
 	virtual bool IsDisc() = 0;
+	// Hint that these blocks are likely to be read soon.  Only PrefetchingBlockDevice acts on it.
+	virtual void Prefetch(u32 minBlock, int count) {}
+	// Direct access to the blocks of a memory mapped, uncompressed image, valid as long as
+	// the device.  Otherwise nullptr, and they need to be read.
+	virtual const u8 *GetBlockView(u32 minBlock, int count) { return nullptr; }
 
 	u32 CalculateCRC(volatile bool *cancel = nullptr);
 	void NotifyReadError();
@@ -77,6 +87,35 @@ class CISOFileBlockDevice : public BlockDevice {
 	int ver_;
 };
 
+// Same header and index as CSO v1, but with "ZCSO" as the magic and each frame a single
+// zstd frame.  Tools/zcsotool converts ISO and CSO images to it.
+class ZCSOFileBlockDevice : public BlockDevice {
+public:
+	ZCSOFileBlockDevice(FileLoader *fileLoader);
+	~ZCSOFileBlockDevice();
+	bool ReadBlock(int blockNumber, u8 *outPtr, bool uncached = false) override;
+	bool ReadBlocks(u32 minBlock, int count, u8 *outPtr) override;
+	u32 GetNumBlocks() override { return numBlocks_; }
+	bool IsDisc() override { return true; }
+
+private:
+	bool DecodeFrame(ZSTD_DCtx_s *dctx, u32 frame, const u8 *src, size_t srcSize, u8 *dst);
+
+	FileLoader *fileLoader_;
+	std::vector<u32> index_;
+	std::vector<u8> readBuffer_;
+	// The last frame decoded for a partial read, since sequential single block reads are common.
+	std::vector<u8> frameCache_;
+	u32 frameCacheFrame_;
+	// For a partial first frame in ReadBlocks, when the last one goes to frameCache_.
+	std::vector<u8> edgeBuffer_;
+	ZSTD_DCtx_s *dctx_ = nullptr;
+	u8 indexShift_ = 0;
+	u8 blockShift_ = 0;
+	u32 frameSize_ = 0;
+	u32 numBlocks_ = 0;
+	u32 numFrames_ = 0;
+};
 
 class FileBlockDevice : public BlockDevice {
 public:
@@ -86,6 +125,7 @@ class FileBlockDevice : public BlockDevice {
 	bool ReadBlocks(u32 minBlock, int count, u8 *outPtr) override;
 	u32 GetNumBlocks() override {return (u32)(filesize_ / GetBlockSize());}
 	bool IsDisc() override { return true; }
+	const u8 *GetBlockView(u32 minBlock, int count) override;
 
 private:
 	FileLoader *fileLoader_;
@@ -132,4 +172,54 @@ class NPDRMDemoBlockDevice : public BlockDevice {
 };
 
 
+// Wraps another device, and reads ahead on an I/O thread when asked through Prefetch().
+// ISOFileSystem does that when it sees a file being streamed, like movies and music.
+// Keeps a few extents of read ahead blocks, so a couple of streams can run at once.
+class PrefetchingBlockDevice : public BlockDevice {
+public:
+	PrefetchingBlockDevice(BlockDevice *inner);
+	~PrefetchingBlockDevice();
+	bool ReadBlock(int blockNumber, u8 *outPtr, bool uncached = false) override;
+	bool ReadBlocks(u32 minBlock, int count, u8 *outPtr) override;
+	u32 GetNumBlocks() override { return numBlocks_; }
+	bool IsDisc() override { return inner_->IsDisc(); }
+	void Prefetch(u32 minBlock, int count) override;
+	// Views don't need the inner device's state, and beat any read ahead.
+	const u8 *GetBlockView(u32 minBlock, int count) override { return inner_->GetBlockView(minBlock, count); }
+
+	// Hit and miss counts of the devices that currently exist.  Empty if there are none.
+	static void GetDebugStats(char *stats, size_t bufsize);
+
+private:
+	struct Extent {
+		u32 start = 0;
+		u32 count = 0;
+		u64 lastUse = 0;
+		bool pending = false;
+		std::vector<u8> data;
+	};
+
+	void RunPrefetch(Extent *extent);
+	// Copies any leading blocks the cache has.  Needs cacheMutex_.
+	u32 ReadFromCache(std::unique_lock<std::mutex> &guard, u32 minBlock, u32 count, u8 *outPtr);
+
+	enum {
+		MAX_EXTENTS = 4,
+	};
+
+	BlockDevice *inner_;
+	u32 numBlocks_;
+	// The inner devices aren't thread safe, so all reads from it go through this.
+	std::mutex innerMutex_;
+	std::mutex cacheMutex_;
+	std::condition_variable cacheCond_;
+	Extent extents_[MAX_EXTENTS];
+	u64 useCounter_ = 0;
+	int pendingCount_ = 0;
+
+	std::atomic<u64> hits_{};
+	std::atomic<u64> misses_{};
+	std::atomic<u64> reads_{};
+};
+
 BlockDevice *constructBlockDevice(FileLoader *fileLoader);
@@ -472,6 +472,7 @@ size_t ISOFileSystem::ReadFile(u32 handle, u8 *pointer, s64 size, int &usec) {
 		if (e.isBlockSectorMode) {
 			// Whole sectors! Shortcut to this simple code.
 			blockDevice->ReadBlocks(e.seekPos, (int)size, pointer);
+			TrackSequentialRead(e, e.seekPos, e.seekPos + (u32)size, blockDevice->GetNumBlocks());
 			if (abs((int)lastReadBlock_ - (int)e.seekPos) > 100) {
 				// This is an estimate, sometimes it takes 1+ seconds, but it definitely takes time.
 				usec = 100000;
@@ -524,24 +525,35 @@ size_t ISOFileSystem::ReadFile(u32 handle, u8 *pointer, s64 size, int &usec) {
 		}
 
 		const u8 *const start = pointer;
-		if (firstBlockSize > 0) {
-			blockDevice->ReadBlock(secNum++, theSector);
-			memcpy(pointer, theSector + firstBlockOffset, firstBlockSize);
-			pointer += firstBlockSize;
-		}
-		if (middleSize > 0) {
-			const u32 sectors = (u32)(middleSize / 2048);
-			blockDevice->ReadBlocks(secNum, sectors, pointer);
-			secNum += sectors;
-			pointer += middleSize;
-		}
-		if (lastBlockSize > 0) {
-			blockDevice->ReadBlock(secNum++, theSector);
-			memcpy(pointer, theSector, lastBlockSize);
-			pointer += lastBlockSize;
+		const u32 endSecNum = (u32)((positionOnIso + size + 2047) / 2048);
+		const u8 *view = size > 0 ? blockDevice->GetBlockView(secNum, endSecNum - secNum) : nullptr;
+		if (view) {
+			// Mapped, so no need to go through whole sectors.
+			memcpy(pointer, view + firstBlockOffset, (size_t)size);
+			pointer += size;
+			secNum = endSecNum;
+		} else {
+			if (firstBlockSize > 0) {
+				blockDevice->ReadBlock(secNum++, theSector);
+				memcpy(pointer, theSector + firstBlockOffset, firstBlockSize);
+				pointer += firstBlockSize;
+			}
+			if (middleSize > 0) {
+				const u32 sectors = (u32)(middleSize / 2048);
+				blockDevice->ReadBlocks(secNum, sectors, pointer);
+				secNum += sectors;
+				pointer += middleSize;
+			}
+			if (lastBlockSize > 0) {
+				blockDevice->ReadBlock(secNum++, theSector);
+				memcpy(pointer, theSector, lastBlockSize);
+				pointer += lastBlockSize;
+			}
 		}
 
 		size_t totalBytes = pointer - start;
+		const u64 fileEndOnIso = positionOnIso - e.seekPos + fileSize;
+		TrackSequentialRead(e, (u32)(positionOnIso / 2048), secNum, (u32)((fileEndOnIso + 2047) / 2048));
 		if (abs((int)lastReadBlock_ - (int)secNum) > 100) {
 			// This is an estimate, sometimes it takes 1+ seconds, but it definitely takes time.
 			usec = 100000;
@@ -556,6 +568,20 @@ size_t ISOFileSystem::ReadFile(u32 handle, u8 *pointer, s64 size, int &usec) {
 	}
 }
 
+void ISOFileSystem::TrackSequentialRead(OpenFileEntry &e, u32 firstBlock, u32 endBlock, u32 fileEndBlock) {
+	// Movies and music are read in small chunks, each picking up where the last one ended,
+	// maybe in the same block if it ended partway through.
+	if (firstBlock + 1 >= e.nextSequentialBlock && firstBlock <= e.nextSequentialBlock)
+		e.sequentialReads++;
+	else
+		e.sequentialReads = 0;
+	e.nextSequentialBlock = endBlock;
+
+	const int READ_AHEAD_BLOCKS = 64;
+	if (e.sequentialReads >= 2 && endBlock < fileEndBlock)
+		blockDevice->Prefetch(endBlock, std::min(READ_AHEAD_BLOCKS, (int)(fileEndBlock - endBlock)));
+}
+
 size_t ISOFileSystem::WriteFile(u32 handle, const u8 *pointer, s64 size) {
 	ERROR_LOG(FILESYS, "Hey, what are you doing? You can't write to an ISO!");
 	return 0;
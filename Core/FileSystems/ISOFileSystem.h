@@ -80,6 +80,9 @@ class ISOFileSystem : public IFileSystem {
 		bool isBlockSectorMode;  // "umd:" mode: all sizes and offsets are in 2048 byte chunks
 		u32 sectorStart;
 		u32 openSize;
+		// To detect streaming: where the last read ended, and how many in a row followed on.
+		u32 nextSequentialBlock = 0;
+		int sequentialReads = 0;
 	};
 
 	typedef std::map<u32,OpenFileEntry> EntryMap;
@@ -91,6 +94,7 @@ class ISOFileSystem : public IFileSystem {
 
 	TreeEntry entireISO;
 
+	void TrackSequentialRead(OpenFileEntry &e, u32 firstBlock, u32 endBlock, u32 fileEndBlock);
 	void ReadDirectory(TreeEntry *root);
 	TreeEntry *GetFromPath(const std::string &path, bool catchError = true);
 	std::string EntryFullPath(TreeEntry *e);
@@ -179,6 +179,45 @@ IFileSystem *MetaFileSystem::GetHandleOwner(u32 handle)
 	return nullptr;
 }
 
+std::unique_lock<std::recursive_mutex> MetaFileSystem::LockDevice(IFileSystem *sys) {
+	return std::unique_lock<std::recursive_mutex>(DeviceLock(sys));
+}
+
+std::recursive_mutex &MetaFileSystem::DeviceLock(IFileSystem *sys) {
+	std::lock_guard<std::recursive_mutex> guard(lock);
+	// umd0:, umd1:, umd: and disc0: are separate filesystems but share the disc.
+	if (sys->Flags() & FileSystemFlags::UMD)
+		return umdLock_;
+	std::unique_ptr<std::recursive_mutex> &deviceLock = deviceLocks_[sys];
+	if (!deviceLock)
+		deviceLock.reset(new std::recursive_mutex());
+	return *deviceLock;
+}
+
+std::unique_lock<std::recursive_mutex> MetaFileSystem::LockHandleDevice(u32 handle, std::shared_ptr<IFileSystem> *sys) {
+	std::recursive_mutex *deviceLock = nullptr;
+	{
+		std::lock_guard<std::recursive_mutex> guard(lock);
+		for (const MountPoint &mount : fileSystems) {
+			if (mount.system->OwnsHandle(handle)) {
+				*sys = mount.system;
+				deviceLock = &DeviceLock(sys->get());
+				break;
+			}
+		}
+	}
+	// The global lock is released by now, so I/O on other devices isn't blocked by this one.
+	if (!deviceLock)
+		return std::unique_lock<std::recursive_mutex>();
+	return std::unique_lock<std::recursive_mutex>(*deviceLock);
+}
+
+uintptr_t MetaFileSystem::GetHandleDeviceKey(u32 handle) {
+	std::lock_guard<std::recursive_mutex> guard(lock);
+	IFileSystem *sys = GetHandleOwner(handle);
+	return sys ? (uintptr_t)&DeviceLock(sys) : 0;
+}
+
 int MetaFileSystem::MapFilePath(const std::string &_inpath, std::string &outpath, MountPoint **system)
 {
 	int error = SCE_KERNEL_ERROR_ERRNO_FILE_NOT_FOUND;
@@ -346,10 +385,12 @@ int MetaFileSystem::OpenFile(std::string filename, FileAccess access, const char
 	std::string of;
 	MountPoint *mount;
 	int error = MapFilePath(filename, of, &mount);
-	if (error == 0)
+	if (error == 0) {
+		auto deviceGuard = LockDevice(mount->system.get());
 		return mount->system->OpenFile(of, access, mount->prefix.c_str());
-	else
+	} else {
 		return error;
+	}
 }
 
 PSPFileInfo MetaFileSystem::GetFileInfo(std::string filename)
@@ -360,6 +401,7 @@ PSPFileInfo MetaFileSystem::GetFileInfo(std::string filename)
 	int error = MapFilePath(filename, of, &system);
 	if (error == 0)
 	{
+		auto deviceGuard = LockDevice(system);
 		return system->GetFileInfo(of);
 	}
 	else
@@ -377,6 +419,7 @@ std::vector<PSPFileInfo> MetaFileSystem::GetDirListing(std::string path)
 	int error = MapFilePath(path, of, &system);
 	if (error == 0)
 	{
+		auto deviceGuard = LockDevice(system);
 		return system->GetDirListing(of);
 	}
 	else
@@ -436,6 +479,7 @@ bool MetaFileSystem::MkDir(const std::string &dirname)
 	int error = MapFilePath(dirname, of, &system);
 	if (error == 0)
 	{
+		auto deviceGuard = LockDevice(system);
 		return system->MkDir(of);
 	}
 	else
@@ -452,6 +496,7 @@ bool MetaFileSystem::RmDir(const std::string &dirname)
 	int error = MapFilePath(dirname, of, &system);
 	if (error == 0)
 	{
+		auto deviceGuard = LockDevice(system);
 		return system->RmDir(of);
 	}
 	else
@@ -486,6 +531,7 @@ int MetaFileSystem::RenameFile(const std::string &from, const std::string &to)
 		if (osystem != rsystem)
 			return SCE_KERNEL_ERROR_XDEV;
 
+		auto deviceGuard = LockDevice(osystem);
 		return osystem->RenameFile(of, rf);
 	}
 	else
@@ -502,6 +548,7 @@ bool MetaFileSystem::RemoveFile(const std::string &filename)
 	int error = MapFilePath(filename, of, &system);
 	if (error == 0)
 	{
+		auto deviceGuard = LockDevice(system);
 		return system->RemoveFile(of);
 	}
 	else
@@ -512,8 +559,8 @@ bool MetaFileSystem::RemoveFile(const std::string &filename)
 
 int MetaFileSystem::Ioctl(u32 handle, u32 cmd, u32 indataPtr, u32 inlen, u32 outdataPtr, u32 outlen, int &usec)
 {
-	std::lock_guard<std::recursive_mutex> guard(lock);
-	IFileSystem *sys = GetHandleOwner(handle);
+	std::shared_ptr<IFileSystem> sys;
+	auto deviceGuard = LockHandleDevice(handle, &sys);
 	if (sys)
 		return sys->Ioctl(handle, cmd, indataPtr, inlen, outdataPtr, outlen, usec);
 	return SCE_KERNEL_ERROR_ERROR;
@@ -521,8 +568,8 @@ int MetaFileSystem::Ioctl(u32 handle, u32 cmd, u32 indataPtr, u32 inlen, u32 out
 
 PSPDevType MetaFileSystem::DevType(u32 handle)
 {
-	std::lock_guard<std::recursive_mutex> guard(lock);
-	IFileSystem *sys = GetHandleOwner(handle);
+	std::shared_ptr<IFileSystem> sys;
+	auto deviceGuard = LockHandleDevice(handle, &sys);
 	if (sys)
 		return sys->DevType(handle);
 	return PSPDevType::INVALID;
@@ -530,16 +577,19 @@ PSPDevType MetaFileSystem::DevType(u32 handle)
 
 void MetaFileSystem::CloseFile(u32 handle)
 {
+	// This changes the handles, so it can't run during any GetHandleOwner().
 	std::lock_guard<std::recursive_mutex> guard(lock);
 	IFileSystem *sys = GetHandleOwner(handle);
-	if (sys)
+	if (sys) {
+		auto deviceGuard = LockDevice(sys);
 		sys->CloseFile(handle);
+	}
 }
 
 size_t MetaFileSystem::ReadFile(u32 handle, u8 *pointer, s64 size)
 {
-	std::lock_guard<std::recursive_mutex> guard(lock);
-	IFileSystem *sys = GetHandleOwner(handle);
+	std::shared_ptr<IFileSystem> sys;
+	auto deviceGuard = LockHandleDevice(handle, &sys);
 	if (sys)
 		return sys->ReadFile(handle, pointer, size);
 	else
@@ -548,8 +598,8 @@ size_t MetaFileSystem::ReadFile(u32 handle, u8 *pointer, s64 size)
 
 size_t MetaFileSystem::WriteFile(u32 handle, const u8 *pointer, s64 size)
 {
-	std::lock_guard<std::recursive_mutex> guard(lock);
-	IFileSystem *sys = GetHandleOwner(handle);
+	std::shared_ptr<IFileSystem> sys;
+	auto deviceGuard = LockHandleDevice(handle, &sys);
 	if (sys)
 		return sys->WriteFile(handle, pointer, size);
 	else
@@ -558,8 +608,8 @@ size_t MetaFileSystem::WriteFile(u32 handle, const u8 *pointer, s64 size)
 
 size_t MetaFileSystem::ReadFile(u32 handle, u8 *pointer, s64 size, int &usec)
 {
-	std::lock_guard<std::recursive_mutex> guard(lock);
-	IFileSystem *sys = GetHandleOwner(handle);
+	std::shared_ptr<IFileSystem> sys;
+	auto deviceGuard = LockHandleDevice(handle, &sys);
 	if (sys)
 		return sys->ReadFile(handle, pointer, size, usec);
 	else
@@ -568,8 +618,8 @@ size_t MetaFileSystem::ReadFile(u32 handle, u8 *pointer, s64 size, int &usec)
 
 size_t MetaFileSystem::WriteFile(u32 handle, const u8 *pointer, s64 size, int &usec)
 {
-	std::lock_guard<std::recursive_mutex> guard(lock);
-	IFileSystem *sys = GetHandleOwner(handle);
+	std::shared_ptr<IFileSystem> sys;
+	auto deviceGuard = LockHandleDevice(handle, &sys);
 	if (sys)
 		return sys->WriteFile(handle, pointer, size, usec);
 	else
@@ -578,8 +628,8 @@ size_t MetaFileSystem::WriteFile(u32 handle, const u8 *pointer, s64 size, int &u
 
 size_t MetaFileSystem::SeekFile(u32 handle, s32 position, FileMove type)
 {
-	std::lock_guard<std::recursive_mutex> guard(lock);
-	IFileSystem *sys = GetHandleOwner(handle);
+	std::shared_ptr<IFileSystem> sys;
+	auto deviceGuard = LockHandleDevice(handle, &sys);
 	if (sys)
 		return sys->SeekFile(handle,position,type);
 	else
@@ -608,10 +658,12 @@ u64 MetaFileSystem::FreeSpace(const std::string &path)
 	std::string of;
 	IFileSystem *system;
 	int error = MapFilePath(path, of, &system);
-	if (error == 0)
+	if (error == 0) {
+		auto deviceGuard = LockDevice(system);
 		return system->FreeSpace(of);
-	else
+	} else {
 		return 0;
+	}
 }
 
 void MetaFileSystem::DoState(PointerWrap &p)
@@ -643,6 +695,7 @@ void MetaFileSystem::DoState(PointerWrap &p)
 
 	for (u32 i = 0; i < n; ++i) {
 		if (!skipPfat0 || fileSystems[i].prefix != "pfat0:") {
+			auto deviceGuard = LockDevice(fileSystems[i].system.get());
 			fileSystems[i].system->DoState(p);
 		}
 	}
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <map>
 #include <string>
 #include <vector>
 #include <mutex>
@@ -45,6 +47,15 @@ class MetaFileSystem : public IHandleAllocator, public IFileSystem {
 	std::string startingDirectory;
 	std::recursive_mutex lock;  // must be recursive
 
+	// Calls into a filesystem hold the lock of its device.  File I/O only holds the global
+	// lock to find the handle, so I/O on different devices can run at the same time.
+	std::recursive_mutex umdLock_;
+	std::map<IFileSystem *, std::unique_ptr<std::recursive_mutex>> deviceLocks_;
+
+	std::recursive_mutex &DeviceLock(IFileSystem *sys);
+	std::unique_lock<std::recursive_mutex> LockDevice(IFileSystem *sys);
+	std::unique_lock<std::recursive_mutex> LockHandleDevice(u32 handle, std::shared_ptr<IFileSystem> *sys);
+
 	void Reset() {
 		// This used to be 6, probably an attempt to replicate PSP handles.
 		// However, that's an artifact of using psplink anyway...
@@ -68,6 +79,8 @@ class MetaFileSystem : public IHandleAllocator, public IFileSystem {
 	IFileSystem *GetSystem(const std::string &prefix);
 	IFileSystem *GetSystemFromFilename(const std::string &filename);
 	IFileSystem *GetHandleOwner(u32 handle);
+	// Handles with the same key are on the same device, and can't be accessed in parallel.
+	uintptr_t GetHandleDeviceKey(u32 handle);
 	FileSystemFlags FlagsFromFilename(const std::string &filename) {
 		IFileSystem *sys = GetSystemFromFilename(filename);
 		return sys ? sys->Flags() : FileSystemFlags::NONE;
@@ -17,6 +17,7 @@
 
 #include <atomic>
 #include <mutex>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/File/Path.h"
@@ -44,6 +45,7 @@
 #include "Core/HLE/sceAudio.h"
 #include "Core/HLE/sceKernel.h"
 #include "Core/HLE/sceKernelThread.h"
+#include "Core/HW/PolyphaseResampler.h"
 #include "Core/HW/StereoResampler.h"
 #include "Core/Util/AudioFormat.h"
 
@@ -72,6 +74,9 @@ static int audioHostIntervalCycles;
 
 static s32 *mixBuffer;
 static s16 *clampedMixBuffer;
+// For the SRC channel, when its frequency differs from the mix.  Keeps its position between blocks.
+static PolyphaseResampler srcResampler;
+static std::vector<s16> srcBuffer;
 #ifndef MOBILE_DEVICE
 WaveFileWriter g_wave_writer;
 static bool m_logAudio;
@@ -130,6 +135,7 @@ void __AudioInit() {
 	memset(mixBuffer, 0, hwBlockSize * 2 * sizeof(s32));
 
 	resampler.Clear();
+	srcResampler.Clear();
 	CoreTiming::RegisterMHzChangeCallback(&__AudioCPUMHzChange);
 }
 
@@ -175,6 +181,8 @@ void __AudioDoState(PointerWrap &p) {
 		chans[i].index = i;
 		chans[i].DoState(p);
 	}
+	if (p.mode == p.MODE_READ)
+		srcResampler.Clear();
 
 	__AudioCPUMHzChange();
 }
@@ -328,6 +336,12 @@ void __AudioSetOutputFrequency(int freq) {
 
 void __AudioSetSRCFrequency(int freq) {
 	srcFrequency = freq;
+	// A new stream, don't start it with the tail and phase of the last one.
+	srcResampler.Clear();
+}
+
+void __AudioReleaseSRC() {
+	srcResampler.Clear();
 }
 
 // Mix samples from the various audio channels into a single sample queue.
@@ -337,8 +351,7 @@ void __AudioUpdate(bool resetRecording) {
 	// Audio throttle doesn't really work on the PSP since the mixing intervals are so closely tied
 	// to the CPU. Much better to throttle the frame rate on frame display and just throw away audio
 	// if the buffer somehow gets full.
-	bool firstChannel = true;
-	std::vector<int16_t> srcBuffer;
+	memset(mixBuffer, 0, hwBlockSize * 2 * sizeof(s32));
 
 	for (u32 i = 0; i < PSP_AUDIO_CHANNEL_MAX + 1; i++)	{
 		if (!chans[i].reserved)
@@ -351,7 +364,10 @@ void __AudioUpdate(bool resetRecording) {
 		}
 
 		bool needsResample = i == PSP_AUDIO_CHANNEL_SRC && srcFrequency != 0 && srcFrequency != mixFrequency;
-		size_t sz = needsResample ? (hwBlockSize * 2 * srcFrequency) / mixFrequency : hwBlockSize * 2;
+		if (needsResample) {
+			srcResampler.SetRatio((u32)(65536.0 * srcFrequency / (double)mixFrequency));
+		}
+		size_t sz = needsResample ? srcResampler.InputNeeded(hwBlockSize) * 2 : hwBlockSize * 2;
 		if (sz > chanSampleQueues[i].size()) {
 			ERROR_LOG(SCEAUDIO, "Channel %i buffer underrun at %i of %i", i, (int)chanSampleQueues[i].size() / 2, (int)sz / 2);
 		}
@@ -362,35 +378,17 @@ void __AudioUpdate(bool resetRecording) {
 		chanSampleQueues[i].popPointers(sz, &buf1, &sz1, &buf2, &sz2);
 
 		if (needsResample) {
-			auto read = [&](size_t i) {
-				if (i < sz1)
-					return buf1[i];
-				if (i < sz1 + sz2)
-					return buf2[i - sz1];
-				if (buf2)
-					return buf2[sz2 - 1];
-				return buf1[sz1 - 1];
-			};
+			srcResampler.Push(buf1, (int)sz1 / 2);
+			if (buf2)
+				srcResampler.Push(buf2, (int)sz2 / 2);
 
 			srcBuffer.resize(hwBlockSize * 2);
-
-			// TODO: This is terrible, since it's doing it by small chunk and discarding frac.
-			const uint32_t ratio = (uint32_t)(65536.0 * srcFrequency / (double)mixFrequency);
-			uint32_t frac = 0;
-			size_t readIndex = 0;
-			for (size_t outIndex = 0; readIndex < sz && outIndex < srcBuffer.size(); outIndex += 2) {
-				size_t readIndex2 = readIndex + 2;
-				int16_t l1 = read(readIndex);
-				int16_t r1 = read(readIndex + 1);
-				int16_t l2 = read(readIndex2);
-				int16_t r2 = read(readIndex2 + 1);
-				int sampleL = ((l1 << 16) + (l2 - l1) * (uint16_t)frac) >> 16;
-				int sampleR = ((r1 << 16) + (r2 - r1) * (uint16_t)frac) >> 16;
-				srcBuffer[outIndex] = sampleL;
-				srcBuffer[outIndex + 1] = sampleR;
-				frac += ratio;
-				readIndex += 2 * (uint16_t)(frac >> 16);
-				frac &= 0xffff;
+			int produced = srcResampler.Resample(srcBuffer.data(), hwBlockSize);
+			// On underrun, hold the last frame.
+			const s16 *last = srcResampler.LastFrame();
+			for (int f = produced; f < hwBlockSize; f++) {
+				srcBuffer[f * 2] = last[0];
+				srcBuffer[f * 2 + 1] = last[1];
 			}
 
 			buf1 = srcBuffer.data();
@@ -399,29 +397,9 @@ void __AudioUpdate(bool resetRecording) {
 			sz2 = 0;
 		}
 
-		if (firstChannel) {
-			for (size_t s = 0; s < sz1; s++)
-				mixBuffer[s] = buf1[s];
-			if (buf2) {
-				for (size_t s = 0; s < sz2; s++)
-					mixBuffer[s + sz1] = buf2[s];
-			}
-			firstChannel = false;
-		} else {
-			// Surprisingly hard to SIMD efficiently on SSE2 due to lack of 16-to-32-bit sign extension. NEON should be straight-forward though, and SSE4.1 can do it nicely.
-			// Actually, the cmple/pack trick should work fine...
-			for (size_t s = 0; s < sz1; s++)
-				mixBuffer[s] += buf1[s];
-			if (buf2) {
-				for (size_t s = 0; s < sz2; s++)
-					mixBuffer[s + sz1] += buf2[s];
-			}
-		}
-	}
-
-	if (firstChannel) {
-		// Nothing was written above, let's memset.
-		memset(mixBuffer, 0, hwBlockSize * 2 * sizeof(s32));
+		MixS16ToS32(mixBuffer, buf1, sz1);
+		if (buf2)
+			MixS16ToS32(mixBuffer + sz1, buf2, sz2);
 	}
 
 	if (g_Config.bEnableSound) {
@@ -451,9 +429,7 @@ void __AudioUpdate(bool resetRecording) {
 			}
 		} else {
 			if (g_Config.bDumpAudio) {
-				for (int i = 0; i < hwBlockSize * 2; i++) {
-					clampedMixBuffer[i] = clamp_s16(mixBuffer[i]);
-				}
+				ClampS32ToS16(clampedMixBuffer, mixBuffer, hwBlockSize * 2);
 				g_wave_writer.AddStereoSamples(clampedMixBuffer, hwBlockSize);
 			} else {
 				__StopLogAudio();
@@ -387,6 +387,7 @@ static u32 sceAudioOutput2Release() {
 
 	chan.reset();
 	chan.reserved = false;
+	__AudioReleaseSRC();
 	return hleLogSuccessI(SCEAUDIO, 0);
 }
 
@@ -448,6 +449,7 @@ static u32 sceAudioSRCChRelease() {
 
 	chan.reset();
 	chan.reserved = false;
+	__AudioReleaseSRC();
 	return hleLogSuccessI(SCEAUDIO, 0);
 }
 
@@ -39,6 +39,7 @@
 #include "Core/Host.h"
 #include "Core/Reporting.h"
 #include "Core/Core.h"
+#include "Core/FileSystems/BlockDevices.h"
 #include "Core/System.h"
 #include "Core/HLE/HLE.h"
 #include "Core/HLE/FunctionWrappers.h"
@@ -492,16 +493,19 @@ double *__DisplayGetFrameTimes(int *out_valid, int *out_pos, double **out_sleep)
 void __DisplayGetDebugStats(char *stats, size_t bufsize) {
 	char statbuf[4096];
 	gpu->GetStats(statbuf, sizeof(statbuf));
+	char discbuf[256];
+	PrefetchingBlockDevice::GetDebugStats(discbuf, sizeof(discbuf));
 
 	snprintf(stats, bufsize,
 		"Kernel processing time: %0.2f ms\n"
 		"Slowest syscall: %s : %0.2f ms\n"
-		"Most active syscall: %s : %0.2f ms\n%s",
+		"Most active syscall: %s : %0.2f ms\n%s%s",
 		kernelStats.msInSyscalls * 1000.0f,
 		kernelStats.slowestSyscallName ? kernelStats.slowestSyscallName : "(none)",
 		kernelStats.slowestSyscallTime * 1000.0f,
 		kernelStats.summedSlowestSyscallName ? kernelStats.summedSlowestSyscallName : "(none)",
 		kernelStats.summedSlowestSyscallTime * 1000.0f,
+		discbuf,
 		statbuf);
 }
 
@@ -69,6 +69,7 @@ static u32 sceVaudioChRelease() {
 		chans[PSP_AUDIO_CHANNEL_VAUDIO].reset();
 		chans[PSP_AUDIO_CHANNEL_VAUDIO].reserved = false;
 		vaudioReserved = false;
+		__AudioReleaseSRC();
 		return 0;
 	}
 }
@@ -16,19 +16,34 @@
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 
 #include "Common/Serialize/Serializer.h"
 #include "Common/Serialize/SerializeFuncs.h"
 #include "Common/Serialize/SerializeMap.h"
 #include "Common/Serialize/SerializeSet.h"
+#include "Common/Thread/ThreadManager.h"
 #include "Core/MIPS/MIPS.h"
 #include "Core/Reporting.h"
 #include "Core/System.h"
+#include "Core/ThreadPools.h"
 #include "Core/HW/AsyncIOManager.h"
 #include "Core/FileSystems/MetaFileSystem.h"
 
+class AsyncIOTask : public Task {
+public:
+	AsyncIOTask(std::function<void()> func) : func_(std::move(func)) {}
+	void Run() override {
+		func_();
+	}
+
+private:
+	std::function<void()> func_;
+};
+
 bool AsyncIOManager::HasOperation(u32 handle) {
+	std::lock_guard<std::mutex> guard(resultsLock_);
 	if (resultsPending_.find(handle) != resultsPending_.end()) {
 		return true;
 	}
@@ -45,9 +60,17 @@ void AsyncIOManager::ScheduleOperation(AsyncIOEvent ev) {
 			ERROR_LOG_REPORT(SCEIO, "Scheduling operation for file %d while one is pending (type %d)", ev.handle, ev.type);
 		}
 	}
+	ev.scheduledTicks = CoreTiming::GetTicks();
 	ScheduleEvent(ev);
 }
 
+void AsyncIOManager::SyncThread(bool force) {
+	IOThreadEventQueue::SyncThread(force);
+
+	std::unique_lock<std::mutex> guard(resultsLock_);
+	resultsWait_.wait(guard, [&] { return workers_ == 0; });
+}
+
 void AsyncIOManager::Shutdown() {
 	std::lock_guard<std::mutex> guard(resultsLock_);
 	resultsPending_.clear();
@@ -86,7 +109,7 @@ bool AsyncIOManager::ReadResult(u32 handle, AsyncIOResult &result) {
 bool AsyncIOManager::WaitResult(u32 handle, AsyncIOResult &result) {
 	std::unique_lock<std::mutex> guard(resultsLock_);
 	ScheduleEvent(IO_EVENT_SYNC);
-	while (HasEvents() && ThreadEnabled() && resultsPending_.find(handle) != resultsPending_.end()) {
+	while ((HasEvents() || workers_ != 0) && ThreadEnabled() && resultsPending_.find(handle) != resultsPending_.end()) {
 		if (PopResult(handle, result)) {
 			return true;
 		}
@@ -100,7 +123,7 @@ u64 AsyncIOManager::ResultFinishTicks(u32 handle) {
 
 	std::unique_lock<std::mutex> guard(resultsLock_);
 	ScheduleEvent(IO_EVENT_SYNC);
-	while (HasEvents() && ThreadEnabled() && resultsPending_.find(handle) != resultsPending_.end()) {
+	while ((HasEvents() || workers_ != 0) && ThreadEnabled() && resultsPending_.find(handle) != resultsPending_.end()) {
 		if (ReadResult(handle, result)) {
 			return result.finishTicks;
 		}
@@ -114,13 +137,52 @@ u64 AsyncIOManager::ResultFinishTicks(u32 handle) {
 }
 
 void AsyncIOManager::ProcessEvent(AsyncIOEvent ev) {
+	if (!ThreadEnabled() || g_threadManager.GetNumLooperThreads() == 0) {
+		RunOperation(ev);
+		return;
+	}
+
+	uintptr_t device = pspFileSystem.GetHandleDeviceKey(ev.handle);
+	std::unique_lock<std::mutex> guard(resultsLock_);
+	auto it = deviceQueues_.find(device);
+	if (it != deviceQueues_.end()) {
+		// That device's worker will get to it, in order.
+		it->second.push_back(ev);
+		return;
+	}
+
+	resultsWait_.wait(guard, [&] { return workers_ < MAX_WORKERS; });
+	deviceQueues_[device].push_back(ev);
+	workers_++;
+	g_threadManager.EnqueueTask(new AsyncIOTask([this, device] {
+		RunDeviceQueue(device);
+	}), TaskType::IO_BLOCKING);
+}
+
+void AsyncIOManager::RunDeviceQueue(uintptr_t device) {
+	std::unique_lock<std::mutex> guard(resultsLock_);
+	std::deque<AsyncIOEvent> &queue = deviceQueues_[device];
+	while (!queue.empty()) {
+		AsyncIOEvent ev = queue.front();
+		guard.unlock();
+		RunOperation(ev);
+		guard.lock();
+		queue.pop_front();
+	}
+
+	deviceQueues_.erase(device);
+	workers_--;
+	resultsWait_.notify_all();
+}
+
+void AsyncIOManager::RunOperation(const AsyncIOEvent &ev) {
 	switch (ev.type) {
 	case IO_EVENT_READ:
-		Read(ev.handle, ev.buf, ev.bytes, ev.invalidateAddr);
+		Read(ev.handle, ev.buf, ev.bytes, ev.invalidateAddr, ev.scheduledTicks);
 		break;
 
 	case IO_EVENT_WRITE:
-		Write(ev.handle, ev.buf, ev.bytes);
+		Write(ev.handle, ev.buf, ev.bytes, ev.scheduledTicks);
 		break;
 
 	default:
@@ -128,16 +190,16 @@ void AsyncIOManager::ProcessEvent(AsyncIOEvent ev) {
 	}
 }
 
-void AsyncIOManager::Read(u32 handle, u8 *buf, size_t bytes, u32 invalidateAddr) {
+void AsyncIOManager::Read(u32 handle, u8 *buf, size_t bytes, u32 invalidateAddr, u64 scheduledTicks) {
 	int usec = 0;
 	s64 result = pspFileSystem.ReadFile(handle, buf, bytes, usec);
-	EventResult(handle, AsyncIOResult(result, usec, invalidateAddr));
+	EventResult(handle, AsyncIOResult(result, scheduledTicks, usec, invalidateAddr));
 }
 
-void AsyncIOManager::Write(u32 handle, u8 *buf, size_t bytes) {
+void AsyncIOManager::Write(u32 handle, u8 *buf, size_t bytes, u64 scheduledTicks) {
 	int usec = 0;
 	s64 result = pspFileSystem.WriteFile(handle, buf, bytes, usec);
-	EventResult(handle, AsyncIOResult(result, usec));
+	EventResult(handle, AsyncIOResult(result, scheduledTicks, usec, 0));
 }
 
 void AsyncIOManager::EventResult(u32 handle, AsyncIOResult result) {
@@ -146,7 +208,7 @@ void AsyncIOManager::EventResult(u32 handle, AsyncIOResult result) {
 		ERROR_LOG_REPORT(SCEIO, "Overwriting previous result for file action on handle %d", handle);
 	}
 	results_[handle] = result;
-	resultsWait_.notify_one();
+	resultsWait_.notify_all();
 }
 
 void AsyncIOManager::DoState(PointerWrap &p) {
@@ -15,6 +15,7 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <deque>
 #include <map>
 #include <set>
 #include <mutex>
@@ -39,6 +40,8 @@ struct AsyncIOEvent {
 	u8 *buf;
 	size_t bytes;
 	u32 invalidateAddr;
+	// Set by ScheduleOperation(), so the finish time doesn't depend on when a worker got to it.
+	u64 scheduledTicks = 0;
 
 	operator AsyncIOEventType() const {
 		return type;
@@ -56,6 +59,10 @@ struct AsyncIOResult {
 		finishTicks = CoreTiming::GetTicks() + usToCycles(usec);
 	}
 
+	AsyncIOResult(s64 r, u64 startTicks, int usec, u32 addr) : result(r), invalidateAddr(addr) {
+		finishTicks = startTicks + usToCycles(usec);
+	}
+
 	void DoState(PointerWrap &p) {
 		auto s = p.Section("AsyncIOResult", 1, 2);
 		if (!s)
@@ -76,6 +83,11 @@ struct AsyncIOResult {
 };
 
 typedef ThreadEventQueue<NoBase, AsyncIOEvent, AsyncIOEventType, IO_EVENT_INVALID, IO_EVENT_SYNC, IO_EVENT_FINISH> IOThreadEventQueue;
+
+// With the IO thread enabled, operations run on ThreadManager I/O workers, so reads on
+// different devices (say the UMD and the memory stick) overlap.  Operations on the same
+// device still run one at a time in the order they were scheduled, which keeps the
+// filesystems' timing estimates the same as running them in sequence.
 class AsyncIOManager : public IOThreadEventQueue {
 public:
 	void DoState(PointerWrap &p);
@@ -84,6 +96,9 @@ class AsyncIOManager : public IOThreadEventQueue {
 	void ScheduleOperation(AsyncIOEvent ev);
 	void Shutdown();
 
+	// Also waits for operations already handed to workers.
+	void SyncThread(bool force = false);
+
 	bool HasResult(u32 handle);
 	bool WaitResult(u32 handle, AsyncIOResult &result);
 	u64 ResultFinishTicks(u32 handle);
@@ -95,10 +110,17 @@ class AsyncIOManager : public IOThreadEventQueue {
 	}
 
 private:
+	enum {
+		// Devices worked on at once, beyond that the event thread waits for a worker.
+		MAX_WORKERS = 4,
+	};
+
 	bool PopResult(u32 handle, AsyncIOResult &result);
 	bool ReadResult(u32 handle, AsyncIOResult &result);
-	void Read(u32 handle, u8 *buf, size_t bytes, u32 invalidateAddr);
-	void Write(u32 handle, u8 *buf, size_t bytes);
+	void RunOperation(const AsyncIOEvent &ev);
+	void RunDeviceQueue(uintptr_t device);
+	void Read(u32 handle, u8 *buf, size_t bytes, u32 invalidateAddr, u64 scheduledTicks);
+	void Write(u32 handle, u8 *buf, size_t bytes, u64 scheduledTicks);
 
 	void EventResult(u32 handle, AsyncIOResult result);
 
@@ -106,4 +128,8 @@ class AsyncIOManager : public IOThreadEventQueue {
 	std::condition_variable resultsWait_;
 	std::set<u32> resultsPending_;
 	std::map<u32, AsyncIOResult> results_;
+
+	// Operations waiting for their device, per device.  A device with an entry has a worker.
+	std::map<uintptr_t, std::deque<AsyncIOEvent>> deviceQueues_;
+	int workers_ = 0;
 };
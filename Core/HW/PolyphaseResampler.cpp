@@ -0,0 +1,178 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include "ppsspp_config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "Core/HW/PolyphaseResampler.h"
+#include "Core/Util/AudioFormat.h"
+
+#ifdef _M_SSE
+#include <emmintrin.h>
+#endif
+#if PPSSPP_ARCH(ARM_NEON)
+#if defined(_MSC_VER) && PPSSPP_ARCH(ARM64)
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
+// Output frame n is between taps HISTORY and HISTORY + 1 of its window.
+static const int HISTORY = PolyphaseResampler::TAPS / 2 - 1;
+static const int FILTER_SHIFT = 14;
+
+// Full bandwidth, in 1/1024 of the input rate.
+static const int MAX_CUTOFF = 512;
+
+PolyphaseResampler::PolyphaseResampler() {
+	Clear();
+	BuildFilter(MAX_CUTOFF);
+}
+
+void PolyphaseResampler::SetRatio(u32 ratio) {
+	ratio_ = std::max(ratio, 1U);
+	// When downsampling, cut what the output rate can't hold.
+	int cutoff = ratio_ <= 0x10000 ? MAX_CUTOFF : (int)(((u64)MAX_CUTOFF << 16) / ratio_);
+	// The ratio drifts a little all the time, only rebuild when the cutoff moved by over 1/32.
+	if (std::abs(cutoff - cutoff_) * 32 > cutoff_)
+		BuildFilter(cutoff);
+}
+
+void PolyphaseResampler::BuildFilter(int cutoff) {
+	cutoff_ = cutoff;
+	const double fc = cutoff / 1024.0;
+	const double pi = 3.14159265358979323846;
+	for (int p = 0; p < PHASES; ++p) {
+		const double phase = (double)p / PHASES;
+		double taps[TAPS];
+		double sum = 0.0;
+		for (int t = 0; t < TAPS; ++t) {
+			const double d = t - HISTORY - phase;
+			const double x = 2.0 * fc * d;
+			const double sinc = x == 0.0 ? 1.0 : sin(pi * x) / (pi * x);
+			// Blackman, reaching zero half the filter length away.
+			const double w = 0.42 + 0.5 * cos(pi * d / (TAPS / 2)) + 0.08 * cos(2.0 * pi * d / (TAPS / 2));
+			taps[t] = sinc * std::max(w, 0.0);
+			sum += taps[t];
+		}
+
+		// Each phase has exactly unity gain, put the rounding error on the largest tap.
+		int total = 0;
+		int largest = 0;
+		for (int t = 0; t < TAPS; ++t) {
+			filter_[p][t] = (s16)lrint(taps[t] / sum * (1 << FILTER_SHIFT));
+			total += filter_[p][t];
+			if (filter_[p][t] > filter_[p][largest])
+				largest = t;
+		}
+		filter_[p][largest] += (s16)((1 << FILTER_SHIFT) - total);
+	}
+}
+
+void PolyphaseResampler::Push(const s16 *samples, int numFrames) {
+	buffer_.insert(buffer_.end(), samples, samples + numFrames * 2);
+}
+
+static inline void FilterFrame(s16 *out, const s16 *window, const s16 *coefs) {
+#ifdef _M_SSE
+	const __m128i c = _mm_loadu_si128((const __m128i *)coefs);
+	// c0 c1 c0 c1 c2 c3 c2 c3, and the same for 4-7.
+	const __m128i c03 = _mm_unpacklo_epi32(c, c);
+	const __m128i c47 = _mm_unpackhi_epi32(c, c);
+	__m128i f03 = _mm_loadu_si128((const __m128i *)window);
+	__m128i f47 = _mm_loadu_si128((const __m128i *)(window + 8));
+	// From LRLR to LLRR in each pair of frames, so that madd sums within a channel.
+	f03 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(f03, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+	f47 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(f47, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+	__m128i sum = _mm_add_epi32(_mm_madd_epi16(f03, c03), _mm_madd_epi16(f47, c47));
+	sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+	sum = _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(1 << (FILTER_SHIFT - 1))), FILTER_SHIFT);
+	const u32 packed = (u32)_mm_cvtsi128_si32(_mm_packs_epi32(sum, sum));
+	memcpy(out, &packed, sizeof(packed));
+#elif PPSSPP_ARCH(ARM_NEON)
+	const int16x8x2_t frames = vld2q_s16(window);
+	const int16x8_t c = vld1q_s16(coefs);
+	int32x4_t l = vmull_s16(vget_low_s16(frames.val[0]), vget_low_s16(c));
+	l = vmlal_s16(l, vget_high_s16(frames.val[0]), vget_high_s16(c));
+	int32x4_t r = vmull_s16(vget_low_s16(frames.val[1]), vget_low_s16(c));
+	r = vmlal_s16(r, vget_high_s16(frames.val[1]), vget_high_s16(c));
+	const int32x2_t lr = vpadd_s32(vadd_s32(vget_low_s32(l), vget_high_s32(l)), vadd_s32(vget_low_s32(r), vget_high_s32(r)));
+	const int16x4_t packed = vqrshrn_n_s32(vcombine_s32(lr, lr), FILTER_SHIFT);
+	out[0] = vget_lane_s16(packed, 0);
+	out[1] = vget_lane_s16(packed, 1);
+#else
+	int l = 0, r = 0;
+	for (int t = 0; t < PolyphaseResampler::TAPS; ++t) {
+		l += window[t * 2] * coefs[t];
+		r += window[t * 2 + 1] * coefs[t];
+	}
+	out[0] = clamp_s16((l + (1 << (FILTER_SHIFT - 1))) >> FILTER_SHIFT);
+	out[1] = clamp_s16((r + (1 << (FILTER_SHIFT - 1))) >> FILTER_SHIFT);
+#endif
+}
+
+int PolyphaseResampler::Resample(s16 *out, int numFrames) {
+	const size_t frames = buffer_.size() / 2;
+	u32 frac = frac_;
+	size_t readPos = readPos_;
+	int produced = 0;
+	while (produced < numFrames && readPos + TAPS <= frames) {
+		FilterFrame(out + produced * 2, &buffer_[readPos * 2], filter_[(frac * PHASES) >> 16]);
+		++produced;
+		frac += ratio_;
+		readPos += frac >> 16;
+		frac &= 0xFFFF;
+	}
+	frac_ = frac;
+
+	if (produced > 0) {
+		lastFrame_[0] = out[produced * 2 - 2];
+		lastFrame_[1] = out[produced * 2 - 1];
+	}
+
+	// Drop the frames that are behind the window now.
+	const size_t drop = std::min(readPos, frames);
+	buffer_.erase(buffer_.begin(), buffer_.begin() + drop * 2);
+	readPos_ = readPos - drop;
+	return produced;
+}
+
+int PolyphaseResampler::InputNeeded(int numFrames) const {
+	if (numFrames <= 0)
+		return 0;
+	const u64 lastPos = readPos_ + (((u64)frac_ + (u64)(numFrames - 1) * ratio_) >> 16);
+	const s64 needed = (s64)(lastPos + TAPS) - (s64)(buffer_.size() / 2);
+	return needed > 0 ? (int)needed : 0;
+}
+
+int PolyphaseResampler::BufferedFrames() const {
+	const s64 left = (s64)(buffer_.size() / 2) - (s64)(readPos_ + HISTORY);
+	return left > 0 ? (int)left : 0;
+}
+
+void PolyphaseResampler::Clear() {
+	// Start on the first pushed frame, with silence before it.
+	buffer_.assign(HISTORY * 2, 0);
+	readPos_ = 0;
+	frac_ = 0;
+	lastFrame_[0] = 0;
+	lastFrame_[1] = 0;
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Resamples 16-bit stereo with a windowed sinc, one filter phase per 1/256 of an input frame.
+// Input is pushed as it comes and the position between input frames is kept, so the output
+// is continuous no matter how the stream is split into blocks.  Not thread safe.
+class PolyphaseResampler {
+public:
+	enum {
+		TAPS = 8,
+		PHASES = 256,
+	};
+
+	PolyphaseResampler();
+
+	// Input frames per output frame, in 16.16.  When downsampling this also lowers the cutoff.
+	void SetRatio(u32 ratio);
+	u32 Ratio() const { return ratio_; }
+
+	void Push(const s16 *samples, int numFrames);
+	// Returns how many of numFrames it produced before running out of input.
+	int Resample(s16 *out, int numFrames);
+
+	// How many more input frames Resample() needs to produce numFrames.
+	int InputNeeded(int numFrames) const;
+	// Input frames not yet passed.
+	int BufferedFrames() const;
+	// The last frame Resample() produced, for padding on underruns.
+	const s16 *LastFrame() const { return lastFrame_; }
+
+	void Clear();
+
+private:
+	void BuildFilter(int cutoff);
+
+	// Interleaved stereo.  Frame readPos_ is the first tap of the next output frame.
+	std::vector<s16> buffer_;
+	size_t readPos_ = 0;
+	u32 frac_ = 0;
+	u32 ratio_ = 0x10000;
+	s16 lastFrame_[2]{};
+
+	// In 1/1024 of the input rate, what the current filter was built for.
+	int cutoff_ = 0;
+	// Q14, TAPS per phase.
+	alignas(16) s16 filter_[PHASES][TAPS];
+};
@@ -160,10 +160,8 @@ inline void ClampBufferToS16WithVolume(s16 *out, const s32 *in, size_t size) {
 
 void StereoResampler::Clear() {
 	memset(m_buffer, 0, m_maxBufsize * 2 * sizeof(int16_t));
-}
-
-inline int16_t MixSingleSample(int16_t s1, int16_t s2, uint16_t frac) {
-	return s1 + (((s2 - s1) * frac) >> 16);
+	// The filter belongs to the audio thread, it clears it on the next Mix().
+	resetFilter_ = true;
 }
 
 // Executed from sound stream thread, pulling sound out of the buffer.
@@ -188,8 +186,8 @@ unsigned int StereoResampler::Mix(short* samples, unsigned int numSamples, bool
 	// This is only for debug visualization, not used for anything.
 	lastBufSize_ = ((indexW - indexR) & INDEX_MASK) / 2;
 
-	// Drift prevention mechanism.
-	float numLeft = (float)(((indexW - indexR) & INDEX_MASK) / 2);
+	// Drift prevention mechanism.  What's already in the filter counts too.
+	float numLeft = (float)(((indexW - indexR) & INDEX_MASK) / 2 + filter_.BufferedFrames());
 	// If we had to discard samples the last frame due to underrun,
 	// apply an adjustment here. Otherwise we'll overestimate how many
 	// samples we need.
@@ -211,40 +209,36 @@ unsigned int StereoResampler::Mix(short* samples, unsigned int numSamples, bool
 	output_sample_rate_ = (float)(m_input_sample_rate + offset);
 	const u32 ratio = (u32)(65536.0 * output_sample_rate_ / (double)sample_rate);
 	ratio_ = ratio;
-	// TODO: consider a higher-quality resampling algorithm.
-	// TODO: Add a fast path for 1:1.
-	u32 frac = m_frac;
-	for (currentSample = 0; currentSample < numSamples * 2; currentSample += 2) {
-		if (((indexW - indexR) & INDEX_MASK) <= 2) {
-			// Ran out!
-			// int missing = numSamples * 2 - currentSample;
-			// ILOG("Resampler underrun: %d (numSamples: %d, currentSample: %d)", missing, numSamples, currentSample / 2);
-			underrunCount_++;
-			break;
-		}
-		u32 indexR2 = indexR + 2; //next sample
-		s16 l1 = m_buffer[indexR & INDEX_MASK]; //current
-		s16 r1 = m_buffer[(indexR + 1) & INDEX_MASK]; //current
-		s16 l2 = m_buffer[indexR2 & INDEX_MASK]; //next
-		s16 r2 = m_buffer[(indexR2 + 1) & INDEX_MASK]; //next
-		samples[currentSample] = MixSingleSample(l1, l2, (u16)frac);
-		samples[currentSample + 1] = MixSingleSample(r1, r2, (u16)frac);
-		frac += ratio;
-		indexR += 2 * (frac >> 16);
-		frac &= 0xffff;
+
+	if (resetFilter_.exchange(false))
+		filter_.Clear();
+	filter_.SetRatio(ratio);
+
+	// Only give the filter what this call needs, the rest waits in m_buffer where the drift
+	// control above sees it.
+	int toPush = std::min(filter_.InputNeeded(numSamples), (int)(((indexW - indexR) & INDEX_MASK) / 2));
+	while (toPush > 0) {
+		const u32 start = indexR & INDEX_MASK;
+		const int frames = std::min(toPush, (int)(m_maxBufsize * 2 - start) / 2);
+		filter_.Push(&m_buffer[start], frames);
+		indexR += frames * 2;
+		toPush -= frames;
+	}
+
+	currentSample = filter_.Resample(samples, numSamples) * 2;
+	if (currentSample < numSamples * 2) {
+		// Ran out!
+		underrunCount_++;
 	}
-	m_frac = frac;
 
 	// Let's not count the underrun padding here.
 	outputSampleCount_ += currentSample / 2;
 
 	// Padding with the last value to reduce clicking
-	short s[2];
-	s[0] = clamp_s16(m_buffer[(indexR - 1) & INDEX_MASK]);
-	s[1] = clamp_s16(m_buffer[(indexR - 2) & INDEX_MASK]);
+	const s16 *last = filter_.LastFrame();
 	for (; currentSample < numSamples * 2; currentSample += 2) {
-		samples[currentSample] = s[0];
-		samples[currentSample + 1] = s[1];
+		samples[currentSample] = last[0];
+		samples[currentSample + 1] = last[1];
 	}
 
 	// Flush cached variable
@@ -24,6 +24,7 @@
 
 #include "Common/Serialize/Serializer.h"
 #include "Common/CommonTypes.h"
+#include "Core/HW/PolyphaseResampler.h"
 
 struct AudioDebugStats;
 
@@ -58,7 +59,10 @@ class StereoResampler {
 	std::atomic<u32> m_indexR;
 	float m_numLeftI = 0.0f;
 
-	u32 m_frac = 0;
+	// Only touched by Mix(), on the audio thread.
+	PolyphaseResampler filter_;
+	std::atomic<bool> resetFilter_{ false };
+
 	float output_sample_rate_ = 0.0;
 	int lastBufSize_ = 0;
 	int lastPushSize_ = 0;
@@ -91,7 +91,7 @@ IdentifiedFileType Identify_File(FileLoader *fileLoader, std::string *errorStrin
 			// maybe it also just happened to have that size, let's assume it's a PSP ISO and error out later if it's not.
 		}
 		return IdentifiedFileType::PSP_ISO;
-	} else if (extension == ".cso") {
+	} else if (extension == ".cso" || extension == ".zcso") {
 		return IdentifiedFileType::PSP_ISO;
 	} else if (extension == ".ppst") {
 		return IdentifiedFileType::PPSSPP_SAVESTATE;
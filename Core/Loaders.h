@@ -82,6 +82,12 @@ class FileLoader {
 		return ReadAt(absolutePos, 1, bytes, data, flags);
 	}
 
+	// Direct read only access to the data, valid as long as the loader.  Only possible when
+	// the file is memory mapped, otherwise (or when out of range) nullptr.
+	virtual const u8 *GetView(s64 absolutePos, size_t bytes) {
+		return nullptr;
+	}
+
 	// Cancel any operations that might block, if possible.
 	virtual void Cancel() {}
 
@@ -128,6 +134,9 @@ class ProxiedFileLoader : public FileLoader {
 	size_t ReadAt(s64 absolutePos, size_t bytes, void *data, Flags flags = Flags::NONE) override {
 		return backend_->ReadAt(absolutePos, bytes, data, flags);
 	}
+	const u8 *GetView(s64 absolutePos, size_t bytes) override {
+		return backend_->GetView(absolutePos, bytes);
+	}
 
 protected:
 	FileLoader *backend_;
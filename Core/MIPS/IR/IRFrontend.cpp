@@ -221,7 +221,7 @@ MIPSOpcode IRFrontend::GetOffsetInstruction(int offset) {
 	return Memory::Read_Instruction(GetCompilerPC() + 4 * offset);
 }
 
-void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes, bool preload) {
+void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes, bool preload, bool simplify) {
 	js.cancel = false;
 	js.preloading = preload;
 	js.blockStart = em_address;
@@ -258,17 +258,8 @@ void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &m
 
 	IRWriter simplified;
 	IRWriter *code = &ir;
-	if (!js.hadBreakpoints) {
-		static const IRPassFunc passes[] = {
-			&RemoveLoadStoreLeftRight,
-			&OptimizeFPMoves,
-			&PropagateConstants,
-			&PurgeTemps,
-			// &ReorderLoadStore,
-			// &MergeLoadStore,
-			// &ThreeOpToTwoOp,
-		};
-		if (IRApplyPasses(passes, ARRAY_SIZE(passes), ir, simplified, opts))
+	if (!js.hadBreakpoints && simplify) {
+		if (SimplifyBlock(ir, simplified, opts))
 			logBlocks = 1;
 		code = &simplified;
 		//if (ir.GetInstructions().size() >= 24)
@@ -313,6 +304,20 @@ void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &m
 		dontLogBlocks--;
 }
 
+bool IRFrontend::SimplifyBlock(const IRWriter &in, IRWriter &out, const IROptions &opts) {
+	static const IRPassFunc passes[] = {
+		&RemoveLoadStoreLeftRight,
+		&OptimizeFPMoves,
+		&PropagateConstants,
+		&PurgeTemps,
+		&RemoveDeadWrites,
+		// &ReorderLoadStore,
+		// &MergeLoadStore,
+		// &ThreeOpToTwoOp,
+	};
+	return IRApplyPasses(passes, ARRAY_SIZE(passes), in, out, opts);
+}
+
 void IRFrontend::Comp_RunBlock(MIPSOpcode op) {
 	// This shouldn't be necessary, the dispatcher should catch us before we get here.
 	ERROR_LOG(JIT, "Comp_RunBlock should never be reached!");
@@ -88,7 +88,10 @@ class IRFrontend : public MIPSFrontendInterface {
 	void DoState(PointerWrap &p);
 	bool CheckRounding(u32 blockAddress);  // returns true if we need a do-over
 
-	void DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes, bool preload);
+	// Without simplify, the raw IR is returned and SimplifyBlock() can be run on it later.
+	void DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes, bool preload, bool simplify = true);
+	// The standard pass list.  Only touches the IR, so it's safe to run on another thread.
+	static bool SimplifyBlock(const IRWriter &in, IRWriter &out, const IROptions &opts);
 
 	void EatPrefix() override {
 		js.EatPrefix();
@@ -97,6 +100,9 @@ class IRFrontend : public MIPSFrontendInterface {
 	void SetOptions(const IROptions &o) {
 		opts = o;
 	}
+	const IROptions &GetOptions() const {
+		return opts;
+	}
 
 private:
 	void RestoreRoundingMode(bool force = false);
@@ -1008,3 +1008,375 @@ u32 IRInterpret(MIPSState *mips, const IRInst *inst, int count) {
 	Crash();
 	return 0;
 }
+
+// Threaded mode.  Only the common ops get their own handler, the rest go through IRInterpret
+// one at a time, so both modes always agree.
+
+#define IR_THREADED_HANDLER(name) static const IRThreadedInst *name(MIPSState *mips, const IRThreadedInst *t, u32 *exitPC)
+
+IR_THREADED_HANDLER(ThreadedFallback) {
+	IRInst insts[2] = { t->inst, { IROp::ExitToConst, { 0 }, 0, 0, 0 } };
+	u32 pc = IRInterpret(mips, insts, 2);
+	if (pc != 0) {
+		*exitPC = pc;
+		return nullptr;
+	}
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedNop) {
+	return t + 1;
+}
+
+// Simple ops that just compute a GPR.
+#define IR_THREADED_GPR_OP(name, expr) \
+	IR_THREADED_HANDLER(Threaded##name) { \
+		const IRInst *inst = &t->inst; \
+		mips->r[inst->dest] = (expr); \
+		return t + 1; \
+	}
+
+IR_THREADED_GPR_OP(SetConst, inst->constant)
+IR_THREADED_GPR_OP(Mov, mips->r[inst->src1])
+IR_THREADED_GPR_OP(Add, mips->r[inst->src1] + mips->r[inst->src2])
+IR_THREADED_GPR_OP(Sub, mips->r[inst->src1] - mips->r[inst->src2])
+IR_THREADED_GPR_OP(And, mips->r[inst->src1] & mips->r[inst->src2])
+IR_THREADED_GPR_OP(Or, mips->r[inst->src1] | mips->r[inst->src2])
+IR_THREADED_GPR_OP(Xor, mips->r[inst->src1] ^ mips->r[inst->src2])
+IR_THREADED_GPR_OP(AddConst, mips->r[inst->src1] + inst->constant)
+IR_THREADED_GPR_OP(SubConst, mips->r[inst->src1] - inst->constant)
+IR_THREADED_GPR_OP(AndConst, mips->r[inst->src1] & inst->constant)
+IR_THREADED_GPR_OP(OrConst, mips->r[inst->src1] | inst->constant)
+IR_THREADED_GPR_OP(XorConst, mips->r[inst->src1] ^ inst->constant)
+IR_THREADED_GPR_OP(Neg, -(s32)mips->r[inst->src1])
+IR_THREADED_GPR_OP(Not, ~mips->r[inst->src1])
+IR_THREADED_GPR_OP(Ext8to32, SignExtend8ToU32(mips->r[inst->src1]))
+IR_THREADED_GPR_OP(Ext16to32, SignExtend16ToU32(mips->r[inst->src1]))
+IR_THREADED_GPR_OP(ShlImm, mips->r[inst->src1] << (int)inst->src2)
+IR_THREADED_GPR_OP(ShrImm, mips->r[inst->src1] >> (int)inst->src2)
+IR_THREADED_GPR_OP(SarImm, (s32)mips->r[inst->src1] >> (int)inst->src2)
+IR_THREADED_GPR_OP(Shl, mips->r[inst->src1] << (mips->r[inst->src2] & 31))
+IR_THREADED_GPR_OP(Shr, mips->r[inst->src1] >> (mips->r[inst->src2] & 31))
+IR_THREADED_GPR_OP(Sar, (s32)mips->r[inst->src1] >> (mips->r[inst->src2] & 31))
+IR_THREADED_GPR_OP(Slt, (s32)mips->r[inst->src1] < (s32)mips->r[inst->src2])
+IR_THREADED_GPR_OP(SltU, mips->r[inst->src1] < mips->r[inst->src2])
+IR_THREADED_GPR_OP(SltConst, (s32)mips->r[inst->src1] < (s32)inst->constant)
+IR_THREADED_GPR_OP(SltUConst, mips->r[inst->src1] < inst->constant)
+IR_THREADED_GPR_OP(Clz, clz32(mips->r[inst->src1]))
+IR_THREADED_GPR_OP(Max, (s32)mips->r[inst->src1] > (s32)mips->r[inst->src2] ? mips->r[inst->src1] : mips->r[inst->src2])
+IR_THREADED_GPR_OP(Min, (s32)mips->r[inst->src1] < (s32)mips->r[inst->src2] ? mips->r[inst->src1] : mips->r[inst->src2])
+IR_THREADED_GPR_OP(MfLo, mips->lo)
+IR_THREADED_GPR_OP(MfHi, mips->hi)
+IR_THREADED_GPR_OP(Load8, Memory::ReadUnchecked_U8(mips->r[inst->src1] + inst->constant))
+IR_THREADED_GPR_OP(Load8Ext, SignExtend8ToU32(Memory::ReadUnchecked_U8(mips->r[inst->src1] + inst->constant)))
+IR_THREADED_GPR_OP(Load16, Memory::ReadUnchecked_U16(mips->r[inst->src1] + inst->constant))
+IR_THREADED_GPR_OP(Load16Ext, SignExtend16ToU32(Memory::ReadUnchecked_U16(mips->r[inst->src1] + inst->constant)))
+IR_THREADED_GPR_OP(Load32, Memory::ReadUnchecked_U32(mips->r[inst->src1] + inst->constant))
+IR_THREADED_GPR_OP(FpCondToReg, mips->fpcond)
+IR_THREADED_GPR_OP(FMovToGPR, mips->fi[inst->src1])
+
+IR_THREADED_HANDLER(ThreadedRorImm) {
+	const IRInst *inst = &t->inst;
+	u32 x = mips->r[inst->src1];
+	int sa = inst->src2;
+	mips->r[inst->dest] = (x >> sa) | (x << (32 - sa));
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedMovZ) {
+	const IRInst *inst = &t->inst;
+	if (mips->r[inst->src1] == 0)
+		mips->r[inst->dest] = mips->r[inst->src2];
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedMovNZ) {
+	const IRInst *inst = &t->inst;
+	if (mips->r[inst->src1] != 0)
+		mips->r[inst->dest] = mips->r[inst->src2];
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedMtLo) {
+	mips->lo = mips->r[t->inst.src1];
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedMtHi) {
+	mips->hi = mips->r[t->inst.src1];
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedMult) {
+	const IRInst *inst = &t->inst;
+	s64 result = (s64)(s32)mips->r[inst->src1] * (s64)(s32)mips->r[inst->src2];
+	memcpy(&mips->lo, &result, 8);
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedMultU) {
+	const IRInst *inst = &t->inst;
+	u64 result = (u64)mips->r[inst->src1] * (u64)mips->r[inst->src2];
+	memcpy(&mips->lo, &result, 8);
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedStore8) {
+	const IRInst *inst = &t->inst;
+	Memory::WriteUnchecked_U8(mips->r[inst->src3], mips->r[inst->src1] + inst->constant);
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedStore16) {
+	const IRInst *inst = &t->inst;
+	Memory::WriteUnchecked_U16(mips->r[inst->src3], mips->r[inst->src1] + inst->constant);
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedStore32) {
+	const IRInst *inst = &t->inst;
+	Memory::WriteUnchecked_U32(mips->r[inst->src3], mips->r[inst->src1] + inst->constant);
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedLoadFloat) {
+	const IRInst *inst = &t->inst;
+	mips->f[inst->dest] = Memory::ReadUnchecked_Float(mips->r[inst->src1] + inst->constant);
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedStoreFloat) {
+	const IRInst *inst = &t->inst;
+	Memory::WriteUnchecked_Float(mips->f[inst->src3], mips->r[inst->src1] + inst->constant);
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedSetConstF) {
+	memcpy(&mips->f[t->inst.dest], &t->inst.constant, 4);
+	return t + 1;
+}
+
+// Simple ops that just compute an FPR.
+#define IR_THREADED_FPR_OP(name, expr) \
+	IR_THREADED_HANDLER(Threaded##name) { \
+		const IRInst *inst = &t->inst; \
+		mips->f[inst->dest] = (expr); \
+		return t + 1; \
+	}
+
+IR_THREADED_FPR_OP(FAdd, mips->f[inst->src1] + mips->f[inst->src2])
+IR_THREADED_FPR_OP(FSub, mips->f[inst->src1] - mips->f[inst->src2])
+IR_THREADED_FPR_OP(FDiv, mips->f[inst->src1] / mips->f[inst->src2])
+IR_THREADED_FPR_OP(FMov, mips->f[inst->src1])
+IR_THREADED_FPR_OP(FAbs, fabsf(mips->f[inst->src1]))
+IR_THREADED_FPR_OP(FSqrt, sqrtf(mips->f[inst->src1]))
+IR_THREADED_FPR_OP(FNeg, -mips->f[inst->src1])
+IR_THREADED_FPR_OP(FCvtSW, (float)mips->fs[inst->src1])
+
+IR_THREADED_HANDLER(ThreadedFMul) {
+	const IRInst *inst = &t->inst;
+	if ((my_isinf(mips->f[inst->src1]) && mips->f[inst->src2] == 0.0f) || (my_isinf(mips->f[inst->src2]) && mips->f[inst->src1] == 0.0f)) {
+		mips->fi[inst->dest] = 0x7fc00000;
+	} else {
+		mips->f[inst->dest] = mips->f[inst->src1] * mips->f[inst->src2];
+	}
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedFMovFromGPR) {
+	memcpy(&mips->f[t->inst.dest], &mips->r[t->inst.src1], 4);
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedZeroFpCond) {
+	mips->fpcond = 0;
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedDowncount) {
+	mips->downcount -= t->inst.constant;
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedSetPC) {
+	mips->pc = mips->r[t->inst.src1];
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedSetPCConst) {
+	mips->pc = t->inst.constant;
+	return t + 1;
+}
+
+IR_THREADED_HANDLER(ThreadedExitToConst) {
+	*exitPC = t->inst.constant;
+	return nullptr;
+}
+
+IR_THREADED_HANDLER(ThreadedExitToReg) {
+	*exitPC = mips->r[t->inst.src1];
+	return nullptr;
+}
+
+IR_THREADED_HANDLER(ThreadedExitToPC) {
+	*exitPC = mips->pc;
+	return nullptr;
+}
+
+#define IR_THREADED_COND_EXIT(name, cond) \
+	IR_THREADED_HANDLER(Threaded##name) { \
+		const IRInst *inst = &t->inst; \
+		if (cond) { \
+			*exitPC = inst->constant; \
+			return nullptr; \
+		} \
+		return t + 1; \
+	}
+
+IR_THREADED_COND_EXIT(ExitToConstIfEq, mips->r[inst->src1] == mips->r[inst->src2])
+IR_THREADED_COND_EXIT(ExitToConstIfNeq, mips->r[inst->src1] != mips->r[inst->src2])
+IR_THREADED_COND_EXIT(ExitToConstIfGtZ, (s32)mips->r[inst->src1] > 0)
+IR_THREADED_COND_EXIT(ExitToConstIfGeZ, (s32)mips->r[inst->src1] >= 0)
+IR_THREADED_COND_EXIT(ExitToConstIfLtZ, (s32)mips->r[inst->src1] < 0)
+IR_THREADED_COND_EXIT(ExitToConstIfLeZ, (s32)mips->r[inst->src1] <= 0)
+
+// Fused pairs.  These run both ops exactly in order, they just save a dispatch.
+IR_THREADED_HANDLER(ThreadedAddConstLoad32) {
+	const IRInst *add = &t[0].inst;
+	const IRInst *load = &t[1].inst;
+	mips->r[add->dest] = mips->r[add->src1] + add->constant;
+	mips->r[load->dest] = Memory::ReadUnchecked_U32(mips->r[load->src1] + load->constant);
+	return t + 2;
+}
+
+IR_THREADED_HANDLER(ThreadedAddConstStore32) {
+	const IRInst *add = &t[0].inst;
+	const IRInst *store = &t[1].inst;
+	mips->r[add->dest] = mips->r[add->src1] + add->constant;
+	Memory::WriteUnchecked_U32(mips->r[store->src3], mips->r[store->src1] + store->constant);
+	return t + 2;
+}
+
+IR_THREADED_HANDLER(ThreadedDowncountExitToConst) {
+	mips->downcount -= t[0].inst.constant;
+	*exitPC = t[1].inst.constant;
+	return nullptr;
+}
+
+static IRThreadedHandler GetThreadedHandler(IROp op) {
+	switch (op) {
+	case IROp::RestoreRoundingMode:
+	case IROp::ApplyRoundingMode:
+	case IROp::UpdateRoundingMode:
+		return &ThreadedNop;
+	case IROp::SetConst: return &ThreadedSetConst;
+	case IROp::SetConstF: return &ThreadedSetConstF;
+	case IROp::Mov: return &ThreadedMov;
+	case IROp::Add: return &ThreadedAdd;
+	case IROp::Sub: return &ThreadedSub;
+	case IROp::And: return &ThreadedAnd;
+	case IROp::Or: return &ThreadedOr;
+	case IROp::Xor: return &ThreadedXor;
+	case IROp::AddConst: return &ThreadedAddConst;
+	case IROp::SubConst: return &ThreadedSubConst;
+	case IROp::AndConst: return &ThreadedAndConst;
+	case IROp::OrConst: return &ThreadedOrConst;
+	case IROp::XorConst: return &ThreadedXorConst;
+	case IROp::Neg: return &ThreadedNeg;
+	case IROp::Not: return &ThreadedNot;
+	case IROp::Ext8to32: return &ThreadedExt8to32;
+	case IROp::Ext16to32: return &ThreadedExt16to32;
+	case IROp::ShlImm: return &ThreadedShlImm;
+	case IROp::ShrImm: return &ThreadedShrImm;
+	case IROp::SarImm: return &ThreadedSarImm;
+	case IROp::RorImm: return &ThreadedRorImm;
+	case IROp::Shl: return &ThreadedShl;
+	case IROp::Shr: return &ThreadedShr;
+	case IROp::Sar: return &ThreadedSar;
+	case IROp::Slt: return &ThreadedSlt;
+	case IROp::SltU: return &ThreadedSltU;
+	case IROp::SltConst: return &ThreadedSltConst;
+	case IROp::SltUConst: return &ThreadedSltUConst;
+	case IROp::Clz: return &ThreadedClz;
+	case IROp::MovZ: return &ThreadedMovZ;
+	case IROp::MovNZ: return &ThreadedMovNZ;
+	case IROp::Max: return &ThreadedMax;
+	case IROp::Min: return &ThreadedMin;
+	case IROp::MtLo: return &ThreadedMtLo;
+	case IROp::MtHi: return &ThreadedMtHi;
+	case IROp::MfLo: return &ThreadedMfLo;
+	case IROp::MfHi: return &ThreadedMfHi;
+	case IROp::Mult: return &ThreadedMult;
+	case IROp::MultU: return &ThreadedMultU;
+	case IROp::Load8: return &ThreadedLoad8;
+	case IROp::Load8Ext: return &ThreadedLoad8Ext;
+	case IROp::Load16: return &ThreadedLoad16;
+	case IROp::Load16Ext: return &ThreadedLoad16Ext;
+	case IROp::Load32: return &ThreadedLoad32;
+	case IROp::LoadFloat: return &ThreadedLoadFloat;
+	case IROp::Store8: return &ThreadedStore8;
+	case IROp::Store16: return &ThreadedStore16;
+	case IROp::Store32: return &ThreadedStore32;
+	case IROp::StoreFloat: return &ThreadedStoreFloat;
+	case IROp::FAdd: return &ThreadedFAdd;
+	case IROp::FSub: return &ThreadedFSub;
+	case IROp::FMul: return &ThreadedFMul;
+	case IROp::FDiv: return &ThreadedFDiv;
+	case IROp::FMov: return &ThreadedFMov;
+	case IROp::FAbs: return &ThreadedFAbs;
+	case IROp::FSqrt: return &ThreadedFSqrt;
+	case IROp::FNeg: return &ThreadedFNeg;
+	case IROp::FCvtSW: return &ThreadedFCvtSW;
+	case IROp::FMovFromGPR: return &ThreadedFMovFromGPR;
+	case IROp::FMovToGPR: return &ThreadedFMovToGPR;
+	case IROp::FpCondToReg: return &ThreadedFpCondToReg;
+	case IROp::ZeroFpCond: return &ThreadedZeroFpCond;
+	case IROp::Downcount: return &ThreadedDowncount;
+	case IROp::SetPC: return &ThreadedSetPC;
+	case IROp::SetPCConst: return &ThreadedSetPCConst;
+	case IROp::ExitToConst: return &ThreadedExitToConst;
+	case IROp::ExitToReg: return &ThreadedExitToReg;
+	case IROp::ExitToPC: return &ThreadedExitToPC;
+	case IROp::ExitToConstIfEq: return &ThreadedExitToConstIfEq;
+	case IROp::ExitToConstIfNeq: return &ThreadedExitToConstIfNeq;
+	case IROp::ExitToConstIfGtZ: return &ThreadedExitToConstIfGtZ;
+	case IROp::ExitToConstIfGeZ: return &ThreadedExitToConstIfGeZ;
+	case IROp::ExitToConstIfLtZ: return &ThreadedExitToConstIfLtZ;
+	case IROp::ExitToConstIfLeZ: return &ThreadedExitToConstIfLeZ;
+	default:
+		return &ThreadedFallback;
+	}
+}
+
+static IRThreadedHandler GetFusedHandler(IROp first, IROp second) {
+	if (first == IROp::AddConst && second == IROp::Load32)
+		return &ThreadedAddConstLoad32;
+	if (first == IROp::AddConst && second == IROp::Store32)
+		return &ThreadedAddConstStore32;
+	if (first == IROp::Downcount && second == IROp::ExitToConst)
+		return &ThreadedDowncountExitToConst;
+	return nullptr;
+}
+
+void IRCompileThreaded(const IRInst *inst, int count, IRThreadedInst *out) {
+	for (int i = 0; i < count; ++i) {
+		out[i].inst = inst[i];
+		out[i].handler = GetThreadedHandler(inst[i].op);
+	}
+	// The second op keeps its own handler, it's just skipped over.
+	for (int i = 0; i + 1 < count; ++i) {
+		IRThreadedHandler fused = GetFusedHandler(inst[i].op, inst[i + 1].op);
+		if (fused) {
+			out[i].handler = fused;
+			++i;
+		}
+	}
+}
+
+u32 IRInterpretThreaded(MIPSState *mips, const IRThreadedInst *inst) {
+	u32 exitPC = 0;
+	while (inst) {
+		inst = inst->handler(mips, inst, &exitPC);
+	}
+	return exitPC;
+}
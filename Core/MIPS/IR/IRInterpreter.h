@@ -1,9 +1,9 @@
 #pragma once
 
 #include "Common/CommonTypes.h"
+#include "Core/MIPS/IR/IRInst.h"
 
 class MIPSState;
-struct IRInst;
 
 inline static u32 ReverseBits32(u32 v) {
 	// http://graphics.stanford.edu/~seander/bithacks.html#ReverseParallel
@@ -21,3 +21,19 @@ inline static u32 ReverseBits32(u32 v) {
 }
 
 u32 IRInterpret(MIPSState *ms, const IRInst *inst, int count);
+
+// Pre-decoded ("threaded") form of an IR block.  Each op carries a pointer to its handler,
+// so running it is an indirect call per op rather than a trip through the big switch.
+// Handlers return the next op to run, or nullptr after writing the new PC to exitPC.
+struct IRThreadedInst;
+typedef const IRThreadedInst *(*IRThreadedHandler)(MIPSState *mips, const IRThreadedInst *inst, u32 *exitPC);
+
+struct IRThreadedInst {
+	IRThreadedHandler handler;
+	IRInst inst;
+};
+
+// Fills out[0..count), common pairs of ops are fused into a single handler.
+void IRCompileThreaded(const IRInst *inst, int count, IRThreadedInst *out);
+// Returns the new PC, like IRInterpret.
+u32 IRInterpretThreaded(MIPSState *ms, const IRThreadedInst *inst);
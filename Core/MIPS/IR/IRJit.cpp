@@ -15,15 +15,19 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
 #include <set>
 
 #include "ext/xxhash.h"
 #include "Common/Profiler/Profiler.h"
 
 #include "Common/Log.h"
+#include "Common/File/FileUtil.h"
 #include "Common/Serialize/Serializer.h"
 #include "Common/StringUtils.h"
+#include "Common/Thread/ThreadManager.h"
 
+#include "Core/Config.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HLE/sceKernelMemory.h"
@@ -50,9 +54,12 @@ IRJit::IRJit(MIPSState *mipsState) : frontend_(mipsState->HasDefaultPrefix()), m
 	opts.disableFlags = g_Config.uJitDisableFlags;
 	opts.unalignedLoadStore = opts.disableFlags & (uint32_t)JitDisable::LSU_UNALIGNED;
 	frontend_.SetOptions(opts);
+	backgroundCompile_ = g_Config.bIRBackgroundCompile;
 }
 
 IRJit::~IRJit() {
+	// The tasks queue their results on us.
+	WaitForBackgroundCompiles();
 }
 
 void IRJit::DoState(PointerWrap &p) {
@@ -65,6 +72,9 @@ void IRJit::UpdateFCR31() {
 void IRJit::ClearCache() {
 	INFO_LOG(JIT, "IRJit: Clearing the cache!");
 	blocks_.Clear();
+	std::lock_guard<std::mutex> guard(backgroundLock_);
+	simplifiedBlocks_.clear();
+	cacheGeneration_++;
 }
 
 void IRJit::InvalidateCacheAt(u32 em_address, int length) {
@@ -74,7 +84,11 @@ void IRJit::InvalidateCacheAt(u32 em_address, int length) {
 void IRJit::Compile(u32 em_address) {
 	PROFILE_THIS_SCOPE("jitc");
 
-	if (g_Config.bPreloadFunctions) {
+	// Invalidation can happen mid-block (from a syscall), so this is where we're sure nothing's running.
+	PublishSimplifiedBlocks();
+	blocks_.CompactIfNeeded();
+
+	if (g_Config.bPreloadFunctions || diskCacheLoaded_) {
 		// Look to see if we've preloaded this block.
 		int block_num = blocks_.FindPreloadBlock(em_address);
 		if (block_num != -1) {
@@ -88,11 +102,24 @@ void IRJit::Compile(u32 em_address) {
 		}
 	}
 
+	if (backgroundCompile_) {
+		if (!CompileBlockInBackground(em_address)) {
+			ERROR_LOG(JIT, "Ran out of block numbers, clearing cache");
+			ClearCache();
+			CompileBlockInBackground(em_address);
+		}
+		if (frontend_.CheckRounding(em_address)) {
+			ClearCache();
+			CompileBlockInBackground(em_address);
+		}
+		return;
+	}
+
 	std::vector<IRInst> instructions;
 	u32 mipsBytes;
 	if (!CompileBlock(em_address, instructions, mipsBytes, false)) {
-		// Ran out of block numbers - need to reset.
-		ERROR_LOG(JIT, "Ran out of block numbers, clearing cache");
+		// Ran out of block numbers or code space - need to reset.
+		ERROR_LOG(JIT, "Ran out of block numbers or code space, clearing cache");
 		ClearCache();
 		CompileBlock(em_address, instructions, mipsBytes, false);
 	}
@@ -119,8 +146,12 @@ bool IRJit::CompileBlock(u32 em_address, std::vector<IRInst> &instructions, u32
 	}
 
 	IRBlock *b = blocks_.GetBlock(block_num);
-	b->SetInstructions(instructions);
+	b->SetInstructions(blocks_.GetArena(), instructions);
 	b->SetOriginalSize(mipsBytes);
+	if (!CompileTargetBlock(b, block_num, preload)) {
+		// Out of native code space.  Same deal, the caller will clear.
+		return false;
+	}
 	if (preload) {
 		// Hash, then only update page stats, don't link yet.
 		b->UpdateHash();
@@ -134,6 +165,337 @@ bool IRJit::CompileBlock(u32 em_address, std::vector<IRInst> &instructions, u32
 	return true;
 }
 
+class IRSimplifyTask : public Task {
+public:
+	IRSimplifyTask(IRJit *jit, int block_num, u32 em_address, u32 generation, const IROptions &opts, std::vector<IRInst> &&instructions)
+		: jit_(jit), blockNum_(block_num), address_(em_address), generation_(generation), opts_(opts), instructions_(std::move(instructions)) {
+	}
+
+	void Run() override {
+		IRWriter ir;
+		IRWriter simplified;
+		for (const IRInst &inst : instructions_)
+			ir.Write(inst);
+		IRFrontend::SimplifyBlock(ir, simplified, opts_);
+		instructions_ = simplified.GetInstructions();
+		jit_->QueueSimplifiedBlock(blockNum_, address_, generation_, std::move(instructions_));
+	}
+
+private:
+	IRJit *jit_;
+	int blockNum_;
+	u32 address_;
+	u32 generation_;
+	IROptions opts_;
+	std::vector<IRInst> instructions_;
+};
+
+static bool HasDebugOps(const IRInst *insts, int count) {
+	for (int i = 0; i < count; ++i) {
+		if (insts[i].op == IROp::Breakpoint || insts[i].op == IROp::MemoryCheck)
+			return true;
+	}
+	return false;
+}
+
+bool IRJit::CompileBlockInBackground(u32 em_address) {
+	std::vector<IRInst> instructions;
+	u32 mipsBytes;
+	frontend_.DoJit(em_address, instructions, mipsBytes, false, false);
+	_dbg_assert_(!instructions.empty());
+
+	int block_num = blocks_.AllocateBlock(em_address);
+	if ((block_num & ~MIPS_EMUHACK_VALUE_MASK) != 0)
+		return false;
+
+	IRBlock *b = blocks_.GetBlock(block_num);
+	b->SetInstructions(blocks_.GetArena(), instructions);
+	b->SetOriginalSize(mipsBytes);
+	blocks_.FinalizeBlock(block_num);
+
+	// The frontend leaves blocks with breakpoints alone, so must we.
+	if (HasDebugOps(&instructions[0], (int)instructions.size()))
+		return true;
+
+	{
+		std::lock_guard<std::mutex> guard(backgroundLock_);
+		backgroundPending_++;
+	}
+	IRSimplifyTask *task = new IRSimplifyTask(this, block_num, em_address, cacheGeneration_, frontend_.GetOptions(), std::move(instructions));
+	g_threadManager.EnqueueTask(task, TaskType::CPU_COMPUTE);
+	return true;
+}
+
+void IRJit::QueueSimplifiedBlock(int block_num, u32 em_address, u32 generation, std::vector<IRInst> &&instructions) {
+	std::lock_guard<std::mutex> guard(backgroundLock_);
+	simplifiedBlocks_.push_back(SimplifiedBlock{ block_num, em_address, generation, std::move(instructions) });
+	backgroundPending_--;
+	backgroundCond_.notify_all();
+}
+
+void IRJit::PublishSimplifiedBlocks() {
+	std::vector<SimplifiedBlock> finished;
+	{
+		std::lock_guard<std::mutex> guard(backgroundLock_);
+		if (simplifiedBlocks_.empty())
+			return;
+		finished.swap(simplifiedBlocks_);
+	}
+
+	for (const SimplifiedBlock &result : finished) {
+		IRBlock *b = blocks_.GetBlock(result.block_num);
+		if (result.generation != cacheGeneration_ || !b || !b->IsValid())
+			continue;
+		u32 start, size;
+		b->GetRange(start, size);
+		// Invalidated meanwhile, and the number reused for another block.
+		if (start != result.address)
+			continue;
+		b->ReplaceInstructions(blocks_.GetArena(), result.instructions);
+	}
+}
+
+void IRJit::WaitForBackgroundCompiles() {
+	std::unique_lock<std::mutex> guard(backgroundLock_);
+	backgroundCond_.wait(guard, [this] { return backgroundPending_ == 0; });
+}
+
+static bool InvertExitCondition(IROp op, IROp *inverted) {
+	switch (op) {
+	case IROp::ExitToConstIfEq: *inverted = IROp::ExitToConstIfNeq; return true;
+	case IROp::ExitToConstIfNeq: *inverted = IROp::ExitToConstIfEq; return true;
+	case IROp::ExitToConstIfGtZ: *inverted = IROp::ExitToConstIfLeZ; return true;
+	case IROp::ExitToConstIfLeZ: *inverted = IROp::ExitToConstIfGtZ; return true;
+	case IROp::ExitToConstIfGeZ: *inverted = IROp::ExitToConstIfLtZ; return true;
+	case IROp::ExitToConstIfLtZ: *inverted = IROp::ExitToConstIfGeZ; return true;
+	case IROp::ExitToConstIfFpTrue: *inverted = IROp::ExitToConstIfFpFalse; return true;
+	case IROp::ExitToConstIfFpFalse: *inverted = IROp::ExitToConstIfFpTrue; return true;
+	default:
+		return false;
+	}
+}
+
+bool IRJit::CompileTrace(int block_num) {
+	PROFILE_THIS_SCOPE("jitc");
+
+	// The trace gets the next block number, don't bother if that would run out.
+	if ((blocks_.GetNumBlocks() & ~MIPS_EMUHACK_VALUE_MASK) != 0)
+		return false;
+
+	std::vector<IRInst> trace;
+	std::vector<int> members;
+	std::vector<std::pair<u32, u32>> ranges;
+	int num = block_num;
+	while (num != -1) {
+		IRBlock *b = blocks_.GetBlock(num);
+		const IRInst *insts = b->GetInstructions();
+		int count = b->GetNumInstructions();
+		if (!b->IsValid() || b->IsTrace() || HasDebugOps(insts, count))
+			break;
+
+		members.push_back(num);
+		u32 start, size;
+		b->GetRange(start, size);
+		ranges.push_back(std::make_pair(start, size));
+
+		// Only continue into a block that's mostly where this one goes.
+		u32 hot = b->GetHotExit(TRACE_THRESHOLD / 4);
+		int next = -1;
+		if (hot != 0 && (int)members.size() < MAX_TRACE_BLOCKS) {
+			next = blocks_.GetBlockNumberFromStartAddress(hot);
+			// No loops inside a trace, they'd never check downcount.
+			if (std::find(members.begin(), members.end(), next) != members.end())
+				next = -1;
+		}
+
+		// Fall through into the next block by dropping the exit to it, or inverting the branch that takes it.
+		int keep = count;
+		IRInst inverted{};
+		bool hasInverted = false;
+		if (next != -1 && count >= 1 && insts[count - 1].op == IROp::ExitToConst) {
+			if (insts[count - 1].constant == hot) {
+				keep = count - 1;
+			} else if (count >= 2 && insts[count - 2].constant == hot && InvertExitCondition(insts[count - 2].op, &inverted.op)) {
+				keep = count - 2;
+				inverted.src1 = insts[count - 2].src1;
+				inverted.src2 = insts[count - 2].src2;
+				inverted.constant = insts[count - 1].constant;
+				hasInverted = true;
+			} else {
+				next = -1;
+			}
+		} else {
+			next = -1;
+		}
+
+		trace.insert(trace.end(), insts, insts + keep);
+		if (hasInverted)
+			trace.push_back(inverted);
+		num = next;
+	}
+
+	if (members.size() < 2)
+		return false;
+
+	IRWriter ir;
+	IRWriter simplified;
+	for (const IRInst &inst : trace)
+		ir.Write(inst);
+	// The blocks were already simplified, but constants, temps and dead writes couldn't be followed across their exits.
+	static const IRPassFunc passes[] = {
+		&PropagateConstants,
+		&PurgeTemps,
+		&RemoveDeadWrites,
+	};
+	IRApplyPasses(passes, ARRAY_SIZE(passes), ir, simplified, frontend_.GetOptions());
+
+	int trace_num = blocks_.AllocateBlock(ranges[0].first);
+	IRBlock *b = blocks_.GetBlock(trace_num);
+	b->SetInstructions(blocks_.GetArena(), simplified.GetInstructions());
+	b->SetOriginalSize(ranges[0].second);
+	for (const auto &range : ranges)
+		b->AddTraceRange(range.first, range.second);
+	if (!CompileTargetBlock(b, trace_num, false))
+		return false;
+
+	// Replaces the emuhack of the first block, which stays around in case the trace is invalidated.
+	blocks_.FinalizeBlock(trace_num);
+	DEBUG_LOG(JIT, "IRJit: Formed trace at %08x from %d blocks", ranges[0].first, (int)members.size());
+	return true;
+}
+
+// Bump when the IR or its passes change meaning.  The build's version string is also checked.
+static const u32 IR_CACHE_MAGIC = 0x48435249;  // IRCH
+static const u32 IR_CACHE_VERSION = 1;
+
+struct IRCacheHeader {
+	u32 magic;
+	u32 version;
+	u32 disableFlags;
+	u32 instSize;
+	char gitVersion[32];
+	u32 numBlocks;
+	u32 reserved;
+};
+
+struct IRCacheBlockHeader {
+	u32 address;
+	u32 mipsBytes;
+	u64 hash;
+	u32 numInstructions;
+	u32 reserved;
+};
+
+static void FillCacheHeader(IRCacheHeader &header, u32 disableFlags) {
+	memset(&header, 0, sizeof(header));
+	header.magic = IR_CACHE_MAGIC;
+	header.version = IR_CACHE_VERSION;
+	header.disableFlags = disableFlags;
+	header.instSize = (u32)sizeof(IRInst);
+	truncate_cpy(header.gitVersion, PPSSPP_GIT_VERSION);
+}
+
+bool IRJit::LoadCache(const Path &filename) {
+	FILE *f = File::OpenCFile(filename, "rb");
+	if (!f)
+		return false;
+
+	IRCacheHeader expected;
+	FillCacheHeader(expected, frontend_.GetOptions().disableFlags);
+	IRCacheHeader header;
+	if (fread(&header, sizeof(header), 1, f) != 1 || memcmp(&header, &expected, offsetof(IRCacheHeader, numBlocks)) != 0) {
+		INFO_LOG(JIT, "IR cache %s is missing or from another version, ignoring", filename.c_str());
+		fclose(f);
+		return false;
+	}
+
+	int loaded = 0;
+	std::vector<IRInst> instructions;
+	for (u32 i = 0; i < header.numBlocks; ++i) {
+		IRCacheBlockHeader blockHeader;
+		if (fread(&blockHeader, sizeof(blockHeader), 1, f) != 1)
+			break;
+		// Blocks are short, anything much bigger means the file is damaged.
+		if (blockHeader.numInstructions == 0 || blockHeader.numInstructions > 0xFFFF || blockHeader.mipsBytes == 0 || blockHeader.mipsBytes > 0x10000)
+			break;
+		instructions.resize(blockHeader.numInstructions);
+		if (fread(&instructions[0], sizeof(IRInst), blockHeader.numInstructions, f) != blockHeader.numInstructions)
+			break;
+		if (!Memory::IsValidRange(blockHeader.address, blockHeader.mipsBytes))
+			continue;
+		if ((blocks_.GetNumBlocks() & ~MIPS_EMUHACK_VALUE_MASK) != 0)
+			break;
+
+		int block_num = blocks_.AllocateBlock(blockHeader.address);
+		IRBlock *b = blocks_.GetBlock(block_num);
+		b->SetInstructions(blocks_.GetArena(), instructions);
+		b->SetOriginalSize(blockHeader.mipsBytes);
+		b->SetHash(blockHeader.hash);
+		if (!CompileTargetBlock(b, block_num, true))
+			break;
+		// Only added to the page lists, Compile() will check the hash before using it.
+		blocks_.FinalizeBlock(block_num, true);
+		loaded++;
+	}
+	fclose(f);
+
+	INFO_LOG(JIT, "Loaded %d of %d blocks from IR cache %s", loaded, (int)header.numBlocks, filename.c_str());
+	diskCacheLoaded_ = loaded != 0;
+	return diskCacheLoaded_;
+}
+
+void IRJit::SaveCache(const Path &filename) {
+	std::vector<int> saved;
+	for (int i = 0; i < blocks_.GetNumBlocks(); ++i) {
+		IRBlock *b = blocks_.GetBlock(i);
+		if (b->IsDestroyed() || b->IsTrace() || b->GetNumInstructions() == 0)
+			continue;
+		// Breakpoints depend on the debugger state at the time.
+		if (HasDebugOps(b->GetInstructions(), b->GetNumInstructions()))
+			continue;
+		if (b->IsValid()) {
+			// Only preloaded blocks have a hash yet.
+			b->UpdateHash();
+		} else if (!b->HashMatches()) {
+			// Preloaded, never used, and the code has changed since.
+			continue;
+		}
+		saved.push_back(i);
+	}
+	if (saved.empty())
+		return;
+
+	FILE *f = File::OpenCFile(filename, "wb");
+	if (!f) {
+		WARN_LOG(JIT, "Unable to write IR cache %s", filename.c_str());
+		return;
+	}
+
+	IRCacheHeader header;
+	FillCacheHeader(header, frontend_.GetOptions().disableFlags);
+	header.numBlocks = (u32)saved.size();
+	bool success = fwrite(&header, sizeof(header), 1, f) == 1;
+	for (int i : saved) {
+		if (!success)
+			break;
+		const IRBlock *b = blocks_.GetBlock(i);
+		IRCacheBlockHeader blockHeader{};
+		b->GetRange(blockHeader.address, blockHeader.mipsBytes);
+		blockHeader.hash = b->GetHash();
+		blockHeader.numInstructions = b->GetNumInstructions();
+		success = fwrite(&blockHeader, sizeof(blockHeader), 1, f) == 1;
+		success = success && fwrite(b->GetInstructions(), sizeof(IRInst), blockHeader.numInstructions, f) == blockHeader.numInstructions;
+	}
+	fclose(f);
+
+	if (!success) {
+		WARN_LOG(JIT, "Failed writing IR cache %s, removing it", filename.c_str());
+		File::Delete(filename);
+	} else {
+		INFO_LOG(JIT, "Saved %d blocks to IR cache %s", (int)saved.size(), filename.c_str());
+	}
+}
+
 void IRJit::CompileFunction(u32 start_address, u32 length) {
 	PROFILE_THIS_SCOPE("jitc");
 
@@ -158,9 +520,9 @@ void IRJit::CompileFunction(u32 start_address, u32 length) {
 		std::vector<IRInst> instructions;
 		u32 mipsBytes;
 		if (!CompileBlock(em_address, instructions, mipsBytes, true)) {
-			// Ran out of block numbers - let's hope there's no more code it needs to run.
+			// Ran out of block numbers or code space - let's hope there's no more code it needs to run.
 			// Will flush when actually compiling.
-			ERROR_LOG(JIT, "Ran out of block numbers while compiling function");
+			ERROR_LOG(JIT, "Ran out of block numbers or code space while compiling function");
 			return;
 		}
 
@@ -212,7 +574,9 @@ void IRJit::RunLoopUntil(u64 globalticks) {
 
 	// ApplyRoundingMode(true);
 	// IR Dispatcher
-	
+	const bool threaded = g_Config.bIRThreadedInterpreter;
+	const bool traces = jo.enableTraces;
+
 	while (true) {
 		// RestoreRoundingMode(true);
 		CoreTiming::Advance();
@@ -220,13 +584,23 @@ void IRJit::RunLoopUntil(u64 globalticks) {
 		if (coreState != 0) {
 			break;
 		}
+		if (backgroundCompile_)
+			PublishSimplifiedBlocks();
 		while (mips_->downcount >= 0) {
 			u32 inst = Memory::ReadUnchecked_U32(mips_->pc);
 			u32 opcode = inst & 0xFF000000;
 			if (opcode == MIPS_EMUHACK_OPCODE) {
 				u32 data = inst & 0xFFFFFF;
 				IRBlock *block = blocks_.GetBlock(data);
-				mips_->pc = IRInterpret(mips_, block->GetInstructions(), block->GetNumInstructions());
+				if (threaded)
+					mips_->pc = IRInterpretThreaded(mips_, block->GetThreadedInstructions());
+				else
+					mips_->pc = IRInterpret(mips_, block->GetInstructions(), block->GetNumInstructions());
+				if (traces && !block->IsTrace()) {
+					block->RecordExit(mips_->pc);
+					if (block->CountEntry(TRACE_THRESHOLD))
+						CompileTrace(data);
+				}
 				if (!Memory::IsValidAddress(mips_->pc)) {
 					Core_ExecException(mips_->pc, mips_->pc, ExecExceptionType::JUMP);
 					break;
@@ -260,12 +634,64 @@ bool IRJit::ReplaceJalTo(u32 dest) {
 	return false;
 }
 
+IRInstArena::~IRInstArena() {
+	for (Chunk &chunk : chunks_)
+		delete[] chunk.data;
+}
+
+IRInst *IRInstArena::Alloc(size_t count) {
+	if (chunks_.empty() || chunks_.back().capacity - chunks_.back().used < count) {
+		Chunk chunk;
+		chunk.capacity = std::max(count, (size_t)CHUNK_INSTRUCTIONS);
+		chunk.data = new IRInst[chunk.capacity];
+		chunk.used = 0;
+		chunks_.push_back(chunk);
+	}
+
+	Chunk &chunk = chunks_.back();
+	IRInst *ptr = chunk.data + chunk.used;
+	chunk.used += count;
+	usedCount_ += count;
+	return ptr;
+}
+
+void IRInstArena::Clear() {
+	// Keep the first chunk around, we'll most likely fill it right back up.
+	for (size_t i = 1; i < chunks_.size(); ++i)
+		delete[] chunks_[i].data;
+	if (!chunks_.empty()) {
+		chunks_.resize(1);
+		chunks_[0].used = 0;
+	}
+	usedCount_ = 0;
+	deadCount_ = 0;
+}
+
+void IRInstArena::Swap(IRInstArena &other) {
+	std::swap(chunks_, other.chunks_);
+	std::swap(usedCount_, other.usedCount_);
+	std::swap(deadCount_, other.deadCount_);
+}
+
 void IRBlockCache::Clear() {
 	for (int i = 0; i < (int)blocks_.size(); ++i) {
 		blocks_[i].Destroy(i);
 	}
 	blocks_.clear();
 	byPage_.clear();
+	arena_.Clear();
+}
+
+void IRBlockCache::CompactIfNeeded() {
+	// Only worth the copy once at least half the arena, and at least a chunk's worth, is dead.
+	size_t dead = arena_.DeadCount();
+	if (dead * 2 < arena_.UsedCount() || dead < 65536)
+		return;
+
+	IRInstArena compacted;
+	for (IRBlock &b : blocks_)
+		b.Relocate(compacted);
+	arena_.Swap(compacted);
 }
 
 void IRBlockCache::InvalidateICache(u32 address, u32 length) {
@@ -279,9 +705,20 @@ void IRBlockCache::InvalidateICache(u32 address, u32 length) {
 
 		const std::vector<int> &blocksInPage = iter->second;
 		for (int i : blocksInPage) {
-			if (blocks_[i].OverlapsRange(address, length)) {
+			if (!blocks_[i].IsDestroyed() && blocks_[i].OverlapsRange(address, length)) {
+				u32 start, size;
+				blocks_[i].GetRange(start, size);
+				const bool trace = blocks_[i].IsTrace();
 				// Not removing from the page, hopefully doesn't build up with small recompiles.
 				blocks_[i].Destroy(i);
+				arena_.MarkDead(blocks_[i].GetNumInstructions());
+
+				// If only a later block of the trace changed, its first block is still good.  Link it again.
+				if (trace) {
+					int first = GetBlockNumberFromStartAddress(start);
+					if (first != -1 && blocks_[first].IsValid() && blocks_[first].HasOriginalFirstOp())
+						blocks_[first].Finalize(first);
+				}
 			}
 		}
 	}
@@ -289,6 +726,16 @@ void IRBlockCache::InvalidateICache(u32 address, u32 length) {
 
 void IRBlockCache::FinalizeBlock(int i, bool preload) {
 	if (!preload) {
+		if (blocks_[i].IsTrace()) {
+			u32 startAddr, size;
+			blocks_[i].GetRange(startAddr, size);
+			u32 op = Memory::ReadUnchecked_U32(startAddr);
+			int first = MIPS_IS_RUNBLOCK(op) ? (int)(op & MIPS_EMUHACK_VALUE_MASK) : -1;
+			if (first >= 0 && first < (int)blocks_.size() && first != i)
+				blocks_[i].SetOriginalFirstOp(blocks_[first].GetOriginalFirstOp());
+			else
+				blocks_[i].SetOriginalFirstOp(Memory::Read_Opcode_JIT(startAddr));
+		}
 		blocks_[i].Finalize(i);
 	}
 
@@ -301,6 +748,17 @@ void IRBlockCache::FinalizeBlock(int i, bool preload) {
 	for (u32 page = startPage; page <= endPage; ++page) {
 		byPage_[page].push_back(i);
 	}
+
+	// Traces need to be found by invalidation of any of their blocks.
+	for (const auto &range : blocks_[i].GetTraceRanges()) {
+		startPage = AddressToPage(range.first);
+		endPage = AddressToPage(range.first + range.second);
+		for (u32 page = startPage; page <= endPage; ++page) {
+			std::vector<int> &blocksInPage = byPage_[page];
+			if (blocksInPage.empty() || blocksInPage.back() != i)
+				blocksInPage.push_back(i);
+		}
+	}
 }
 
 u32 IRBlockCache::AddressToPage(u32 addr) const {
@@ -435,6 +893,39 @@ int IRBlockCache::GetBlockNumberFromStartAddress(u32 em_address, bool realBlocks
 	return best;
 }
 
+const IRThreadedInst *IRBlock::GetThreadedInstructions() {
+	if (!threaded_ && instr_) {
+		threaded_ = new IRThreadedInst[numInstructions_];
+		IRCompileThreaded(instr_, numInstructions_, threaded_);
+	}
+	return threaded_;
+}
+
+IRBlock::~IRBlock() {
+	delete[] threaded_;
+}
+
+void IRBlock::ReplaceInstructions(IRInstArena &arena, const std::vector<IRInst> &inst) {
+	arena.MarkDead(numInstructions_);
+	SetInstructions(arena, inst);
+	delete[] threaded_;
+	threaded_ = nullptr;
+}
+
+void IRBlock::Relocate(IRInstArena &arena) {
+	if (IsDestroyed() || !instr_) {
+		instr_ = nullptr;
+		numInstructions_ = 0;
+		delete[] threaded_;
+		threaded_ = nullptr;
+		return;
+	}
+
+	IRInst *moved = arena.Alloc(numInstructions_);
+	memcpy(moved, instr_, sizeof(IRInst) * numInstructions_);
+	instr_ = moved;
+}
+
 bool IRBlock::HasOriginalFirstOp() const {
 	return Memory::ReadUnchecked_U32(origAddr_) == origFirstOpcode_.encoding;
 }
@@ -452,7 +943,9 @@ void IRBlock::Finalize(int number) {
 	// Check it wasn't invalidated, in case this is after preload.
 	// TODO: Allow reusing blocks when the code matches hash_ again, instead.
 	if (origAddr_) {
-		origFirstOpcode_ = Memory::Read_Opcode_JIT(origAddr_);
+		// A trace is given its first block's original op instead, memory only holds that block's emuhack.
+		if (!IsTrace())
+			origFirstOpcode_ = Memory::Read_Opcode_JIT(origAddr_);
 		MIPSOpcode opcode = MIPSOpcode(MIPS_EMUHACK_OPCODE | number);
 		Memory::Write_Opcode_JIT(origAddr_, opcode);
 	}
@@ -490,7 +983,14 @@ u64 IRBlock::CalculateHash() const {
 bool IRBlock::OverlapsRange(u32 addr, u32 size) const {
 	addr &= 0x3FFFFFFF;
 	u32 origAddr = origAddr_ & 0x3FFFFFFF;
-	return addr + size > origAddr && addr < origAddr + origSize_;
+	if (addr + size > origAddr && addr < origAddr + origSize_)
+		return true;
+	for (const auto &range : traceRanges_) {
+		u32 start = range.first & 0x3FFFFFFF;
+		if (addr + size > start && addr < start + range.second)
+			return true;
+	}
+	return false;
 }
 
 MIPSOpcode IRJit::GetOriginalOp(MIPSOpcode op) {
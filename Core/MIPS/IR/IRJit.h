@@ -17,8 +17,12 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "Common/Common.h"
 #include "Common/CPUDetect.h"
@@ -33,9 +37,50 @@
 #include "stddef.h"
 #endif
 
+struct IRThreadedInst;
+
 namespace MIPSComp {
 
-// TODO : Use arena allocators. For now let's just malloc.
+// Bump allocator for block IR, so a game's IR ends up in a few large contiguous chunks.
+// Nothing is freed individually, dead space is only reclaimed by IRBlockCache::CompactIfNeeded().
+class IRInstArena {
+public:
+	IRInstArena() {}
+	IRInstArena(const IRInstArena &) = delete;
+	~IRInstArena();
+
+	IRInst *Alloc(size_t count);
+	// Only bookkeeping, so the cache can tell when compacting is worth it.
+	void MarkDead(size_t count) {
+		deadCount_ += count;
+	}
+	void Clear();
+	void Swap(IRInstArena &other);
+
+	size_t UsedCount() const {
+		return usedCount_;
+	}
+	size_t DeadCount() const {
+		return deadCount_;
+	}
+
+private:
+	struct Chunk {
+		IRInst *data;
+		size_t capacity;
+		size_t used;
+	};
+
+	enum {
+		// 512 KB per chunk.  Larger blocks just get a chunk of their own.
+		CHUNK_INSTRUCTIONS = 65536,
+	};
+
+	std::vector<Chunk> chunks_;
+	size_t usedCount_ = 0;
+	size_t deadCount_ = 0;
+};
+
 class IRBlock {
 public:
 	IRBlock() : instr_(nullptr), numInstructions_(0), origAddr_(0), origSize_(0) {}
@@ -47,33 +92,56 @@ class IRBlock {
 		origSize_ = b.origSize_;
 		origFirstOpcode_ = b.origFirstOpcode_;
 		hash_ = b.hash_;
+		targetOffset_ = b.targetOffset_;
+		threaded_ = b.threaded_;
+		entryCount_ = b.entryCount_;
+		hotExit_ = b.hotExit_;
+		hotExitVotes_ = b.hotExitVotes_;
+		traceRanges_ = std::move(b.traceRanges_);
 		b.instr_ = nullptr;
+		b.threaded_ = nullptr;
 	}
 
-	~IRBlock() {
-		delete[] instr_;
-	}
+	~IRBlock();
 
-	void SetInstructions(const std::vector<IRInst> &inst) {
-		instr_ = new IRInst[inst.size()];
+	// The storage belongs to the arena, which must outlive the block.
+	void SetInstructions(IRInstArena &arena, const std::vector<IRInst> &inst) {
+		instr_ = arena.Alloc(inst.size());
 		numInstructions_ = (u16)inst.size();
 		if (!inst.empty()) {
 			memcpy(instr_, &inst[0], sizeof(IRInst) * inst.size());
 		}
 	}
+	// Swaps in reoptimized IR, the old storage is left to the next compaction.
+	void ReplaceInstructions(IRInstArena &arena, const std::vector<IRInst> &inst);
+	// Copies the IR into another arena, or drops it if the block was destroyed.
+	void Relocate(IRInstArena &arena);
 
 	const IRInst *GetInstructions() const { return instr_; }
 	int GetNumInstructions() const { return numInstructions_; }
+	// Built on first use, only the threaded interpreter needs it.
+	const IRThreadedInst *GetThreadedInstructions();
 	MIPSOpcode GetOriginalFirstOp() const { return origFirstOpcode_; }
+	void SetOriginalFirstOp(MIPSOpcode op) {
+		origFirstOpcode_ = op;
+	}
 	bool HasOriginalFirstOp() const;
 	bool RestoreOriginalFirstOp(int number);
 	bool IsValid() const { return origAddr_ != 0 && origFirstOpcode_.encoding != 0x68FFFFFF; }
+	bool IsDestroyed() const { return origAddr_ == 0; }
 	void SetOriginalSize(u32 size) {
 		origSize_ = size;
 	}
 	void UpdateHash() {
 		hash_ = CalculateHash();
 	}
+	// For blocks loaded from disk, which are checked against the code before use.
+	void SetHash(u64 hash) {
+		hash_ = hash;
+	}
+	u64 GetHash() const {
+		return hash_;
+	}
 	bool HashMatches() const {
 		return origAddr_ && hash_ == CalculateHash();
 	}
@@ -84,6 +152,45 @@ class IRBlock {
 		size = origSize_;
 	}
 
+	// Offset of native code for this block, when a backend compiled it.  -1 if none.
+	void SetTargetOffset(int offset) {
+		targetOffset_ = offset;
+	}
+	int GetTargetOffset() const {
+		return targetOffset_;
+	}
+
+	// Hot path profiling, only done by the IR interpreter loop.
+	// Returns true once, when the entry count reaches threshold.
+	bool CountEntry(u32 threshold) {
+		return ++entryCount_ == threshold;
+	}
+	// Majority vote, so this keeps the dominant successor without a table per block.
+	void RecordExit(u32 pc) {
+		if (pc == hotExit_) {
+			hotExitVotes_++;
+		} else if (hotExitVotes_ == 0) {
+			hotExit_ = pc;
+			hotExitVotes_ = 1;
+		} else {
+			hotExitVotes_--;
+		}
+	}
+	u32 GetHotExit(int minVotes) const {
+		return hotExitVotes_ >= minVotes ? hotExit_ : 0;
+	}
+
+	// A trace starts at its first block's address, but also covers the ranges of all blocks in it.
+	bool IsTrace() const {
+		return !traceRanges_.empty();
+	}
+	void AddTraceRange(u32 start, u32 size) {
+		traceRanges_.push_back(std::make_pair(start, size));
+	}
+	const std::vector<std::pair<u32, u32>> &GetTraceRanges() const {
+		return traceRanges_;
+	}
+
 	void Finalize(int number);
 	void Destroy(int number);
 
@@ -91,10 +198,16 @@ class IRBlock {
 	u64 CalculateHash() const;
 
 	IRInst *instr_;
+	IRThreadedInst *threaded_ = nullptr;
 	u16 numInstructions_;
 	u32 origAddr_;
 	u32 origSize_;
 	u64 hash_ = 0;
+	int targetOffset_ = -1;
+	u32 entryCount_ = 0;
+	u32 hotExit_ = 0;
+	int hotExitVotes_ = 0;
+	std::vector<std::pair<u32, u32>> traceRanges_;
 	MIPSOpcode origFirstOpcode_ = MIPSOpcode(0x68FFFFFF);
 };
 
@@ -102,9 +215,15 @@ class IRBlockCache : public JitBlockCacheDebugInterface {
 public:
 	IRBlockCache() {}
 	void Clear();
+	// Moves the IR of live blocks together once enough has been invalidated.
+	// Must not be called while any block is running, since it moves their instructions.
+	void CompactIfNeeded();
 	void InvalidateICache(u32 address, u32 length);
 	void FinalizeBlock(int i, bool preload = false);
 	int GetNumBlocks() const override { return (int)blocks_.size(); }
+	IRInstArena &GetArena() {
+		return arena_;
+	}
 	int AllocateBlock(int emAddr) {
 		blocks_.push_back(IRBlock(emAddr));
 		return (int)blocks_.size() - 1;
@@ -131,6 +250,7 @@ class IRBlockCache : public JitBlockCacheDebugInterface {
 
 	std::vector<IRBlock> blocks_;
 	std::unordered_map<u32, std::vector<int>> byPage_;
+	IRInstArena arena_;
 };
 
 class IRJit : public JitInterface {
@@ -170,8 +290,30 @@ class IRJit : public JitInterface {
 	void LinkBlock(u8 *exitPoint, const u8 *checkedEntry) override;
 	void UnlinkBlock(u8 *checkedEntry, u32 originalAddress) override;
 
-private:
+	bool LoadCache(const Path &filename) override;
+	void SaveCache(const Path &filename) override;
+
+	// Called from the simplify task on a worker thread.
+	void QueueSimplifiedBlock(int block_num, u32 em_address, u32 generation, std::vector<IRInst> &&instructions);
+
+protected:
 	bool CompileBlock(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes, bool preload);
+	// Compiles the block unsimplified so it can run right away, and queues the passes on a worker.
+	bool CompileBlockInBackground(u32 em_address);
+	// Swaps finished blocks in.  Only safe while no block is running.
+	void PublishSimplifiedBlocks();
+	void WaitForBackgroundCompiles();
+
+	enum {
+		// Entries before a block's successors are looked at for a trace.
+		TRACE_THRESHOLD = 2000,
+		MAX_TRACE_BLOCKS = 8,
+	};
+
+	// Joins a hot block with its usual successors into one block, and reoptimizes across them.
+	bool CompileTrace(int block_num);
+	// Native backends override this to lower the block's IR.  Returns false when out of space.
+	virtual bool CompileTargetBlock(IRBlock *block, int block_num, bool preload) { return true; }
 	bool ReplaceJalTo(u32 dest);
 
 	JitOptions jo;
@@ -180,6 +322,23 @@ class IRJit : public JitInterface {
 	IRBlockCache blocks_;
 
 	MIPSState *mips_;
+	// Set once blocks were loaded from disk, so Compile() looks for them.
+	bool diskCacheLoaded_ = false;
+
+	// Native backends lower each block once, so they leave this off and want the final IR right away.
+	bool backgroundCompile_ = false;
+	struct SimplifiedBlock {
+		int block_num;
+		u32 address;
+		u32 generation;
+		std::vector<IRInst> instructions;
+	};
+	std::mutex backgroundLock_;
+	std::condition_variable backgroundCond_;
+	std::vector<SimplifiedBlock> simplifiedBlocks_;
+	int backgroundPending_ = 0;
+	// Bumped on every clear, so results for reused block numbers are dropped.
+	u32 cacheGeneration_ = 0;
 
 	// where to write branch-likely trampolines. not used atm
 	// u32 blTrampolines_;
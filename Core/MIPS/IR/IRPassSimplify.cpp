@@ -1385,3 +1385,213 @@ bool MergeLoadStore(const IRWriter &in, IRWriter &out, const IROptions &opts) {
 	}
 	return logBlocks;
 }
+
+static bool IsTrackedGPR(int r) {
+	return (r > 0 && r < 32) || (r >= IRTEMP_0 && r <= IRTEMP_LR_SHIFT);
+}
+
+static bool IsTempGPR(int r) {
+	return r >= IRTEMP_0 && r <= IRTEMP_LR_SHIFT;
+}
+
+static int FPRArgCount(char type) {
+	switch (type) {
+	case 'F': return 1;
+	case '2': return 2;
+	case 'V': return 4;
+	default: return 0;
+	}
+}
+
+struct IRRegInterval {
+	int reg;
+	int start;
+	int end;
+	int uses;
+};
+
+// Classic linear scan: when out of slots, drop whichever active interval ends last.
+static void LinearScanPinned(std::vector<IRRegInterval> &intervals, int maxPinned, std::vector<u8> &pinned) {
+	pinned.clear();
+	if (maxPinned <= 0)
+		return;
+
+	std::sort(intervals.begin(), intervals.end(), [](const IRRegInterval &a, const IRRegInterval &b) {
+		return a.start < b.start;
+	});
+
+	std::vector<IRRegInterval> active;
+	std::vector<IRRegInterval> kept;
+	for (const IRRegInterval &interval : intervals) {
+		// Pinning only pays off with a few uses.
+		if (interval.uses < 2)
+			continue;
+
+		for (size_t i = 0; i < active.size(); ) {
+			if (active[i].end < interval.start) {
+				kept.push_back(active[i]);
+				active.erase(active.begin() + i);
+			} else {
+				++i;
+			}
+		}
+
+		if ((int)active.size() < maxPinned) {
+			active.push_back(interval);
+			continue;
+		}
+
+		auto furthest = std::max_element(active.begin(), active.end(), [](const IRRegInterval &a, const IRRegInterval &b) {
+			return a.end < b.end;
+		});
+		if (furthest->end > interval.end)
+			*furthest = interval;
+	}
+	kept.insert(kept.end(), active.begin(), active.end());
+
+	std::sort(kept.begin(), kept.end(), [](const IRRegInterval &a, const IRRegInterval &b) {
+		return a.uses > b.uses;
+	});
+	for (size_t i = 0; i < kept.size() && (int)i < maxPinned; ++i)
+		pinned.push_back((u8)kept[i].reg);
+}
+
+void IRComputeLiveness(const IRInst *insts, int count, int maxPinnedGPRs, int maxPinnedFPRs, IRLiveness &out) {
+	std::bitset<256> gprAtExit;
+	std::bitset<256> fprAtExit;
+	for (int r = 0; r < 256; ++r) {
+		if (IsTrackedGPR(r) && !IsTempGPR(r))
+			gprAtExit.set(r);
+	}
+	fprAtExit.set();
+
+	out.gprLiveOut.reset();
+	out.fprLiveOut.reset();
+	out.deadWrite.assign(count, false);
+
+	int gprFirst[256], gprLast[256], gprUses[256];
+	int fprFirst[256], fprLast[256], fprUses[256];
+	for (int r = 0; r < 256; ++r) {
+		gprFirst[r] = fprFirst[r] = -1;
+		gprLast[r] = fprLast[r] = -1;
+		gprUses[r] = fprUses[r] = 0;
+	}
+	auto useGPR = [&](int r, int i) {
+		if (gprFirst[r] == -1)
+			gprFirst[r] = i;
+		gprLast[r] = std::max(gprLast[r], i);
+		gprUses[r]++;
+	};
+	auto useFPR = [&](int r, int i) {
+		if (fprFirst[r] == -1)
+			fprFirst[r] = i;
+		fprLast[r] = std::max(fprLast[r], i);
+		fprUses[r]++;
+	};
+
+	// Walk backwards, so we know what's read later when we see a write.
+	std::bitset<256> gprLive = gprAtExit;
+	std::bitset<256> fprLive = fprAtExit;
+	for (int i = count - 1; i >= 0; --i) {
+		const IRInst &inst = insts[i];
+		const IRMeta *m = GetIRMeta(inst.op);
+
+		if ((m->flags & IRFLAG_EXIT) != 0 || inst.op == IROp::Interpret || inst.op == IROp::CallReplacement) {
+			gprLive |= gprAtExit;
+			fprLive |= fprAtExit;
+		}
+
+		bool src3 = (m->flags & (IRFLAG_SRC3 | IRFLAG_SRC3DST)) != 0;
+		int destGPR = !src3 && m->types[0] == 'G' && IsTrackedGPR(inst.dest) ? inst.dest : -1;
+		// FCmovVfpuCC only sometimes writes, so it reads its dest too.
+		int destFPR = !src3 && m->types[0] == 'F' && inst.op != IROp::FCmovVfpuCC ? inst.dest : -1;
+		// Writes to zero are discarded anyway, PurgeTemps also leaves these behind as nops.
+		bool writesZero = !src3 && m->types[0] == 'G' && inst.dest == MIPS_REG_ZERO;
+
+		if (writesZero || (destGPR != -1 && !gprLive.test(destGPR)) || (destFPR != -1 && !fprLive.test(destFPR))) {
+			// Nothing reads it, so the sources don't matter either.
+			out.deadWrite[i] = true;
+			continue;
+		}
+
+		if (destGPR != -1) {
+			gprLive.reset(destGPR);
+			if (!IsTempGPR(destGPR))
+				out.gprLiveOut.set(destGPR);
+			useGPR(destGPR, i);
+		}
+		if (destFPR != -1) {
+			fprLive.reset(destFPR);
+			out.fprLiveOut.set(destFPR);
+			useFPR(destFPR, i);
+		}
+
+		// Partial or masked vector writes, just count them as written.
+		if (!src3 && (m->types[0] == 'V' || m->types[0] == '2')) {
+			for (int j = 0; j < FPRArgCount(m->types[0]); ++j) {
+				out.fprLiveOut.set(inst.dest + j);
+				useFPR(inst.dest + j, i);
+			}
+		}
+
+		if (src3 || inst.op == IROp::FCmovVfpuCC) {
+			if (m->types[0] == 'G' && IsTrackedGPR(inst.src3)) {
+				gprLive.set(inst.src3);
+				useGPR(inst.src3, i);
+			}
+			for (int j = 0; j < FPRArgCount(m->types[0]); ++j) {
+				fprLive.set(inst.src3 + j);
+				useFPR(inst.src3 + j, i);
+			}
+		}
+		for (int arg = 1; arg <= 2; ++arg) {
+			int r = arg == 1 ? inst.src1 : inst.src2;
+			if (m->types[arg] == 'G' && IsTrackedGPR(r)) {
+				gprLive.set(r);
+				useGPR(r, i);
+			}
+			for (int j = 0; j < FPRArgCount(m->types[arg]); ++j) {
+				fprLive.set(r + j);
+				useFPR(r + j, i);
+			}
+		}
+	}
+
+	out.gprLiveIn.reset();
+	for (int r = 0; r < 256; ++r) {
+		if (IsTrackedGPR(r) && gprLive.test(r) && gprUses[r] != 0)
+			out.gprLiveIn.set(r);
+	}
+	out.fprLiveIn = fprLive;
+	for (int r = 0; r < 256; ++r) {
+		if (fprUses[r] == 0)
+			out.fprLiveIn.reset(r);
+	}
+
+	std::vector<IRRegInterval> intervals;
+	for (int r = 0; r < 256; ++r) {
+		if (gprUses[r] != 0)
+			intervals.push_back(IRRegInterval{ r, gprFirst[r], gprLast[r], gprUses[r] });
+	}
+	LinearScanPinned(intervals, maxPinnedGPRs, out.pinnedGPRs);
+
+	intervals.clear();
+	for (int r = 0; r < 256; ++r) {
+		if (fprUses[r] != 0)
+			intervals.push_back(IRRegInterval{ r, fprFirst[r], fprLast[r], fprUses[r] });
+	}
+	LinearScanPinned(intervals, maxPinnedFPRs, out.pinnedFPRs);
+}
+
+bool RemoveDeadWrites(const IRWriter &in, IRWriter &out, const IROptions &opts) {
+	CONDITIONAL_DISABLE;
+	const std::vector<IRInst> &insts = in.GetInstructions();
+	IRLiveness liveness;
+	IRComputeLiveness(insts.data(), (int)insts.size(), 0, 0, liveness);
+
+	for (size_t i = 0; i < insts.size(); ++i) {
+		if (!liveness.deadWrite[i])
+			out.Write(insts[i]);
+	}
+	return false;
+}
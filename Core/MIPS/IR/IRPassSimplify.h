@@ -1,5 +1,8 @@
 #pragma once
 
+#include <bitset>
+#include <vector>
+
 #include "Core/MIPS/IR/IRInst.h"
 
 typedef bool (*IRPassFunc)(const IRWriter &in, IRWriter &out, const IROptions &opts);
@@ -14,3 +17,25 @@ bool ThreeOpToTwoOp(const IRWriter &in, IRWriter &out, const IROptions &opts);
 bool OptimizeFPMoves(const IRWriter &in, IRWriter &out, const IROptions &opts);
 bool ReorderLoadStore(const IRWriter &in, IRWriter &out, const IROptions &opts);
 bool MergeLoadStore(const IRWriter &in, IRWriter &out, const IROptions &opts);
+bool RemoveDeadWrites(const IRWriter &in, IRWriter &out, const IROptions &opts);
+
+// Register liveness for a block, indexed by IR GPR and IR FPR number.
+// Only the MIPS GPRs, the IR temps and the FPRs are tracked.  The other state in the GPR
+// space (lo/hi, fpcond, VFPU control...) is accessed implicitly by some ops, so assume it's live.
+// There's no view past the block's exits, so anything not a temp is assumed read after an exit.
+struct IRLiveness {
+	// Read before being written in the block.
+	std::bitset<256> gprLiveIn;
+	std::bitset<256> fprLiveIn;
+	// Written by a write in the block that isn't dead, so these may need to be stored back.
+	// Not checked against liveness after the block, and GPR temps are left out.
+	std::bitset<256> gprLiveOut;
+	std::bitset<256> fprLiveOut;
+	// Per instruction, true if all it does is write a reg that's never read.
+	std::vector<bool> deadWrite;
+	// Worth keeping in host registers across the whole block, by linear scan.  Most used first.
+	std::vector<u8> pinnedGPRs;
+	std::vector<u8> pinnedFPRs;
+};
+
+void IRComputeLiveness(const IRInst *insts, int count, int maxPinnedGPRs, int maxPinnedFPRs, IRLiveness &out);
@@ -41,7 +41,7 @@
 #elif PPSSPP_ARCH(MIPS)
 #include "../MIPS/MipsJit.h"
 #elif PPSSPP_ARCH(LOONGARCH64)
-#include "../LOONGARCH64/LoongArch64Jit.h"
+#include "../LOONGARCH64/LoongArch64IRJit.h"
 #else
 #include "../fake/FakeJit.h"
 #endif
@@ -76,7 +76,7 @@ namespace MIPSComp {
 #elif PPSSPP_ARCH(MIPS)
 		return new MIPSComp::MipsJit(mipsState);
 #elif PPSSPP_ARCH(LOONGARCH64)
-		return new MIPSComp::LoongArch64Jit(mipsState);
+		return new MIPSComp::LoongArch64IRJit(mipsState);
 #else
 		return new MIPSComp::FakeJit(mipsState);
 #endif
@@ -32,6 +32,7 @@ std::vector<std::string> DisassembleX86(const u8 *data, int size);
 struct JitBlock;
 class JitBlockCache;
 class JitBlockCacheDebugInterface;
+class Path;
 class PointerWrap;
 
 #ifdef USING_QT_UI
@@ -148,6 +149,11 @@ namespace MIPSComp {
 		// like that.
 		virtual void LinkBlock(u8 *exitPoint, const u8 *entryPoint) = 0;
 		virtual void UnlinkBlock(u8 *checkedEntry, u32 originalAddress) = 0;
+
+		// Persistent cache of compiled blocks, one file per game.  Loaded blocks are only used
+		// once the code at their address is verified to match.
+		virtual bool LoadCache(const Path &filename) { return false; }
+		virtual void SaveCache(const Path &filename) {}
 	};
 
 	typedef void (MIPSFrontendInterface::*MIPSCompileFunc)(MIPSOpcode opcode);
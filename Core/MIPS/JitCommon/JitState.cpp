@@ -57,6 +57,7 @@ namespace MIPSComp {
 		continueBranches = false;
 		continueJumps = false;
 		continueMaxInstructions = 300;
+		enableTraces = !Disabled(JitDisable::IR_TRACES);
 
 		useStaticAlloc = false;
 		enablePointerify = false;
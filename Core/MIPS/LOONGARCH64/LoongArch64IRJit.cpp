@@ -0,0 +1,859 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include "ppsspp_config.h"
+#if PPSSPP_ARCH(LOONGARCH64)
+
+#include <cstddef>
+#include <cstring>
+
+#include "Common/Log.h"
+#include "Common/MemoryUtil.h"
+#include "Common/Profiler/Profiler.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/MemMap.h"
+#include "Core/MIPS/MIPS.h"
+#include "Core/MIPS/IR/IRInst.h"
+#include "Core/MIPS/IR/IRPassSimplify.h"
+#include "Core/MIPS/LOONGARCH64/LoongArch64IRJit.h"
+#include "Core/System.h"
+
+namespace MIPSComp {
+
+using namespace LoongArch64Gen;
+using namespace LoongArch64IRJitConstants;
+
+// Host offsets are PSP addresses, zero extended (or masked, same as MemMap.h.)
+#ifdef MASKED_PSP_MEMORY
+static const u8 MEMORY_MASK_MSB = 29;
+#else
+static const u8 MEMORY_MASK_MSB = 31;
+#endif
+
+static const int PC_OFFSET = (int)offsetof(MIPSState, pc);
+static const int DOWNCOUNT_OFFSET = (int)offsetof(MIPSState, downcount);
+
+static int FPROffset(int irFpr) {
+	return (int)offsetof(MIPSState, f) + irFpr * 4;
+}
+
+static bool FitsS12(s32 imm) {
+	return imm >= -2048 && imm < 2048;
+}
+
+// Runs a single IR op through the interpreter.  Returns a new PC if the op exits (like Break.)
+static u32 DoIRInst(u64 value) {
+	IRInst inst[2];
+	memcpy(&inst[0], &value, sizeof(IRInst));
+	inst[1] = { IROp::ExitToConst, { 0 }, 0, 0, 0 };
+	return IRInterpret(currentMIPS, inst, 2);
+}
+
+LoongArch64IRJit::LoongArch64IRJit(MIPSState *mipsState) : IRJit(mipsState), regs_(this) {
+	// Blocks are lowered when compiled, swapping their IR later would need a second lowering.
+	backgroundCompile_ = false;
+	AllocCodeSpace(1024 * 1024 * 16);
+	GenerateFixedCode();
+}
+
+LoongArch64IRJit::~LoongArch64IRJit() {
+	FreeCodeSpace();
+}
+
+void LoongArch64IRJit::GenerateFixedCode() {
+	BeginWrite();
+
+	// RA and S0-S8, rounded up to keep the stack 16-byte aligned.
+	const int saveSize = 96;
+	enterDispatcher_ = GetCodePtr();
+	ADDI_D(R_SP, R_SP, -saveSize);
+	ST_D(R_RA, R_SP, 0);
+	for (int i = 0; i < 9; i++)
+		ST_D((LoongArch64Reg)(S0 + i), R_SP, 8 + i * 8);
+	MOVP2R(CTXREG, &mips_->r[0]);
+	MOVP2R(MEMBASEREG, Memory::base);
+	FixupBranch skipToOuterLoop = B();
+
+	outerLoopPCInSCRATCH1_ = GetCodePtr();
+	ST_W(SCRATCH1, CTXREG, PC_OFFSET);
+	outerLoop_ = GetCodePtr();
+	SetJumpTarget(skipToOuterLoop);
+	QuickCallFunction(SCRATCH1, &CoreTiming::Advance);
+
+	dispatcherCheckCoreState_ = GetCodePtr();
+	MOVP2R(SCRATCH1, &coreState);
+	LD_W(SCRATCH1, SCRATCH1, 0);
+	FixupBranch badCoreState = BNEZ(SCRATCH1);
+	LD_W(SCRATCH2, CTXREG, DOWNCOUNT_OFFSET);
+	BLT(SCRATCH2, R_ZERO, outerLoop_);
+
+	dispatcher_ = GetCodePtr();
+	LD_WU(SCRATCH1, CTXREG, PC_OFFSET);
+	dispatcherPCInSCRATCH1_ = GetCodePtr();
+	ST_W(SCRATCH1, CTXREG, PC_OFFSET);
+	BSTRPICK_D(SCRATCH2, SCRATCH1, MEMORY_MASK_MSB, 0);
+	LDX_WU(SCRATCH2, MEMBASEREG, SCRATCH2);
+	SRLI_W(A0, SCRATCH2, 24);
+	ADDI_W(A1, R_ZERO, MIPS_EMUHACK_OPCODE >> 24);
+	FixupBranch notBlock = BNE(A0, A1);
+	// Look up the native entry by block number.
+	BSTRPICK_D(SCRATCH2, SCRATCH2, 23, 0);
+	MOVP2R(A0, &blockOffsetsPtr_);
+	LD_D(A0, A0, 0);
+	ALSL_D(A0, SCRATCH2, A0, 2);
+	LD_WU(A0, A0, 0);
+	FixupBranch noNative = BEQZ(A0);
+	MOVP2R(A1, GetBasePtr());
+	ADD_D(A0, A0, A1);
+	JR(A0);
+
+	SetJumpTarget(notBlock);
+	SetJumpTarget(noNative);
+	MOVP2R(A0, this);
+	QuickCallFunction(SCRATCH1, &DispatcherCompile);
+	B(dispatcherCheckCoreState_);
+
+	quitLoop_ = GetCodePtr();
+	SetJumpTarget(badCoreState);
+	LD_D(R_RA, R_SP, 0);
+	for (int i = 0; i < 9; i++)
+		LD_D((LoongArch64Reg)(S0 + i), R_SP, 8 + i * 8);
+	ADDI_D(R_SP, R_SP, saveSize);
+	JR(R_RA);
+
+	FlushIcache();
+	EndWrite();
+
+	jitStartOffset_ = (int)GetOffset(GetCodePtr());
+}
+
+void LoongArch64IRJit::DispatcherCompile(LoongArch64IRJit *jit) {
+	u32 pc = jit->mips_->pc;
+	if (!Memory::IsValidAddress(pc)) {
+		Core_ExecException(pc, pc, ExecExceptionType::JUMP);
+		return;
+	}
+	jit->Compile(pc);
+}
+
+void LoongArch64IRJit::RunLoopUntil(u64 globalticks) {
+	PROFILE_THIS_SCOPE("jit");
+	((void (*)())enterDispatcher_)();
+}
+
+void LoongArch64IRJit::ClearCache() {
+	IRJit::ClearCache();
+	ClearCodeSpace(jitStartOffset_);
+	FlushIcacheSection(region + jitStartOffset_, region + region_size);
+	blockOffsets_.clear();
+	blockOffsetsPtr_ = nullptr;
+	exitsByTarget_.clear();
+}
+
+bool LoongArch64IRJit::DescribeCodePtr(const u8 *ptr, std::string &name) {
+	if (!IsInSpace(ptr))
+		return false;
+	if (ptr < GetBasePtr() + jitStartOffset_) {
+		if (ptr >= quitLoop_)
+			name = "quitLoop";
+		else if (ptr >= dispatcherPCInSCRATCH1_)
+			name = "dispatcherPCInSCRATCH1";
+		else if (ptr >= dispatcher_)
+			name = "dispatcher";
+		else if (ptr >= dispatcherCheckCoreState_)
+			name = "dispatcherCheckCoreState";
+		else if (ptr >= outerLoop_)
+			name = "outerLoop";
+		else
+			name = "enterDispatcher";
+	} else {
+		name = "(LoongArch64 IR block)";
+	}
+	return true;
+}
+
+void LoongArch64IRJit::LinkBlock(u8 *exitPoint, const u8 *checkedEntry) {
+	if (PlatformIsWXExclusive()) {
+		ProtectMemoryPages(exitPoint, 32, MEM_PROT_READ | MEM_PROT_WRITE);
+	}
+	LoongArch64Emitter emit(exitPoint);
+	emit.B(checkedEntry);
+	emit.FlushIcache();
+	if (PlatformIsWXExclusive()) {
+		ProtectMemoryPages(exitPoint, 32, MEM_PROT_READ | MEM_PROT_EXEC);
+	}
+}
+
+bool LoongArch64IRJit::CompileTargetBlock(IRBlock *block, int block_num, bool preload) {
+	// Generous, the worst case is a fallback call with an exit check per op.
+	const size_t sizeEstimate = 64 * block->GetNumInstructions() + 256;
+	if (GetSpaceLeft() < 0x10000 || GetSpaceLeft() < sizeEstimate)
+		return false;
+
+	u32 startPC, mipsBytes;
+	block->GetRange(startPC, mipsBytes);
+
+	BeginWrite(sizeEstimate);
+
+	// Linked exits arrive here with the PC in SCRATCH1.  The block might have been invalidated
+	// since, in which case the emuhack op is gone and we let the dispatcher sort it out.
+	const u8 *checkedEntry = GetCodePtr();
+	BSTRPICK_D(SCRATCH2, SCRATCH1, MEMORY_MASK_MSB, 0);
+	LDX_WU(SCRATCH2, MEMBASEREG, SCRATCH2);
+	MOVI2R(A0, (u32)(MIPS_EMUHACK_OPCODE | block_num));
+	FixupBranch matches = BEQ(SCRATCH2, A0);
+	B(dispatcherPCInSCRATCH1_);
+	SetJumpTarget(matches);
+
+	const u8 *normalEntry = GetCodePtr();
+	const IRInst *instructions = block->GetInstructions();
+	IRLiveness liveness;
+	// Leave some of the allocatable regs for everything else.
+	IRComputeLiveness(instructions, block->GetNumInstructions(), 8, 0, liveness);
+	regs_.Start();
+	regs_.SetPinned(liveness.pinnedGPRs);
+	for (int i = 0; i < block->GetNumInstructions(); ++i) {
+		CompileIRInst(instructions[i]);
+	}
+	// Blocks always end in an exit, this is just in case.
+	BREAK(0);
+
+	FlushIcache();
+	EndWrite();
+
+	block->SetTargetOffset((int)GetOffset(checkedEntry));
+	if ((int)blockOffsets_.size() <= block_num)
+		blockOffsets_.resize(block_num + 1, 0);
+	blockOffsets_[block_num] = (u32)GetOffset(normalEntry);
+	blockOffsetsPtr_ = blockOffsets_.data();
+
+	if (jo.enableBlocklink) {
+		auto range = exitsByTarget_.equal_range(startPC);
+		for (auto it = range.first; it != range.second; ++it) {
+			LinkBlock(GetWritablePtrFromCodePtr(it->second), checkedEntry);
+		}
+	}
+
+	return true;
+}
+
+void LoongArch64IRJit::WriteConstExit(u32 pc) {
+	MOVI2R(SCRATCH1, pc);
+	LD_W(SCRATCH2, CTXREG, DOWNCOUNT_OFFSET);
+	FixupBranch enoughCycles = BGE(SCRATCH2, R_ZERO);
+	B(outerLoopPCInSCRATCH1_);
+	SetJumpTarget(enoughCycles);
+
+	// This is the branch that LinkBlock patches later.
+	const u8 *exitPtr = GetCodePtr();
+	IRBlock *target = blocks_.GetBlock(blocks_.GetBlockNumberFromStartAddress(pc));
+	if (jo.enableBlocklink && target && target->GetTargetOffset() >= 0) {
+		B(GetBasePtr() + target->GetTargetOffset());
+	} else {
+		B(dispatcherPCInSCRATCH1_);
+	}
+	exitsByTarget_.insert(std::make_pair(pc, exitPtr));
+}
+
+void LoongArch64IRJit::WriteDynamicExit() {
+	LD_W(SCRATCH2, CTXREG, DOWNCOUNT_OFFSET);
+	FixupBranch enoughCycles = BGE(SCRATCH2, R_ZERO);
+	B(outerLoopPCInSCRATCH1_);
+	SetJumpTarget(enoughCycles);
+	B(dispatcherPCInSCRATCH1_);
+}
+
+LoongArch64Reg LoongArch64IRJit::MapAddress(IRReg base, u32 offset) {
+	LoongArch64Reg rs = regs_.MapReg(base);
+	if (FitsS12((s32)offset)) {
+		ADDI_W(SCRATCH1, rs, (s16)offset);
+	} else {
+		MOVI2R(SCRATCH1, offset);
+		ADD_W(SCRATCH1, rs, SCRATCH1);
+	}
+	BSTRPICK_D(SCRATCH1, SCRATCH1, MEMORY_MASK_MSB, 0);
+	return SCRATCH1;
+}
+
+void LoongArch64IRJit::LoadFPR(LoongArch64Reg fr, int irFpr) {
+	FLD_S(fr, CTXREG, FPROffset(irFpr));
+}
+
+void LoongArch64IRJit::StoreFPR(LoongArch64Reg fr, int irFpr) {
+	FST_S(fr, CTXREG, FPROffset(irFpr));
+}
+
+void LoongArch64IRJit::CompileFallback(const IRInst &inst) {
+	regs_.FlushAll();
+	u64 value;
+	memcpy(&value, &inst, sizeof(inst));
+	MOVI2R(A0, value);
+	QuickCallFunction(SCRATCH2, &DoIRInst);
+	FixupBranch keepGoing = BEQZ(A0);
+	MOVE(SCRATCH1, A0);
+	B(outerLoopPCInSCRATCH1_);
+	SetJumpTarget(keepGoing);
+}
+
+void LoongArch64IRJit::CompileIRInst(const IRInst &inst) {
+	switch (inst.op) {
+	case IROp::Nop:
+	case IROp::RestoreRoundingMode:
+	case IROp::ApplyRoundingMode:
+	case IROp::UpdateRoundingMode:
+		// The interpreter ignores rounding modes too.
+		break;
+
+	case IROp::SetConst:
+		MOVI2R(regs_.MapReg(inst.dest, MAP_NOINIT), inst.constant);
+		break;
+
+	case IROp::SetConstF:
+		MOVI2R(SCRATCH1, inst.constant);
+		ST_W(SCRATCH1, CTXREG, FPROffset(inst.dest));
+		break;
+
+	case IROp::Mov:
+		if (inst.dest != inst.src1) {
+			regs_.MapDirtyIn(inst.dest, inst.src1);
+			MOVE(regs_.R(inst.dest), regs_.R(inst.src1));
+		}
+		break;
+
+	case IROp::Add:
+	case IROp::Sub:
+	case IROp::And:
+	case IROp::Or:
+	case IROp::Xor:
+	case IROp::Shl:
+	case IROp::Shr:
+	case IROp::Sar:
+	case IROp::Ror:
+	case IROp::Slt:
+	case IROp::SltU:
+	{
+		regs_.MapDirtyInIn(inst.dest, inst.src1, inst.src2);
+		LoongArch64Reg rd = regs_.R(inst.dest);
+		LoongArch64Reg rs = regs_.R(inst.src1);
+		LoongArch64Reg rt = regs_.R(inst.src2);
+		switch (inst.op) {
+		case IROp::Add: ADD_W(rd, rs, rt); break;
+		case IROp::Sub: SUB_W(rd, rs, rt); break;
+		case IROp::And: AND(rd, rs, rt); break;
+		case IROp::Or: OR(rd, rs, rt); break;
+		case IROp::Xor: XOR(rd, rs, rt); break;
+		// The W shifts only look at the low 5 bits of the amount, like the PSP.
+		case IROp::Shl: SLL_W(rd, rs, rt); break;
+		case IROp::Shr: SRL_W(rd, rs, rt); break;
+		case IROp::Sar: SRA_W(rd, rs, rt); break;
+		case IROp::Ror: ROTR_W(rd, rs, rt); break;
+		// Values are kept sign extended, which preserves both signed and unsigned order.
+		case IROp::Slt: SLT(rd, rs, rt); break;
+		case IROp::SltU: SLTU(rd, rs, rt); break;
+		default: break;
+		}
+		break;
+	}
+
+	case IROp::AddConst:
+	case IROp::SubConst:
+	{
+		u32 imm = inst.op == IROp::SubConst ? 0 - inst.constant : inst.constant;
+		regs_.MapDirtyIn(inst.dest, inst.src1);
+		if (FitsS12((s32)imm)) {
+			ADDI_W(regs_.R(inst.dest), regs_.R(inst.src1), (s16)imm);
+		} else {
+			MOVI2R(SCRATCH1, imm);
+			ADD_W(regs_.R(inst.dest), regs_.R(inst.src1), SCRATCH1);
+		}
+		break;
+	}
+
+	case IROp::AndConst:
+	case IROp::OrConst:
+	case IROp::XorConst:
+	{
+		regs_.MapDirtyIn(inst.dest, inst.src1);
+		LoongArch64Reg rd = regs_.R(inst.dest);
+		LoongArch64Reg rs = regs_.R(inst.src1);
+		if (inst.constant <= 0xFFF) {
+			// These zero extend the immediate, which is what we want.
+			if (inst.op == IROp::AndConst)
+				ANDI(rd, rs, (u16)inst.constant);
+			else if (inst.op == IROp::OrConst)
+				ORI(rd, rs, (u16)inst.constant);
+			else
+				XORI(rd, rs, (u16)inst.constant);
+		} else {
+			MOVI2R(SCRATCH1, inst.constant);
+			if (inst.op == IROp::AndConst)
+				AND(rd, rs, SCRATCH1);
+			else if (inst.op == IROp::OrConst)
+				OR(rd, rs, SCRATCH1);
+			else
+				XOR(rd, rs, SCRATCH1);
+		}
+		break;
+	}
+
+	case IROp::ShlImm:
+	case IROp::ShrImm:
+	case IROp::SarImm:
+	case IROp::RorImm:
+	{
+		regs_.MapDirtyIn(inst.dest, inst.src1);
+		LoongArch64Reg rd = regs_.R(inst.dest);
+		LoongArch64Reg rs = regs_.R(inst.src1);
+		u8 sa = inst.src2 & 31;
+		if (inst.op == IROp::ShlImm)
+			SLLI_W(rd, rs, sa);
+		else if (inst.op == IROp::ShrImm)
+			SRLI_W(rd, rs, sa);
+		else if (inst.op == IROp::SarImm)
+			SRAI_W(rd, rs, sa);
+		else
+			ROTRI_W(rd, rs, sa);
+		break;
+	}
+
+	case IROp::SltConst:
+	case IROp::SltUConst:
+	{
+		regs_.MapDirtyIn(inst.dest, inst.src1);
+		LoongArch64Reg rd = regs_.R(inst.dest);
+		LoongArch64Reg rs = regs_.R(inst.src1);
+		// The immediate is sign extended in both cases, same as our register values.
+		if (FitsS12((s32)inst.constant)) {
+			if (inst.op == IROp::SltConst)
+				SLTI(rd, rs, (s16)inst.constant);
+			else
+				SLTUI(rd, rs, (s16)inst.constant);
+		} else {
+			MOVI2R(SCRATCH1, inst.constant);
+			if (inst.op == IROp::SltConst)
+				SLT(rd, rs, SCRATCH1);
+			else
+				SLTU(rd, rs, SCRATCH1);
+		}
+		break;
+	}
+
+	case IROp::Neg:
+	case IROp::Not:
+	case IROp::Clz:
+	case IROp::BSwap16:
+	case IROp::BSwap32:
+	case IROp::Ext8to32:
+	case IROp::Ext16to32:
+	case IROp::ReverseBits:
+	{
+		regs_.MapDirtyIn(inst.dest, inst.src1);
+		LoongArch64Reg rd = regs_.R(inst.dest);
+		LoongArch64Reg rs = regs_.R(inst.src1);
+		switch (inst.op) {
+		case IROp::Neg: SUB_W(rd, R_ZERO, rs); break;
+		case IROp::Not: NOR(rd, rs, R_ZERO); break;
+		case IROp::Clz: CLZ_W(rd, rs); break;
+		case IROp::BSwap16: REVB_2H(rd, rs); break;
+		case IROp::BSwap32:
+			REVB_2W(rd, rs);
+			ADDI_W(rd, rd, 0);
+			break;
+		case IROp::Ext8to32: EXT_W_B(rd, rs); break;
+		case IROp::Ext16to32: EXT_W_H(rd, rs); break;
+		case IROp::ReverseBits: BITREV_W(rd, rs); break;
+		default: break;
+		}
+		break;
+	}
+
+	case IROp::MovZ:
+	case IROp::MovNZ:
+	{
+		regs_.MapDirtyInIn(inst.dest, inst.src1, inst.src2, false);
+		LoongArch64Reg rd = regs_.R(inst.dest);
+		LoongArch64Reg cond = regs_.R(inst.src1);
+		LoongArch64Reg rt = regs_.R(inst.src2);
+		if (inst.op == IROp::MovZ) {
+			MASKNEZ(SCRATCH1, rt, cond);
+			MASKEQZ(SCRATCH2, rd, cond);
+		} else {
+			MASKEQZ(SCRATCH1, rt, cond);
+			MASKNEZ(SCRATCH2, rd, cond);
+		}
+		OR(rd, SCRATCH1, SCRATCH2);
+		break;
+	}
+
+	case IROp::Max:
+	case IROp::Min:
+	{
+		regs_.MapDirtyInIn(inst.dest, inst.src1, inst.src2);
+		LoongArch64Reg rd = regs_.R(inst.dest);
+		LoongArch64Reg rs = regs_.R(inst.src1);
+		LoongArch64Reg rt = regs_.R(inst.src2);
+		SLT(SCRATCH1, rs, rt);
+		if (inst.op == IROp::Max) {
+			MASKEQZ(SCRATCH2, rt, SCRATCH1);
+			MASKNEZ(SCRATCH1, rs, SCRATCH1);
+		} else {
+			MASKEQZ(SCRATCH2, rs, SCRATCH1);
+			MASKNEZ(SCRATCH1, rt, SCRATCH1);
+		}
+		OR(rd, SCRATCH1, SCRATCH2);
+		break;
+	}
+
+	case IROp::MtLo:
+	case IROp::MtHi:
+	{
+		IRReg target = inst.op == IROp::MtLo ? IRREG_LO : IRREG_HI;
+		regs_.MapDirtyIn(target, inst.src1);
+		MOVE(regs_.R(target), regs_.R(inst.src1));
+		break;
+	}
+
+	case IROp::MfLo:
+	case IROp::MfHi:
+	{
+		IRReg source = inst.op == IROp::MfLo ? IRREG_LO : IRREG_HI;
+		regs_.MapDirtyIn(inst.dest, source);
+		MOVE(regs_.R(inst.dest), regs_.R(source));
+		break;
+	}
+
+	case IROp::Mult:
+	case IROp::MultU:
+	case IROp::Madd:
+	case IROp::MaddU:
+	case IROp::Msub:
+	case IROp::MsubU:
+	{
+		bool accumulate = inst.op != IROp::Mult && inst.op != IROp::MultU;
+		bool isUnsigned = inst.op == IROp::MultU || inst.op == IROp::MaddU || inst.op == IROp::MsubU;
+		regs_.SpillLock(inst.src1, inst.src2, IRREG_LO);
+		regs_.SpillLock(IRREG_HI);
+		regs_.MapReg(inst.src1);
+		regs_.MapReg(inst.src2);
+		if (isUnsigned)
+			MULW_D_WU(SCRATCH1, regs_.R(inst.src1), regs_.R(inst.src2));
+		else
+			MULW_D_W(SCRATCH1, regs_.R(inst.src1), regs_.R(inst.src2));
+
+		LoongArch64Reg lo = regs_.MapReg(IRREG_LO, accumulate ? MAP_DIRTY : MAP_NOINIT);
+		LoongArch64Reg hi = regs_.MapReg(IRREG_HI, accumulate ? MAP_DIRTY : MAP_NOINIT);
+		regs_.ReleaseSpillLocks();
+		if (accumulate) {
+			// Glue hi:lo together, lo is sign extended so insert rather than OR.
+			SLLI_D(SCRATCH2, hi, 32);
+			BSTRINS_D(SCRATCH2, lo, 31, 0);
+			if (inst.op == IROp::Madd || inst.op == IROp::MaddU)
+				ADD_D(SCRATCH1, SCRATCH2, SCRATCH1);
+			else
+				SUB_D(SCRATCH1, SCRATCH2, SCRATCH1);
+		}
+		ADDI_W(lo, SCRATCH1, 0);
+		SRAI_D(hi, SCRATCH1, 32);
+		break;
+	}
+
+	case IROp::Load8:
+	case IROp::Load8Ext:
+	case IROp::Load16:
+	case IROp::Load16Ext:
+	case IROp::Load32:
+	{
+		LoongArch64Reg addr = MapAddress(inst.src1, inst.constant);
+		LoongArch64Reg rd = regs_.MapReg(inst.dest, MAP_NOINIT);
+		switch (inst.op) {
+		case IROp::Load8: LDX_BU(rd, MEMBASEREG, addr); break;
+		case IROp::Load8Ext: LDX_B(rd, MEMBASEREG, addr); break;
+		case IROp::Load16: LDX_HU(rd, MEMBASEREG, addr); break;
+		case IROp::Load16Ext: LDX_H(rd, MEMBASEREG, addr); break;
+		case IROp::Load32: LDX_W(rd, MEMBASEREG, addr); break;
+		default: break;
+		}
+		break;
+	}
+
+	case IROp::Store8:
+	case IROp::Store16:
+	case IROp::Store32:
+	{
+		regs_.SpillLock(inst.src3, inst.src1);
+		LoongArch64Reg addr = MapAddress(inst.src1, inst.constant);
+		LoongArch64Reg rt = regs_.MapReg(inst.src3);
+		regs_.ReleaseSpillLocks();
+		switch (inst.op) {
+		case IROp::Store8: STX_B(rt, MEMBASEREG, addr); break;
+		case IROp::Store16: STX_H(rt, MEMBASEREG, addr); break;
+		case IROp::Store32: STX_W(rt, MEMBASEREG, addr); break;
+		default: break;
+		}
+		break;
+	}
+
+	case IROp::LoadFloat:
+		FLDX_S(F0, MEMBASEREG, MapAddress(inst.src1, inst.constant));
+		StoreFPR(F0, inst.dest);
+		break;
+
+	case IROp::StoreFloat:
+		LoadFPR(F0, inst.src3);
+		FSTX_S(F0, MEMBASEREG, MapAddress(inst.src1, inst.constant));
+		break;
+
+	case IROp::LoadVec4:
+		VLDX(V0, MEMBASEREG, MapAddress(inst.src1, inst.constant));
+		VST(V0, CTXREG, FPROffset(inst.dest));
+		break;
+
+	case IROp::StoreVec4:
+		VLD(V0, CTXREG, FPROffset(inst.dest));
+		VSTX(V0, MEMBASEREG, MapAddress(inst.src1, inst.constant));
+		break;
+
+	case IROp::FAdd:
+	case IROp::FSub:
+	case IROp::FMul:
+	case IROp::FDiv:
+		LoadFPR(F0, inst.src1);
+		LoadFPR(F1, inst.src2);
+		switch (inst.op) {
+		case IROp::FAdd: FADD_S(F0, F0, F1); break;
+		case IROp::FSub: FSUB_S(F0, F0, F1); break;
+		// inf * 0 gives the default NaN, 0x7FC00000, which is what the PSP wants.
+		case IROp::FMul: FMUL_S(F0, F0, F1); break;
+		case IROp::FDiv: FDIV_S(F0, F0, F1); break;
+		default: break;
+		}
+		StoreFPR(F0, inst.dest);
+		break;
+
+	case IROp::FMov:
+		LD_W(SCRATCH1, CTXREG, FPROffset(inst.src1));
+		ST_W(SCRATCH1, CTXREG, FPROffset(inst.dest));
+		break;
+
+	case IROp::FAbs:
+	case IROp::FNeg:
+	case IROp::FSqrt:
+	case IROp::FCvtSW:
+		LoadFPR(F0, inst.src1);
+		if (inst.op == IROp::FAbs)
+			FABS_S(F0, F0);
+		else if (inst.op == IROp::FNeg)
+			FNEG_S(F0, F0);
+		else if (inst.op == IROp::FSqrt)
+			FSQRT_S(F0, F0);
+		else
+			FFINT_S_W(F0, F0);
+		StoreFPR(F0, inst.dest);
+		break;
+
+	case IROp::FMovFromGPR:
+		ST_W(regs_.MapReg(inst.src1), CTXREG, FPROffset(inst.dest));
+		break;
+
+	case IROp::FMovToGPR:
+		LD_W(regs_.MapReg(inst.dest, MAP_NOINIT), CTXREG, FPROffset(inst.src1));
+		break;
+
+	case IROp::FCmp:
+	{
+		LoongArch64Reg fpcond = regs_.MapReg(IRREG_FPCOND, MAP_NOINIT);
+		LoongArch64FCond cond;
+		switch (inst.dest) {
+		case IRFpCompareMode::EitherUnordered: cond = FCOND_CUN; break;
+		case IRFpCompareMode::EqualOrdered:
+		case IRFpCompareMode::EqualUnordered: cond = FCOND_CEQ; break;
+		case IRFpCompareMode::LessEqualOrdered:
+		case IRFpCompareMode::LessEqualUnordered: cond = FCOND_CLE; break;
+		case IRFpCompareMode::LessOrdered:
+		case IRFpCompareMode::LessUnordered: cond = FCOND_CLT; break;
+		default:
+			MOVE(fpcond, R_ZERO);
+			return;
+		}
+		LoadFPR(F0, inst.src1);
+		LoadFPR(F1, inst.src2);
+		FCMP_COND_S(FCC0, F0, F1, cond);
+		MOVCF2GR(fpcond, FCC0);
+		break;
+	}
+
+	case IROp::ZeroFpCond:
+		MOVE(regs_.MapReg(IRREG_FPCOND, MAP_NOINIT), R_ZERO);
+		break;
+
+	case IROp::FpCondToReg:
+		regs_.MapDirtyIn(inst.dest, IRREG_FPCOND);
+		MOVE(regs_.R(inst.dest), regs_.R(IRREG_FPCOND));
+		break;
+
+	case IROp::VfpuCtrlToReg:
+		regs_.MapDirtyIn(inst.dest, IRREG_VFPU_CTRL_BASE + inst.src1);
+		MOVE(regs_.R(inst.dest), regs_.R(IRREG_VFPU_CTRL_BASE + inst.src1));
+		break;
+
+	case IROp::SetCtrlVFPU:
+		MOVI2R(regs_.MapReg(IRREG_VFPU_CTRL_BASE + inst.dest, MAP_NOINIT), inst.constant);
+		break;
+
+	case IROp::SetCtrlVFPUReg:
+		regs_.MapDirtyIn(IRREG_VFPU_CTRL_BASE + inst.dest, inst.src1);
+		MOVE(regs_.R(IRREG_VFPU_CTRL_BASE + inst.dest), regs_.R(inst.src1));
+		break;
+
+	case IROp::SetCtrlVFPUFReg:
+		LD_W(regs_.MapReg(IRREG_VFPU_CTRL_BASE + inst.dest, MAP_NOINIT), CTXREG, FPROffset(inst.src1));
+		break;
+
+	case IROp::Vec4Mov:
+		VLD(V0, CTXREG, FPROffset(inst.src1));
+		VST(V0, CTXREG, FPROffset(inst.dest));
+		break;
+
+	case IROp::Vec4Add:
+	case IROp::Vec4Sub:
+	case IROp::Vec4Mul:
+	case IROp::Vec4Div:
+		VLD(V0, CTXREG, FPROffset(inst.src1));
+		VLD(V1, CTXREG, FPROffset(inst.src2));
+		switch (inst.op) {
+		case IROp::Vec4Add: VFADD_S(V0, V0, V1); break;
+		case IROp::Vec4Sub: VFSUB_S(V0, V0, V1); break;
+		case IROp::Vec4Mul: VFMUL_S(V0, V0, V1); break;
+		case IROp::Vec4Div: VFDIV_S(V0, V0, V1); break;
+		default: break;
+		}
+		VST(V0, CTXREG, FPROffset(inst.dest));
+		break;
+
+	case IROp::Vec4Scale:
+		VLD(V0, CTXREG, FPROffset(inst.src1));
+		VLDREPL(32, V1, CTXREG, FPROffset(inst.src2));
+		VFMUL_S(V0, V0, V1);
+		VST(V0, CTXREG, FPROffset(inst.dest));
+		break;
+
+	case IROp::Vec4Neg:
+	case IROp::Vec4Abs:
+		VLD(V0, CTXREG, FPROffset(inst.src1));
+		if (inst.op == IROp::Vec4Neg) {
+			MOVI2R(SCRATCH1, (u32)0x80000000);
+			VREPLGR2VR(32, V1, SCRATCH1);
+			VXOR_V(V0, V0, V1);
+		} else {
+			MOVI2R(SCRATCH1, (u32)0x7FFFFFFF);
+			VREPLGR2VR(32, V1, SCRATCH1);
+			VAND_V(V0, V0, V1);
+		}
+		VST(V0, CTXREG, FPROffset(inst.dest));
+		break;
+
+	case IROp::Downcount:
+		LD_W(SCRATCH1, CTXREG, DOWNCOUNT_OFFSET);
+		if (FitsS12(-(s32)inst.constant)) {
+			ADDI_W(SCRATCH1, SCRATCH1, (s16)-(s32)inst.constant);
+		} else {
+			MOVI2R(SCRATCH2, inst.constant);
+			SUB_W(SCRATCH1, SCRATCH1, SCRATCH2);
+		}
+		ST_W(SCRATCH1, CTXREG, DOWNCOUNT_OFFSET);
+		break;
+
+	case IROp::SetPC:
+		ST_W(regs_.MapReg(inst.src1), CTXREG, PC_OFFSET);
+		break;
+
+	case IROp::SetPCConst:
+		MOVI2R(SCRATCH1, inst.constant);
+		ST_W(SCRATCH1, CTXREG, PC_OFFSET);
+		break;
+
+	case IROp::ExitToConst:
+		regs_.FlushAll();
+		WriteConstExit(inst.constant);
+		break;
+
+	case IROp::ExitToReg:
+		MOVE(SCRATCH1, regs_.MapReg(inst.src1));
+		regs_.FlushAll();
+		WriteDynamicExit();
+		break;
+
+	case IROp::ExitToPC:
+		regs_.FlushAll();
+		LD_WU(SCRATCH1, CTXREG, PC_OFFSET);
+		WriteDynamicExit();
+		break;
+
+	case IROp::ExitToConstIfEq:
+	case IROp::ExitToConstIfNeq:
+	case IROp::ExitToConstIfGtZ:
+	case IROp::ExitToConstIfGeZ:
+	case IROp::ExitToConstIfLtZ:
+	case IROp::ExitToConstIfLeZ:
+	case IROp::ExitToConstIfFpTrue:
+	case IROp::ExitToConstIfFpFalse:
+	{
+		bool isFp = inst.op == IROp::ExitToConstIfFpTrue || inst.op == IROp::ExitToConstIfFpFalse;
+		LoongArch64Reg lhs;
+		LoongArch64Reg rhs = R_ZERO;
+		if (isFp) {
+			lhs = regs_.MapReg(IRREG_FPCOND);
+		} else if (inst.op == IROp::ExitToConstIfEq || inst.op == IROp::ExitToConstIfNeq) {
+			regs_.MapInIn(inst.src1, inst.src2);
+			lhs = regs_.R(inst.src1);
+			rhs = regs_.R(inst.src2);
+		} else {
+			lhs = regs_.MapReg(inst.src1);
+		}
+		// Write back, but keep the mappings for the path that doesn't exit.
+		regs_.FlushDirty();
+
+		// Branch over the exit when the condition is false.
+		FixupBranch skip;
+		switch (inst.op) {
+		case IROp::ExitToConstIfEq: skip = BNE(lhs, rhs); break;
+		case IROp::ExitToConstIfNeq: skip = BEQ(lhs, rhs); break;
+		case IROp::ExitToConstIfGtZ: skip = BGE(R_ZERO, lhs); break;
+		case IROp::ExitToConstIfGeZ: skip = BLT(lhs, R_ZERO); break;
+		case IROp::ExitToConstIfLtZ: skip = BGE(lhs, R_ZERO); break;
+		case IROp::ExitToConstIfLeZ: skip = BLT(R_ZERO, lhs); break;
+		case IROp::ExitToConstIfFpTrue: skip = BEQZ(lhs); break;
+		default: skip = BNEZ(lhs); break;
+		}
+		WriteConstExit(inst.constant);
+		SetJumpTarget(skip);
+		break;
+	}
+
+	default:
+		// Div/DivU (PSP specific results), FMin/FMax (NaN handling), the float to int
+		// conversions, left/right memory ops, the rarer VFPU ops, and system ops like
+		// Syscall and Interpret.
+		CompileFallback(inst);
+		break;
+	}
+}
+
+}  // namespace MIPSComp
+
+#endif // PPSSPP_ARCH(LOONGARCH64)
@@ -0,0 +1,88 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+// Lowers the (simplified) IR blocks of IRJit to native LoongArch64 code.
+// The frontend, the IR passes and the block cache are shared with the IR interpreter,
+// anything without a native lowering is handed back to IRInterpret one op at a time.
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/LoongArch64Emitter.h"
+#include "Core/MIPS/IR/IRJit.h"
+#include "Core/MIPS/LOONGARCH64/LoongArch64IRRegCache.h"
+
+namespace MIPSComp {
+
+class LoongArch64IRJit : public IRJit, public LoongArch64Gen::LoongArch64CodeBlock {
+public:
+	LoongArch64IRJit(MIPSState *mipsState);
+	~LoongArch64IRJit();
+
+	void RunLoopUntil(u64 globalticks) override;
+
+	bool DescribeCodePtr(const u8 *ptr, std::string &name) override;
+	bool CodeInRange(const u8 *ptr) const override { return IsInSpace(ptr); }
+	const u8 *GetDispatcher() const override { return dispatcher_; }
+
+	void ClearCache() override;
+
+	void LinkBlock(u8 *exitPoint, const u8 *checkedEntry) override;
+
+protected:
+	bool CompileTargetBlock(IRBlock *block, int block_num, bool preload) override;
+
+private:
+	void GenerateFixedCode();
+	void CompileIRInst(const IRInst &inst);
+	void CompileFallback(const IRInst &inst);
+
+	// Leaves the masked host offset in SCRATCH1, ready for LDX/STX against MEMBASEREG.
+	LoongArch64Gen::LoongArch64Reg MapAddress(IRReg base, u32 offset);
+	void LoadFPR(LoongArch64Gen::LoongArch64Reg fr, int irFpr);
+	void StoreFPR(LoongArch64Gen::LoongArch64Reg fr, int irFpr);
+
+	// All exits expect the destination PC in SCRATCH1 and the regcache flushed.
+	void WriteConstExit(u32 pc);
+	void WriteDynamicExit();
+
+	static void DispatcherCompile(LoongArch64IRJit *jit);
+
+	LoongArch64IRRegCache regs_;
+
+	const u8 *enterDispatcher_ = nullptr;
+	const u8 *outerLoop_ = nullptr;
+	const u8 *outerLoopPCInSCRATCH1_ = nullptr;
+	const u8 *dispatcherCheckCoreState_ = nullptr;
+	const u8 *dispatcher_ = nullptr;
+	const u8 *dispatcherPCInSCRATCH1_ = nullptr;
+	const u8 *quitLoop_ = nullptr;
+	int jitStartOffset_ = 0;
+
+	// Indexed by block number, offset of the normal entry from the code base (0 if none.)
+	// The dispatcher reads the data pointer through blockOffsetsPtr_, since it may move.
+	std::vector<u32> blockOffsets_;
+	const u32 *blockOffsetsPtr_ = nullptr;
+
+	// Every constant exit by target PC, so they can be (re)linked when a block for it is compiled.
+	std::unordered_multimap<u32, const u8 *> exitsByTarget_;
+};
+
+}  // namespace MIPSComp
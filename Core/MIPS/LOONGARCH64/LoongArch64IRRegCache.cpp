@@ -0,0 +1,196 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include "ppsspp_config.h"
+#if PPSSPP_ARCH(LOONGARCH64)
+
+#include "Common/Log.h"
+#include "Core/MIPS/LOONGARCH64/LoongArch64IRRegCache.h"
+
+using namespace LoongArch64Gen;
+using namespace LoongArch64IRJitConstants;
+
+// Callee-saved first.  The temps are only handed out under pressure.
+static const LoongArch64Reg allocationOrder[] = {
+	S2, S3, S4, S5, S6, S7, S8,
+	T2, T3, T4, T5, T6, T7, T8,
+};
+
+LoongArch64IRRegCache::LoongArch64IRRegCache(LoongArch64Emitter *emit) : emit_(emit) {
+	Start();
+}
+
+void LoongArch64IRRegCache::Start() {
+	for (int i = 0; i < NUM_HOSTREGS; i++) {
+		hr_[i].irReg = -1;
+		hr_[i].isDirty = false;
+		lastUse_[i] = 0;
+	}
+	for (int i = 0; i < TOTAL_MAPPABLE_MIPSREGS; i++) {
+		ir_[i].reg = INVALID_REG;
+		ir_[i].spillLock = false;
+		ir_[i].pinned = false;
+	}
+	useCounter_ = 0;
+}
+
+void LoongArch64IRRegCache::SetPinned(const std::vector<u8> &regs) {
+	for (u8 r : regs)
+		ir_[r].pinned = true;
+}
+
+LoongArch64Reg LoongArch64IRRegCache::R(IRReg r) {
+	if (r == MIPS_REG_ZERO)
+		return R_ZERO;
+	_dbg_assert_msg_(ir_[r].reg != INVALID_REG, "IR reg %d not mapped", r);
+	return ir_[r].reg;
+}
+
+LoongArch64Reg LoongArch64IRRegCache::MapReg(IRReg r, int flags) {
+	if (r == MIPS_REG_ZERO)
+		return R_ZERO;
+
+	LoongArch64Reg hr = ir_[r].reg;
+	if (hr == INVALID_REG) {
+		for (LoongArch64Reg candidate : allocationOrder) {
+			if (hr_[candidate].irReg == -1) {
+				hr = candidate;
+				break;
+			}
+		}
+		if (hr == INVALID_REG) {
+			hr = FindBestToSpill();
+			_assert_msg_(hr != INVALID_REG, "LoongArch64 regcache: all registers spill locked");
+			Release(hr);
+		}
+
+		hr_[hr].irReg = r;
+		hr_[hr].isDirty = false;
+		ir_[r].reg = hr;
+		if ((flags & MAP_NOINIT) != MAP_NOINIT) {
+			emit_->LD_W(hr, CTXREG, r * 4);
+		}
+	}
+
+	if (flags & MAP_DIRTY)
+		hr_[hr].isDirty = true;
+	lastUse_[hr] = ++useCounter_;
+	return hr;
+}
+
+LoongArch64Reg LoongArch64IRRegCache::FindBestToSpill() {
+	// First try to keep the pinned regs, then take whatever we can.
+	for (int pass = 0; pass < 2; ++pass) {
+		LoongArch64Reg best = INVALID_REG;
+		u32 bestUse = 0xFFFFFFFF;
+		for (LoongArch64Reg candidate : allocationOrder) {
+			IRReg r = hr_[candidate].irReg;
+			if (r == -1 || ir_[r].spillLock || (pass == 0 && ir_[r].pinned))
+				continue;
+			if (lastUse_[candidate] < bestUse) {
+				best = candidate;
+				bestUse = lastUse_[candidate];
+			}
+		}
+		if (best != INVALID_REG)
+			return best;
+	}
+	return INVALID_REG;
+}
+
+void LoongArch64IRRegCache::Release(LoongArch64Reg hr) {
+	IRReg r = hr_[hr].irReg;
+	if (r == -1)
+		return;
+	if (hr_[hr].isDirty) {
+		emit_->ST_W(hr, CTXREG, r * 4);
+	}
+	ir_[r].reg = INVALID_REG;
+	hr_[hr].irReg = -1;
+	hr_[hr].isDirty = false;
+}
+
+void LoongArch64IRRegCache::MapIn(IRReg rs) {
+	MapReg(rs);
+}
+
+void LoongArch64IRRegCache::MapInIn(IRReg rs, IRReg rt) {
+	SpillLock(rs, rt);
+	MapReg(rs);
+	MapReg(rt);
+	ReleaseSpillLocks();
+}
+
+void LoongArch64IRRegCache::MapDirtyIn(IRReg rd, IRReg rs, bool avoidLoad) {
+	SpillLock(rd, rs);
+	bool load = !avoidLoad || rd == rs;
+	MapReg(rd, load ? MAP_DIRTY : MAP_NOINIT);
+	MapReg(rs);
+	ReleaseSpillLocks();
+}
+
+void LoongArch64IRRegCache::MapDirtyInIn(IRReg rd, IRReg rs, IRReg rt, bool avoidLoad) {
+	SpillLock(rd, rs, rt);
+	bool load = !avoidLoad || (rd == rs || rd == rt);
+	MapReg(rd, load ? MAP_DIRTY : MAP_NOINIT);
+	MapReg(rt);
+	MapReg(rs);
+	ReleaseSpillLocks();
+}
+
+void LoongArch64IRRegCache::SpillLock(IRReg r1, IRReg r2, IRReg r3) {
+	ir_[r1].spillLock = true;
+	if (r2 != -1) ir_[r2].spillLock = true;
+	if (r3 != -1) ir_[r3].spillLock = true;
+}
+
+void LoongArch64IRRegCache::ReleaseSpillLocks() {
+	for (int i = 0; i < TOTAL_MAPPABLE_MIPSREGS; i++) {
+		ir_[i].spillLock = false;
+	}
+}
+
+void LoongArch64IRRegCache::FlushReg(IRReg r) {
+	if (r != MIPS_REG_ZERO && ir_[r].reg != INVALID_REG)
+		Release(ir_[r].reg);
+}
+
+void LoongArch64IRRegCache::DiscardReg(IRReg r) {
+	LoongArch64Reg hr = r == MIPS_REG_ZERO ? INVALID_REG : ir_[r].reg;
+	if (hr == INVALID_REG)
+		return;
+	ir_[r].reg = INVALID_REG;
+	hr_[hr].irReg = -1;
+	hr_[hr].isDirty = false;
+}
+
+void LoongArch64IRRegCache::FlushDirty() {
+	for (LoongArch64Reg hr : allocationOrder) {
+		if (hr_[hr].irReg != -1 && hr_[hr].isDirty) {
+			emit_->ST_W(hr, CTXREG, hr_[hr].irReg * 4);
+			hr_[hr].isDirty = false;
+		}
+	}
+}
+
+void LoongArch64IRRegCache::FlushAll() {
+	for (LoongArch64Reg hr : allocationOrder) {
+		Release(hr);
+	}
+}
+
+#endif // PPSSPP_ARCH(LOONGARCH64)
@@ -0,0 +1,102 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+// Maps IR GPRs (indices into MIPSState::r, including the IR temps and the "other" regs
+// like lo/hi) onto LoongArch64 host registers.  IRRegCache only does constant folding
+// before the IR passes, this is the one that actually allocates.
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/LoongArch64Emitter.h"
+#include "Core/MIPS/IR/IRRegCache.h"
+
+namespace LoongArch64IRJitConstants {
+
+// Points at mips_->r[0], so IR reg N is at CTXREG + N * 4.
+const LoongArch64Gen::LoongArch64Reg CTXREG = LoongArch64Gen::S0;
+const LoongArch64Gen::LoongArch64Reg MEMBASEREG = LoongArch64Gen::S1;
+const LoongArch64Gen::LoongArch64Reg SCRATCH1 = LoongArch64Gen::T0;
+const LoongArch64Gen::LoongArch64Reg SCRATCH2 = LoongArch64Gen::T1;
+
+// Initing is the default so the flag is reversed.
+enum {
+	MAP_DIRTY = 1,
+	MAP_NOINIT = 2 | MAP_DIRTY,
+};
+
+}  // namespace
+
+typedef int IRReg;
+
+class LoongArch64IRRegCache {
+public:
+	LoongArch64IRRegCache(LoongArch64Gen::LoongArch64Emitter *emit);
+
+	// Forget all mappings, call at the start of each block.
+	void Start();
+	// Hint from IRComputeLiveness, these are only spilled when nothing else can be.
+	void SetPinned(const std::vector<u8> &regs);
+
+	// Values are kept sign extended from 32 bits, which is what the W ops produce.
+	LoongArch64Gen::LoongArch64Reg MapReg(IRReg r, int flags = 0);
+	void MapIn(IRReg rs);
+	void MapInIn(IRReg rs, IRReg rt);
+	void MapDirtyIn(IRReg rd, IRReg rs, bool avoidLoad = true);
+	void MapDirtyInIn(IRReg rd, IRReg rs, IRReg rt, bool avoidLoad = true);
+
+	void SpillLock(IRReg r1, IRReg r2 = -1, IRReg r3 = -1);
+	void ReleaseSpillLocks();
+
+	// Writes back dirty regs.  Mappings are dropped too, since this is used before calls
+	// that may read or write the context.
+	void FlushAll();
+	// Writes back dirty regs but keeps them mapped, for conditional exits.
+	void FlushDirty();
+	void FlushReg(IRReg r);
+	// The IR reg is about to be written in memory behind our back.
+	void DiscardReg(IRReg r);
+
+	LoongArch64Gen::LoongArch64Reg R(IRReg r);
+
+private:
+	struct HostReg {
+		IRReg irReg;  // -1 if free.
+		bool isDirty;
+	};
+	struct IRRegInfo {
+		LoongArch64Gen::LoongArch64Reg reg;  // INVALID_REG if in memory.
+		bool spillLock;
+		bool pinned;
+	};
+
+	enum {
+		NUM_HOSTREGS = 32,
+	};
+
+	LoongArch64Gen::LoongArch64Reg FindBestToSpill();
+	void Release(LoongArch64Gen::LoongArch64Reg hr);
+
+	LoongArch64Gen::LoongArch64Emitter *emit_;
+	HostReg hr_[NUM_HOSTREGS];
+	IRRegInfo ir_[TOTAL_MAPPABLE_MIPSREGS];
+	// Bumped on every use, so we spill the least recently used reg.
+	u32 lastUse_[NUM_HOSTREGS];
+	u32 useCounter_ = 0;
+};
@@ -18,6 +18,7 @@
 #include "ppsspp_config.h"
 #if PPSSPP_ARCH(LOONGARCH64)
 
+#include "Common/MemoryUtil.h"
 #include "Common/Profiler/Profiler.h"
 #include "Common/Serialize/Serializer.h"
 #include "Common/Serialize/SerializeFuncs.h"
@@ -238,7 +239,15 @@ void LoongArch64Jit::Comp_RunBlock(MIPSOpcode op)
 }
 
 void LoongArch64Jit::LinkBlock(u8 *exitPoint, const u8 *checkedEntry) {
-	// TODO
+	if (PlatformIsWXExclusive()) {
+		ProtectMemoryPages(exitPoint, 32, MEM_PROT_READ | MEM_PROT_WRITE);
+	}
+	LoongArch64Emitter emit(exitPoint);
+	emit.B(checkedEntry);
+	emit.FlushIcache();
+	if (PlatformIsWXExclusive()) {
+		ProtectMemoryPages(exitPoint, 32, MEM_PROT_READ | MEM_PROT_EXEC);
+	}
 }
 
 void LoongArch64Jit::UnlinkBlock(u8 *checkedEntry, u32 originalAddress) {
@@ -267,7 +276,8 @@ void LoongArch64Jit::Comp_Generic(MIPSOpcode op)
 		//SaveDowncount();
 		RestoreRoundingMode();
 		// Move Imm32(js.compilerPC) in to M(&mips_->pc)
-		QuickCallFunction(V1, (void *)func);
+		MOVI2R(A0, op.encoding);
+		QuickCallFunction(T0, (void *)func);
 		ApplyRoundingMode();
 		//RestoreDowncount();
 	}
@@ -281,10 +291,10 @@ void LoongArch64Jit::Comp_Generic(MIPSOpcode op)
 	}
 }
 
-void LoongArch64Jit::MovFromPC(MIPSReg r) {
+void LoongArch64Jit::MovFromPC(LoongArch64Reg r) {
 }
 
-void LoongArch64Jit::MovToPC(MIPSReg r) {
+void LoongArch64Jit::MovToPC(LoongArch64Reg r) {
 }
 
 void LoongArch64Jit::SaveDowncount() {
@@ -296,7 +306,7 @@ void LoongArch64Jit::RestoreDowncount() {
 void LoongArch64Jit::WriteDownCount(int offset) {
 }
 
-void LoongArch64Jit::WriteDownCountR(MIPSReg reg) {
+void LoongArch64Jit::WriteDownCountR(LoongArch64Reg reg) {
 }
 
 void LoongArch64Jit::RestoreRoundingMode(bool force) {
@@ -327,7 +337,7 @@ void LoongArch64Jit::WriteExit(u32 destination, int exit_num)
 	}
 }
 
-void LoongArch64Jit::WriteExitDestInR(MIPSReg Reg)
+void LoongArch64Jit::WriteExitDestInR(LoongArch64Reg Reg)
 {
 	MovToPC(Reg);
 	//WriteDownCount();
@@ -363,4 +373,4 @@ void LoongArch64Jit::WriteSyscallExit()
 	
 }
 
-#endif // PPSSPP_ARCH(MIPS)
+#endif // PPSSPP_ARCH(LOONGARCH64)
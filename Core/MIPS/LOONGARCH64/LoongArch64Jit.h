@@ -17,8 +17,8 @@
 
 #pragma once
 
-#include "Common/MipsEmitter.h"
-using namespace MIPSGen;
+#include "Common/LoongArch64Emitter.h"
+using namespace LoongArch64Gen;
 
 #include "Core/MIPS/JitCommon/JitCommon.h"
 #include "Core/MIPS/JitCommon/JitState.h"
@@ -32,7 +32,7 @@ using namespace MIPSGen;
 namespace MIPSComp
 {
 
-class LoongArch64Jit : public MIPSGen::MIPSCodeBlock, public JitInterface, public MIPSFrontendInterface
+class LoongArch64Jit : public LoongArch64Gen::LoongArch64CodeBlock, public JitInterface, public MIPSFrontendInterface
 {
 public:
 	LoongArch64Jit(MIPSState *mipsState);
@@ -157,12 +157,12 @@ class LoongArch64Jit : public MIPSGen::MIPSCodeBlock, public JitInterface, publi
 	void FlushPrefixV();
 
 	void WriteDownCount(int offset = 0);
-	void WriteDownCountR(MIPSReg reg);
+	void WriteDownCountR(LoongArch64Reg reg);
 	void RestoreRoundingMode(bool force = false);
 	void ApplyRoundingMode(bool force = false);
 	void UpdateRoundingMode();
-	void MovFromPC(MIPSReg r);
-	void MovToPC(MIPSReg r);
+	void MovFromPC(LoongArch64Reg r);
+	void MovToPC(LoongArch64Reg r);
 
 	bool ReplaceJalTo(u32 dest);
 
@@ -170,7 +170,7 @@ class LoongArch64Jit : public MIPSGen::MIPSCodeBlock, public JitInterface, publi
 	void RestoreDowncount();
 
 	void WriteExit(u32 destination, int exit_num);
-	void WriteExitDestInR(MIPSReg Reg);
+	void WriteExitDestInR(LoongArch64Reg Reg);
 	void WriteSyscallExit();
 
 	JitBlockCache blocks;
@@ -72,6 +72,14 @@ static void UseLargeMem(int memsize) {
 	}
 }
 
+static BlockDevice *ConstructGameBlockDevice(FileLoader *fileLoader) {
+	BlockDevice *bd = constructBlockDevice(fileLoader);
+	// Nothing to gain when the whole ISO is in RAM anyway.
+	if (bd && g_Config.bDiscReadAhead && !g_Config.bCacheFullIsoInRam)
+		bd = new PrefetchingBlockDevice(bd);
+	return bd;
+}
+
 // We gather the game info before actually loading/booting the ISO
 // to determine if the emulator should enable extra memory and
 // double-sized texture coordinates.
@@ -87,7 +95,7 @@ void InitMemoryForGameISO(FileLoader *fileLoader) {
 		fileSystem = std::shared_ptr<IFileSystem>(new VirtualDiscFileSystem(&pspFileSystem, fileLoader->GetPath()));
 		blockSystem = fileSystem;
 	} else {
-		auto bd = constructBlockDevice(fileLoader);
+		auto bd = ConstructGameBlockDevice(fileLoader);
 		// Can't init anything without a block device...
 		if (!bd)
 			return;
@@ -155,7 +163,7 @@ bool ReInitMemoryForGameISO(FileLoader *fileLoader) {
 		fileSystem = std::shared_ptr<IFileSystem>(new VirtualDiscFileSystem(&pspFileSystem, fileLoader->GetPath()));
 		blockSystem = fileSystem;
 	} else {
-		auto bd = constructBlockDevice(fileLoader);
+		auto bd = ConstructGameBlockDevice(fileLoader);
 		if (!bd)
 			return false;
 
@@ -365,7 +373,7 @@ static Path NormalizePath(const Path &path) {
 bool Load_PSP_ELF_PBP(FileLoader *fileLoader, std::string *error_string) {
 	// This is really just for headless, might need tweaking later.
 	if (PSP_CoreParameter().mountIsoLoader != nullptr) {
-		auto bd = constructBlockDevice(PSP_CoreParameter().mountIsoLoader);
+		auto bd = ConstructGameBlockDevice(PSP_CoreParameter().mountIsoLoader);
 		if (bd != NULL) {
 			std::shared_ptr<IFileSystem> umd2 = std::shared_ptr<IFileSystem>(new ISOFileSystem(&pspFileSystem, bd));
 			std::shared_ptr<IFileSystem> blockSystem = std::shared_ptr<IFileSystem>(new ISOBlockSystem(umd2));
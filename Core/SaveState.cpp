@@ -16,12 +16,17 @@
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <vector>
-#include <thread>
 #include <mutex>
 
+#include <zstd.h>
+
+
 #include "Common/Data/Text/I18n.h"
-#include "Common/Thread/ThreadUtil.h"
+#include "Common/Thread/ParallelLoop.h"
 #include "Common/Data/Text/Parsers.h"
 
 #include "Common/File/FileUtil.h"
@@ -92,8 +97,7 @@ namespace SaveState
 	CChunkFileReader::Error SaveToRam(std::vector<u8> &data) {
 		SaveStart state;
 		size_t sz = CChunkFileReader::MeasurePtr(state);
-		if (data.size() < sz)
-			data.resize(sz);
+		data.resize(sz);
 		return CChunkFileReader::SavePtr(&data[0], state, sz);
 	}
 
@@ -102,152 +106,258 @@ namespace SaveState
 		return CChunkFileReader::LoadPtr(&data[0], state, errorString);
 	}
 
-	struct StateRingbuffer
+	// Rewind snapshots, kept within a memory budget.  Every so often a full state is taken as a base,
+	// the ones in between only keep the blocks that changed since.  Blocks are found dirty by hash,
+	// so bases don't need to stay around uncompressed.  Everything is zstd compressed in segments,
+	// in parallel on the thread pool.
+	class StateRingbuffer
 	{
-		StateRingbuffer(int size) : first_(0), next_(0), size_(size), base_(-1)
-		{
-			states_.resize(size);
-			baseMapping_.resize(size);
-		}
-
+	public:
 		CChunkFileReader::Error Save()
 		{
 			std::lock_guard<std::mutex> guard(lock_);
-
-			int n = next_++ % size_;
-			if ((next_ % size_) == first_)
-				++first_;
-
-			static std::vector<u8> buffer;
-			std::vector<u8> *compressBuffer = &buffer;
-			CChunkFileReader::Error err;
-
-			if (base_ == -1 || ++baseUsage_ > BASE_USAGE_INTERVAL)
+			// Only one snapshot in flight, since it's compressed from buffer_.
+			WaitForCompress();
+			Trim();
+
+			CChunkFileReader::Error err = SaveToRam(buffer_);
+			if (err != CChunkFileReader::ERROR_NONE)
+				return err;
+
+			std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+			entry->rawSize = buffer_.size();
+			entry->segments.resize((buffer_.size() + SEGMENT_SIZE - 1) / SEGMENT_SIZE);
+			if (NeedsNewBase())
 			{
-				base_ = (base_ + 1) % ARRAY_SIZE(bases_);
+				base_ = entry;
+				baseData_ = buffer_;
 				baseUsage_ = 0;
-				err = SaveToRam(bases_[base_]);
-				// Let's not bother savestating twice.
-				compressBuffer = &bases_[base_];
 			}
 			else
-				err = SaveToRam(buffer);
+			{
+				entry->base = base_;
+			}
+			entries_.push_back(entry);
 
-			if (err == CChunkFileReader::ERROR_NONE)
-				ScheduleCompress(&states_[n], compressBuffer, &bases_[base_]);
-			else
-				states_[n].clear();
-			baseMapping_[n] = base_;
+			compressCounter_ = ParallelRangeLoopWaitable(&g_threadManager, [this, entry](int lower, int upper) {
+				for (int i = lower; i < upper; ++i)
+					CompressSegment(*entry, i);
+			}, 0, (int)entry->segments.size(), 1);
 			return err;
 		}
 
 		CChunkFileReader::Error Restore(std::string *errorString)
 		{
 			std::lock_guard<std::mutex> guard(lock_);
+			WaitForCompress();
 
 			// No valid states left.
-			if (Empty())
+			if (entries_.empty())
 				return CChunkFileReader::ERROR_BAD_FILE;
 
-			int n = (--next_ + size_) % size_;
-			if (states_[n].empty())
+			std::shared_ptr<Entry> entry = entries_.back();
+			entries_.pop_back();
+			// Don't build the next deltas on an entry that's no longer in the ring.
+			if (entry == base_)
+			{
+				base_.reset();
+				baseData_.clear();
+			}
+			if (entry->failed || !Decompress(*entry, buffer_))
 				return CChunkFileReader::ERROR_BAD_FILE;
-
-			static std::vector<u8> buffer;
-			LockedDecompress(buffer, states_[n], bases_[baseMapping_[n]]);
-			return LoadFromRam(buffer, errorString);
+			return LoadFromRam(buffer_, errorString);
 		}
 
-		void ScheduleCompress(std::vector<u8> *result, const std::vector<u8> *state, const std::vector<u8> *base)
+		void Clear()
 		{
-			if (compressThread_.joinable())
-				compressThread_.join();
-			compressThread_ = std::thread([=]{
-				SetCurrentThreadName("SaveStateCompress");
-				Compress(*result, *state, *base);
-			});
+			// This lock is mainly for shutdown.
+			std::lock_guard<std::mutex> guard(lock_);
+			WaitForCompress();
+			entries_.clear();
+			base_.reset();
+			baseData_.clear();
+			baseUsage_ = 0;
 		}
 
-		void Compress(std::vector<u8> &result, const std::vector<u8> &state, const std::vector<u8> &base)
+		bool Empty() const
 		{
 			std::lock_guard<std::mutex> guard(lock_);
-			// Bail if we were cleared before locking.
-			if (first_ == 0 && next_ == 0)
-				return;
+			return entries_.empty();
+		}
 
-			result.clear();
-			for (size_t i = 0; i < state.size(); i += BLOCK_SIZE)
+	private:
+		struct Entry
+		{
+			// Null for a base, which has all blocks.
+			std::shared_ptr<Entry> base;
+			size_t rawSize = 0;
+			// Compressed separately so they can be done in parallel.  Empty for a delta segment without dirty blocks.
+			std::vector<std::vector<u8>> segments;
+			std::atomic<bool> failed{ false };
+
+			size_t Bytes() const
 			{
-				int blockSize = std::min(BLOCK_SIZE, (int)(state.size() - i));
-				if (i + blockSize > base.size() || memcmp(&state[i], &base[i], blockSize) != 0)
+				size_t bytes = sizeof(Entry);
+				for (const auto &segment : segments)
+					bytes += segment.size();
+				return bytes;
+			}
+		};
+
+		static size_t BlockSize(size_t block, size_t stateSize)
+		{
+			return std::min((size_t)BLOCK_SIZE, stateSize - block * BLOCK_SIZE);
+		}
+
+		bool NeedsNewBase()
+		{
+			if (!base_ || entries_.empty() || ++baseUsage_ > BASE_USAGE_INTERVAL)
+				return true;
+			// Once deltas get large, a fresh base is cheaper.
+			const Entry &last = *entries_.back();
+			return last.base && last.Bytes() * 2 > base_->Bytes();
+		}
+
+		// Called on the thread pool.  buffer_ and baseData_ are left alone until all segments are done.
+		void CompressSegment(Entry &entry, int segment)
+		{
+			const size_t start = (size_t)segment * SEGMENT_SIZE;
+			const size_t end = std::min(start + SEGMENT_SIZE, buffer_.size());
+			const size_t firstBlock = start / BLOCK_SIZE;
+			const size_t numBlocks = (end - start + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+			const u8 *src = &buffer_[start];
+			size_t srcSize = end - start;
+			std::vector<u8> delta;
+			if (entry.base)
+			{
+				// One flag per block, then the data of the dirty ones.  Compared byte for byte, a hash
+				// collision would silently bring back stale memory on rewind.
+				delta.resize(numBlocks);
+				bool dirty = false;
+				for (size_t i = 0; i < numBlocks; ++i)
 				{
-					result.push_back(1);
-					result.insert(result.end(), state.begin() + i, state.begin() +i + blockSize);
+					size_t block = firstBlock + i;
+					const u8 *data = &buffer_[block * BLOCK_SIZE];
+					size_t blockSize = BlockSize(block, buffer_.size());
+					bool clean = block * BLOCK_SIZE < baseData_.size() && BlockSize(block, baseData_.size()) == blockSize && memcmp(&baseData_[block * BLOCK_SIZE], data, blockSize) == 0;
+					if (!clean)
+					{
+						delta[i] = 1;
+						delta.insert(delta.end(), data, data + blockSize);
+						dirty = true;
+					}
 				}
-				else
-					result.push_back(0);
+				if (!dirty)
+					return;
+				src = &delta[0];
+				srcSize = delta.size();
 			}
+
+			std::vector<u8> &result = entry.segments[segment];
+			result.resize(ZSTD_compressBound(srcSize));
+			size_t written = ZSTD_compress(&result[0], result.size(), src, srcSize, COMPRESS_LEVEL);
+			if (ZSTD_isError(written))
+			{
+				entry.failed = true;
+				result.clear();
+				return;
+			}
+			result.resize(written);
+			result.shrink_to_fit();
 		}
 
-		void LockedDecompress(std::vector<u8> &result, const std::vector<u8> &compressed, const std::vector<u8> &base)
+		bool Decompress(const Entry &entry, std::vector<u8> &result)
 		{
-			result.clear();
-			result.reserve(base.size());
-			auto basePos = base.begin();
-			for (size_t i = 0; i < compressed.size(); )
+			if (entry.base && !Decompress(*entry.base, result))
+				return false;
+			// Blocks a delta didn't store are all within the base's size.
+			result.resize(entry.rawSize);
+
+			std::vector<u8> delta;
+			for (size_t segment = 0; segment < entry.segments.size(); ++segment)
 			{
-				if (compressed[i] == 0)
+				const std::vector<u8> &compressed = entry.segments[segment];
+				const size_t start = segment * SEGMENT_SIZE;
+				const size_t end = std::min(start + SEGMENT_SIZE, entry.rawSize);
+				if (!entry.base)
 				{
-					++i;
-					int blockSize = std::min(BLOCK_SIZE, (int)(base.size() - result.size()));
-					result.insert(result.end(), basePos, basePos + blockSize);
-					basePos += blockSize;
+					size_t size = ZSTD_decompress(&result[start], end - start, compressed.data(), compressed.size());
+					if (ZSTD_isError(size) || size != end - start)
+						return false;
+					continue;
 				}
-				else
+				if (compressed.empty())
+					continue;
+
+				const size_t firstBlock = start / BLOCK_SIZE;
+				const size_t numBlocks = (end - start + BLOCK_SIZE - 1) / BLOCK_SIZE;
+				delta.resize(numBlocks + end - start);
+				size_t size = ZSTD_decompress(&delta[0], delta.size(), compressed.data(), compressed.size());
+				if (ZSTD_isError(size) || size < numBlocks)
+					return false;
+				size_t pos = numBlocks;
+				for (size_t i = 0; i < numBlocks; ++i)
 				{
-					++i;
-					int blockSize = std::min(BLOCK_SIZE, (int)(compressed.size() - i));
-					result.insert(result.end(), compressed.begin() + i, compressed.begin() + i + blockSize);
-					i += blockSize;
-					basePos += blockSize;
+					if (!delta[i])
+						continue;
+					size_t block = firstBlock + i;
+					size_t blockSize = BlockSize(block, entry.rawSize);
+					if (pos + blockSize > size)
+						return false;
+					memcpy(&result[block * BLOCK_SIZE], &delta[pos], blockSize);
+					pos += blockSize;
 				}
 			}
+			return true;
 		}
 
-		void Clear()
+		size_t UsedBytes() const
 		{
-			if (compressThread_.joinable())
-				compressThread_.join();
-
-			// This lock is mainly for shutdown.
-			std::lock_guard<std::mutex> guard(lock_);
-			first_ = 0;
-			next_ = 0;
+			size_t bytes = 0;
+			for (const auto &entry : entries_)
+				bytes += entry->Bytes();
+			// The oldest deltas may still hold on to a base that was dropped.
+			if (!entries_.empty() && entries_.front()->base)
+				bytes += entries_.front()->base->Bytes();
+			return bytes;
 		}
 
-		bool Empty() const
+		void Trim()
 		{
-			return next_ == first_;
+			const size_t limit = (size_t)std::max(g_Config.iRewindMaxMemoryMB, 1) * 1024 * 1024;
+			while (entries_.size() > 1 && UsedBytes() > limit)
+				entries_.pop_front();
 		}
 
-		static const int BLOCK_SIZE;
-		// TODO: Instead, based on size of compressed state?
-		static const int BASE_USAGE_INTERVAL;
-
-		typedef std::vector<u8> StateBuffer;
-
-		int first_;
-		int next_;
-		int size_;
+		void WaitForCompress()
+		{
+			if (compressCounter_)
+			{
+				compressCounter_->WaitAndRelease();
+				compressCounter_ = nullptr;
+			}
+		}
 
-		std::vector<StateBuffer> states_;
-		StateBuffer bases_[2];
-		std::vector<int> baseMapping_;
-		std::mutex lock_;
-		std::thread compressThread_;
+		enum
+		{
+			BLOCK_SIZE = 8192,
+			// 64 blocks, a few of these per core for a typical state.
+			SEGMENT_SIZE = 512 * 1024,
+			BASE_USAGE_INTERVAL = 15,
+			// Rewind favors speed, the deltas are mostly small anyway.
+			COMPRESS_LEVEL = 1,
+		};
 
-		int base_;
-		int baseUsage_;
+		std::deque<std::shared_ptr<Entry>> entries_;
+		std::shared_ptr<Entry> base_;
+		// The uncompressed state of base_, what new deltas are compared against.  Not counted
+		// in the rewind memory limit, it's one state no matter how many are kept.
+		std::vector<u8> baseData_;
+		int baseUsage_ = 0;
+		std::vector<u8> buffer_;
+		WaitableCounter *compressCounter_ = nullptr;
+		mutable std::mutex lock_;
 	};
 
 	static bool needsProcess = false;
@@ -264,15 +374,11 @@ namespace SaveState
 	static int lastSaveDataGeneration = 0;
 	static std::string saveStateInitialGitVersion = "";
 
-	// TODO: Should this be configurable?
-	static const int REWIND_NUM_STATES = 20;
 	static const int SCREENSHOT_FAILURE_RETRIES = 15;
-	static StateRingbuffer rewindStates(REWIND_NUM_STATES);
+	static StateRingbuffer rewindStates;
 	// TODO: Any reason for this to be configurable?
 	const static float rewindMaxWallFrequency = 1.0f;
 	static double rewindLastTime = 0.0f;
-	const int StateRingbuffer::BLOCK_SIZE = 8192;
-	const int StateRingbuffer::BASE_USAGE_INTERVAL = 15;
 
 	void SaveStart::DoState(PointerWrap &p)
 	{
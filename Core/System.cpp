@@ -46,6 +46,7 @@
 #include "Core/MIPS/MIPS.h"
 #include "Core/MIPS/MIPSAnalyst.h"
 #include "Core/MIPS/MIPSVFPUUtils.h"
+#include "Core/MIPS/JitCommon/JitCommon.h"
 #include "Core/Debugger/SymbolMap.h"
 #include "Core/Host.h"
 #include "Core/System.h"
@@ -217,6 +218,13 @@ bool DiscIDFromGEDumpPath(const Path &path, FileLoader *fileLoader, std::string
 	}
 }
 
+static Path JitCachePath() {
+	std::string discID = g_paramSFO.GetDiscID();
+	if (discID.empty() || !g_Config.bIRDiskCache)
+		return Path();
+	return GetSysDirectory(DIRECTORY_APP_CACHE) / (discID + ".ircache");
+}
+
 bool CPU_Init(std::string *errorString) {
 	coreState = CORE_POWERUP;
 	currentMIPS = &mipsr4k;
@@ -299,6 +307,11 @@ bool CPU_Init(std::string *errorString) {
 	}
 	mipsr4k.Reset();
 
+	// Blocks are only used once the game's code is there and matches, so this can go before loading.
+	Path jitCachePath = JitCachePath();
+	if (MIPSComp::jit && jitCachePath.Valid())
+		MIPSComp::jit->LoadCache(jitCachePath);
+
 	host->AttemptLoadSymbolMap();
 
 	if (coreParameter.enableSound) {
@@ -343,6 +356,13 @@ void CPU_Shutdown() {
 	PSP_LoadingLock lock;
 	PSPLoaders_Shutdown();
 
+	// Before anything unloads, so the blocks still match the code in memory.
+	Path jitCachePath = JitCachePath();
+	if (MIPSComp::jit && jitCachePath.Valid()) {
+		File::CreateFullPath(GetSysDirectory(DIRECTORY_APP_CACHE));
+		MIPSComp::jit->SaveCache(jitCachePath);
+	}
+
 	if (g_Config.bAutoSaveSymbolMap) {
 		host->SaveSymbolMap();
 	}
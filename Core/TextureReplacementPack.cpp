@@ -0,0 +1,117 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+#include <cstring>
+#include <zstd.h>
+
+#include "ext/xxhash.h"
+
+#include "Common/Log.h"
+#include "Core/Loaders.h"
+#include "Core/TextureReplacementPack.h"
+#include "Core/FileLoaders/LocalFileLoader.h"
+
+static const int PACK_VERSION = 1;
+
+ReplacementPack::~ReplacementPack() {
+	delete file_;
+}
+
+ReplacementPack *ReplacementPack::Open(const Path &filename) {
+	FileLoader *file = new LocalFileLoader(filename);
+	ReplacementPackHeader header{};
+	if (!file->Exists() || file->ReadAt(0, sizeof(header), &header) != sizeof(header)) {
+		delete file;
+		return nullptr;
+	}
+
+	const u64 indexSize = (u64)header.numEntries * sizeof(ReplacementPackEntry);
+	const u64 fileSize = (u64)file->FileSize();
+	if (memcmp(header.magic, "PPTP", 4) != 0 || header.version != PACK_VERSION || header.fileSize != fileSize || header.indexOffset + indexSize > fileSize) {
+		ERROR_LOG(G3D, "Invalid texture pack: %s", filename.c_str());
+		delete file;
+		return nullptr;
+	}
+
+	ReplacementPack *pack = new ReplacementPack();
+	pack->file_ = file;
+	pack->numEntries_ = header.numEntries;
+	pack->fileSize_ = fileSize;
+	pack->index_ = (const ReplacementPackEntry *)file->GetView(header.indexOffset, (size_t)indexSize);
+	if (!pack->index_ && indexSize != 0) {
+		pack->indexCopy_.resize(header.numEntries);
+		if (file->ReadAt(header.indexOffset, (size_t)indexSize, &pack->indexCopy_[0]) != indexSize) {
+			ERROR_LOG(G3D, "Could not read texture pack index: %s", filename.c_str());
+			delete pack;
+			return nullptr;
+		}
+		pack->index_ = &pack->indexCopy_[0];
+	}
+
+	INFO_LOG(G3D, "Opened texture pack with %d files: %s", (int)header.numEntries, filename.c_str());
+	return pack;
+}
+
+u64 ReplacementPack::HashName(const std::string &name) {
+	std::string normalized = name;
+	std::replace(normalized.begin(), normalized.end(), '\\', '/');
+	return XXH64(normalized.data(), normalized.size(), 0);
+}
+
+const ReplacementPackEntry *ReplacementPack::Find(const std::string &name) const {
+	const u64 nameHash = HashName(name);
+	const ReplacementPackEntry *end = index_ + numEntries_;
+	const ReplacementPackEntry *it = std::lower_bound(index_, end, nameHash, [](const ReplacementPackEntry &entry, u64 h) {
+		return entry.nameHash < h;
+	});
+	if (it == end || it->nameHash != nameHash)
+		return nullptr;
+	return it;
+}
+
+bool ReplacementPack::Read(const ReplacementPackEntry &entry, std::vector<u8> &out) const {
+	const ReplacementPackType type = (ReplacementPackType)entry.type;
+	const bool image = type == ReplacementPackType::RGBA || type == ReplacementPackType::RGBA_ZSTD;
+	if (entry.offset + entry.size > fileSize_ || (image && entry.rawSize != (u32)entry.w * entry.h * 4)) {
+		ERROR_LOG(G3D, "Invalid texture pack entry %016llx", (unsigned long long)entry.nameHash);
+		return false;
+	}
+
+	const bool compressed = type == ReplacementPackType::RGBA_ZSTD || type == ReplacementPackType::FILE_ZSTD;
+	out.resize(entry.rawSize);
+	if (!compressed) {
+		return entry.size == entry.rawSize && file_->ReadAt(entry.offset, entry.size, out.data()) == entry.size;
+	}
+
+	// The pack is usually mapped, then there's nothing to read first.
+	std::vector<u8> buffer;
+	const u8 *src = file_->GetView(entry.offset, entry.size);
+	if (!src) {
+		buffer.resize(entry.size);
+		if (file_->ReadAt(entry.offset, entry.size, buffer.data()) != entry.size)
+			return false;
+		src = buffer.data();
+	}
+
+	size_t result = ZSTD_decompress(out.data(), out.size(), src, entry.size);
+	if (result != entry.rawSize) {
+		ERROR_LOG(G3D, "Could not decompress texture pack entry %016llx", (unsigned long long)entry.nameHash);
+		return false;
+	}
+	return true;
+}
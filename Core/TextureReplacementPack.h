@@ -0,0 +1,91 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Swap.h"
+#include "Common/File/Path.h"
+
+class FileLoader;
+
+// A whole texture folder in one file, built by Tools/texpacktool.  Files are found by the
+// hash of their path relative to the folder, in an index sorted by that hash.  Images are
+// stored already decoded to RGBA8888, raw or compressed with zstd, so a lookup needs no file
+// open and a load no PNG decoding.  Other files (the inis) are stored as they are.
+//
+// Layout, all little endian: the header, the index at indexOffset, then the data.
+struct ReplacementPackHeader {
+	char magic[4];  // "PPTP"
+	u32_le version;
+	u32_le numEntries;
+	u32_le reserved;
+	u64_le indexOffset;
+	u64_le fileSize;
+};
+
+enum class ReplacementPackType : u8 {
+	RGBA = 0,
+	RGBA_ZSTD = 1,
+	FILE = 2,
+	FILE_ZSTD = 3,
+};
+
+struct ReplacementPackEntry {
+	u64_le nameHash;
+	u64_le offset;
+	// Stored bytes, and bytes once decompressed.
+	u32_le size;
+	u32_le rawSize;
+	// Images only.
+	u16_le w;
+	u16_le h;
+	u8 type;
+	// A CheckAlphaResult, computed over the whole image.
+	u8 alpha;
+	u16_le reserved;
+};
+
+static_assert(sizeof(ReplacementPackHeader) == 32, "Pack header layout changed");
+static_assert(sizeof(ReplacementPackEntry) == 32, "Pack entry layout changed");
+
+class ReplacementPack {
+public:
+	~ReplacementPack();
+
+	// Returns nullptr if the file is missing or not a valid pack.
+	static ReplacementPack *Open(const Path &filename);
+	// Names use / between folders, like in textures.ini.
+	static u64 HashName(const std::string &name);
+
+	const ReplacementPackEntry *Find(const std::string &name) const;
+	// Decompresses the whole entry into out.  Safe to call from any thread.
+	bool Read(const ReplacementPackEntry &entry, std::vector<u8> &out) const;
+
+private:
+	ReplacementPack() {}
+
+	FileLoader *file_ = nullptr;
+	// Points into the mapped file, or indexCopy_ when it couldn't be mapped.
+	const ReplacementPackEntry *index_ = nullptr;
+	std::vector<ReplacementPackEntry> indexCopy_;
+	u32 numEntries_ = 0;
+	u64 fileSize_ = 0;
+};
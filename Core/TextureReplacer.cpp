@@ -17,8 +17,12 @@
 
 #include "ppsspp_config.h"
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <memory>
+#include <mutex>
+#include <sstream>
 #include <png.h>
 
 #include "ext/xxhash.h"
@@ -30,16 +34,18 @@
 #include "Common/Data/Text/Parsers.h"
 #include "Common/File/FileUtil.h"
 #include "Common/StringUtils.h"
-#include "Common/Thread/ParallelLoop.h"
+#include "Common/Thread/ThreadManager.h"
 #include "Core/Config.h"
 #include "Core/Host.h"
 #include "Core/System.h"
+#include "Core/TextureReplacementPack.h"
 #include "Core/TextureReplacer.h"
 #include "Core/ThreadPools.h"
 #include "Core/ELF/ParamSFO.h"
 #include "GPU/Common/TextureDecoder.h"
 
 static const std::string INI_FILENAME = "textures.ini";
+static const std::string PACK_FILENAME = "textures.pack";
 static const std::string NEW_TEXTURE_DIR = "new/";
 static const int VERSION = 1;
 static const int MAX_MIP_LEVELS = 12;  // 12 should be plenty, 8 is the max mip levels supported by the PSP.
@@ -73,7 +79,12 @@ void TextureReplacer::NotifyConfigChanged() {
 		enabled_ = File::Exists(basePath_) && File::IsDirectory(basePath_);
 	}
 
+	// Textures already loaded from the old pack keep it alive until they're gone.
+	pack_.reset();
 	if (enabled_) {
+		const Path packFilename = basePath_ / PACK_FILENAME;
+		if (File::Exists(packFilename))
+			pack_.reset(ReplacementPack::Open(packFilename));
 		enabled_ = LoadIni();
 	}
 }
@@ -93,10 +104,8 @@ bool TextureReplacer::LoadIni() {
 	// Prevents dumping the mipmaps.
 	ignoreMipmap_ = false;
 
-	if (File::Exists(basePath_ / INI_FILENAME)) {
-		IniFile ini;
-		ini.LoadFromVFS((basePath_ / INI_FILENAME).ToString());
-
+	IniFile ini;
+	if (LoadIniFile(ini, INI_FILENAME)) {
 		if (!LoadIniValues(ini)) {
 			return false;
 		}
@@ -107,7 +116,7 @@ bool TextureReplacer::LoadIni() {
 			if (!overrideFilename.empty() && overrideFilename != INI_FILENAME) {
 				INFO_LOG(G3D, "Loading extra texture ini: %s", overrideFilename.c_str());
 				IniFile overrideIni;
-				overrideIni.LoadFromVFS((basePath_ / overrideFilename).ToString());
+				LoadIniFile(overrideIni, overrideFilename);
 
 				if (!LoadIniValues(overrideIni, true)) {
 					return false;
@@ -120,6 +129,20 @@ bool TextureReplacer::LoadIni() {
 	return true;
 }
 
+bool TextureReplacer::LoadIniFile(IniFile &ini, const std::string &filename) {
+	// A loose ini wins, so it can be tweaked without rebuilding the pack.
+	const Path path = basePath_ / filename;
+	if (File::Exists(path))
+		return ini.LoadFromVFS(path.ToString());
+
+	const ReplacementPackEntry *entry = pack_ ? pack_->Find(filename) : nullptr;
+	std::vector<u8> data;
+	if (!entry || !pack_->Read(*entry, data))
+		return false;
+	std::istringstream stream(std::string(data.begin(), data.end()));
+	return ini.Load(stream);
+}
+
 bool TextureReplacer::LoadIniValues(IniFile &ini, bool isOverride) {
 	auto options = ini.GetOrCreateSection("options");
 	std::string hash;
@@ -397,7 +420,9 @@ void TextureReplacer::PopulateReplacement(ReplacedTexture *result, u64 cachekey,
 	for (int i = 0; i < MAX_MIP_LEVELS; ++i) {
 		const std::string hashfile = LookupHashFile(cachekey, hash, i);
 		const Path filename = basePath_ / hashfile;
-		if (hashfile.empty() || !File::Exists(filename)) {
+		// With a pack, only its index is searched, not the folder.
+		const ReplacementPackEntry *packEntry = pack_ && !hashfile.empty() ? pack_->Find(hashfile) : nullptr;
+		if (hashfile.empty() || (pack_ ? !packEntry : !File::Exists(filename))) {
 			// Out of valid mip levels.  Bail out.
 			break;
 		}
@@ -405,7 +430,16 @@ void TextureReplacer::PopulateReplacement(ReplacedTexture *result, u64 cachekey,
 		ReplacedTextureLevel level;
 		level.fmt = ReplacedTextureFormat::F_8888;
 		level.file = filename;
-		bool good = PopulateLevel(level);
+		bool good;
+		if (packEntry) {
+			level.pack = pack_;
+			level.packEntry = packEntry;
+			level.w = packEntry->w;
+			level.h = packEntry->h;
+			good = packEntry->type == (u8)ReplacementPackType::RGBA || packEntry->type == (u8)ReplacementPackType::RGBA_ZSTD;
+		} else {
+			good = PopulateLevel(level);
+		}
 
 		// We pad files that have been hashrange'd so they are the same texture size.
 		level.w = (level.w * w) / newW;
@@ -427,6 +461,10 @@ void TextureReplacer::PopulateReplacement(ReplacedTexture *result, u64 cachekey,
 	}
 
 	result->alphaStatus_ = ReplacedTextureAlpha::UNKNOWN;
+	if (!result->levels_.empty()) {
+		result->data_ = std::make_shared<ReplacedTextureData>();
+		result->replacer_ = this;
+	}
 }
 
 enum class ReplacedImageType {
@@ -525,7 +563,7 @@ void TextureReplacer::NotifyTextureDecoded(const ReplacedTextureDecodeInfo &repl
 	const Path saveFilename = basePath_ / NEW_TEXTURE_DIR / hashfile;
 
 	// If it's empty, it's an ignored hash, we intentionally don't save.
-	if (hashfile.empty() || File::Exists(filename)) {
+	if (hashfile.empty() || (pack_ && pack_->Find(hashfile)) || File::Exists(filename)) {
 		// If it exists, must've been decoded and saved as a new texture already.
 		return;
 	}
@@ -733,13 +771,60 @@ float TextureReplacer::LookupReduceHashRange(int& w, int& h) {
 	}
 }
 
-void ReplacedTexture::Load(int level, void *out, int rowPitch) {
-	_assert_msg_((size_t)level < levels_.size(), "Invalid miplevel");
-	_assert_msg_(out != nullptr && rowPitch > 0, "Invalid out/pitch");
+enum class ReplacedDataState {
+	NONE,
+	LOADING,
+	READY,
+};
 
-	const ReplacedTextureLevel &info = levels_[level];
+struct ReplacedTextureData {
+	std::mutex lock;
+	std::condition_variable cond;
+	ReplacedDataState state = ReplacedDataState::NONE;
+	// RGBA8888, the level's w * 4 bytes per row.  Empty if the level failed to load.
+	std::vector<std::vector<uint8_t>> levels;
+	ReplacedTextureAlpha alphaStatus = ReplacedTextureAlpha::UNKNOWN;
+};
+
+static bool LoadPackLevelData(const ReplacedTextureLevel &info, std::vector<uint8_t> &out, CheckAlphaResult *alpha) {
+	const ReplacementPackEntry &entry = *info.packEntry;
+	if (entry.w > info.w || entry.h > info.h) {
+		ERROR_LOG(G3D, "Texture replacement changed size: %s", info.file.c_str());
+		return false;
+	}
+
+	if (!info.pack->Read(entry, out)) {
+		ERROR_LOG(G3D, "Could not load texture replacement from pack: %s", info.file.c_str());
+		out.clear();
+		return false;
+	}
+
+	if (entry.w != info.w || entry.h != info.h) {
+		// Padded for a hashrange, like a smaller PNG would be.
+		std::vector<uint8_t> image;
+		image.swap(out);
+		out.resize(info.w * 4 * info.h);
+		for (int y = 0; y < entry.h; ++y) {
+			memcpy(&out[info.w * 4 * y], &image[entry.w * 4 * y], entry.w * 4);
+		}
+	}
+	*alpha = (CheckAlphaResult)entry.alpha;
+	return true;
+}
+
+static bool LoadLevelData(const ReplacedTextureLevel &info, std::vector<uint8_t> &out, CheckAlphaResult *alpha) {
+	if (info.pack)
+		return LoadPackLevelData(info, out, alpha);
 
 	FILE *fp = File::OpenCFile(info.file, "rb");
+	if (!fp) {
+		ERROR_LOG(G3D, "Could not open texture replacement: %s", info.file.c_str());
+		return false;
+	}
+
+	const int pitch = info.w * 4;
+	out.resize(pitch * info.h);
+	bool success = false;
 	auto imageType = Identify(fp);
 	if (imageType == ReplacedImageType::ZIM) {
 		size_t zimSize = File::GetFileSize(fp);
@@ -748,20 +833,17 @@ void ReplacedTexture::Load(int level, void *out, int rowPitch) {
 
 		int w, h, f;
 		uint8_t *image;
-		const int MIN_LINES_PER_THREAD = 4;
 		if (LoadZIMPtr(&zim[0], zimSize, &w, &h, &f, &image)) {
-			ParallelRangeLoop(&g_threadManager, [&](int l, int h) {
-				for (int y = l; y < h; ++y) {
-					memcpy((uint8_t *)out + rowPitch * y, image + w * 4 * y, w * 4);
-				}
-			}, 0, h, MIN_LINES_PER_THREAD);
+			w = std::min(w, info.w);
+			h = std::min(h, info.h);
+			for (int y = 0; y < h; ++y) {
+				memcpy(&out[pitch * y], image + w * 4 * y, w * 4);
+			}
 			free(image);
-		}
 
-		// This will only check the hashed bits.
-		CheckAlphaResult res = CheckAlphaRGBA8888Basic((u32 *)out, rowPitch / sizeof(u32), w, h);
-		if (res == CHECKALPHA_ANY || level == 0) {
-			alphaStatus_ = ReplacedTextureAlpha(res);
+			// This will only check the hashed bits.
+			*alpha = CheckAlphaRGBA8888Basic((u32 *)&out[0], info.w, w, h);
+			success = true;
 		}
 	} else if (imageType == ReplacedImageType::PNG) {
 		png_image png = {};
@@ -769,35 +851,157 @@ void ReplacedTexture::Load(int level, void *out, int rowPitch) {
 
 		if (!png_image_begin_read_from_stdio(&png, fp)) {
 			ERROR_LOG(G3D, "Could not load texture replacement info: %s - %s", info.file.c_str(), png.message);
-			return;
+		} else if ((int)png.width > info.w || (int)png.height > info.h) {
+			ERROR_LOG(G3D, "Texture replacement changed size: %s", info.file.c_str());
+			png_image_free(&png);
+		} else {
+			bool hasAlpha = (png.format & PNG_FORMAT_FLAG_ALPHA) != 0;
+			png.format = PNG_FORMAT_RGBA;
+
+			if (!png_image_finish_read(&png, nullptr, &out[0], pitch, nullptr)) {
+				ERROR_LOG(G3D, "Could not load texture replacement: %s - %s", info.file.c_str(), png.message);
+			} else if (hasAlpha) {
+				// This will only check the hashed bits.
+				*alpha = CheckAlphaRGBA8888Basic((u32 *)&out[0], info.w, png.width, png.height);
+				success = true;
+			} else {
+				// Well, we know for sure it doesn't have alpha.
+				*alpha = CHECKALPHA_FULL;
+				success = true;
+			}
+			png_image_free(&png);
 		}
+	}
 
-		bool checkedAlpha = false;
-		if ((png.format & PNG_FORMAT_FLAG_ALPHA) == 0) {
-			// Well, we know for sure it doesn't have alpha.
-			if (level == 0) {
-				alphaStatus_ = ReplacedTextureAlpha::FULL;
-			}
-			checkedAlpha = true;
+	fclose(fp);
+	if (!success)
+		out.clear();
+	return success;
+}
+
+static void LoadReplacedLevels(const std::vector<ReplacedTextureLevel> &levels, ReplacedTextureData *data) {
+	std::vector<std::vector<uint8_t>> decoded(levels.size());
+	ReplacedTextureAlpha alphaStatus = ReplacedTextureAlpha::UNKNOWN;
+	for (size_t i = 0; i < levels.size(); ++i) {
+		CheckAlphaResult res;
+		if (LoadLevelData(levels[i], decoded[i], &res) && (res == CHECKALPHA_ANY || i == 0)) {
+			alphaStatus = ReplacedTextureAlpha(res);
 		}
-		png.format = PNG_FORMAT_RGBA;
+	}
 
-		if (!png_image_finish_read(&png, nullptr, out, rowPitch, nullptr)) {
-			ERROR_LOG(G3D, "Could not load texture replacement: %s - %s", info.file.c_str(), png.message);
-			return;
+	std::lock_guard<std::mutex> guard(data->lock);
+	data->levels = std::move(decoded);
+	data->alphaStatus = alphaStatus;
+	data->state = ReplacedDataState::READY;
+	data->cond.notify_all();
+}
+
+class ReplacedTextureTask : public Task {
+public:
+	ReplacedTextureTask(const std::vector<ReplacedTextureLevel> &levels, std::shared_ptr<ReplacedTextureData> data)
+		: levels_(levels), data_(data) {
+	}
+
+	void Run() override {
+		LoadReplacedLevels(levels_, data_.get());
+	}
+
+private:
+	std::vector<ReplacedTextureLevel> levels_;
+	std::shared_ptr<ReplacedTextureData> data_;
+};
+
+bool ReplacedTexture::IsReady(double budget) {
+	if (!data_)
+		return true;
+
+	std::unique_lock<std::mutex> guard(data_->lock);
+	if (data_->state == ReplacedDataState::NONE) {
+		data_->state = ReplacedDataState::LOADING;
+		if (g_threadManager.GetNumLooperThreads() > 0) {
+			g_threadManager.EnqueueTask(new ReplacedTextureTask(levels_, data_), TaskType::IO_BLOCKING);
+		} else {
+			guard.unlock();
+			LoadReplacedLevels(levels_, data_.get());
+			guard.lock();
 		}
-		png_image_free(&png);
+	}
 
-		if (!checkedAlpha) {
-			// This will only check the hashed bits.
-			CheckAlphaResult res = CheckAlphaRGBA8888Basic((u32 *)out, rowPitch / sizeof(u32), png.width, png.height);
-			if (res == CHECKALPHA_ANY || level == 0) {
-				alphaStatus_ = ReplacedTextureAlpha(res);
-			}
+	auto loaded = [&] { return data_->state == ReplacedDataState::READY; };
+	if (budget < 0.0) {
+		data_->cond.wait(guard, loaded);
+	} else if (budget > 0.0) {
+		data_->cond.wait_for(guard, std::chrono::duration<double>(budget), loaded);
+	}
+
+	if (!loaded())
+		return false;
+	alphaStatus_ = data_->alphaStatus;
+	guard.unlock();
+
+	replacer_->NotifyResident(this);
+	return true;
+}
+
+void ReplacedTexture::Load(int level, void *out, int rowPitch) {
+	_assert_msg_((size_t)level < levels_.size(), "Invalid miplevel");
+	_assert_msg_(out != nullptr && rowPitch > 0, "Invalid out/pitch");
+
+	IsReady(-1.0);
+
+	const ReplacedTextureLevel &info = levels_[level];
+	std::lock_guard<std::mutex> guard(data_->lock);
+	if ((size_t)level >= data_->levels.size() || data_->levels[level].empty())
+		return;
+	const std::vector<uint8_t> &data = data_->levels[level];
+
+	const int pitch = info.w * 4;
+	if (pitch == rowPitch) {
+		memcpy(out, &data[0], data.size());
+	} else {
+		for (int y = 0; y < info.h; ++y) {
+			memcpy((uint8_t *)out + rowPitch * y, &data[pitch * y], pitch);
 		}
 	}
+}
+
+size_t ReplacedTexture::DataSize() const {
+	size_t size = 0;
+	for (const ReplacedTextureLevel &level : levels_) {
+		size += (size_t)level.w * level.h * 4;
+	}
+	return size;
+}
 
-	fclose(fp);
+void ReplacedTexture::Purge() {
+	std::lock_guard<std::mutex> guard(data_->lock);
+	if (data_->state == ReplacedDataState::READY) {
+		data_->levels.clear();
+		data_->levels.shrink_to_fit();
+		data_->state = ReplacedDataState::NONE;
+	}
+}
+
+void TextureReplacer::NotifyResident(ReplacedTexture *texture) {
+	if (texture->resident_) {
+		resident_.splice(resident_.begin(), resident_, texture->residentPos_);
+		return;
+	}
+
+	resident_.push_front(texture);
+	texture->residentPos_ = resident_.begin();
+	texture->resident_ = true;
+	residentBytes_ += texture->DataSize();
+
+	// Always keep the one just used, even if it alone is over budget.
+	const size_t budget = (size_t)std::max(g_Config.iReplacementTextureRAMBudget, 0) * 1024 * 1024;
+	while (residentBytes_ > budget && resident_.size() > 1) {
+		ReplacedTexture *oldest = resident_.back();
+		resident_.pop_back();
+		oldest->resident_ = false;
+		residentBytes_ -= oldest->DataSize();
+		oldest->Purge();
+	}
 }
 
 bool TextureReplacer::GenerateIni(const std::string &gameID, Path &generatedFilename) {
@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -30,8 +32,11 @@
 #include "GPU/ge_constants.h"
 
 class IniFile;
+class ReplacementPack;
+struct ReplacementPackEntry;
 class TextureCacheCommon;
 class TextureReplacer;
+struct ReplacedTextureData;
 
 enum class ReplacedTextureFormat {
 	F_5650,
@@ -62,6 +67,9 @@ struct ReplacedTextureLevel {
 	int h;
 	ReplacedTextureFormat fmt;
 	Path file;
+	// Set when the level comes from the texture pack instead of file.
+	std::shared_ptr<ReplacementPack> pack;
+	const ReplacementPackEntry *packEntry = nullptr;
 };
 
 struct ReplacementCacheKey {
@@ -153,12 +161,26 @@ struct ReplacedTexture {
 		return (u8)alphaStatus_;
 	}
 
+	// The first call starts decoding the levels on an I/O worker.  Waits up to budget seconds
+	// for them, or until they're done if negative.  GPU thread only.
+	bool IsReady(double budget);
+	// Blocks until the levels are decoded, if IsReady() wasn't true yet.
 	void Load(int level, void *out, int rowPitch);
 
 protected:
+	size_t DataSize() const;
+	void Purge();
+
 	std::vector<ReplacedTextureLevel> levels_;
 	ReplacedTextureAlpha alphaStatus_;
 
+	// Decoded levels, shared with the task decoding them.
+	std::shared_ptr<ReplacedTextureData> data_;
+	TextureReplacer *replacer_ = nullptr;
+	// Position in the replacer's resident list, when resident_.
+	std::list<ReplacedTexture *>::iterator residentPos_;
+	bool resident_ = false;
+
 	friend TextureReplacer;
 };
 
@@ -187,6 +209,9 @@ class TextureReplacer {
 	u32 ComputeHash(u32 addr, int bufw, int w, int h, GETextureFormat fmt, u16 maxSeenV);
 
 	ReplacedTexture &FindReplacement(u64 cachekey, u32 hash, int w, int h);
+	ReplacedTexture &FindNone() {
+		return none_;
+	}
 	bool FindFiltering(u64 cachekey, u32 hash, TextureFiltering *forceFiltering);
 
 	void NotifyTextureDecoded(const ReplacedTextureDecodeInfo &replacedInfo, const void *data, int pitch, int level, int w, int h);
@@ -195,6 +220,7 @@ class TextureReplacer {
 
 protected:
 	bool LoadIni();
+	bool LoadIniFile(IniFile &ini, const std::string &filename);
 	bool LoadIniValues(IniFile &ini, bool isOverride = false);
 	void ParseHashRange(const std::string &key, const std::string &value);
 	void ParseFiltering(const std::string &key, const std::string &value);
@@ -205,6 +231,7 @@ class TextureReplacer {
 	std::string HashName(u64 cachekey, u32 hash, int level);
 	void PopulateReplacement(ReplacedTexture *result, u64 cachekey, u32 hash, int w, int h);
 	bool PopulateLevel(ReplacedTextureLevel &level);
+	void NotifyResident(ReplacedTexture *texture);
 
 	SimpleBuf<u32> saveBuf;
 	bool enabled_ = false;
@@ -216,6 +243,8 @@ class TextureReplacer {
 	bool ignoreMipmap_ = false;
 	std::string gameID_;
 	Path basePath_;
+	// When the folder has a pack, its images are used instead of loose files.
+	std::shared_ptr<ReplacementPack> pack_;
 	ReplacedTextureHash hash_ = ReplacedTextureHash::QUICK;
 	typedef std::pair<int, int> WidthHeightPair;
 	std::unordered_map<u64, WidthHeightPair> hashranges_;
@@ -226,4 +255,11 @@ class TextureReplacer {
 	ReplacedTexture none_;
 	std::unordered_map<ReplacementCacheKey, ReplacedTexture> cache_;
 	std::unordered_map<ReplacementCacheKey, ReplacedTextureLevel> savedCache_;
+
+	// Textures with decoded levels in RAM, most recently used first.  Kept under
+	// g_Config.iReplacementTextureRAMBudget by purging from the back.
+	std::list<ReplacedTexture *> resident_;
+	size_t residentBytes_ = 0;
+
+	friend ReplacedTexture;
 };
@@ -24,6 +24,13 @@
 #ifdef _M_SSE
 #include <emmintrin.h>
 #endif
+#if PPSSPP_ARCH(ARM_NEON)
+#if defined(_MSC_VER) && PPSSPP_ARCH(ARM64)
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
 
 void AdjustVolumeBlockStandard(s16 *out, s16 *in, size_t size, int leftVol, int rightVol) {
 #ifdef _M_SSE
@@ -111,6 +118,57 @@ void ConvertS16ToF32(float *out, const s16 *in, size_t size) {
 	}
 }
 
+void MixS16ToS32(s32 *out, const s16 *in, size_t size) {
+#ifdef _M_SSE
+	while (size >= 8) {
+		__m128i indata = _mm_loadu_si128((const __m128i *)in);
+		// Sign extend by putting each sample in the top half, then shifting it back down.
+		__m128i inlo = _mm_srai_epi32(_mm_unpacklo_epi16(indata, indata), 16);
+		__m128i inhi = _mm_srai_epi32(_mm_unpackhi_epi16(indata, indata), 16);
+		_mm_storeu_si128((__m128i *)out, _mm_add_epi32(_mm_loadu_si128((const __m128i *)out), inlo));
+		_mm_storeu_si128((__m128i *)(out + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(out + 4)), inhi));
+		in += 8;
+		out += 8;
+		size -= 8;
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	while (size >= 8) {
+		int16x8_t indata = vld1q_s16(in);
+		vst1q_s32(out, vaddw_s16(vld1q_s32(out), vget_low_s16(indata)));
+		vst1q_s32(out + 4, vaddw_s16(vld1q_s32(out + 4), vget_high_s16(indata)));
+		in += 8;
+		out += 8;
+		size -= 8;
+	}
+#endif
+	for (size_t i = 0; i < size; i++) {
+		out[i] += in[i];
+	}
+}
+
+void ClampS32ToS16(s16 *out, const s32 *in, size_t size) {
+#ifdef _M_SSE
+	while (size >= 8) {
+		__m128i in1 = _mm_loadu_si128((const __m128i *)in);
+		__m128i in2 = _mm_loadu_si128((const __m128i *)(in + 4));
+		_mm_storeu_si128((__m128i *)out, _mm_packs_epi32(in1, in2));
+		in += 8;
+		out += 8;
+		size -= 8;
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	while (size >= 8) {
+		vst1q_s16(out, vcombine_s16(vqmovn_s32(vld1q_s32(in)), vqmovn_s32(vld1q_s32(in + 4))));
+		in += 8;
+		out += 8;
+		size -= 8;
+	}
+#endif
+	for (size_t i = 0; i < size; i++) {
+		out[i] = clamp_s16(in[i]);
+	}
+}
+
 #if !defined(_M_SSE) && !PPSSPP_ARCH(ARM64)
 AdjustVolumeBlockFunc AdjustVolumeBlock = &AdjustVolumeBlockStandard;
 
@@ -69,6 +69,9 @@ static inline s16 ApplySampleVolume20Bit(s16 sample, int vol20) {
 void SetupAudioFormats();
 void AdjustVolumeBlockStandard(s16 *out, s16 *in, size_t size, int leftVol, int rightVol);
 void ConvertS16ToF32(float *ou, const s16 *in, size_t size);
+// Adds 16-bit samples into a 32-bit mix, and clamps such a mix back down.
+void MixS16ToS32(s32 *out, const s16 *in, size_t size);
+void ClampS32ToS16(s16 *out, const s32 *in, size_t size);
 
 #ifdef _M_SSE
 #define AdjustVolumeBlock AdjustVolumeBlockStandard
@@ -111,7 +111,7 @@ static bool RegisterServer(int port) {
 
 bool RemoteISOFileSupported(const std::string &filename) {
 	// Disc-like files.
-	if (endsWithNoCase(filename, ".cso") || endsWithNoCase(filename, ".iso")) {
+	if (endsWithNoCase(filename, ".cso") || endsWithNoCase(filename, ".zcso") || endsWithNoCase(filename, ".iso")) {
 		return true;
 	}
 	// May work - but won't have supporting files.
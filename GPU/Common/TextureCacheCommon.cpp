@@ -21,11 +21,14 @@
 #include "Common/Data/Convert/ColorConv.h"
 #include "Common/Profiler/Profiler.h"
 #include "Common/MemoryUtil.h"
+#include "Common/TimeUtil.h"
 #include "Common/StringUtils.h"
+#include "Common/Thread/ParallelLoop.h"
 #include "Core/Config.h"
 #include "Core/Debugger/MemBlockInfo.h"
 #include "Core/Reporting.h"
 #include "Core/System.h"
+#include "Core/ThreadPools.h"
 #include "GPU/Common/FramebufferManagerCommon.h"
 #include "GPU/Common/TextureCacheCommon.h"
 #include "GPU/Common/TextureDecoder.h"
@@ -36,6 +39,7 @@
 #include "GPU/GPUInterface.h"
 #include "GPU/GPUState.h"
 #include "Core/Util/PPGeDraw.h"
+#include "ext/xxhash.h"
 
 #if defined(_M_SSE)
 #include <emmintrin.h>
@@ -67,6 +71,11 @@
 #define TEXCACHE_MIN_PRESSURE 16 * 1024 * 1024  // Total in VRAM
 #define TEXCACHE_SECOND_MIN_PRESSURE 4 * 1024 * 1024
 
+// Seconds per frame we may wait on replacement textures to finish loading.  Anything slower
+// shows the original texture until it's ready.
+#define REPLACEMENT_FRAME_BUDGET 0.002
+#define REPLACEMENT_TEXTURE_BUDGET 0.0005
+
 // Just for reference
 
 // PSP Color formats:
@@ -371,6 +380,7 @@ TexCacheEntry *TextureCacheCommon::SetTexture() {
 
 	TexCache::iterator entryIter = cache_.find(cachekey);
 	TexCacheEntry *entry = nullptr;
+	gpuStats.numTextureLookups++;
 
 	// Note: It's necessary to reset needshadertexclamp, for otherwise DIRTY_TEXCLAMP won't get set later.
 	// Should probably revisit how this works..
@@ -453,6 +463,13 @@ TexCacheEntry *TextureCacheCommon::SetTexture() {
 			}
 		}
 
+		if (match && (entry->status & TexCacheEntry::STATUS_TO_REPLACE)) {
+			if (FindReplacement(entry, gstate.getTextureWidth(0), gstate.getTextureHeight(0)).Valid()) {
+				match = false;
+				reason = "replacing";
+			}
+		}
+
 		if (match) {
 			// got one!
 			gstate_c.curTextureWidth = w;
@@ -469,6 +486,7 @@ TexCacheEntry *TextureCacheCommon::SetTexture() {
 			nextNeedsChange_ = false;
 			// Might need a rebuild if the hash fails, but that will be set later.
 			nextNeedsRebuild_ = false;
+			gpuStats.numTextureCacheHits++;
 			VERBOSE_LOG(G3D, "Texture at %08x found in cache, applying", texaddr);
 			return entry; //Done!
 		} else {
@@ -688,7 +706,7 @@ void TextureCacheCommon::Decimate(bool forcePressure) {
 		for (TexCache::iterator iter = secondCache_.begin(); iter != secondCache_.end(); ) {
 			// In low memory mode, we kill them all since secondary cache is disabled.
 			if (lowMemoryMode_ || iter->second->lastFrame + TEXTURE_SECOND_KILL_AGE < gpuStats.numFlips) {
-				ReleaseTexture(iter->second.get(), true);
+				ReleaseEntryTexture(iter->second.get(), true);
 				secondCacheSizeEstimate_ -= EstimateTexMemoryUsage(iter->second.get());
 				secondCache_.erase(iter++);
 			} else {
@@ -725,15 +743,39 @@ bool TextureCacheCommon::IsVideo(u32 texaddr) {
 	return false;
 }
 
+ReplacedTexture &TextureCacheCommon::FindReplacement(TexCacheEntry *entry, int w, int h) {
+	u64 cachekey = replacer_.Enabled() ? entry->CacheKey() : 0;
+	ReplacedTexture &replaced = replacer_.FindReplacement(cachekey, entry->fullhash, w, h);
+	if (!replaced.Valid()) {
+		entry->status &= ~TexCacheEntry::STATUS_TO_REPLACE;
+		return replaced;
+	}
+
+	double start = time_now_d();
+	double budget = std::min(REPLACEMENT_TEXTURE_BUDGET, REPLACEMENT_FRAME_BUDGET - replacementTimeThisFrame_);
+	bool ready = replaced.IsReady(std::max(budget, 0.0));
+	replacementTimeThisFrame_ += time_now_d() - start;
+	if (!ready) {
+		entry->status |= TexCacheEntry::STATUS_TO_REPLACE;
+		return replacer_.FindNone();
+	}
+
+	entry->status &= ~TexCacheEntry::STATUS_TO_REPLACE;
+	return replaced;
+}
+
 void TextureCacheCommon::HandleTextureChange(TexCacheEntry *const entry, const char *reason, bool initialMatch, bool doDelete) {
-	cacheSizeEstimate_ -= EstimateTexMemoryUsage(entry);
+	ForgetTexMemoryUsage(entry);
 	entry->numInvalidated++;
 	gpuStats.numTextureInvalidations++;
 	DEBUG_LOG(G3D, "Texture different or overwritten, reloading at %08x: %s", entry->addr, reason);
 	if (doDelete) {
 		InvalidateLastTexture();
-		ReleaseTexture(entry, true);
+		ReleaseEntryTexture(entry, true);
 		entry->status &= ~TexCacheEntry::STATUS_IS_SCALED;
+	} else {
+		// The texture went to the secondary cache, along with its dedupCache_ reference.
+		entry->status &= ~TexCacheEntry::STATUS_DEDUP_BORROWED;
 	}
 
 	// Mark as hashing, if marked as reliable.
@@ -1306,6 +1348,40 @@ static inline void ConvertFormatToRGBA8888(GEPaletteFormat format, u32 *dst, con
 	ConvertFormatToRGBA8888(GETextureFormat(format), dst, src, numPixels);
 }
 
+// Levels with at least this many pixels are decoded on several threads, in chunks of rows.
+static const int PARALLEL_DECODE_MIN_PIXELS = 256 * 128;
+static const int PARALLEL_DECODE_CHUNK_PIXELS = 8192;
+// Below this, building the CLUT4 pair table costs more than it saves.
+static const int CLUT4_PAIRS_MIN_PIXELS = 2048;
+
+// Calls func(l, h) to decode rows [l, h), all at once or in parallel chunks.
+template <typename F>
+static void DecodeRows(int rows, int pixelsPerRow, const F &func) {
+	if (rows * pixelsPerRow >= PARALLEL_DECODE_MIN_PIXELS && g_threadManager.GetNumLooperThreads() > 1) {
+		ParallelRangeLoop(&g_threadManager, func, 0, rows, std::max(1, PARALLEL_DECODE_CHUNK_PIXELS / pixelsPerRow));
+	} else {
+		func(0, rows);
+	}
+}
+
+template <typename ClutT, typename PairT>
+static void DeIndexTexture4Rows(u8 *out, int outPitch, const u8 *texptr, int w, int h, int bufw, const ClutT *clut) {
+	if (w * h < CLUT4_PAIRS_MIN_PIXELS) {
+		for (int y = 0; y < h; ++y) {
+			DeIndexTexture4((ClutT *)(out + outPitch * y), texptr + (bufw * y) / 2, w, clut);
+		}
+		return;
+	}
+
+	PairT pairs[256];
+	BuildClut4Pairs(pairs, clut);
+	DecodeRows(h, w, [&](int l, int hi) {
+		for (int y = l; y < hi; ++y) {
+			DeIndexTexture4Pairs(out + outPitch * y, texptr + (bufw * y) / 2, w, pairs);
+		}
+	});
+}
+
 template <typename DXTBlock, int n>
 static void DecodeDXTBlock(uint8_t *out, int outPitch, uint32_t texaddr, const uint8_t *texptr, int w, int h, int bufw, bool reverseColors, bool useBGRA) {
 	int minw = std::min(bufw, w);
@@ -1320,19 +1396,20 @@ static void DecodeDXTBlock(uint8_t *out, int outPitch, uint32_t texaddr, const u
 		h = (((int)limited / sizeof(DXTBlock)) / (bufw / 4)) * 4;
 	}
 
-	for (int y = 0; y < h; y += 4) {
-		u32 blockIndex = (y / 4) * (bufw / 4);
-		int blockHeight = std::min(h - y, 4);
-		for (int x = 0; x < minw; x += 4) {
+	const int blocksPerRow = (minw + 3) / 4;
+	DecodeRows((h + 3) / 4, minw * 4, [&](int l, int hi) {
+		for (int by = l; by < hi; ++by) {
+			const int y = by * 4;
+			u32 blockIndex = by * (bufw / 4);
+			int blockHeight = std::min(h - y, 4);
 			if (n == 1)
-				DecodeDXT1Block(dst + outPitch32 * y + x, (const DXT1Block *)src + blockIndex, outPitch32, blockHeight, false);
+				DecodeDXT1Blocks(dst + outPitch32 * y, (const DXT1Block *)src + blockIndex, blocksPerRow, outPitch32, blockHeight, false);
 			if (n == 3)
-				DecodeDXT3Block(dst + outPitch32 * y + x, (const DXT3Block *)src + blockIndex, outPitch32, blockHeight);
+				DecodeDXT3Blocks(dst + outPitch32 * y, (const DXT3Block *)src + blockIndex, blocksPerRow, outPitch32, blockHeight);
 			if (n == 5)
-				DecodeDXT5Block(dst + outPitch32 * y + x, (const DXT5Block *)src + blockIndex, outPitch32, blockHeight);
-			blockIndex++;
+				DecodeDXT5Blocks(dst + outPitch32 * y, (const DXT5Block *)src + blockIndex, blocksPerRow, outPitch32, blockHeight);
 		}
-	}
+	});
 	w = (w + 3) & ~3;
 	if (reverseColors) {
 		ReverseColors(out, out, GE_TFMT_8888, outPitch32 * h, useBGRA);
@@ -1379,27 +1456,25 @@ void TextureCacheCommon::DecodeTextureLevel(u8 *out, int outPitch, GETextureForm
 		{
 			if (clutAlphaLinear_ && mipmapShareClut && !expandTo32bit) {
 				// Here, reverseColors means the CLUT is already reversed.
-				if (reverseColors) {
-					for (int y = 0; y < h; ++y) {
-						DeIndexTexture4Optimal((u16 *)(out + outPitch * y), texptr + (bufw * y) / 2, w, clutAlphaLinearColor_);
-					}
-				} else {
-					for (int y = 0; y < h; ++y) {
-						DeIndexTexture4OptimalRev((u16 *)(out + outPitch * y), texptr + (bufw * y) / 2, w, clutAlphaLinearColor_);
+				DecodeRows(h, w, [&](int l, int hi) {
+					if (reverseColors) {
+						for (int y = l; y < hi; ++y) {
+							DeIndexTexture4Optimal((u16 *)(out + outPitch * y), texptr + (bufw * y) / 2, w, clutAlphaLinearColor_);
+						}
+					} else {
+						for (int y = l; y < hi; ++y) {
+							DeIndexTexture4OptimalRev((u16 *)(out + outPitch * y), texptr + (bufw * y) / 2, w, clutAlphaLinearColor_);
+						}
 					}
-				}
+				});
 			} else {
 				const u16 *clut = GetCurrentClut<u16>() + clutSharingOffset;
 				if (expandTo32bit && !reverseColors) {
 					// We simply expand the CLUT to 32-bit, then we deindex as usual. Probably the fastest way.
 					ConvertFormatToRGBA8888(clutformat, expandClut_, clut, 16);
-					for (int y = 0; y < h; ++y) {
-						DeIndexTexture4((u32 *)(out + outPitch * y), texptr + (bufw * y) / 2, w, expandClut_);
-					}
+					DeIndexTexture4Rows<u32, u64>(out, outPitch, texptr, w, h, bufw, expandClut_);
 				} else {
-					for (int y = 0; y < h; ++y) {
-						DeIndexTexture4((u16 *)(out + outPitch * y), texptr + (bufw * y) / 2, w, clut);
-					}
+					DeIndexTexture4Rows<u16, u32>(out, outPitch, texptr, w, h, bufw, clut);
 				}
 			}
 		}
@@ -1408,9 +1483,7 @@ void TextureCacheCommon::DecodeTextureLevel(u8 *out, int outPitch, GETextureForm
 		case GE_CMODE_32BIT_ABGR8888:
 		{
 			const u32 *clut = GetCurrentClut<u32>() + clutSharingOffset;
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture4((u32 *)(out + outPitch * y), texptr + (bufw * y) / 2, w, clut);
-			}
+			DeIndexTexture4Rows<u32, u64>(out, outPitch, texptr, w, h, bufw, clut);
 		}
 		break;
 
@@ -1439,13 +1512,17 @@ void TextureCacheCommon::DecodeTextureLevel(u8 *out, int outPitch, GETextureForm
 		if (!swizzled) {
 			// Just a simple copy, we swizzle the color format.
 			if (reverseColors) {
-				for (int y = 0; y < h; ++y) {
-					ReverseColors(out + outPitch * y, texptr + bufw * sizeof(u16) * y, format, w, useBGRA);
-				}
+				DecodeRows(h, w, [&](int l, int hi) {
+					for (int y = l; y < hi; ++y) {
+						ReverseColors(out + outPitch * y, texptr + bufw * sizeof(u16) * y, format, w, useBGRA);
+					}
+				});
 			} else if (expandTo32bit) {
-				for (int y = 0; y < h; ++y) {
-					ConvertFormatToRGBA8888(format, (u32 *)(out + outPitch * y), (const u16 *)texptr + bufw * y, w);
-				}
+				DecodeRows(h, w, [&](int l, int hi) {
+					for (int y = l; y < hi; ++y) {
+						ConvertFormatToRGBA8888(format, (u32 *)(out + outPitch * y), (const u16 *)texptr + bufw * y, w);
+					}
+				});
 			} else {
 				for (int y = 0; y < h; ++y) {
 					memcpy(out + outPitch * y, texptr + bufw * sizeof(u16) * y, w * sizeof(u16));
@@ -1464,13 +1541,17 @@ void TextureCacheCommon::DecodeTextureLevel(u8 *out, int outPitch, GETextureForm
 			const u8 *unswizzled = (u8 *)tmpTexBuf32_.data();
 
 			if (reverseColors) {
-				for (int y = 0; y < h; ++y) {
-					ReverseColors(out + outPitch * y, unswizzled + bufw * sizeof(u16) * y, format, w, useBGRA);
-				}
+				DecodeRows(h, w, [&](int l, int hi) {
+					for (int y = l; y < hi; ++y) {
+						ReverseColors(out + outPitch * y, unswizzled + bufw * sizeof(u16) * y, format, w, useBGRA);
+					}
+				});
 			} else if (expandTo32bit) {
-				for (int y = 0; y < h; ++y) {
-					ConvertFormatToRGBA8888(format, (u32 *)(out + outPitch * y), (const u16 *)unswizzled + bufw * y, w);
-				}
+				DecodeRows(h, w, [&](int l, int hi) {
+					for (int y = l; y < hi; ++y) {
+						ConvertFormatToRGBA8888(format, (u32 *)(out + outPitch * y), (const u16 *)unswizzled + bufw * y, w);
+					}
+				});
 			} else {
 				for (int y = 0; y < h; ++y) {
 					memcpy(out + outPitch * y, unswizzled + bufw * sizeof(u16) * y, w * sizeof(u16));
@@ -1559,21 +1640,27 @@ void TextureCacheCommon::ReadIndexedTex(u8 *out, int outPitch, int level, const
 	{
 		switch (bytesPerIndex) {
 		case 1:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u16 *)(out + outPitch * y), (const u8 *)texptr + bufw * y, w, clut16);
-			}
+			DecodeRows(h, w, [&](int l, int hi) {
+				for (int y = l; y < hi; ++y) {
+					DeIndexTexture((u16 *)(out + outPitch * y), (const u8 *)texptr + bufw * y, w, clut16);
+				}
+			});
 			break;
 
 		case 2:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u16 *)(out + outPitch * y), (const u16_le *)texptr + bufw * y, w, clut16);
-			}
+			DecodeRows(h, w, [&](int l, int hi) {
+				for (int y = l; y < hi; ++y) {
+					DeIndexTexture((u16 *)(out + outPitch * y), (const u16_le *)texptr + bufw * y, w, clut16);
+				}
+			});
 			break;
 
 		case 4:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u16 *)(out + outPitch * y), (const u32_le *)texptr + bufw * y, w, clut16);
-			}
+			DecodeRows(h, w, [&](int l, int hi) {
+				for (int y = l; y < hi; ++y) {
+					DeIndexTexture((u16 *)(out + outPitch * y), (const u32_le *)texptr + bufw * y, w, clut16);
+				}
+			});
 			break;
 		}
 	}
@@ -1583,21 +1670,27 @@ void TextureCacheCommon::ReadIndexedTex(u8 *out, int outPitch, int level, const
 	{
 		switch (bytesPerIndex) {
 		case 1:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u32 *)(out + outPitch * y), (const u8 *)texptr + bufw * y, w, clut32);
-			}
+			DecodeRows(h, w, [&](int l, int hi) {
+				for (int y = l; y < hi; ++y) {
+					DeIndexTexture((u32 *)(out + outPitch * y), (const u8 *)texptr + bufw * y, w, clut32);
+				}
+			});
 			break;
 
 		case 2:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u32 *)(out + outPitch * y), (const u16_le *)texptr + bufw * y, w, clut32);
-			}
+			DecodeRows(h, w, [&](int l, int hi) {
+				for (int y = l; y < hi; ++y) {
+					DeIndexTexture((u32 *)(out + outPitch * y), (const u16_le *)texptr + bufw * y, w, clut32);
+				}
+			});
 			break;
 
 		case 4:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u32 *)(out + outPitch * y), (const u32_le *)texptr + bufw * y, w, clut32);
-			}
+			DecodeRows(h, w, [&](int l, int hi) {
+				for (int y = l; y < hi; ++y) {
+					DeIndexTexture((u32 *)(out + outPitch * y), (const u32_le *)texptr + bufw * y, w, clut32);
+				}
+			});
 			break;
 		}
 	}
@@ -1667,7 +1760,11 @@ void TextureCacheCommon::ApplyTexture() {
 	// Okay, now actually rebuild the texture if needed.
 	if (nextNeedsRebuild_) {
 		_assert_(!entry->texturePtr);
-		BuildTexture(entry);
+		const u64 srcHash = CanDedupTexture(entry) ? DedupSourceHash(entry) : 0;
+		if (!ReuseDedupTexture(entry, srcHash)) {
+			BuildTexture(entry);
+			AddDedupTexture(entry, srcHash);
+		}
 		InvalidateLastTexture();
 	}
 
@@ -1679,25 +1776,156 @@ void TextureCacheCommon::ApplyTexture() {
 void TextureCacheCommon::Clear(bool delete_them) {
 	ForgetLastTexture();
 	for (TexCache::iterator iter = cache_.begin(); iter != cache_.end(); ++iter) {
-		ReleaseTexture(iter->second.get(), delete_them);
+		ReleaseEntryTexture(iter->second.get(), delete_them);
 	}
 	// In case the setting was changed, we ALWAYS clear the secondary cache (enabled or not.)
 	for (TexCache::iterator iter = secondCache_.begin(); iter != secondCache_.end(); ++iter) {
-		ReleaseTexture(iter->second.get(), delete_them);
+		ReleaseEntryTexture(iter->second.get(), delete_them);
 	}
 	if (cache_.size() + secondCache_.size()) {
 		INFO_LOG(G3D, "Texture cached cleared from %i textures", (int)(cache_.size() + secondCache_.size()));
 		cache_.clear();
 		secondCache_.clear();
+		dedupCache_.clear();
 		cacheSizeEstimate_ = 0;
 		secondCacheSizeEstimate_ = 0;
 	}
 	videos_.clear();
 }
 
+void TextureCacheCommon::ReleaseEntryTexture(TexCacheEntry *entry, bool delete_them) {
+	if (entry->status & TexCacheEntry::STATUS_DEDUPED) {
+		const bool borrowed = (entry->status & TexCacheEntry::STATUS_DEDUP_BORROWED) != 0;
+		entry->status &= ~(TexCacheEntry::STATUS_DEDUPED | TexCacheEntry::STATUS_DEDUP_BORROWED);
+		auto it = dedupCache_.find(entry->dedupKey);
+		if (it != dedupCache_.end()) {
+			DedupTexture &shared = it->second;
+			if (--shared.refCount > 0) {
+				if (!borrowed) {
+					// The borrowers don't count it, so it stays in the estimate until they're gone.
+					shared.sizeEstimate = EstimateTexMemoryUsage(entry);
+					cacheSizeEstimate_ += shared.sizeEstimate;
+				}
+				// Other entries still use it, just forget it here.
+				entry->texturePtr = nullptr;
+#ifdef _WIN32
+				entry->textureView = nullptr;
+#endif
+				return;
+			}
+			cacheSizeEstimate_ -= shared.sizeEstimate;
+			dedupCache_.erase(it);
+		}
+	}
+	ReleaseTexture(entry, delete_them);
+}
+
+bool TextureCacheCommon::CanDedupTexture(const TexCacheEntry *entry) {
+	if (!g_Config.bTextureDedupCache || replacer_.Enabled()) {
+		// Replacements and saved textures are looked up by address, too.
+		return false;
+	}
+	// Only level 0 is hashed, and the PPGe textures are never scaled.
+	if (entry->maxLevel != 0 || (entry->addr > 0x05000000 && entry->addr < PSP_GetKernelMemoryEnd())) {
+		return false;
+	}
+	// Not final yet, these will be rebuilt.
+	return (entry->status & (TexCacheEntry::STATUS_TO_SCALE | TexCacheEntry::STATUS_TO_REPLACE)) == 0;
+}
+
+u64 TextureCacheCommon::DedupParams(const TexCacheEntry *entry) const {
+	u64 params = ((u64)entry->bufw << 32) | ((u64)entry->dim << 16) | ((u64)entry->format << 8);
+	params |= (u64)(standardScaleFactor_ & 0x1F) << 3;
+	params |= (gstate.isTextureSwizzled() ? 1 : 0) | (lowMemoryMode_ ? 2 : 0);
+	return params;
+}
+
+// What a shared texture carries over from the entry that built it.
+static const int DEDUP_STATUS_MASK = TexCacheEntry::STATUS_ALPHA_MASK | TexCacheEntry::STATUS_IS_SCALED | TexCacheEntry::STATUS_BAD_MIPS;
+
+static inline u64 DedupKey(u64 srcHash, u64 params) {
+	return srcHash ^ (params * 0x9E3779B97F4A7C15ULL);
+}
+
+u64 TextureCacheCommon::DedupSourceHash(const TexCacheEntry *entry) const {
+	const int h = 1 << ((entry->dim >> 8) & 0xf);
+	const u32 sizeInRAM = (textureBitsPerPixel[entry->format] * entry->bufw * h) / 8;
+	if (!Memory::IsValidRange(entry->addr, sizeInRAM)) {
+		return 0;
+	}
+
+	u64 hash = XXH3_64bits(Memory::GetPointerUnchecked(entry->addr), sizeInRAM);
+	if (entry->format >= GE_TFMT_CLUT4 && entry->format <= GE_TFMT_CLUT32) {
+		hash = XXH3_64bits_withSeed(clutBufRaw_, clutTotalBytes_, hash);
+	}
+	// 0 means no hash.
+	return hash == 0 ? 1 : hash;
+}
+
+void TextureCacheCommon::ForgetTexMemoryUsage(const TexCacheEntry *entry) {
+	if ((entry->status & TexCacheEntry::STATUS_DEDUP_BORROWED) == 0) {
+		cacheSizeEstimate_ -= EstimateTexMemoryUsage(entry);
+	}
+}
+
+bool TextureCacheCommon::ReuseDedupTexture(TexCacheEntry *entry, u64 srcHash) {
+	if (srcHash == 0 || !CanDedupTexture(entry)) {
+		return false;
+	}
+
+	const u64 params = DedupParams(entry);
+	const u64 key = DedupKey(srcHash, params);
+	auto it = dedupCache_.find(key);
+	if (it == dedupCache_.end()) {
+		return false;
+	}
+	DedupTexture &shared = it->second;
+	if (shared.srcHash != srcHash || shared.fullhash != entry->fullhash || shared.cluthash != entry->cluthash || shared.params != params) {
+		return false;
+	}
+
+	shared.refCount++;
+	entry->texturePtr = shared.texturePtr;
+#ifdef _WIN32
+	entry->textureView = shared.textureView;
+#endif
+	// Already counted once by the entry that built it.
+	entry->status = (entry->status & ~DEDUP_STATUS_MASK) | shared.status | TexCacheEntry::STATUS_DEDUPED | TexCacheEntry::STATUS_DEDUP_BORROWED;
+	entry->dedupKey = key;
+	gpuStats.numTextureDedupHits++;
+	VERBOSE_LOG(G3D, "Texture at %08x has the same contents as a loaded one, sharing it", entry->addr);
+	return true;
+}
+
+void TextureCacheCommon::AddDedupTexture(TexCacheEntry *entry, u64 srcHash) {
+	if (srcHash == 0 || !entry->texturePtr || !CanDedupTexture(entry)) {
+		return;
+	}
+
+	const u64 params = DedupParams(entry);
+	const u64 key = DedupKey(srcHash, params);
+	DedupTexture shared{};
+	shared.srcHash = srcHash;
+	shared.fullhash = entry->fullhash;
+	shared.cluthash = entry->cluthash;
+	shared.params = params;
+	shared.refCount = 1;
+	shared.texturePtr = entry->texturePtr;
+#ifdef _WIN32
+	shared.textureView = entry->textureView;
+#endif
+	shared.status = entry->status & DEDUP_STATUS_MASK;
+	// If the key is taken by different contents, this one just isn't shared.
+	if (dedupCache_.emplace(key, shared).second) {
+		entry->status |= TexCacheEntry::STATUS_DEDUPED;
+		entry->dedupKey = key;
+	}
+}
+
 void TextureCacheCommon::DeleteTexture(TexCache::iterator it) {
-	ReleaseTexture(it->second.get(), true);
-	cacheSizeEstimate_ -= EstimateTexMemoryUsage(it->second.get());
+	// Before the release, which forgets whether it was borrowing.
+	ForgetTexMemoryUsage(it->second.get());
+	ReleaseEntryTexture(it->second.get(), true);
 	cache_.erase(it);
 }
 
@@ -1757,15 +1985,17 @@ bool TextureCacheCommon::CheckFullHash(TexCacheEntry *entry, bool &doDelete) {
 				// If the entry already exists in the secondary texture cache, drop it nicely.
 				auto oldIter = secondCache_.find(secondKey);
 				if (oldIter != secondCache_.end()) {
-					ReleaseTexture(oldIter->second.get(), true);
+					ReleaseEntryTexture(oldIter->second.get(), true);
 				}
 
 				// Archive the entire texture entry as is, since we'll use its params if it is seen again.
 				// We keep parameters on the current entry, since we are STILL building a new texture here.
 				secondCache_[secondKey].reset(new TexCacheEntry(*entry));
 
-				// Make sure we don't delete the texture we just archived.
+				// Make sure we don't delete the texture we just archived.  Its dedupCache_ reference moved too.
 				entry->texturePtr = nullptr;
+				// HandleTextureChange() still needs to know if it was borrowing.
+				entry->status &= ~TexCacheEntry::STATUS_DEDUPED;
 				doDelete = false;
 			}
 		}
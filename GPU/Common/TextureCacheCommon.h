@@ -18,6 +18,7 @@
 #pragma once
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
@@ -133,6 +134,10 @@ struct TexCacheEntry {
 		STATUS_FRAMEBUFFER_OVERLAP = 0x800,
 
 		STATUS_FORCE_REBUILD = 0x1000,
+
+		STATUS_TO_REPLACE = 0x2000,    // Replacement still loading, showing the original until ready.
+		STATUS_DEDUPED = 0x4000,       // Host texture is in dedupCache_, maybe shared with other entries.
+		STATUS_DEDUP_BORROWED = 0x8000, // Reusing another entry's texture, so not in cacheSizeEstimate_.
 	};
 
 	// Status, but int so we can zero initialize.
@@ -161,6 +166,8 @@ struct TexCacheEntry {
 	u32 fullhash;
 	u32 cluthash;
 	u16 maxSeenV;
+	// Where the host texture is in dedupCache_, if STATUS_DEDUPED.
+	u64 dedupKey;
 
 	TexStatus GetHashStatus() {
 		return TexStatus(status & STATUS_MASK);
@@ -264,6 +271,8 @@ class TextureCacheCommon {
 	virtual void BindTexture(TexCacheEntry *entry) = 0;
 	virtual void Unbind() = 0;
 	virtual void ReleaseTexture(TexCacheEntry *entry, bool delete_them) = 0;
+	// Use this instead of ReleaseTexture(), it only releases shared textures once unused.
+	void ReleaseEntryTexture(TexCacheEntry *entry, bool delete_them);
 	void DeleteTexture(TexCache::iterator it);
 	void Decimate(bool forcePressure = false);
 
@@ -271,8 +280,19 @@ class TextureCacheCommon {
 
 	void HandleTextureChange(TexCacheEntry *const entry, const char *reason, bool initialMatch, bool doDelete);
 	virtual void BuildTexture(TexCacheEntry *const entry) = 0;
+	// Returns an invalid replacement while the replacement is still loading.
+	ReplacedTexture &FindReplacement(TexCacheEntry *entry, int w, int h);
 	virtual void UpdateCurrentClut(GEPaletteFormat clutFormat, u32 clutBase, bool clutIndexIsSimple) = 0;
 	bool CheckFullHash(TexCacheEntry *entry, bool &doDelete);
+	// Look up or add the entry's host texture in dedupCache_, by its contents.  Needs a fresh fullhash.
+	bool ReuseDedupTexture(TexCacheEntry *entry, u64 srcHash);
+	void AddDedupTexture(TexCacheEntry *entry, u64 srcHash);
+	bool CanDedupTexture(const TexCacheEntry *entry);
+	u64 DedupParams(const TexCacheEntry *entry) const;
+	// 64-bit hash of the texels and CLUT, or 0 if they can't be read.
+	u64 DedupSourceHash(const TexCacheEntry *entry) const;
+	// Takes the entry out of cacheSizeEstimate_, unless it's borrowing a shared texture.
+	void ForgetTexMemoryUsage(const TexCacheEntry *entry);
 
 	void DecodeTextureLevel(u8 *out, int outPitch, GETextureFormat format, GEPaletteFormat clutformat, uint32_t texaddr, int level, int bufw, bool reverseColors, bool useBGRA, bool expandTo32Bit);
 	void UnswizzleFromMem(u32 *dest, u32 destPitch, const u8 *texptr, u32 bufw, u32 height, u32 bytesPerPixel);
@@ -333,6 +353,7 @@ class TextureCacheCommon {
 
 	int decimationCounter_;
 	int texelsScaledThisFrame_ = 0;
+	double replacementTimeThisFrame_ = 0.0;
 	int timesInvalidatedAllThisFrame_ = 0;
 
 	TexCache cache_;
@@ -341,6 +362,27 @@ class TextureCacheCommon {
 	TexCache secondCache_;
 	u32 secondCacheSizeEstimate_ = 0;
 
+	// Identical textures are often uploaded at several addresses (streamed atlases, double buffered
+	// videos.)  Those entries share one host texture through this, keyed by contents rather than address.
+	struct DedupTexture {
+		// The fullhash is too weak to share textures across addresses on its own.
+		u64 srcHash;
+		u32 fullhash;
+		u32 cluthash;
+		// Everything else the decoded texture depends on, see DedupParams().
+		u64 params;
+		int refCount;
+		void *texturePtr;
+#ifdef _WIN32
+		void *textureView;
+#endif
+		// Alpha, scaling and mip status of the entry that built it.
+		int status;
+		// Counted here once the entry that built it is gone, until the last borrower lets go.
+		u32 sizeEstimate;
+	};
+	std::unordered_map<u64, DedupTexture> dedupCache_;
+
 	struct VideoInfo {
 		u32 addr;
 		u32 size;
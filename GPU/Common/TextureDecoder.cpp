@@ -19,6 +19,7 @@
 #include "ext/xxhash.h"
 #include "Common/Data/Convert/ColorConv.h"
 #include "Common/CPUDetect.h"
+#include "Common/Math/CrossSIMD.h"
 
 #include "GPU/GPU.h"
 #include "GPU/GPUState.h"
@@ -332,6 +333,9 @@ class DXTDecoder {
 	inline void WriteColorsDXT3(u32 *dst, const DXT3Block *src, int pitch, int height);
 	inline void WriteColorsDXT5(u32 *dst, const DXT5Block *src, int pitch, int height);
 
+	// From the four block palettes of DecodeDXTColors4(), lane picks the block.
+	inline void SetColors(const u32 colors[4][4], int lane);
+
 protected:
 	u32 colors_[4];
 	u8 alpha_[8];
@@ -345,7 +349,7 @@ static inline int mix_2_3(int c1, int c2) {
 	return (c1 + c1 + c2) / 3;
 }
 
-// This could probably be done faster by decoding two or four blocks at a time with SSE/NEON.
+// DecodeDXTColors() below does the same for four blocks at a time.
 void DXTDecoder::DecodeColors(const DXT1Block *src, bool ignore1bitAlpha) {
 	u16 c1 = src->color1;
 	u16 c2 = src->color2;
@@ -447,7 +451,11 @@ void DXTDecoder::WriteColorsDXT5(u32 *dst, const DXT5Block *src, int pitch, int
 	}
 }
 
-// This could probably be done faster by decoding two or four blocks at a time with SSE/NEON.
+void DXTDecoder::SetColors(const u32 colors[4][4], int lane) {
+	for (int i = 0; i < 4; ++i)
+		colors_[i] = colors[i][lane];
+}
+
 void DecodeDXT1Block(u32 *dst, const DXT1Block *src, int pitch, int height, bool ignore1bitAlpha) {
 	DXTDecoder dxt;
 	dxt.DecodeColors(src, ignore1bitAlpha);
@@ -468,6 +476,118 @@ void DecodeDXT5Block(u32 *dst, const DXT5Block *src, int pitch, int height) {
 	dxt.WriteColorsDXT5(dst, src, pitch, height);
 }
 
+#if defined(_M_SSE) || PPSSPP_ARCH(ARM_NEON)
+// The palettes of four blocks at once, one per lane, bit for bit like DXTDecoder.  The c1 > c2
+// choices become masks, since lanes can differ.
+template <typename T>
+static inline T SelectMask(const T &mask, const T &a, const T &b) {
+	// b - (b & mask) is b & ~mask, without needing a not.
+	return (a & mask) | (b - (b & mask));
+}
+
+template <typename T>
+static inline T MaskGreater(const T &a, const T &b) {
+	// Both are at most 16 bits, so b - a only wraps when a > b.
+	return T(0) - ((b - a) >> 31);
+}
+
+template <typename T>
+static inline T Div3(const T &v) {
+	// Exact up to far beyond 3 * 255.
+	return (v * T(0xAAAB)) >> 17;
+}
+
+template <typename T>
+static inline void DecodeDXTColors(const T &c1, const T &c2, u32 alpha, T colors[4]) {
+	T red1 = (c1 << 3) & T(0xF8);
+	T red2 = (c2 << 3) & T(0xF8);
+	T green1 = (c1 >> 3) & T(0xFC);
+	T green2 = (c2 >> 3) & T(0xFC);
+	T blue1 = (c1 >> 8) & T(0xF8);
+	T blue2 = (c2 >> 8) & T(0xF8);
+	const T a(alpha << 24);
+
+	colors[0] = a | (red1 << 16) | (green1 << 8) | blue1;
+	colors[1] = a | (red2 << 16) | (green2 << 8) | blue2;
+
+	const T mix12 = (Div3(red1 + red1 + red2) << 16) | (Div3(green1 + green1 + green2) << 8) | Div3(blue1 + blue1 + blue2);
+	const T mix21 = (Div3(red2 + red2 + red1) << 16) | (Div3(green2 + green2 + green1) << 8) | Div3(blue2 + blue2 + blue1);
+	const T average = (((red1 + red2) >> 1) << 16) | (((green1 + green2) >> 1) << 8) | ((blue1 + blue2) >> 1);
+	const T greater = MaskGreater(c1, c2);
+	colors[2] = a | SelectMask(greater, mix12, average);
+	colors[3] = (a | mix21) & greater;
+}
+
+static inline void DecodeDXTColors4(const DXT1Block *src, size_t stride, u32 alpha, u32 colors[4][4]) {
+	u32 c1[4], c2[4];
+	for (int i = 0; i < 4; ++i) {
+		const DXT1Block *block = (const DXT1Block *)((const u8 *)src + stride * i);
+		c1[i] = block->color1;
+		c2[i] = block->color2;
+	}
+	Vec4U32 result[4];
+	DecodeDXTColors(Vec4U32::Load(c1), Vec4U32::Load(c2), alpha, result);
+	for (int i = 0; i < 4; ++i)
+		result[i].Store(colors[i]);
+}
+#endif
+
+void DecodeDXT1Blocks(u32 *dst, const DXT1Block *src, int count, int pitch, int height, bool ignore1bitAlpha) {
+	int i = 0;
+#if defined(_M_SSE) || PPSSPP_ARCH(ARM_NEON)
+	for (; i + 4 <= count; i += 4) {
+		u32 colors[4][4];
+		DecodeDXTColors4(src + i, sizeof(DXT1Block), ignore1bitAlpha ? 0 : 255, colors);
+		for (int j = 0; j < 4; ++j) {
+			DXTDecoder dxt;
+			dxt.SetColors(colors, j);
+			dxt.WriteColorsDXT1(dst + (i + j) * 4, src + i + j, pitch, height);
+		}
+	}
+#endif
+	for (; i < count; ++i) {
+		DecodeDXT1Block(dst + i * 4, src + i, pitch, height, ignore1bitAlpha);
+	}
+}
+
+void DecodeDXT3Blocks(u32 *dst, const DXT3Block *src, int count, int pitch, int height) {
+	int i = 0;
+#if defined(_M_SSE) || PPSSPP_ARCH(ARM_NEON)
+	for (; i + 4 <= count; i += 4) {
+		u32 colors[4][4];
+		DecodeDXTColors4(&src[i].color, sizeof(DXT3Block), 0, colors);
+		for (int j = 0; j < 4; ++j) {
+			DXTDecoder dxt;
+			dxt.SetColors(colors, j);
+			dxt.WriteColorsDXT3(dst + (i + j) * 4, src + i + j, pitch, height);
+		}
+	}
+#endif
+	for (; i < count; ++i) {
+		DecodeDXT3Block(dst + i * 4, src + i, pitch, height);
+	}
+}
+
+void DecodeDXT5Blocks(u32 *dst, const DXT5Block *src, int count, int pitch, int height) {
+	int i = 0;
+#if defined(_M_SSE) || PPSSPP_ARCH(ARM_NEON)
+	for (; i + 4 <= count; i += 4) {
+		u32 colors[4][4];
+		DecodeDXTColors4(&src[i].color, sizeof(DXT5Block), 0, colors);
+		for (int j = 0; j < 4; ++j) {
+			DXTDecoder dxt;
+			dxt.SetColors(colors, j);
+			// Eight multiplies per block with no 32-bit multiply in SSE2, this is faster scalar.
+			dxt.DecodeAlphaDXT5(src + i + j);
+			dxt.WriteColorsDXT5(dst + (i + j) * 4, src + i + j, pitch, height);
+		}
+	}
+#endif
+	for (; i < count; ++i) {
+		DecodeDXT5Block(dst + i * 4, src + i, pitch, height);
+	}
+}
+
 #ifdef _M_SSE
 static inline u32 CombineSSEBitsToDWORD(const __m128i &v) {
 	__m128i temp;
@@ -96,6 +96,10 @@ struct DXT5Block {
 void DecodeDXT1Block(u32 *dst, const DXT1Block *src, int pitch, int height, bool ignore1bitAlpha);
 void DecodeDXT3Block(u32 *dst, const DXT3Block *src, int pitch, int height);
 void DecodeDXT5Block(u32 *dst, const DXT5Block *src, int pitch, int height);
+// A row of count blocks, side by side in dst.  Faster than one at a time for long rows.
+void DecodeDXT1Blocks(u32 *dst, const DXT1Block *src, int count, int pitch, int height, bool ignore1bitAlpha);
+void DecodeDXT3Blocks(u32 *dst, const DXT3Block *src, int count, int pitch, int height);
+void DecodeDXT5Blocks(u32 *dst, const DXT5Block *src, int count, int pitch, int height);
 
 static const u8 textureBitsPerPixel[16] = {
 	16,  //GE_TFMT_5650,
@@ -134,8 +138,12 @@ inline void DeIndexTexture(ClutT *dest, const IndexT *indexed, int length, const
 			}
 		}
 	} else {
+		// Read gstate up front, since the writes to dest might alias it as far as the compiler knows.
+		const int shift = gstate.getClutIndexShift();
+		const u32 mask = gstate.getClutIndexMask();
+		const u32 offset = gstate.transformClutIndex(0);
 		for (int i = 0; i < length; ++i) {
-			*dest++ = clut[gstate.transformClutIndex(*indexed++)];
+			*dest++ = clut[(((u32)*indexed++ >> shift) & mask) | offset];
 		}
 	}
 }
@@ -166,6 +174,26 @@ inline void DeIndexTexture4(ClutT *dest, const u8 *indexed, int length, const Cl
 	}
 }
 
+// Each byte of CLUT4 indices is two pixels, so for large textures it's cheaper to look both up at
+// once, from a table of all 256 pairs.  PairT holds two ClutT, the first one in the low bits.
+template <typename ClutT, typename PairT>
+inline void BuildClut4Pairs(PairT pairs[256], const ClutT *clut) {
+	ClutT colors[16];
+	for (int i = 0; i < 16; ++i) {
+		colors[i] = clut[gstate.transformClutIndex(i)];
+	}
+	for (int i = 0; i < 256; ++i) {
+		pairs[i] = (PairT)colors[i & 0xF] | ((PairT)colors[i >> 4] << (sizeof(ClutT) * 8));
+	}
+}
+
+template <typename PairT>
+inline void DeIndexTexture4Pairs(u8 *dest, const u8 *indexed, int length, const PairT pairs[256]) {
+	for (int i = 0; i < (length + 1) / 2; ++i) {
+		memcpy(dest + i * sizeof(PairT), &pairs[indexed[i]], sizeof(PairT));
+	}
+}
+
 template <typename ClutT>
 inline void DeIndexTexture4Optimal(ClutT *dest, const u8 *indexed, int length, ClutT color) {
 	for (int i = 0; i < length; i += 2) {
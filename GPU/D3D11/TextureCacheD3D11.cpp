@@ -174,6 +174,7 @@ void TextureCacheD3D11::StartFrame() {
 		// INFO_LOG(G3D, "Scaled %i texels", texelsScaledThisFrame_);
 	}
 	texelsScaledThisFrame_ = 0;
+	replacementTimeThisFrame_ = 0.0;
 	if (clearCacheNextFrame_) {
 		Clear(true);
 		clearCacheNextFrame_ = false;
@@ -480,10 +481,9 @@ void TextureCacheD3D11::BuildTexture(TexCacheEntry *const entry) {
 		scaleFactor = scaleFactor > 4 ? 4 : (scaleFactor > 2 ? 2 : 1);
 	}
 
-	u64 cachekey = replacer_.Enabled() ? entry->CacheKey() : 0;
 	int w = gstate.getTextureWidth(0);
 	int h = gstate.getTextureHeight(0);
-	ReplacedTexture &replaced = replacer_.FindReplacement(cachekey, entry->fullhash, w, h);
+	ReplacedTexture &replaced = FindReplacement(entry, w, h);
 	if (replaced.GetSize(0, w, h)) {
 		// We're replacing, so we won't scale.
 		scaleFactor = 1;
@@ -68,6 +68,9 @@ struct GPUStatistics {
 		numTexturesHashed = 0;
 		numTextureSwitches = 0;
 		numTextureDataBytesHashed = 0;
+		numTextureLookups = 0;
+		numTextureCacheHits = 0;
+		numTextureDedupHits = 0;
 		numShaderSwitches = 0;
 		numFlushes = 0;
 		numTexturesDecoded = 0;
@@ -94,6 +97,11 @@ struct GPUStatistics {
 	int numTexturesHashed;
 	int numTextureDataBytesHashed;
 	int numTextureSwitches;
+	// SetTexture() calls, and how many found a matching entry in the cache.
+	int numTextureLookups;
+	int numTextureCacheHits;
+	// Textures that didn't need decoding, since the same contents were already loaded elsewhere.
+	int numTextureDedupHits;
 	int numShaderSwitches;
 	int numTexturesDecoded;
 	int numFramebufferEvaluations;
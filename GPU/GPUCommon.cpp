@@ -2906,7 +2906,7 @@ size_t GPUCommon::FormatGPUStatsCommon(char *buffer, size_t size) {
 		"Commands per call level: %i %i %i %i\n"
 		"Vertices: %d cached: %d uncached: %d\n"
 		"FBOs active: %d (evaluations: %d)\n"
-		"Textures: %d, dec: %d, invalidated: %d, hashed: %d kB\n"
+		"Textures: %d, dec: %d, dedup hits: %d, invalidated: %d, hashed: %d kB\n"
 		"Readbacks: %d, uploads: %d\n"
 		"GPU cycles executed: %d (%f per vertex)\n",
 		gpuStats.msProcessingDisplayLists * 1000.0f,
@@ -2923,6 +2923,7 @@ size_t GPUCommon::FormatGPUStatsCommon(char *buffer, size_t size) {
 		gpuStats.numFramebufferEvaluations,
 		(int)textureCache_->NumLoadedTextures(),
 		gpuStats.numTexturesDecoded,
+		gpuStats.numTextureDedupHits,
 		gpuStats.numTextureInvalidations,
 		gpuStats.numTextureDataBytesHashed / 1024,
 		gpuStats.numReadbacks,
@@ -0,0 +1,179 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+
+#include "Common/Profiler/Profiler.h"
+#include "Common/Thread/ParallelLoop.h"
+#include "Core/ThreadPools.h"
+#include "GPU/GPUState.h"
+#include "GPU/Software/BinManager.h"
+#include "GPU/Software/RasterizerRectangle.h"
+
+BinManager g_binManager;
+
+BinManager::BinManager() {
+	items_.reserve(MAX_ITEMS);
+}
+
+void BinManager::SetEnabled(bool enabled) {
+	if (enabled_ && !enabled)
+		Flush();
+	enabled_ = enabled;
+}
+
+void BinManager::AddTriangle(const VertexData &v0, const VertexData &v1, const VertexData &v2) {
+	if (!enabled_) {
+		Rasterizer::DrawTriangle(v0, v1, v2);
+		return;
+	}
+	const VertexData *verts[] = { &v0, &v1, &v2 };
+	AddItem(Item{ ItemType::TRIANGLE, v0, v1, v2 }, verts, 3);
+}
+
+void BinManager::AddClearRect(const VertexData &v0, const VertexData &v1) {
+	if (!enabled_) {
+		Rasterizer::ClearRectangle(v0, v1);
+		return;
+	}
+	const VertexData *verts[] = { &v0, &v1 };
+	AddItem(Item{ ItemType::CLEAR_RECT, v0, v1 }, verts, 2);
+}
+
+void BinManager::AddSprite(const VertexData &v0, const VertexData &v1) {
+	if (!enabled_) {
+		Rasterizer::DrawSprite(v0, v1);
+		return;
+	}
+	const VertexData *verts[] = { &v0, &v1 };
+	AddItem(Item{ ItemType::SPRITE, v0, v1 }, verts, 2);
+}
+
+void BinManager::AddPoint(const VertexData &v0) {
+	if (!enabled_) {
+		Rasterizer::DrawPoint(v0);
+		return;
+	}
+	const VertexData *verts[] = { &v0 };
+	AddItem(Item{ ItemType::POINT, v0 }, verts, 1);
+}
+
+void BinManager::AddLine(const VertexData &v0, const VertexData &v1) {
+	if (!enabled_) {
+		Rasterizer::DrawLine(v0, v1);
+		return;
+	}
+	const VertexData *verts[] = { &v0, &v1 };
+	AddItem(Item{ ItemType::LINE, v0, v1 }, verts, 2);
+}
+
+void BinManager::AddItem(const Item &item, const VertexData *verts[], int count) {
+	int minX = verts[0]->screenpos.x;
+	int minY = verts[0]->screenpos.y;
+	int maxX = minX;
+	int maxY = minY;
+	for (int i = 1; i < count; ++i) {
+		minX = std::min(minX, (int)verts[i]->screenpos.x);
+		minY = std::min(minY, (int)verts[i]->screenpos.y);
+		maxX = std::max(maxX, (int)verts[i]->screenpos.x);
+		maxY = std::max(maxY, (int)verts[i]->screenpos.y);
+	}
+
+	// Conservative: a pixel of slack for rounding, the rasterizer does the exact test.
+	DrawingCoords scissorTL, scissorBR;
+	Rasterizer::GetScissor(nullptr, scissorTL, scissorBR);
+	int x1 = std::max(((minX - gstate.getOffsetX16()) >> 4) - 1, (int)scissorTL.x);
+	int y1 = std::max(((minY - gstate.getOffsetY16()) >> 4) - 1, (int)scissorTL.y);
+	int x2 = std::min(((maxX - gstate.getOffsetX16()) >> 4) + 1, (int)scissorBR.x);
+	int y2 = std::min(((maxY - gstate.getOffsetY16()) >> 4) + 1, (int)scissorBR.y);
+	x1 = std::max(x1, 0);
+	y1 = std::max(y1, 0);
+	x2 = std::min(x2, TILES_X * TILE_SIZE - 1);
+	y2 = std::min(y2, TILES_Y * TILE_SIZE - 1);
+	if (x1 > x2 || y1 > y2)
+		return;
+
+	if (items_.size() >= MAX_ITEMS)
+		Flush();
+
+	u16 index = (u16)items_.size();
+	items_.push_back(item);
+	for (int ty = y1 >> TILE_SHIFT; ty <= y2 >> TILE_SHIFT; ++ty) {
+		for (int tx = x1 >> TILE_SHIFT; tx <= x2 >> TILE_SHIFT; ++tx) {
+			int tile = ty * TILES_X + tx;
+			if (tileItems_[tile].empty())
+				activeTiles_.push_back(tile);
+			tileItems_[tile].push_back(index);
+		}
+	}
+}
+
+void BinManager::DrawItem(const Item &item, const Rasterizer::TileRect *tile) {
+	switch (item.type) {
+	case ItemType::TRIANGLE:
+		Rasterizer::DrawTriangle(item.v0, item.v1, item.v2, tile);
+		break;
+	case ItemType::CLEAR_RECT:
+		Rasterizer::ClearRectangle(item.v0, item.v1, tile);
+		break;
+	case ItemType::SPRITE:
+		Rasterizer::DrawSprite(item.v0, item.v1, tile);
+		break;
+	case ItemType::POINT:
+		Rasterizer::DrawPoint(item.v0, tile);
+		break;
+	case ItemType::LINE:
+		Rasterizer::DrawLine(item.v0, item.v1, tile);
+		break;
+	}
+}
+
+void BinManager::DrawTile(int tileIndex) {
+	int tx = tileIndex % TILES_X;
+	int ty = tileIndex / TILES_X;
+	Rasterizer::TileRect tile{ tx * TILE_SIZE, ty * TILE_SIZE, tx * TILE_SIZE + TILE_SIZE - 1, ty * TILE_SIZE + TILE_SIZE - 1 };
+	for (u16 index : tileItems_[tileIndex]) {
+		DrawItem(items_[index], &tile);
+	}
+}
+
+void BinManager::Flush() {
+	if (items_.empty())
+		return;
+
+	PROFILE_THIS_SCOPE("bin_flush");
+	// Workers only read the pixel state, so make sure it's computed here.
+	Rasterizer::GetPixelFuncID();
+	int numWorkers = std::min((int)activeTiles_.size(), g_threadManager.GetNumLooperThreads());
+	if (numWorkers <= 1) {
+		for (int tile : activeTiles_)
+			DrawTile(tile);
+	} else {
+		// Interleaved, so a busy area of the screen is shared among the workers.
+		ParallelRangeLoop(&g_threadManager, [&](int l, int h) {
+			for (int w = l; w < h; ++w) {
+				for (size_t i = w; i < activeTiles_.size(); i += numWorkers)
+					DrawTile(activeTiles_[i]);
+			}
+		}, 0, numWorkers, 1);
+	}
+
+	for (int tile : activeTiles_)
+		tileItems_[tile].clear();
+	activeTiles_.clear();
+	items_.clear();
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "GPU/Software/Rasterizer.h"
+
+// Sorts the primitives the clipper produces into screen tiles, and rasterizes the tiles
+// in parallel once the batch ends.  Each tile draws its primitives in submission order,
+// so the result is the same as drawing them one by one.
+//
+// The rasterizer reads gstate directly, so a batch can only contain draws with the same
+// state.  SoftGPU flushes before anything that changes it, or that reads back memory.
+class BinManager {
+public:
+	BinManager();
+
+	// When disabled (the default), primitives are drawn as they come in.
+	void SetEnabled(bool enabled);
+	bool IsEnabled() const { return enabled_; }
+
+	void AddTriangle(const VertexData &v0, const VertexData &v1, const VertexData &v2);
+	void AddClearRect(const VertexData &v0, const VertexData &v1);
+	void AddSprite(const VertexData &v0, const VertexData &v1);
+	void AddPoint(const VertexData &v0);
+	void AddLine(const VertexData &v0, const VertexData &v1);
+
+	bool HasPendingWork() const { return !items_.empty(); }
+	void Flush();
+
+private:
+	enum class ItemType : u8 {
+		TRIANGLE,
+		CLEAR_RECT,
+		SPRITE,
+		POINT,
+		LINE,
+	};
+
+	struct Item {
+		ItemType type;
+		VertexData v0;
+		VertexData v1;
+		VertexData v2;
+	};
+
+	enum {
+		// In drawing coords, so pixels.  Even, to keep the 2x2 quads of triangles whole.
+		TILE_SHIFT = 5,
+		TILE_SIZE = 1 << TILE_SHIFT,
+		TILES_X = 1024 / TILE_SIZE,
+		TILES_Y = 1024 / TILE_SIZE,
+		// Flush early past this, to keep the vertex copies cache friendly.
+		MAX_ITEMS = 4096,
+	};
+
+	void AddItem(const Item &item, const VertexData *verts[], int count);
+	void DrawTile(int tileIndex);
+	static void DrawItem(const Item &item, const Rasterizer::TileRect *tile);
+
+	bool enabled_ = false;
+	std::vector<Item> items_;
+	// Indices into items_, per tile.
+	std::vector<u16> tileItems_[TILES_X * TILES_Y];
+	std::vector<int> activeTiles_;
+};
+
+extern BinManager g_binManager;
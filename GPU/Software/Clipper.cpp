@@ -19,6 +19,7 @@
 
 #include "GPU/GPUState.h"
 
+#include "GPU/Software/BinManager.h"
 #include "GPU/Software/Clipper.h"
 #include "GPU/Software/Rasterizer.h"
 #include "GPU/Software/RasterizerRectangle.h"
@@ -220,13 +221,13 @@ void ProcessRect(const VertexData& v0, const VertexData& v1)
 		RotateUVThrough(v0, v1, *topright, *bottomleft);
 
 		if (gstate.isModeClear()) {
-			Rasterizer::ClearRectangle(v0, v1);
+			g_binManager.AddClearRect(v0, v1);
 		} else {
 			// Four triangles to do backfaces as well. Two of them will get backface culled.
-			Rasterizer::DrawTriangle(*topleft, *topright, *bottomright);
-			Rasterizer::DrawTriangle(*bottomright, *topright, *topleft);
-			Rasterizer::DrawTriangle(*bottomright, *bottomleft, *topleft);
-			Rasterizer::DrawTriangle(*topleft, *bottomleft, *bottomright);
+			g_binManager.AddTriangle(*topleft, *topright, *bottomright);
+			g_binManager.AddTriangle(*bottomright, *topright, *topleft);
+			g_binManager.AddTriangle(*bottomright, *bottomleft, *topleft);
+			g_binManager.AddTriangle(*topleft, *bottomleft, *bottomright);
 		}
 	}
 }
@@ -234,14 +235,14 @@ void ProcessRect(const VertexData& v0, const VertexData& v1)
 void ProcessPoint(VertexData& v0)
 {
 	// Points need no clipping. Will be bounds checked in the rasterizer (which seems backwards?)
-	Rasterizer::DrawPoint(v0);
+	g_binManager.AddPoint(v0);
 }
 
 void ProcessLine(VertexData& v0, VertexData& v1)
 {
 	if (gstate.isModeThrough()) {
 		// Actually, should clip this one too so we don't need to do bounds checks in the rasterizer.
-		Rasterizer::DrawLine(v0, v1);
+		g_binManager.AddLine(v0, v1);
 		return;
 	}
 
@@ -268,7 +269,7 @@ void ProcessLine(VertexData& v0, VertexData& v1)
 	VertexData data[2] = { *Vertices[0], *Vertices[1] };
 	data[0].screenpos = TransformUnit::ClipToScreen(data[0].clippos);
 	data[1].screenpos = TransformUnit::ClipToScreen(data[1].clippos);
-	Rasterizer::DrawLine(data[0], data[1]);
+	g_binManager.AddLine(data[0], data[1]);
 }
 
 void ProcessTriangle(VertexData& v0, VertexData& v1, VertexData& v2, const VertexData &provoking) {
@@ -278,9 +279,9 @@ void ProcessTriangle(VertexData& v0, VertexData& v1, VertexData& v2, const Verte
 			VertexData corrected2 = v2;
 			corrected2.color0 = provoking.color0;
 			corrected2.color1 = provoking.color1;
-			Rasterizer::DrawTriangle(v0, v1, corrected2);
+			g_binManager.AddTriangle(v0, v1, corrected2);
 		} else {
-			Rasterizer::DrawTriangle(v0, v1, v2);
+			g_binManager.AddTriangle(v0, v1, v2);
 		}
 		return;
 	}
@@ -360,7 +361,7 @@ void ProcessTriangle(VertexData& v0, VertexData& v1, VertexData& v2, const Verte
 				data[2].color1 = provoking.color1;
 			}
 
-			Rasterizer::DrawTriangle(data[0], data[1], data[2]);
+			g_binManager.AddTriangle(data[0], data[1], data[2]);
 		}
 	}
 }
@@ -0,0 +1,91 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include "GPU/GPUState.h"
+#include "GPU/Software/FuncId.h"
+
+void ComputePixelFuncID(PixelFuncID *id_out) {
+	PixelFuncID id{};
+
+	id.clearMode = gstate.isModeClear();
+	id.applyDepthRange = !gstate.isModeThrough();
+	id.fbFormat = gstate.FrameBufFormat() & 3;
+	// Dithering applies even in clear mode.
+	id.dithering = gstate.isDitherEnabled();
+	id.applyColorWriteMask = gstate.getColorMask() != 0;
+
+	if (id.clearMode) {
+		id.clearColor = gstate.isClearModeColorMask();
+		id.clearStencil = gstate.isClearModeAlphaMask();
+		id.clearDepth = gstate.isClearModeDepthMask();
+		id.alphaTestFunc = GE_COMP_ALWAYS;
+		id.colorTestFunc = GE_COMP_ALWAYS;
+	} else {
+		id.alphaTestFunc = gstate.isAlphaTestEnabled() ? gstate.getAlphaTestFunction() : GE_COMP_ALWAYS;
+		id.colorTestFunc = gstate.isColorTestEnabled() ? gstate.getColorTestFunction() : GE_COMP_ALWAYS;
+		id.applyFog = gstate.isFogEnabled() && !gstate.isModeThrough();
+
+		id.stencilTest = gstate.isStencilTestEnabled();
+		if (id.stencilTest) {
+			id.stencilTestFunc = gstate.getStencilTestFunction();
+			id.sFail = gstate.getStencilOpSFail();
+			id.zFail = gstate.getStencilOpZFail();
+			id.zPass = gstate.getStencilOpZPass();
+		}
+
+		id.depthTest = gstate.isDepthTestEnabled();
+		if (id.depthTest) {
+			id.depthTestFunc = gstate.getDepthTestFunction();
+			id.depthWrite = gstate.isDepthWriteEnabled();
+		}
+
+		id.alphaBlend = gstate.isAlphaBlendEnabled();
+		if (id.alphaBlend) {
+			id.alphaBlendEq = gstate.getBlendEq();
+			id.alphaBlendSrc = gstate.getBlendFuncA();
+			id.alphaBlendDst = gstate.getBlendFuncB();
+		}
+
+		// COPY leaves the color alone.
+		id.applyLogicOp = gstate.isLogicOpEnabled() && gstate.getLogicOp() != GE_LOGIC_COPY;
+		if (id.applyLogicOp) {
+			id.logicOp = gstate.getLogicOp();
+		}
+	}
+
+	id.cached.alphaTestRef = gstate.getAlphaTestRef();
+	id.cached.alphaTestMask = gstate.getAlphaTestMask();
+	id.cached.stencilTestRef = gstate.getStencilTestRef();
+	id.cached.stencilTestMask = gstate.getStencilTestMask();
+	id.cached.stencilWriteMask = gstate.getStencilWriteMask();
+	id.cached.minz = gstate.getDepthRangeMin();
+	id.cached.maxz = gstate.getDepthRangeMax();
+	id.cached.framebufStride = gstate.FrameBufStride();
+	id.cached.depthbufStride = gstate.DepthBufStride();
+	id.cached.colorTestRef = gstate.getColorTestRef();
+	id.cached.colorTestMask = gstate.getColorTestMask();
+	id.cached.fogColor = gstate.fogcolor & 0xFFFFFF;
+	id.cached.fixA = gstate.getFixA();
+	id.cached.fixB = gstate.getFixB();
+	id.cached.colorWriteMask = gstate.getColorMask();
+	for (int y = 0; y < 4; ++y) {
+		for (int x = 0; x < 4; ++x)
+			id.cached.ditherMatrix[y * 4 + x] = gstate.getDitherValue(x, y);
+	}
+
+	*id_out = id;
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+#include "GPU/ge_constants.h"
+
+// Everything the per pixel path (tests, blending, logic op, masks) needs from gstate,
+// decoded once per state change instead of once per pixel.  Only clearMode and the framebuffer
+// format pick the function to run, the rest is still branched on per pixel.
+struct PixelFuncID {
+	PixelFuncID() : fullKey(0) {
+	}
+
+	union {
+		u64 fullKey;
+		struct {
+			bool clearMode : 1;
+			// In clear mode, these decide what is written.
+			bool clearColor : 1;
+			bool clearStencil : 1;
+			bool clearDepth : 1;
+			bool applyDepthRange : 1;
+			// GE_COMP_ALWAYS when the test is disabled.
+			uint8_t alphaTestFunc : 3;
+			uint8_t colorTestFunc : 2;
+			bool applyFog : 1;
+			bool stencilTest : 1;
+			uint8_t stencilTestFunc : 3;
+			uint8_t sFail : 3;
+			uint8_t zFail : 3;
+			uint8_t zPass : 3;
+			bool depthTest : 1;
+			uint8_t depthTestFunc : 3;
+			bool depthWrite : 1;
+			uint8_t fbFormat : 2;
+			bool alphaBlend : 1;
+			uint8_t alphaBlendEq : 3;
+			uint8_t alphaBlendSrc : 4;
+			uint8_t alphaBlendDst : 4;
+			bool dithering : 1;
+			bool applyLogicOp : 1;
+			uint8_t logicOp : 4;
+			bool applyColorWriteMask : 1;
+		};
+	};
+
+	// Values the function reads, but that don't change which one it is.
+	struct {
+		u8 alphaTestRef;
+		u8 alphaTestMask;
+		u8 stencilTestRef;
+		u8 stencilTestMask;
+		u8 stencilWriteMask;
+		u16 minz;
+		u16 maxz;
+		u16 framebufStride;
+		u16 depthbufStride;
+		u32 colorTestRef;
+		u32 colorTestMask;
+		u32 fogColor;
+		u32 fixA;
+		u32 fixB;
+		u32 colorWriteMask;
+		s8 ditherMatrix[16];
+	} cached;
+
+	GEBufferFormat FBFormat() const {
+		return GEBufferFormat(fbFormat);
+	}
+};
+
+void ComputePixelFuncID(PixelFuncID *id);
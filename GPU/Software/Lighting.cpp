@@ -15,7 +15,10 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
+
 #include "Common/CPUDetect.h"
+#include "Common/Math/CrossSIMD.h"
 #include "GPU/GPUState.h"
 #include "GPU/Software/Lighting.h"
 
@@ -36,114 +39,252 @@ static inline float pspLightPow(float v, float e) {
 	return v;
 }
 
-void Process(VertexData& vertex, bool hasColor) {
-	const int materialupdate = gstate.materialupdate & (hasColor ? 7 : 0);
+// Per light values, decoded once per batch of vertices.
+struct LightState {
+	bool enabled;
+	bool directional;
+	bool spot;
+	bool poweredDiffuse;
+	bool specular;
+	Vec3<float> pos;
+	Vec3<float> att;
+	Vec3<float> spotDir;
+	float spotCutoff;
+	float spotConv;
+	Vec3<float> ambientColor;
+	Vec3<float> diffuseColor;
+	Vec3<float> specularColor;
+};
 
-	Vec3<float> vcol0 = vertex.color0.rgb().Cast<float>() * Vec3<float>::AssignToAll(1.0f / 255.0f);
-	Vec3<float> mec = Vec3<float>::FromRGB(gstate.getMaterialEmissive());
+static void ComputeLightState(LightState *state, int light) {
+	state->enabled = gstate.isLightChanEnabled(light);
+	state->directional = gstate.isDirectionalLight(light);
+	state->spot = gstate.isSpotLight(light);
+	state->poweredDiffuse = gstate.isUsingPoweredDiffuseLight(light);
+	state->specular = gstate.isUsingSpecularLight(light);
+	state->pos = GetLightVec(gstate.lpos, light);
+	state->att = GetLightVec(gstate.latt, light);
+	state->spotDir = GetLightVec(gstate.ldir, light).NormalizedOr001(cpu_info.bSSE4_1);
+	state->spotCutoff = getFloat24(gstate.lcutoff[light]);
+	state->spotConv = getFloat24(gstate.lconv[light]);
+	state->ambientColor = Vec3<float>::FromRGB(gstate.getLightAmbientColor(light));
+	state->diffuseColor = Vec3<float>::FromRGB(gstate.getDiffuseColor(light));
+	state->specularColor = Vec3<float>::FromRGB(gstate.getSpecularColor(light));
+}
 
-	Vec3<float> mac = (materialupdate & 1) ? vcol0 : Vec3<float>::FromRGB(gstate.getMaterialAmbientRGBA());
-	Vec3<float> final_color = mec + mac * Vec3<float>::FromRGB(gstate.getAmbientRGBA());
-	Vec3<float> specular_color(0.0f, 0.0f, 0.0f);
+// Vertices are lit this many at a time.  Each light is applied to the whole batch before
+// the next, so the state checks are done once per light rather than once per vertex.
+// Must be a multiple of 4, the batch is lit four vertices (one Vec4F32) at a time.
+enum { LIGHT_BATCH = 64 };
 
-	for (unsigned int light = 0; light < 4; ++light) {
-		// Always calculate texture coords from lighting results if environment mapping is active
-		// TODO: Should specular lighting should affect this, too?  Doesn't in GLES.
-		// This should be done even if lighting is disabled altogether.
-		if (gstate.getUVGenMode() == GE_TEXMAP_ENVIRONMENT_MAP) {
-			Vec3<float> L = GetLightVec(gstate.lpos, light);
-			// In other words, L.Length2() == 0.0f means Dot({0, 0, 1}, worldnormal).
-			float diffuse_factor = Dot(L.NormalizedOr001(cpu_info.bSSE4_1), vertex.worldnormal);
+// A batch transposed into one array per component, so four vertices fill a Vec4F32.
+struct LightBatch {
+	float posX[LIGHT_BATCH], posY[LIGHT_BATCH], posZ[LIGHT_BATCH];
+	float normX[LIGHT_BATCH], normY[LIGHT_BATCH], normZ[LIGHT_BATCH];
+	// Vertex color, used for the material colors picked by materialupdate.
+	float colR[LIGHT_BATCH], colG[LIGHT_BATCH], colB[LIGHT_BATCH];
+	float finalR[LIGHT_BATCH], finalG[LIGHT_BATCH], finalB[LIGHT_BATCH];
+	float specR[LIGHT_BATCH], specG[LIGHT_BATCH], specB[LIGHT_BATCH];
+};
 
-			if (gstate.getUVLS0() == (int)light)
-				vertex.texturecoords.s() = (diffuse_factor + 1.f) / 2.f;
+// There's no vector pow, so this one goes lane by lane.
+static inline Vec4F32 LightPow4(const Vec4F32 &v, float e) {
+	float lanes[4];
+	v.Store(lanes);
+	for (int i = 0; i < 4; ++i)
+		lanes[i] = pspLightPow(lanes[i], e);
+	return Vec4F32::Load(lanes);
+}
 
-			if (gstate.getUVLS1() == (int)light)
-				vertex.texturecoords.t() = (diffuse_factor + 1.f) / 2.f;
-		}
-	}
+// Same as Vec3::NormalizeOr001(), on four vectors at once.  Returns the lengths.
+static inline Vec4F32 NormalizeOr001(Vec4F32 &x, Vec4F32 &y, Vec4F32 &z) {
+	const Vec4F32 len = Vec4F32::Sqrt(x * x + y * y + z * z);
+	const Vec4U32 zero = len.CompareEq(Vec4F32::Zero());
+	x = Vec4F32::Select(zero, x, x / len);
+	y = Vec4F32::Select(zero, y, y / len);
+	z = Vec4F32::Select(zero, Vec4F32(1.0f), z / len);
+	return len;
+}
 
-	if (!gstate.isLightingEnabled())
-		return;
+// Material color for the lanes, either the vertex color or a constant.
+struct MaterialColor4 {
+	Vec4F32 r, g, b;
+};
 
-	for (unsigned int light = 0; light < 4; ++light) {
-		if (!gstate.isLightChanEnabled(light))
-			continue;
+static inline MaterialColor4 PickMaterial(bool fromVertex, const LightBatch &batch, int i, const Vec3<float> &constant) {
+	if (fromVertex)
+		return { Vec4F32::Load(&batch.colR[i]), Vec4F32::Load(&batch.colG[i]), Vec4F32::Load(&batch.colB[i]) };
+	return { Vec4F32(constant.r()), Vec4F32(constant.g()), Vec4F32(constant.b()) };
+}
+
+static void ApplyLight(LightBatch &batch, int padded, const LightState &ls, int materialupdate, const Vec3<float> &materialAmbient, const Vec3<float> &materialDiffuse, const Vec3<float> &materialSpecular, float specCoef) {
+	const Vec4F32 zero = Vec4F32::Zero();
+	const Vec4F32 one(1.0f);
 
+	for (int i = 0; i < padded; i += 4) {
 		// L =  vector from vertex to light source
 		// TODO: Should transfer the light positions to world/view space for these calculations?
-		Vec3<float> L = GetLightVec(gstate.lpos, light);
-		if (!gstate.isDirectionalLight(light)) {
-			L -= vertex.worldpos;
+		Vec4F32 Lx(ls.pos.x), Ly(ls.pos.y), Lz(ls.pos.z);
+		if (!ls.directional) {
+			Lx = Lx - Vec4F32::Load(&batch.posX[i]);
+			Ly = Ly - Vec4F32::Load(&batch.posY[i]);
+			Lz = Lz - Vec4F32::Load(&batch.posZ[i]);
 		}
 		// TODO: Should this normalize (0, 0, 0) to (0, 0, 1)?
-		float d = L.NormalizeOr001();
+		const Vec4F32 d = NormalizeOr001(Lx, Ly, Lz);
 
-		float att = 1.f;
-		if (!gstate.isDirectionalLight(light)) {
-			att = 1.f / Dot(GetLightVec(gstate.latt, light), Vec3f(1.0f, d, d * d));
-			if (att > 1.f) att = 1.f;
-			if (att < 0.f) att = 0.f;
+		Vec4F32 att = one;
+		if (!ls.directional) {
+			att = one / (Vec4F32(ls.att.x) + Vec4F32(ls.att.y) * d + Vec4F32(ls.att.z) * (d * d));
+			att = Vec4F32::Select(att.CompareGt(one), one, att);
+			att = Vec4F32::Select(att.CompareLt(zero), zero, att);
 		}
 
-		float spot = 1.f;
-		if (gstate.isSpotLight(light)) {
-			Vec3<float> dir = GetLightVec(gstate.ldir, light);
-			float rawSpot = Dot(dir.NormalizedOr001(cpu_info.bSSE4_1), L);
-			float cutoff = getFloat24(gstate.lcutoff[light]);
-			if (rawSpot >= cutoff) {
-				float conv = getFloat24(gstate.lconv[light]);
-				spot = pspLightPow(rawSpot, conv);
-			} else {
-				spot = 0.f;
-			}
+		Vec4F32 spot = one;
+		if (ls.spot) {
+			const Vec4F32 rawSpot = Vec4F32(ls.spotDir.x) * Lx + Vec4F32(ls.spotDir.y) * Ly + Vec4F32(ls.spotDir.z) * Lz;
+			spot = Vec4F32::Select(rawSpot.CompareGe(Vec4F32(ls.spotCutoff)), LightPow4(rawSpot, ls.spotConv), zero);
 		}
 
+		Vec4F32 finalR = Vec4F32::Load(&batch.finalR[i]);
+		Vec4F32 finalG = Vec4F32::Load(&batch.finalG[i]);
+		Vec4F32 finalB = Vec4F32::Load(&batch.finalB[i]);
+
 		// ambient lighting
-		Vec3<float> lac = Vec3<float>::FromRGB(gstate.getLightAmbientColor(light));
-		final_color += lac * mac * att * spot;
+		const MaterialColor4 mac = PickMaterial((materialupdate & 1) != 0, batch, i, materialAmbient);
+		finalR = finalR + Vec4F32(ls.ambientColor.r()) * mac.r * att * spot;
+		finalG = finalG + Vec4F32(ls.ambientColor.g()) * mac.g * att * spot;
+		finalB = finalB + Vec4F32(ls.ambientColor.b()) * mac.b * att * spot;
 
 		// diffuse lighting
-		Vec3<float> ldc = Vec3<float>::FromRGB(gstate.getDiffuseColor(light));
-		Vec3<float> mdc = (materialupdate & 2) ? vcol0 : Vec3<float>::FromRGB(gstate.getMaterialDiffuse());
-
-		float diffuse_factor = Dot(L, vertex.worldnormal);
-		if (gstate.isUsingPoweredDiffuseLight(light)) {
-			float k = gstate.getMaterialSpecularCoef();
-			diffuse_factor = pspLightPow(diffuse_factor, k);
+		const Vec4F32 nx = Vec4F32::Load(&batch.normX[i]);
+		const Vec4F32 ny = Vec4F32::Load(&batch.normY[i]);
+		const Vec4F32 nz = Vec4F32::Load(&batch.normZ[i]);
+		Vec4F32 diffuse_factor = Lx * nx + Ly * ny + Lz * nz;
+		if (ls.poweredDiffuse) {
+			diffuse_factor = LightPow4(diffuse_factor, specCoef);
 		}
 
-		if (diffuse_factor > 0.f) {
-			final_color += ldc * mdc * diffuse_factor * att * spot;
-		}
+		const MaterialColor4 mdc = PickMaterial((materialupdate & 2) != 0, batch, i, materialDiffuse);
+		const Vec4U32 lit = diffuse_factor.CompareGt(zero);
+		finalR = Vec4F32::Select(lit, finalR + Vec4F32(ls.diffuseColor.r()) * mdc.r * diffuse_factor * att * spot, finalR);
+		finalG = Vec4F32::Select(lit, finalG + Vec4F32(ls.diffuseColor.g()) * mdc.g * diffuse_factor * att * spot, finalG);
+		finalB = Vec4F32::Select(lit, finalB + Vec4F32(ls.diffuseColor.b()) * mdc.b * diffuse_factor * att * spot, finalB);
 
-		if (gstate.isUsingSpecularLight(light) && diffuse_factor >= 0.0f) {
-			Vec3<float> H = L + Vec3<float>(0.f, 0.f, 1.f);
+		finalR.Store(&batch.finalR[i]);
+		finalG.Store(&batch.finalG[i]);
+		finalB.Store(&batch.finalB[i]);
 
-			Vec3<float> lsc = Vec3<float>::FromRGB(gstate.getSpecularColor(light));
-			Vec3<float> msc = (materialupdate & 4) ? vcol0 : Vec3<float>::FromRGB(gstate.getMaterialSpecular());
+		if (ls.specular) {
+			Vec4F32 Hx = Lx, Hy = Ly, Hz = Lz + one;
+			NormalizeOr001(Hx, Hy, Hz);
 
-			float specular_factor = Dot(H.NormalizedOr001(cpu_info.bSSE4_1), vertex.worldnormal);
-			float k = gstate.getMaterialSpecularCoef();
-			specular_factor = pspLightPow(specular_factor, k);
+			const MaterialColor4 msc = PickMaterial((materialupdate & 4) != 0, batch, i, materialSpecular);
+			const Vec4F32 specular_factor = LightPow4(Hx * nx + Hy * ny + Hz * nz, specCoef);
+			const Vec4U32 shiny = diffuse_factor.CompareGe(zero) & specular_factor.CompareGt(zero);
 
-			if (specular_factor > 0.f) {
-				specular_color += lsc * msc * specular_factor * att * spot;
+			const Vec4F32 specR = Vec4F32::Load(&batch.specR[i]);
+			const Vec4F32 specG = Vec4F32::Load(&batch.specG[i]);
+			const Vec4F32 specB = Vec4F32::Load(&batch.specB[i]);
+			Vec4F32::Select(shiny, specR + Vec4F32(ls.specularColor.r()) * msc.r * specular_factor * att * spot, specR).Store(&batch.specR[i]);
+			Vec4F32::Select(shiny, specG + Vec4F32(ls.specularColor.g()) * msc.g * specular_factor * att * spot, specG).Store(&batch.specG[i]);
+			Vec4F32::Select(shiny, specB + Vec4F32(ls.specularColor.b()) * msc.b * specular_factor * att * spot, specB).Store(&batch.specB[i]);
+		}
+	}
+}
+
+static void ProcessBatch(VertexData *vertices, int count, bool hasColor) {
+	const int materialupdate = gstate.materialupdate & (hasColor ? 7 : 0);
+	const Vec3<float> mec = Vec3<float>::FromRGB(gstate.getMaterialEmissive());
+	const Vec3<float> ambient = Vec3<float>::FromRGB(gstate.getAmbientRGBA());
+	const Vec3<float> materialAmbient = Vec3<float>::FromRGB(gstate.getMaterialAmbientRGBA());
+	const Vec3<float> materialDiffuse = Vec3<float>::FromRGB(gstate.getMaterialDiffuse());
+	const Vec3<float> materialSpecular = Vec3<float>::FromRGB(gstate.getMaterialSpecular());
+	const float specCoef = gstate.getMaterialSpecularCoef();
+
+	// Always calculate texture coords from lighting results if environment mapping is active
+	// TODO: Should specular lighting should affect this, too?  Doesn't in GLES.
+	// This should be done even if lighting is disabled altogether.
+	if (gstate.getUVGenMode() == GE_TEXMAP_ENVIRONMENT_MAP) {
+		for (int light = 0; light < 4; ++light) {
+			const bool toS = gstate.getUVLS0() == light;
+			const bool toT = gstate.getUVLS1() == light;
+			if (!toS && !toT)
+				continue;
+
+			// In other words, L.Length2() == 0.0f means Dot({0, 0, 1}, worldnormal).
+			const Vec3<float> L = GetLightVec(gstate.lpos, light).NormalizedOr001(cpu_info.bSSE4_1);
+			for (int i = 0; i < count; ++i) {
+				float diffuse_factor = Dot(L, vertices[i].worldnormal);
+				if (toS)
+					vertices[i].texturecoords.s() = (diffuse_factor + 1.f) / 2.f;
+				if (toT)
+					vertices[i].texturecoords.t() = (diffuse_factor + 1.f) / 2.f;
 			}
 		}
 	}
 
-	int maa = (materialupdate & 1) ? vertex.color0.a() : gstate.getMaterialAmbientA();
-	int final_alpha = (gstate.getAmbientA() * maa) / 255;
+	if (!gstate.isLightingEnabled())
+		return;
+
+	// The lanes past count are zero, lit along with the rest and then dropped.
+	const int padded = (count + 3) & ~3;
+	LightBatch batch;
+	for (int i = 0; i < padded; ++i) {
+		const bool real = i < count;
+		const Vec3<float> pos = real ? vertices[i].worldpos : Vec3<float>(0.0f, 0.0f, 0.0f);
+		const Vec3<float> norm = real ? vertices[i].worldnormal : Vec3<float>(0.0f, 0.0f, 0.0f);
+		const Vec3<float> vcol0 = real ? vertices[i].color0.rgb().Cast<float>() * Vec3<float>::AssignToAll(1.0f / 255.0f) : Vec3<float>(0.0f, 0.0f, 0.0f);
+		batch.posX[i] = pos.x;
+		batch.posY[i] = pos.y;
+		batch.posZ[i] = pos.z;
+		batch.normX[i] = norm.x;
+		batch.normY[i] = norm.y;
+		batch.normZ[i] = norm.z;
+		batch.colR[i] = vcol0.r();
+		batch.colG[i] = vcol0.g();
+		batch.colB[i] = vcol0.b();
+
+		const Vec3<float> &mac = (materialupdate & 1) ? vcol0 : materialAmbient;
+		const Vec3<float> final_color = mec + mac * ambient;
+		batch.finalR[i] = final_color.r();
+		batch.finalG[i] = final_color.g();
+		batch.finalB[i] = final_color.b();
+		batch.specR[i] = 0.0f;
+		batch.specG[i] = 0.0f;
+		batch.specB[i] = 0.0f;
+	}
+
+	for (int light = 0; light < 4; ++light) {
+		LightState ls;
+		ComputeLightState(&ls, light);
+		if (!ls.enabled)
+			continue;
+		ApplyLight(batch, padded, ls, materialupdate, materialAmbient, materialDiffuse, materialSpecular, specCoef);
+	}
 
-	if (gstate.isUsingSecondaryColor()) {
-		Vec3<int> final_color_int = (final_color.Clamp(0.0f, 1.0f) * 255.0f).Cast<int>();
-		vertex.color0 = Vec4<int>(final_color_int, final_alpha);
-		vertex.color1 = (specular_color.Clamp(0.0f, 1.0f) * 255.0f).Cast<int>();
-	} else {
-		Vec3<int> final_color_int = ((final_color + specular_color).Clamp(0.0f, 1.0f) * 255.0f).Cast<int>();
-		vertex.color0 = Vec4<int>(final_color_int, final_alpha);
+	const bool secondaryColor = gstate.isUsingSecondaryColor();
+	for (int i = 0; i < count; ++i) {
+		VertexData &vertex = vertices[i];
+		int maa = (materialupdate & 1) ? vertex.color0.a() : gstate.getMaterialAmbientA();
+		int final_alpha = (gstate.getAmbientA() * maa) / 255;
+
+		const Vec3<float> final_color(batch.finalR[i], batch.finalG[i], batch.finalB[i]);
+		const Vec3<float> specular_color(batch.specR[i], batch.specG[i], batch.specB[i]);
+		if (secondaryColor) {
+			Vec3<int> final_color_int = (final_color.Clamp(0.0f, 1.0f) * 255.0f).Cast<int>();
+			vertex.color0 = Vec4<int>(final_color_int, final_alpha);
+			vertex.color1 = (specular_color.Clamp(0.0f, 1.0f) * 255.0f).Cast<int>();
+		} else {
+			Vec3<int> final_color_int = ((final_color + specular_color).Clamp(0.0f, 1.0f) * 255.0f).Cast<int>();
+			vertex.color0 = Vec4<int>(final_color_int, final_alpha);
+		}
 	}
 }
 
+void Process(VertexData *vertices, int count, bool hasColor) {
+	for (int start = 0; start < count; start += LIGHT_BATCH)
+		ProcessBatch(vertices + start, std::min(count - start, (int)LIGHT_BATCH), hasColor);
+}
+
 } // namespace
@@ -21,6 +21,7 @@
 
 namespace Lighting {
 
-void Process(VertexData& vertex, bool hasColor);
+// Computes lit colors for a run of vertices, and their environment mapped texture coordinates.
+void Process(VertexData *vertices, int count, bool hasColor);
 
 }
\ No newline at end of file
@@ -252,20 +252,20 @@ static inline void GetTextureCoordinates(const VertexData& v0, const VertexData&
 }
 
 // NOTE: These likely aren't endian safe
-static inline u32 GetPixelColor(int x, int y)
+static inline u32 GetPixelColor(GEBufferFormat fmt, int stride, int x, int y)
 {
-	switch (gstate.FrameBufFormat()) {
+	switch (fmt) {
 	case GE_FORMAT_565:
-		return RGB565ToRGBA8888(fb.Get16(x, y, gstate.FrameBufStride()));
+		return RGB565ToRGBA8888(fb.Get16(x, y, stride));
 
 	case GE_FORMAT_5551:
-		return RGBA5551ToRGBA8888(fb.Get16(x, y, gstate.FrameBufStride()));
+		return RGBA5551ToRGBA8888(fb.Get16(x, y, stride));
 
 	case GE_FORMAT_4444:
-		return RGBA4444ToRGBA8888(fb.Get16(x, y, gstate.FrameBufStride()));
+		return RGBA4444ToRGBA8888(fb.Get16(x, y, stride));
 
 	case GE_FORMAT_8888:
-		return fb.Get32(x, y, gstate.FrameBufStride());
+		return fb.Get32(x, y, stride);
 
 	case GE_FORMAT_INVALID:
 	case GE_FORMAT_DEPTH16:
@@ -274,23 +274,23 @@ static inline u32 GetPixelColor(int x, int y)
 	return 0;
 }
 
-static inline void SetPixelColor(int x, int y, u32 value)
+static inline void SetPixelColor(GEBufferFormat fmt, int stride, int x, int y, u32 value)
 {
-	switch (gstate.FrameBufFormat()) {
+	switch (fmt) {
 	case GE_FORMAT_565:
-		fb.Set16(x, y, gstate.FrameBufStride(), RGBA8888ToRGB565(value));
+		fb.Set16(x, y, stride, RGBA8888ToRGB565(value));
 		break;
 
 	case GE_FORMAT_5551:
-		fb.Set16(x, y, gstate.FrameBufStride(), RGBA8888ToRGBA5551(value));
+		fb.Set16(x, y, stride, RGBA8888ToRGBA5551(value));
 		break;
 
 	case GE_FORMAT_4444:
-		fb.Set16(x, y, gstate.FrameBufStride(), RGBA8888ToRGBA4444(value));
+		fb.Set16(x, y, stride, RGBA8888ToRGBA4444(value));
 		break;
 
 	case GE_FORMAT_8888:
-		fb.Set32(x, y, gstate.FrameBufStride(), value);
+		fb.Set32(x, y, stride, value);
 		break;
 
 	case GE_FORMAT_INVALID:
@@ -299,56 +299,56 @@ static inline void SetPixelColor(int x, int y, u32 value)
 	}
 }
 
-static inline u16 GetPixelDepth(int x, int y)
+static inline u16 GetPixelDepth(int x, int y, int stride)
 {
-	return depthbuf.Get16(x, y, gstate.DepthBufStride());
+	return depthbuf.Get16(x, y, stride);
 }
 
-static inline void SetPixelDepth(int x, int y, u16 value)
+static inline void SetPixelDepth(int x, int y, int stride, u16 value)
 {
-	depthbuf.Set16(x, y, gstate.DepthBufStride(), value);
+	depthbuf.Set16(x, y, stride, value);
 }
 
-static inline u8 GetPixelStencil(int x, int y)
+static inline u8 GetPixelStencil(GEBufferFormat fmt, int stride, int x, int y)
 {
-	if (gstate.FrameBufFormat() == GE_FORMAT_565) {
+	if (fmt == GE_FORMAT_565) {
 		// Always treated as 0 for comparison purposes.
 		return 0;
-	} else if (gstate.FrameBufFormat() == GE_FORMAT_5551) {
-		return ((fb.Get16(x, y, gstate.FrameBufStride()) & 0x8000) != 0) ? 0xFF : 0;
-	} else if (gstate.FrameBufFormat() == GE_FORMAT_4444) {
-		return Convert4To8(fb.Get16(x, y, gstate.FrameBufStride()) >> 12);
+	} else if (fmt == GE_FORMAT_5551) {
+		return ((fb.Get16(x, y, stride) & 0x8000) != 0) ? 0xFF : 0;
+	} else if (fmt == GE_FORMAT_4444) {
+		return Convert4To8(fb.Get16(x, y, stride) >> 12);
 	} else {
-		return fb.Get32(x, y, gstate.FrameBufStride()) >> 24;
+		return fb.Get32(x, y, stride) >> 24;
 	}
 }
 
-static inline void SetPixelStencil(int x, int y, u8 value)
+static inline void SetPixelStencil(GEBufferFormat fmt, int stride, int x, int y, u8 value)
 {
 	// TODO: This seems like it maybe respects the alpha mask (at least in some scenarios?)
 
-	if (gstate.FrameBufFormat() == GE_FORMAT_565) {
+	if (fmt == GE_FORMAT_565) {
 		// Do nothing
-	} else if (gstate.FrameBufFormat() == GE_FORMAT_5551) {
-		u16 pixel = fb.Get16(x, y, gstate.FrameBufStride()) & ~0x8000;
+	} else if (fmt == GE_FORMAT_5551) {
+		u16 pixel = fb.Get16(x, y, stride) & ~0x8000;
 		pixel |= value != 0 ? 0x8000 : 0;
-		fb.Set16(x, y, gstate.FrameBufStride(), pixel);
-	} else if (gstate.FrameBufFormat() == GE_FORMAT_4444) {
-		u16 pixel = fb.Get16(x, y, gstate.FrameBufStride()) & ~0xF000;
+		fb.Set16(x, y, stride, pixel);
+	} else if (fmt == GE_FORMAT_4444) {
+		u16 pixel = fb.Get16(x, y, stride) & ~0xF000;
 		pixel |= (u16)value << 12;
-		fb.Set16(x, y, gstate.FrameBufStride(), pixel);
+		fb.Set16(x, y, stride, pixel);
 	} else {
-		u32 pixel = fb.Get32(x, y, gstate.FrameBufStride()) & ~0xFF000000;
+		u32 pixel = fb.Get32(x, y, stride) & ~0xFF000000;
 		pixel |= (u32)value << 24;
-		fb.Set32(x, y, gstate.FrameBufStride(), pixel);
+		fb.Set32(x, y, stride, pixel);
 	}
 }
 
-static inline bool DepthTestPassed(int x, int y, u16 z)
+static inline bool DepthTestPassed(GEComparison func, int x, int y, int stride, u16 z)
 {
-	u16 reference_z = GetPixelDepth(x, y);
+	u16 reference_z = GetPixelDepth(x, y, stride);
 
-	switch (gstate.getDepthTestFunction()) {
+	switch (func) {
 	case GE_COMP_NEVER:
 		return false;
 
@@ -389,12 +389,12 @@ static inline bool IsRightSideOrFlatBottomLine(const Vec2<int>& vertex, const Ve
 	}
 }
 
-static inline bool StencilTestPassed(u8 stencil)
+static inline bool StencilTestPassed(const PixelFuncID &pixelID, u8 stencil)
 {
 	// TODO: Does the masking logic make any sense?
-	stencil &= gstate.getStencilTestMask();
-	u8 ref = gstate.getStencilTestRef() & gstate.getStencilTestMask();
-	switch (gstate.getStencilTestFunction()) {
+	stencil &= pixelID.cached.stencilTestMask;
+	u8 ref = pixelID.cached.stencilTestRef & pixelID.cached.stencilTestMask;
+	switch (GEComparison(pixelID.stencilTestFunc)) {
 		case GE_COMP_NEVER:
 			return false;
 
@@ -422,10 +422,10 @@ static inline bool StencilTestPassed(u8 stencil)
 	return true;
 }
 
-static inline u8 ApplyStencilOp(int op, u8 old_stencil) {
+static inline u8 ApplyStencilOp(GEBufferFormat fmt, const PixelFuncID &pixelID, int op, u8 old_stencil) {
 	// TODO: Apply mask to reference or old stencil?
-	u8 reference_stencil = gstate.getStencilTestRef(); // TODO: Apply mask?
-	const u8 write_mask = gstate.getStencilWriteMask();
+	u8 reference_stencil = pixelID.cached.stencilTestRef; // TODO: Apply mask?
+	const u8 write_mask = pixelID.cached.stencilWriteMask;
 
 	switch (op) {
 		case GE_STENCILOP_KEEP:
@@ -441,7 +441,7 @@ static inline u8 ApplyStencilOp(int op, u8 old_stencil) {
 			return (~old_stencil & ~write_mask) | (old_stencil & write_mask);
 
 		case GE_STENCILOP_INCR:
-			switch (gstate.FrameBufFormat()) {
+			switch (fmt) {
 			case GE_FORMAT_8888:
 				if (old_stencil != 0xFF) {
 					return ((old_stencil + 1) & ~write_mask) | (old_stencil & write_mask);
@@ -460,7 +460,7 @@ static inline u8 ApplyStencilOp(int op, u8 old_stencil) {
 			break;
 
 		case GE_STENCILOP_DECR:
-			switch (gstate.FrameBufFormat()) {
+			switch (fmt) {
 			case GE_FORMAT_4444:
 				if (old_stencil >= 0x10)
 					return ((old_stencil - 0x10) & ~write_mask) | (old_stencil & write_mask);
@@ -626,12 +626,12 @@ Vec4<int> GetTextureFunctionOutput(const Vec4<int>& prim_color, const Vec4<int>&
 	return Vec4<int>(out_rgb.r(), out_rgb.g(), out_rgb.b(), out_a);
 }
 
-static inline bool ColorTestPassed(const Vec3<int> &color)
+static inline bool ColorTestPassed(const PixelFuncID &pixelID, const Vec3<int> &color)
 {
-	const u32 mask = gstate.getColorTestMask();
+	const u32 mask = pixelID.cached.colorTestMask;
 	const u32 c = color.ToRGB() & mask;
-	const u32 ref = gstate.getColorTestRef() & mask;
-	switch (gstate.getColorTestFunction()) {
+	const u32 ref = pixelID.cached.colorTestRef & mask;
+	switch (GEComparison(pixelID.colorTestFunc)) {
 		case GE_COMP_NEVER:
 			return false;
 
@@ -645,19 +645,19 @@ static inline bool ColorTestPassed(const Vec3<int> &color)
 			return c != ref;
 
 		default:
-			ERROR_LOG_REPORT(G3D, "Software: Invalid colortest function: %d", gstate.getColorTestFunction());
+			ERROR_LOG_REPORT(G3D, "Software: Invalid colortest function: %d", pixelID.colorTestFunc);
 			break;
 	}
 	return true;
 }
 
-static inline bool AlphaTestPassed(int alpha)
+static inline bool AlphaTestPassed(const PixelFuncID &pixelID, int alpha)
 {
-	const u8 mask = gstate.getAlphaTestMask() & 0xFF;
-	const u8 ref = gstate.getAlphaTestRef() & mask;
+	const u8 mask = pixelID.cached.alphaTestMask;
+	const u8 ref = pixelID.cached.alphaTestRef & mask;
 	alpha &= mask;
 
-	switch (gstate.getAlphaTestFunction()) {
+	switch (GEComparison(pixelID.alphaTestFunc)) {
 		case GE_COMP_NEVER:
 			return false;
 
@@ -685,9 +685,9 @@ static inline bool AlphaTestPassed(int alpha)
 	return true;
 }
 
-static inline Vec3<int> GetSourceFactor(const Vec4<int>& source, const Vec4<int>& dst)
+static inline Vec3<int> GetSourceFactor(const PixelFuncID &pixelID, const Vec4<int>& source, const Vec4<int>& dst)
 {
-	switch (gstate.getBlendFuncA()) {
+	switch (GEBlendSrcFactor(pixelID.alphaBlendSrc)) {
 	case GE_SRCBLEND_DSTCOLOR:
 		return dst.rgb();
 
@@ -729,13 +729,13 @@ static inline Vec3<int> GetSourceFactor(const Vec4<int>& source, const Vec4<int>
 	case GE_SRCBLEND_FIXA:
 	default:
 		// All other dest factors (> 10) are treated as FIXA.
-		return Vec3<int>::FromRGB(gstate.getFixA());
+		return Vec3<int>::FromRGB(pixelID.cached.fixA);
 	}
 }
 
-static inline Vec3<int> GetDestFactor(const Vec4<int>& source, const Vec4<int>& dst)
+static inline Vec3<int> GetDestFactor(const PixelFuncID &pixelID, const Vec4<int>& source, const Vec4<int>& dst)
 {
-	switch (gstate.getBlendFuncB()) {
+	switch (GEBlendDstFactor(pixelID.alphaBlendDst)) {
 	case GE_DSTBLEND_SRCCOLOR:
 		return source.rgb();
 
@@ -777,18 +777,18 @@ static inline Vec3<int> GetDestFactor(const Vec4<int>& source, const Vec4<int>&
 	case GE_DSTBLEND_FIXB:
 	default:
 		// All other dest factors (> 10) are treated as FIXB.
-		return Vec3<int>::FromRGB(gstate.getFixB());
+		return Vec3<int>::FromRGB(pixelID.cached.fixB);
 	}
 }
 
 // Removed inline here - it was never chosen to be inlined by the compiler anyway, too complex.
-Vec3<int> AlphaBlendingResult(const Vec4<int> &source, const Vec4<int> &dst)
+Vec3<int> AlphaBlendingResult(const PixelFuncID &pixelID, const Vec4<int> &source, const Vec4<int> &dst)
 {
 	// Note: These factors cannot go below 0, but they can go above 255 when doubling.
-	Vec3<int> srcfactor = GetSourceFactor(source, dst);
-	Vec3<int> dstfactor = GetDestFactor(source, dst);
+	Vec3<int> srcfactor = GetSourceFactor(pixelID, source, dst);
+	Vec3<int> dstfactor = GetDestFactor(pixelID, source, dst);
 
-	switch (gstate.getBlendEq()) {
+	switch (GEBlendMode(pixelID.alphaBlendEq)) {
 	case GE_BLENDMODE_MUL_AND_ADD:
 	{
 #if defined(_M_SSE)
@@ -838,82 +838,85 @@ Vec3<int> AlphaBlendingResult(const Vec4<int> &source, const Vec4<int> &dst)
 						::abs(source.b() - dst.b()));
 
 	default:
-		ERROR_LOG_REPORT(G3D, "Software: Unknown blend function %x", gstate.getBlendEq());
+		ERROR_LOG_REPORT(G3D, "Software: Unknown blend function %x", pixelID.alphaBlendEq);
 		return Vec3<int>();
 	}
 }
 
-template <bool clearMode>
-inline void DrawSinglePixel(const DrawingCoords &p, u16 z, u8 fog, const Vec4<int> &color_in) {
+template <bool clearMode, GEBufferFormat fbFormat>
+void DrawSinglePixel(int x, int y, u16 z, u8 fog, const Vec4<int> &color_in, const PixelFuncID &pixelID) {
 	Vec4<int> prim_color = color_in.Clamp(0, 255);
 	// Depth range test - applied in clear mode, if not through mode.
-	if (!gstate.isModeThrough())
-		if (z < gstate.getDepthRangeMin() || z > gstate.getDepthRangeMax())
+	if (pixelID.applyDepthRange)
+		if (z < pixelID.cached.minz || z > pixelID.cached.maxz)
 			return;
 
-	if (gstate.isAlphaTestEnabled() && !clearMode)
-		if (!AlphaTestPassed(prim_color.a()))
+	if (pixelID.alphaTestFunc != GE_COMP_ALWAYS && !clearMode)
+		if (!AlphaTestPassed(pixelID, prim_color.a()))
 			return;
 
 	// Fog is applied prior to color test.
-	if (gstate.isFogEnabled() && !gstate.isModeThrough() && !clearMode) {
-		Vec3<int> fogColor = Vec3<int>::FromRGB(gstate.fogcolor);
+	if (pixelID.applyFog && !clearMode) {
+		Vec3<int> fogColor = Vec3<int>::FromRGB(pixelID.cached.fogColor);
 		fogColor = (prim_color.rgb() * (int)fog + fogColor * (255 - (int)fog)) / 255;
 		prim_color.r() = fogColor.r();
 		prim_color.g() = fogColor.g();
 		prim_color.b() = fogColor.b();
 	}
 
-	if (gstate.isColorTestEnabled() && !clearMode)
-		if (!ColorTestPassed(prim_color.rgb()))
+	if (pixelID.colorTestFunc != GE_COMP_ALWAYS && !clearMode)
+		if (!ColorTestPassed(pixelID, prim_color.rgb()))
 			return;
 
+	const int fbStride = pixelID.cached.framebufStride;
+	const int depthStride = pixelID.cached.depthbufStride;
+
 	// In clear mode, it uses the alpha color as stencil.
-	u8 stencil = clearMode ? prim_color.a() : GetPixelStencil(p.x, p.y);
-	if (!clearMode && (gstate.isStencilTestEnabled() || gstate.isDepthTestEnabled())) {
-		if (gstate.isStencilTestEnabled() && !StencilTestPassed(stencil)) {
-			stencil = ApplyStencilOp(gstate.getStencilOpSFail(), stencil);
-			SetPixelStencil(p.x, p.y, stencil);
+	u8 stencil = clearMode ? prim_color.a() : GetPixelStencil(fbFormat, fbStride, x, y);
+	if (!clearMode && (pixelID.stencilTest || pixelID.depthTest)) {
+		if (pixelID.stencilTest && !StencilTestPassed(pixelID, stencil)) {
+			stencil = ApplyStencilOp(fbFormat, pixelID, pixelID.sFail, stencil);
+			SetPixelStencil(fbFormat, fbStride, x, y, stencil);
 			return;
 		}
 
 		// Also apply depth at the same time.  If disabled, same as passing.
-		if (gstate.isDepthTestEnabled() && !DepthTestPassed(p.x, p.y, z)) {
-			if (gstate.isStencilTestEnabled()) {
-				stencil = ApplyStencilOp(gstate.getStencilOpZFail(), stencil);
-				SetPixelStencil(p.x, p.y, stencil);
+		if (pixelID.depthTest && !DepthTestPassed(GEComparison(pixelID.depthTestFunc), x, y, depthStride, z)) {
+			if (pixelID.stencilTest) {
+				stencil = ApplyStencilOp(fbFormat, pixelID, pixelID.zFail, stencil);
+				SetPixelStencil(fbFormat, fbStride, x, y, stencil);
 			}
 			return;
-		} else if (gstate.isStencilTestEnabled()) {
-			stencil = ApplyStencilOp(gstate.getStencilOpZPass(), stencil);
+		} else if (pixelID.stencilTest) {
+			stencil = ApplyStencilOp(fbFormat, pixelID, pixelID.zPass, stencil);
 		}
 
-		if (gstate.isDepthTestEnabled() && gstate.isDepthWriteEnabled()) {
-			SetPixelDepth(p.x, p.y, z);
+		if (pixelID.depthWrite) {
+			SetPixelDepth(x, y, depthStride, z);
 		}
-	} else if (clearMode && gstate.isClearModeDepthMask()) {
-		SetPixelDepth(p.x, p.y, z);
+	} else if (clearMode && pixelID.clearDepth) {
+		SetPixelDepth(x, y, depthStride, z);
 	}
 
-	const u32 old_color = GetPixelColor(p.x, p.y);
+	const u32 old_color = GetPixelColor(fbFormat, fbStride, x, y);
 	u32 new_color;
 
 	// Dithering happens before the logic op and regardless of framebuffer format or clear mode.
 	// We do it while alpha blending because it happens before clamping.
-	if (gstate.isAlphaBlendEnabled() && !clearMode) {
+	if (pixelID.alphaBlend && !clearMode) {
 		const Vec4<int> dst = Vec4<int>::FromRGBA(old_color);
-		Vec3<int> blended = AlphaBlendingResult(prim_color, dst);
-		if (gstate.isDitherEnabled()) {
-			blended += Vec3<int>::AssignToAll(gstate.getDitherValue(p.x, p.y));
+		Vec3<int> blended = AlphaBlendingResult(pixelID, prim_color, dst);
+		if (pixelID.dithering) {
+			blended += Vec3<int>::AssignToAll(pixelID.cached.ditherMatrix[(y & 3) * 4 + (x & 3)]);
 		}
 
 		// ToRGB() always automatically clamps.
 		new_color = blended.ToRGB();
 		new_color |= stencil << 24;
 	} else {
-		if (gstate.isDitherEnabled()) {
+		if (pixelID.dithering) {
 			// We'll discard alpha anyway.
-			prim_color += Vec4<int>::AssignToAll(gstate.getDitherValue(p.x, p.y));
+			prim_color += Vec4<int>::AssignToAll(pixelID.cached.ditherMatrix[(y & 3) * 4 + (x & 3)]);
 		}
 
 #if defined(_M_SSE)
@@ -925,21 +928,61 @@ inline void DrawSinglePixel(const DrawingCoords &p, u16 z, u8 fog, const Vec4<in
 	}
 
 	// Logic ops are applied after blending (if blending is enabled.)
-	if (gstate.isLogicOpEnabled() && !clearMode) {
+	if (pixelID.applyLogicOp && !clearMode) {
 		// Logic ops don't affect stencil, which happens inside ApplyLogicOp.
-		new_color = ApplyLogicOp(gstate.getLogicOp(), old_color, new_color);
+		new_color = ApplyLogicOp(GELogicOp(pixelID.logicOp), old_color, new_color);
 	}
 
 	if (clearMode) {
-		new_color = (new_color & ~gstate.getClearModeColorMask()) | (old_color & gstate.getClearModeColorMask());
+		const u32 keepOldMask = (pixelID.clearColor ? 0 : 0x00FFFFFF) | (pixelID.clearStencil ? 0 : 0xFF000000);
+		new_color = (new_color & ~keepOldMask) | (old_color & keepOldMask);
+	}
+	if (pixelID.applyColorWriteMask) {
+		new_color = (new_color & ~pixelID.cached.colorWriteMask) | (old_color & pixelID.cached.colorWriteMask);
+	}
+
+	SetPixelColor(fbFormat, fbStride, x, y, new_color);
+}
+
+// Instantiated per clear mode and framebuffer format, the rest is decided by branches on the ID.
+template <bool clearMode>
+static SingleFunc GetSingleFuncForFormat(GEBufferFormat fmt) {
+	switch (fmt) {
+	case GE_FORMAT_565:
+		return &DrawSinglePixel<clearMode, GE_FORMAT_565>;
+	case GE_FORMAT_5551:
+		return &DrawSinglePixel<clearMode, GE_FORMAT_5551>;
+	case GE_FORMAT_4444:
+		return &DrawSinglePixel<clearMode, GE_FORMAT_4444>;
+	case GE_FORMAT_8888:
+	default:
+		return &DrawSinglePixel<clearMode, GE_FORMAT_8888>;
 	}
-	new_color = (new_color & ~gstate.getColorMask()) | (old_color & gstate.getColorMask());
+}
 
-	SetPixelColor(p.x, p.y, new_color);
+SingleFunc GetSingleFunc(const PixelFuncID &id) {
+	if (id.clearMode)
+		return GetSingleFuncForFormat<true>(id.FBFormat());
+	return GetSingleFuncForFormat<false>(id.FBFormat());
 }
 
-void DrawSinglePixelNonClear(const DrawingCoords &p, u16 z, u8 fog, const Vec4<int> &color_in) {
-	DrawSinglePixel<false>(p, z, fog, color_in);
+static PixelFuncID currentPixelID;
+static SingleFunc currentPixelFunc = nullptr;
+static bool pixelStateDirty = true;
+
+void DirtyPixelState() {
+	pixelStateDirty = true;
+}
+
+const PixelFuncID &GetPixelFuncID(SingleFunc *func) {
+	if (pixelStateDirty) {
+		ComputePixelFuncID(&currentPixelID);
+		currentPixelFunc = GetSingleFunc(currentPixelID);
+		pixelStateDirty = false;
+	}
+	if (func)
+		*func = currentPixelFunc;
+	return currentPixelID;
 }
 
 static inline void ApplyTexturing(Sampler::Funcs sampler, Vec4<int> &prim_color, float s, float t, int texlevel, int frac_texlevel, bool bilinear, u8 *texptr[], int texbufw[]) {
@@ -1188,6 +1231,8 @@ void DrawTriangleSlice(
 	const bool flatZ = v0.screenpos.z == v1.screenpos.z && v0.screenpos.z == v2.screenpos.z;
 
 	Sampler::Funcs sampler = Sampler::GetFuncs();
+	SingleFunc drawPixel;
+	const PixelFuncID &pixelID = GetPixelFuncID(&drawPixel);
 
 	for (pprime.y = minY; pprime.y <= maxY; pprime.y += 32,
 										w0_base = e0.StepY(w0_base),
@@ -1287,15 +1332,27 @@ void DrawTriangleSlice(
 					subp.x = p.x + (i & 1);
 					subp.y = p.y + (i / 2);
 
-					DrawSinglePixel<clearMode>(subp, (u16)z[i], fog[i], prim_color[i]);
+					drawPixel(subp.x, subp.y, (u16)z[i], fog[i], prim_color[i], pixelID);
 				}
 			}
 		}
 	}
 }
 
+void GetScissor(const TileRect *tile, DrawingCoords &tl, DrawingCoords &br)
+{
+	tl = DrawingCoords(gstate.getScissorX1(), gstate.getScissorY1(), 0);
+	br = DrawingCoords(gstate.getScissorX2(), gstate.getScissorY2(), 0);
+	if (tile) {
+		tl.x = std::max((int)tl.x, tile->x1);
+		tl.y = std::max((int)tl.y, tile->y1);
+		br.x = std::min((int)br.x, tile->x2);
+		br.y = std::min((int)br.y, tile->y2);
+	}
+}
+
 // Draws triangle, vertices specified in counter-clockwise direction
-void DrawTriangle(const VertexData& v0, const VertexData& v1, const VertexData& v2)
+void DrawTriangle(const VertexData& v0, const VertexData& v1, const VertexData& v2, const TileRect *tile)
 {
 	PROFILE_THIS_SCOPE("draw_tri");
 
@@ -1312,8 +1369,8 @@ void DrawTriangle(const VertexData& v0, const VertexData& v1, const VertexData&
 	int maxX = (std::max(std::max(v0.screenpos.x, v1.screenpos.x), v2.screenpos.x) + 0xF) & ~0xF;
 	int maxY = (std::max(std::max(v0.screenpos.y, v1.screenpos.y), v2.screenpos.y) + 0xF) & ~0xF;
 
-	DrawingCoords scissorTL(gstate.getScissorX1(), gstate.getScissorY1(), 0);
-	DrawingCoords scissorBR(gstate.getScissorX2(), gstate.getScissorY2(), 0);
+	DrawingCoords scissorTL, scissorBR;
+	GetScissor(tile, scissorTL, scissorBR);
 	minX = std::max(minX, (int)TransformUnit::DrawingToScreen(scissorTL).x);
 	maxX = std::min(maxX, (int)TransformUnit::DrawingToScreen(scissorBR).x);
 	minY = std::max(minY, (int)TransformUnit::DrawingToScreen(scissorTL).y);
@@ -1325,7 +1382,17 @@ void DrawTriangle(const VertexData& v0, const VertexData& v1, const VertexData&
 
 	const int MIN_LINES_PER_THREAD = 4;
 
-	if (rangeY >= 12 && rangeX >= rangeY * 4) {
+	// The slices only read the pixel state, so make sure it's computed before starting them.
+	GetPixelFuncID();
+
+	// Tiles are already drawn on a worker each.
+	if (tile) {
+		if (gstate.isModeClear()) {
+			DrawTriangleSlice<true>(v0, v1, v2, minX, minY, maxX, maxY, true, 0, rangeY);
+		} else {
+			DrawTriangleSlice<false>(v0, v1, v2, minX, minY, maxX, maxY, true, 0, rangeY);
+		}
+	} else if (rangeY >= 12 && rangeX >= rangeY * 4) {
 		if (gstate.isModeClear()) {
 			auto bound = [&](int a, int b) -> void {
 				DrawTriangleSlice<true>(v0, v1, v2, minX, minY, maxX, maxY, false, a, b);
@@ -1358,14 +1425,16 @@ void DrawTriangle(const VertexData& v0, const VertexData& v1, const VertexData&
 	}
 }
 
-void DrawPoint(const VertexData &v0)
+void DrawPoint(const VertexData &v0, const TileRect *tile)
 {
 	ScreenCoords pos = v0.screenpos;
 	Vec4<int> prim_color = v0.color0;
 	Vec3<int> sec_color = v0.color1;
 
-	ScreenCoords scissorTL(TransformUnit::DrawingToScreen(DrawingCoords(gstate.getScissorX1(), gstate.getScissorY1(), 0)));
-	ScreenCoords scissorBR(TransformUnit::DrawingToScreen(DrawingCoords(gstate.getScissorX2(), gstate.getScissorY2(), 0)));
+	DrawingCoords drawingTL, drawingBR;
+	GetScissor(tile, drawingTL, drawingBR);
+	ScreenCoords scissorTL(TransformUnit::DrawingToScreen(drawingTL));
+	ScreenCoords scissorBR(TransformUnit::DrawingToScreen(drawingBR));
 
 	if (pos.x < scissorTL.x || pos.y < scissorTL.y || pos.x > scissorBR.x || pos.y > scissorBR.y)
 		return;
@@ -1427,22 +1496,20 @@ void DrawPoint(const VertexData &v0)
 		fog = ClampFogDepth(v0.fogdepth);
 	}
 
-	if (clearMode) {
-		DrawSinglePixel<true>(p, z, fog, prim_color);
-	} else {
-		DrawSinglePixel<false>(p, z, fog, prim_color);
-	}
+	SingleFunc drawPixel;
+	const PixelFuncID &pixelID = GetPixelFuncID(&drawPixel);
+	drawPixel(p.x, p.y, z, fog, prim_color, pixelID);
 }
 
-void ClearRectangle(const VertexData &v0, const VertexData &v1)
+void ClearRectangle(const VertexData &v0, const VertexData &v1, const TileRect *tile)
 {
 	int minX = std::min(v0.screenpos.x, v1.screenpos.x) & ~0xF;
 	int minY = std::min(v0.screenpos.y, v1.screenpos.y) & ~0xF;
 	int maxX = (std::max(v0.screenpos.x, v1.screenpos.x) + 0xF) & ~0xF;
 	int maxY = (std::max(v0.screenpos.y, v1.screenpos.y) + 0xF) & ~0xF;
 
-	DrawingCoords scissorTL(gstate.getScissorX1(), gstate.getScissorY1(), 0);
-	DrawingCoords scissorBR(gstate.getScissorX2(), gstate.getScissorY2(), 0);
+	DrawingCoords scissorTL, scissorBR;
+	GetScissor(tile, scissorTL, scissorBR);
 	minX = std::max(minX, (int)TransformUnit::DrawingToScreen(scissorTL).x);
 	maxX = std::max(0, std::min(maxX, (int)TransformUnit::DrawingToScreen(scissorBR).x + 16));
 	minY = std::max(minY, (int)TransformUnit::DrawingToScreen(scissorTL).y);
@@ -1465,7 +1532,7 @@ void ClearRectangle(const VertexData &v0, const VertexData &v1)
 				memset(row, z, w * 2);
 			} else {
 				for (int x = 0; x < w; ++x) {
-					SetPixelDepth(p.x + x, p.y, z);
+					SetPixelDepth(p.x + x, p.y, stride, z);
 				}
 			}
 		}
@@ -1563,7 +1630,7 @@ void ClearRectangle(const VertexData &v0, const VertexData &v1)
 	}
 }
 
-void DrawLine(const VertexData &v0, const VertexData &v1)
+void DrawLine(const VertexData &v0, const VertexData &v1, const TileRect *tile)
 {
 	// TODO: Use a proper line drawing algorithm that handles fractional endpoints correctly.
 	Vec3<int> a(v0.screenpos.x, v0.screenpos.y, v0.screenpos.z);
@@ -1583,8 +1650,10 @@ void DrawLine(const VertexData &v0, const VertexData &v1)
 	float yinc = (float)dy / steps;
 	float zinc = (float)dz / steps;
 
-	ScreenCoords scissorTL(TransformUnit::DrawingToScreen(DrawingCoords(gstate.getScissorX1(), gstate.getScissorY1(), 0)));
-	ScreenCoords scissorBR(TransformUnit::DrawingToScreen(DrawingCoords(gstate.getScissorX2(), gstate.getScissorY2(), 0)));
+	DrawingCoords drawingTL, drawingBR;
+	GetScissor(tile, drawingTL, drawingBR);
+	ScreenCoords scissorTL(TransformUnit::DrawingToScreen(drawingTL));
+	ScreenCoords scissorBR(TransformUnit::DrawingToScreen(drawingBR));
 	bool clearMode = gstate.isModeClear();
 
 	int texbufw[8] = {0};
@@ -1607,6 +1676,8 @@ void DrawLine(const VertexData &v0, const VertexData &v1)
 	}
 
 	Sampler::Funcs sampler = Sampler::GetFuncs();
+	SingleFunc drawPixel;
+	const PixelFuncID &pixelID = GetPixelFuncID(&drawPixel);
 
 	float x = a.x > b.x ? a.x - 1 : a.x;
 	float y = a.y > b.y ? a.y - 1 : a.y;
@@ -1680,11 +1751,7 @@ void DrawLine(const VertexData &v0, const VertexData &v1)
 			ScreenCoords pprime = ScreenCoords((int)x, (int)y, (int)z);
 
 			DrawingCoords p = TransformUnit::ScreenToDrawing(pprime);
-			if (clearMode) {
-				DrawSinglePixel<true>(p, z, fog, prim_color);
-			} else {
-				DrawSinglePixel<false>(p, z, fog, prim_color);
-			}
+			drawPixel(p.x, p.y, z, fog, prim_color, pixelID);
 		}
 
 		x += xinc;
@@ -1702,7 +1769,7 @@ bool GetCurrentStencilbuffer(GPUDebugBuffer &buffer)
 	u8 *row = buffer.GetData();
 	for (int y = gstate.getRegionY1(); y <= gstate.getRegionY2(); ++y) {
 		for (int x = gstate.getRegionX1(); x <= gstate.getRegionX2(); ++x) {
-			row[x - gstate.getRegionX1()] = GetPixelStencil(x, y);
+			row[x - gstate.getRegionX1()] = GetPixelStencil(gstate.FrameBufFormat(), gstate.FrameBufStride(), x, y);
 		}
 		row += w;
 	}
@@ -17,24 +17,43 @@
 
 #pragma once
 
+#include "GPU/Software/FuncId.h"
 #include "TransformUnit.h" // for DrawingCoords
 
 struct GPUDebugBuffer;
 
 namespace Rasterizer {
 
+// Drawing coords, inclusive like the scissor.
+struct TileRect {
+	int x1, y1, x2, y2;
+};
+
+// With a tile (see BinManager), only the part inside it is drawn, all on the calling thread.
+
 // Draws a triangle if its vertices are specified in counter-clockwise order
-void DrawTriangle(const VertexData& v0, const VertexData& v1, const VertexData& v2);
-void DrawPoint(const VertexData &v0);
-void DrawLine(const VertexData &v0, const VertexData &v1);
-void ClearRectangle(const VertexData &v0, const VertexData &v1);
+void DrawTriangle(const VertexData& v0, const VertexData& v1, const VertexData& v2, const TileRect *tile = nullptr);
+void DrawPoint(const VertexData &v0, const TileRect *tile = nullptr);
+void DrawLine(const VertexData &v0, const VertexData &v1, const TileRect *tile = nullptr);
+void ClearRectangle(const VertexData &v0, const VertexData &v1, const TileRect *tile = nullptr);
+
+// The current scissor, narrowed to the tile if there is one.
+void GetScissor(const TileRect *tile, DrawingCoords &tl, DrawingCoords &br);
 
 bool GetCurrentStencilbuffer(GPUDebugBuffer &buffer);
 bool GetCurrentTexture(GPUDebugBuffer &buffer, int level);
 
+// Runs the whole per pixel pipeline for the state the ID was computed from.
+typedef void (*SingleFunc)(int x, int y, u16 z, u8 fog, const Vec4<int> &color_in, const PixelFuncID &pixelID);
+SingleFunc GetSingleFunc(const PixelFuncID &id);
+
+// The ID (and its function) for the current gstate, recomputed only after DirtyPixelState().
+// Not thread safe, call it on the GPU thread before handing work to other threads.
+const PixelFuncID &GetPixelFuncID(SingleFunc *func = nullptr);
+void DirtyPixelState();
+
 // Shared functions with RasterizerRectangle.cpp
-Vec3<int> AlphaBlendingResult(const Vec4<int> &source, const Vec4<int> &dst);
-void DrawSinglePixelNonClear(const DrawingCoords &p, u16 z, u8 fog, const Vec4<int> &color_in);
+Vec3<int> AlphaBlendingResult(const PixelFuncID &pixelID, const Vec4<int> &source, const Vec4<int> &dst);
 Vec4<int> GetTextureFunctionOutput(const Vec4<int>& prim_color, const Vec4<int>& texcolor);
 
 }  // namespace Rasterizer
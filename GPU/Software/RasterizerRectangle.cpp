@@ -13,8 +13,10 @@
 #include "GPU/GPUState.h"
 
 #include "GPU/Common/TextureCacheCommon.h"
+#include "GPU/Software/BinManager.h"
 #include "GPU/Software/SoftGpu.h"
 #include "GPU/Software/Rasterizer.h"
+#include "GPU/Software/RasterizerRectangle.h"
 #include "GPU/Software/Sampler.h"
 
 #if defined(_M_SSE)
@@ -28,14 +30,14 @@ extern bool currentDialogActive;
 namespace Rasterizer {
 
 // Through mode, with the specific Darkstalker settings.
-inline void DrawSinglePixel5551(u16 *pixel, const u32 color_in) {
+inline void DrawSinglePixel5551(u16 *pixel, const u32 color_in, const PixelFuncID &pixelID) {
 	u32 new_color;
 	if ((color_in >> 24) == 255) {
 		new_color = color_in & 0xFFFFFF;
 	} else {
 		const u32 old_color = RGBA5551ToRGBA8888(*pixel);
 		const Vec4<int> dst = Vec4<int>::FromRGBA(old_color);
-		Vec3<int> blended = AlphaBlendingResult(Vec4<int>::FromRGBA(color_in), dst);
+		Vec3<int> blended = AlphaBlendingResult(pixelID, Vec4<int>::FromRGBA(color_in), dst);
 		// ToRGB() always automatically clamps.
 		new_color = blended.ToRGB();
 	}
@@ -73,7 +75,7 @@ static inline Vec4<int> ModulateRGBA(const Vec4<int>& prim_color, const Vec4<int
 
 }
 
-void DrawSprite(const VertexData& v0, const VertexData& v1) {
+void DrawSprite(const VertexData& v0, const VertexData& v1, const TileRect *tile) {
 	const u8 *texptr = nullptr;
 
 	GETextureFormat texfmt = gstate.getTextureFormat();
@@ -84,12 +86,14 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 
 	ScreenCoords pprime(v0.screenpos.x, v0.screenpos.y, 0);
 	Sampler::NearestFunc nearestFunc = Sampler::GetNearestFunc();  // Looks at gstate.
+	SingleFunc drawPixel;
+	const PixelFuncID &pixelID = GetPixelFuncID(&drawPixel);
 
 	DrawingCoords pos0 = TransformUnit::ScreenToDrawing(v0.screenpos);
 	DrawingCoords pos1 = TransformUnit::ScreenToDrawing(v1.screenpos);
 
-	DrawingCoords scissorTL(gstate.getScissorX1(), gstate.getScissorY1(), 0);
-	DrawingCoords scissorBR(gstate.getScissorX2(), gstate.getScissorY2(), 0);
+	DrawingCoords scissorTL, scissorBR;
+	GetScissor(tile, scissorTL, scissorBR);
 
 	int z = pos0.z;
 	float fog = 1.0f;
@@ -144,7 +148,7 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 					for (int x = pos0.x; x < pos1.x; x++) {
 						u32 tex_color = nearestFunc(s, t, texptr, texbufw, 0);
 						if (tex_color & 0xFF000000) {
-							DrawSinglePixel5551(pixel, tex_color);
+							DrawSinglePixel5551(pixel, tex_color, pixelID);
 						}
 						s += ds;
 						pixel++;
@@ -155,7 +159,7 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 						Vec4<int> tex_color = Vec4<int>::FromRGBA(nearestFunc(s, t, texptr, texbufw, 0));
 						prim_color = ModulateRGBA(prim_color, tex_color);
 						if (prim_color.a() > 0) {
-							DrawSinglePixel5551(pixel, prim_color.ToRGBA());
+							DrawSinglePixel5551(pixel, prim_color.ToRGBA(), pixelID);
 						}
 						s += ds;
 						pixel++;
@@ -172,8 +176,7 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 					Vec4<int> prim_color = v1.color0;
 					Vec4<int> tex_color = Vec4<int>::FromRGBA(nearestFunc(s, t, texptr, texbufw, 0));
 					prim_color = GetTextureFunctionOutput(prim_color, tex_color);
-					DrawingCoords pos(x, y, z);
-					DrawSinglePixelNonClear(pos, (u16)z, 1.0f, prim_color);
+					drawPixel(x, y, (u16)z, 1.0f, prim_color, pixelID);
 					s += ds;
 				}
 				t += dt;
@@ -204,7 +207,7 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 				u16 *pixel = fb.Get16Ptr(pos0.x, y, gstate.FrameBufStride());
 				for (int x = pos0.x; x < pos1.x; x++) {
 					Vec4<int> prim_color = v1.color0;
-					DrawSinglePixel5551(pixel, prim_color.ToRGBA());
+					DrawSinglePixel5551(pixel, prim_color.ToRGBA(), pixelID);
 					pixel++;
 				}
 			}
@@ -212,8 +215,7 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 			for (int y = pos0.y; y < pos1.y; y++) {
 				for (int x = pos0.x; x < pos1.x; x++) {
 					Vec4<int> prim_color = v1.color0;
-					DrawingCoords pos(x, y, z);
-					DrawSinglePixelNonClear(pos, (u16)z, fog, prim_color);
+					drawPixel(x, y, (u16)z, fog, prim_color, pixelID);
 				}
 			}
 		}
@@ -237,7 +239,7 @@ bool RectangleFastPath(const VertexData &v0, const VertexData &v1) {
 	bool orient_check = xdiff >= 0 && ydiff >= 0;
 	bool state_check = !gstate.isModeClear();  // TODO: Add support for clear modes in Rasterizer::DrawSprite.
 	if ((coord_check || !gstate.isTextureMapEnabled()) && orient_check && state_check) {
-		Rasterizer::DrawSprite(v0, v1);
+		g_binManager.AddSprite(v0, v1);
 		return true;
 	}
 
@@ -256,6 +258,8 @@ bool RectangleFastPath(const VertexData &v0, const VertexData &v1) {
 			if (g_needsClearAfterDialog) {
 				g_needsClearAfterDialog = false;
 				// Afterwards, we also need to clear the actual destination. Can do a fast rectfill.
+				// This pokes gstate, so it can't wait in a bin.
+				g_binManager.Flush();
 				gstate.textureMapEnable &= ~1;
 				VertexData newV1 = v1;
 				newV1.color0 = Vec4<int>(0, 0, 0, 255);
@@ -13,6 +13,11 @@
 // the JIT will then be able to eliminate UV interpolation.
 
 namespace Rasterizer {
+	struct TileRect;
+
+	// Only 1:1 sprites without clear mode, see RectangleFastPath.
+	void DrawSprite(const VertexData &v0, const VertexData &v1, const TileRect *tile = nullptr);
+
 	// Returns true if the normal path should be skipped.
 	bool RectangleFastPath(const VertexData &v0, const VertexData &v1);
 
@@ -19,6 +19,7 @@
 #include <unordered_map>
 #include <mutex>
 #include "Common/Data/Convert/ColorConv.h"
+#include "Common/Math/CrossSIMD.h"
 #include "Core/Reporting.h"
 #include "GPU/Common/TextureDecoder.h"
 #include "GPU/GPUState.h"
@@ -66,6 +67,10 @@ NearestFunc GetNearestFunc() {
 		return jitted;
 	}
 
+	NearestFunc portable = GetNearestPortableFunc(id);
+	if (portable) {
+		return portable;
+	}
 	return &SampleNearest;
 }
 
@@ -77,6 +82,18 @@ LinearFunc GetLinearFunc() {
 		return jitted;
 	}
 
+	LinearFunc portable = GetLinearPortableFunc(id);
+	if (portable) {
+		return portable;
+	}
+	return &SampleLinear;
+}
+
+NearestFunc GetNearestGenericFunc() {
+	return &SampleNearest;
+}
+
+LinearFunc GetLinearGenericFunc() {
 	return &SampleLinear;
 }
 
@@ -426,4 +443,203 @@ static u32 SampleLinear(int u[4], int v[4], int frac_u, int frac_v, const u8 *tp
 	return ((t * (0x100 - frac_v) + b * frac_v) / (256 * 256)).ToRGBA();
 }
 
+// The portable path, for when there's no jit.  These are specialized on format and swizzle,
+// and written once for u32 (one texel) and Vec4U32 (the four texels of a bilinear sample.)
+// They must give exactly the same results as the functions above.
+
+template <int bits>
+struct TexelBits {
+	// log2 of the texel size in bytes (-1 for 4-bit), and of texels per 32-bit swizzle tile row.
+	static const int byteShift = bits == 4 ? -1 : (bits == 8 ? 0 : (bits == 16 ? 1 : 2));
+	static const int tileTexelShift = 2 - byteShift;
+};
+
+template <int bits, bool swizzle, typename T>
+static inline T TexelOffset(const T &u, const T &v, u32 bufw) {
+	const int byteShift = TexelBits<bits>::byteShift;
+	if (!swizzle) {
+		const T uBytes = byteShift < 0 ? (u >> 1) : (u << byteShift);
+		return v * T((bufw * bits) >> 3) + uBytes;
+	}
+
+	// 16 byte by 8 row blocks, see GetPixelDataOffset().
+	const int tileTexelShift = TexelBits<bits>::tileTexelShift;
+	const T tileU = u >> tileTexelShift;
+	const T tileIndex = ((v & T(7)) << 2) + (v >> 3) * T(((bufw * bits) / 32) * 8) + (tileU & T(3)) + ((tileU >> 2) << 5);
+	const T inTile = u & T((1 << tileTexelShift) - 1);
+	return (tileIndex << 2) + (byteShift < 0 ? (inTile >> 1) : (inTile << byteShift));
+}
+
+template <int bits>
+static inline u32 ReadTexel(const u8 *src, u32 offset) {
+	switch (bits) {
+	case 32: return *(const u32 *)(src + offset);
+	case 16: return *(const u16 *)(src + offset);
+	default: return src[offset];
+	}
+}
+
+template <int bits>
+static inline u32 GatherTexels(const u8 *src, u32 offset) {
+	return ReadTexel<bits>(src, offset);
+}
+
+template <int bits>
+static inline Vec4U32 GatherTexels(const u8 *src, const Vec4U32 &offsets) {
+	alignas(16) u32 off[4];
+	alignas(16) u32 res[4];
+	offsets.Store(off);
+	for (int i = 0; i < 4; ++i)
+		res[i] = ReadTexel<bits>(src, off[i]);
+	return Vec4U32::Load(res);
+}
+
+template <typename T>
+static inline T Decode5650(const T &c) {
+	const T r = c & T(0x1F);
+	const T g = (c >> 5) & T(0x3F);
+	const T b = (c >> 11) & T(0x1F);
+	const T r8 = (r << 3) | (r >> 2);
+	const T g8 = (g << 2) | (g >> 4);
+	const T b8 = (b << 3) | (b >> 2);
+	return r8 | (g8 << 8) | (b8 << 16) | T(0xFF000000);
+}
+
+template <typename T>
+static inline T Decode5551(const T &c) {
+	const T r = c & T(0x1F);
+	const T g = (c >> 5) & T(0x1F);
+	const T b = (c >> 10) & T(0x1F);
+	// All ones when the alpha bit is set.
+	const T a = T(0) - ((c >> 15) & T(1));
+	const T r8 = (r << 3) | (r >> 2);
+	const T g8 = (g << 3) | (g >> 2);
+	const T b8 = (b << 3) | (b >> 2);
+	return r8 | (g8 << 8) | (b8 << 16) | (a & T(0xFF000000));
+}
+
+template <typename T>
+static inline T Decode4444(const T &c) {
+	const T spread = (c & T(0xF)) | ((c & T(0xF0)) << 4) | ((c & T(0xF00)) << 8) | ((c & T(0xF000)) << 12);
+	return spread | (spread << 4);
+}
+
+template <typename T>
+static inline T LookupClut(const T &index, int level, bool clut4) {
+	const GEPaletteFormat clutfmt = gstate.getClutPaletteFormat();
+	const u32 startMask = clutfmt == GE_CMODE_32BIT_ABGR8888 ? 0xFF : 0x1FF;
+	// Only CLUT4 uses separate mipmap palettes.
+	const u32 levelOffset = clut4 && !gstate.isClutSharedForMipmaps() ? level * 16 : 0;
+	const T entry = (((index >> gstate.getClutIndexShift()) & T(gstate.getClutIndexMask())) | T(gstate.getClutIndexStartPos() & startMask)) + T(levelOffset);
+
+	const u8 *clutBytes = (const u8 *)clut;
+	switch (clutfmt) {
+	case GE_CMODE_16BIT_BGR5650:
+		return Decode5650(GatherTexels<16>(clutBytes, entry << 1));
+	case GE_CMODE_16BIT_ABGR5551:
+		return Decode5551(GatherTexels<16>(clutBytes, entry << 1));
+	case GE_CMODE_16BIT_ABGR4444:
+		return Decode4444(GatherTexels<16>(clutBytes, entry << 1));
+	case GE_CMODE_32BIT_ABGR8888:
+	default:
+		return GatherTexels<32>(clutBytes, entry << 2);
+	}
+}
+
+template <GETextureFormat texfmt, bool swizzle, typename T>
+static inline T FetchTexels(const T &u, const T &v, const u8 *tptr, u32 bufw, int level) {
+	switch (texfmt) {
+	case GE_TFMT_5650:
+		return Decode5650(GatherTexels<16>(tptr, TexelOffset<16, swizzle>(u, v, bufw)));
+	case GE_TFMT_5551:
+		return Decode5551(GatherTexels<16>(tptr, TexelOffset<16, swizzle>(u, v, bufw)));
+	case GE_TFMT_4444:
+		return Decode4444(GatherTexels<16>(tptr, TexelOffset<16, swizzle>(u, v, bufw)));
+	case GE_TFMT_8888:
+		return GatherTexels<32>(tptr, TexelOffset<32, swizzle>(u, v, bufw));
+	case GE_TFMT_CLUT32:
+		return LookupClut(GatherTexels<32>(tptr, TexelOffset<32, swizzle>(u, v, bufw)), 0, false);
+	case GE_TFMT_CLUT16:
+		return LookupClut(GatherTexels<16>(tptr, TexelOffset<16, swizzle>(u, v, bufw)), 0, false);
+	case GE_TFMT_CLUT8:
+		return LookupClut(GatherTexels<8>(tptr, TexelOffset<8, swizzle>(u, v, bufw)), 0, false);
+	case GE_TFMT_CLUT4:
+	default:
+	{
+		const T byte = GatherTexels<8>(tptr, TexelOffset<4, swizzle>(u, v, bufw));
+		// Pick the high nibble for odd u, without a per lane shift.
+		const T lo = byte & T(0xF);
+		const T hi = byte >> 4;
+		const T odd = T(0) - (u & T(1));
+		return LookupClut(lo + ((hi - lo) & odd), level, true);
+	}
+	}
+}
+
+template <GETextureFormat texfmt, bool swizzle>
+static u32 SampleNearestPortable(int u, int v, const u8 *tptr, int bufw, int level) {
+	if (!tptr)
+		return 0;
+	return FetchTexels<texfmt, swizzle>((u32)u, (u32)v, tptr, (u32)bufw, level);
+}
+
+template <GETextureFormat texfmt, bool swizzle>
+static u32 SampleLinearPortable(int u[4], int v[4], int frac_u, int frac_v, const u8 *tptr, int bufw, int level) {
+	if (!tptr)
+		return 0;
+	const Vec4U32 c = FetchTexels<texfmt, swizzle>(Vec4U32::Load(u), Vec4U32::Load(v), tptr, (u32)bufw, level);
+
+	// Weights for tl, tr, bl, br.  They add up to 0x10000, so no channel sum can overflow.
+	const u32 inv_u = 0x100 - frac_u;
+	const u32 inv_v = 0x100 - frac_v;
+	alignas(16) const u32 w[4] = { inv_u * inv_v, frac_u * inv_v, inv_u * frac_v, (u32)(frac_u * frac_v) };
+	const Vec4U32 weights = Vec4U32::Load(w);
+	const Vec4U32 mask(0xFF);
+	const Vec4U32 r = (c & mask) * weights;
+	const Vec4U32 g = ((c >> 8) & mask) * weights;
+	const Vec4U32 b = ((c >> 16) & mask) * weights;
+	const Vec4U32 a = (c >> 24) * weights;
+
+	alignas(16) u32 sums[4];
+	(Vec4U32::HorizontalSums(r, g, b, a) >> 16).Store(sums);
+	return sums[0] | (sums[1] << 8) | (sums[2] << 16) | (sums[3] << 24);
+}
+
+#define PORTABLE_SAMPLER_FUNCS(func, fmt) { &func<fmt, false>, &func<fmt, true> }
+
+NearestFunc GetNearestPortableFunc(const SamplerID &id) {
+	static const NearestFunc funcs[8][2] = {
+		PORTABLE_SAMPLER_FUNCS(SampleNearestPortable, GE_TFMT_5650),
+		PORTABLE_SAMPLER_FUNCS(SampleNearestPortable, GE_TFMT_5551),
+		PORTABLE_SAMPLER_FUNCS(SampleNearestPortable, GE_TFMT_4444),
+		PORTABLE_SAMPLER_FUNCS(SampleNearestPortable, GE_TFMT_8888),
+		PORTABLE_SAMPLER_FUNCS(SampleNearestPortable, GE_TFMT_CLUT4),
+		PORTABLE_SAMPLER_FUNCS(SampleNearestPortable, GE_TFMT_CLUT8),
+		PORTABLE_SAMPLER_FUNCS(SampleNearestPortable, GE_TFMT_CLUT16),
+		PORTABLE_SAMPLER_FUNCS(SampleNearestPortable, GE_TFMT_CLUT32),
+	};
+	// DXT decodes whole blocks, and stays on the generic path.
+	if (id.texfmt >= 8)
+		return nullptr;
+	return funcs[id.texfmt][id.swizzle ? 1 : 0];
+}
+
+LinearFunc GetLinearPortableFunc(const SamplerID &id) {
+	static const LinearFunc funcs[8][2] = {
+		PORTABLE_SAMPLER_FUNCS(SampleLinearPortable, GE_TFMT_5650),
+		PORTABLE_SAMPLER_FUNCS(SampleLinearPortable, GE_TFMT_5551),
+		PORTABLE_SAMPLER_FUNCS(SampleLinearPortable, GE_TFMT_4444),
+		PORTABLE_SAMPLER_FUNCS(SampleLinearPortable, GE_TFMT_8888),
+		PORTABLE_SAMPLER_FUNCS(SampleLinearPortable, GE_TFMT_CLUT4),
+		PORTABLE_SAMPLER_FUNCS(SampleLinearPortable, GE_TFMT_CLUT8),
+		PORTABLE_SAMPLER_FUNCS(SampleLinearPortable, GE_TFMT_CLUT16),
+		PORTABLE_SAMPLER_FUNCS(SampleLinearPortable, GE_TFMT_CLUT32),
+	};
+	if (id.texfmt >= 8)
+		return nullptr;
+	return funcs[id.texfmt][id.swizzle ? 1 : 0];
+}
+
+#undef PORTABLE_SAMPLER_FUNCS
+
 };
@@ -19,6 +19,7 @@
 
 #include "ppsspp_config.h"
 
+#include <string>
 #include <unordered_map>
 #if PPSSPP_ARCH(ARM)
 #include "Common/ArmEmitter.h"
@@ -77,6 +78,13 @@ NearestFunc GetNearestFunc();
 typedef u32 (*LinearFunc)(int u[4], int v[4], int frac_u, int frac_v, const u8 *tptr, int bufw, int level);
 LinearFunc GetLinearFunc();
 
+// Used when there's no jit.  DXT formats return nullptr, and use the generic functions.
+NearestFunc GetNearestPortableFunc(const SamplerID &id);
+LinearFunc GetLinearPortableFunc(const SamplerID &id);
+// The reference implementation, which handles every format.
+NearestFunc GetNearestGenericFunc();
+LinearFunc GetLinearGenericFunc();
+
 struct Funcs {
 	NearestFunc nearest;
 	LinearFunc linear;
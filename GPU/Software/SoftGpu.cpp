@@ -36,6 +36,7 @@
 #include "Common/Profiler/Profiler.h"
 #include "Common/GPU/thin3d.h"
 
+#include "GPU/Software/BinManager.h"
 #include "GPU/Software/Rasterizer.h"
 #include "GPU/Software/Sampler.h"
 #include "GPU/Software/SoftGpu.h"
@@ -67,6 +68,8 @@ SoftGPU::SoftGPU(GraphicsContext *gfxCtx, Draw::DrawContext *draw)
 	displayFormat_ = GE_FORMAT_8888;
 
 	Sampler::Init();
+	g_binManager.SetEnabled(g_Config.bSoftwareRendererBinning);
+	Rasterizer::DirtyPixelState();
 	drawEngine_ = new SoftwareDrawEngine();
 	drawEngine_->Init();
 	drawEngineCommon_ = drawEngine_;
@@ -106,6 +109,8 @@ SoftGPU::~SoftGPU() {
 		delete presentation_;
 	}
 
+	// Draws anything left over.
+	g_binManager.SetEnabled(false);
 	Sampler::Shutdown();
 }
 
@@ -269,6 +274,8 @@ void SoftGPU::CopyToCurrentFboFromDisplayRam(int srcwidth, int srcheight) {
 }
 
 void SoftGPU::CopyDisplayToOutput(bool reallyDirty) {
+	g_binManager.Flush();
+	g_binManager.SetEnabled(g_Config.bSoftwareRendererBinning);
 	// The display always shows 480x272.
 	CopyToCurrentFboFromDisplayRam(FB_WIDTH, FB_HEIGHT);
 	framebufferDirty_ = false;
@@ -297,6 +304,7 @@ void SoftGPU::FastRunLoop(DisplayList &list) {
 		u32 cmd = op >> 24;
 
 		u32 diff = op ^ gstate.cmdmem[cmd];
+		PreExecuteOp(op, diff);
 		gstate.cmdmem[cmd] = op;
 		ExecuteOp(op, diff);
 
@@ -304,6 +312,84 @@ void SoftGPU::FastRunLoop(DisplayList &list) {
 	}
 }
 
+// Binned primitives are drawn with whatever gstate is current at flush, so commands
+// that can affect rasterization end the batch.  These only affect vertex fetch and transform.
+static bool CmdKeepsBinnedState(u32 cmd) {
+	switch (cmd) {
+	case GE_CMD_NOP:
+	case GE_CMD_BASE:
+	case GE_CMD_VADDR:
+	case GE_CMD_IADDR:
+	case GE_CMD_OFFSETADDR:
+	case GE_CMD_ORIGIN:
+	case GE_CMD_JUMP:
+	case GE_CMD_BJUMP:
+	case GE_CMD_CALL:
+	case GE_CMD_RET:
+	case GE_CMD_PRIM:
+	case GE_CMD_BEZIER:
+	case GE_CMD_SPLINE:
+	case GE_CMD_BOUNDINGBOX:
+	case GE_CMD_BONEMATRIXNUMBER:
+	case GE_CMD_BONEMATRIXDATA:
+	case GE_CMD_WORLDMATRIXNUMBER:
+	case GE_CMD_WORLDMATRIXDATA:
+	case GE_CMD_VIEWMATRIXNUMBER:
+	case GE_CMD_VIEWMATRIXDATA:
+	case GE_CMD_PROJMATRIXNUMBER:
+	case GE_CMD_PROJMATRIXDATA:
+	case GE_CMD_TGENMATRIXNUMBER:
+	case GE_CMD_TGENMATRIXDATA:
+		return true;
+	default:
+		return cmd >= GE_CMD_MORPHWEIGHT0 && cmd <= GE_CMD_MORPHWEIGHT7;
+	}
+}
+
+void SoftGPU::PreExecuteOp(u32 op, u32 diff) {
+	u32 cmd = op >> 24;
+	bool stateChange = diff != 0 && !CmdKeepsBinnedState(cmd);
+
+	if (g_binManager.HasPendingWork()) {
+		switch (cmd) {
+		case GE_CMD_LOADCLUT:
+		case GE_CMD_TRANSFERSTART:
+		case GE_CMD_TEXFLUSH:
+		case GE_CMD_TEXSYNC:
+		case GE_CMD_END:
+		case GE_CMD_SIGNAL:
+		case GE_CMD_FINISH:
+			// These read or write memory (or let the CPU do so) even without a change.
+			g_binManager.Flush();
+			break;
+		default:
+			if (stateChange)
+				g_binManager.Flush();
+			break;
+		}
+	}
+
+	if (stateChange)
+		Rasterizer::DirtyPixelState();
+}
+
+void SoftGPU::DoState(PointerWrap &p) {
+	GPUCommon::DoState(p);
+	// The whole gstate may have changed.
+	Rasterizer::DirtyPixelState();
+}
+
+void SoftGPU::ReapplyGfxState() {
+	// This runs after gstate was restored, without going through PreExecuteOp.
+	GPUCommon::ReapplyGfxState();
+	Rasterizer::DirtyPixelState();
+}
+
+void SoftGPU::FinishDeferred() {
+	// The CPU may look at the framebuffer once the list stops.
+	g_binManager.Flush();
+}
+
 void SoftGPU::ExecuteOp(u32 op, u32 diff) {
 	u32 cmd = op >> 24;
 	u32 data = op & 0xFFFFFF;
@@ -868,7 +954,8 @@ void SoftGPU::GetStats(char *buffer, size_t bufsize) {
 
 void SoftGPU::InvalidateCache(u32 addr, int size, GPUInvalidationType type)
 {
-	// Nothing to invalidate.
+	// Nothing to invalidate, but binned draws may still read or write this memory.
+	g_binManager.Flush();
 }
 
 void SoftGPU::NotifyVideoUpload(u32 addr, int size, int width, int format)
@@ -926,6 +1013,7 @@ bool SoftGPU::FramebufferDirty() {
 }
 
 bool SoftGPU::GetCurrentFramebuffer(GPUDebugBuffer &buffer, GPUDebugFramebufferType type, int maxRes) {
+	g_binManager.Flush();
 	int x1 = gstate.getRegionX1();
 	int y1 = gstate.getRegionY1();
 	int x2 = gstate.getRegionX2() + 1;
@@ -962,6 +1050,7 @@ bool SoftGPU::GetOutputFramebuffer(GPUDebugBuffer &buffer) {
 
 bool SoftGPU::GetCurrentDepthbuffer(GPUDebugBuffer &buffer)
 {
+	g_binManager.Flush();
 	const int w = gstate.getRegionX2() - gstate.getRegionX1() + 1;
 	const int h = gstate.getRegionY2() - gstate.getRegionY1() + 1;
 	buffer.Allocate(w, h, GPU_DBG_FORMAT_16BIT);
@@ -979,6 +1068,7 @@ bool SoftGPU::GetCurrentDepthbuffer(GPUDebugBuffer &buffer)
 
 bool SoftGPU::GetCurrentStencilbuffer(GPUDebugBuffer &buffer)
 {
+	g_binManager.Flush();
 	return Rasterizer::GetCurrentStencilbuffer(buffer);
 }
 
@@ -60,8 +60,12 @@ class SoftGPU : public GPUCommon {
 
 	void CheckGPUFeatures() override {}
 	void InitClear() override {}
+	void PreExecuteOp(u32 op, u32 diff) override;
 	void ExecuteOp(u32 op, u32 diff) override;
 
+	void DoState(PointerWrap &p) override;
+	void ReapplyGfxState() override;
+
 	void SetDisplayFramebuffer(u32 framebuf, u32 stride, GEBufferFormat format) override;
 	void CopyDisplayToOutput(bool reallyDirty) override;
 	void GetStats(char *buffer, size_t bufsize) override;
@@ -101,6 +105,7 @@ class SoftGPU : public GPUCommon {
 
 protected:
 	void FastRunLoop(DisplayList &list) override;
+	void FinishDeferred() override;
 	void CopyToCurrentFboFromDisplayRam(int srcwidth, int srcheight);
 	void ConvertTextureDescFrom16(Draw::TextureDesc &desc, int srcwidth, int srcheight, u8 *overrideData = nullptr);
 
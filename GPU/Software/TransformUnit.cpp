@@ -155,138 +155,282 @@ ScreenCoords TransformUnit::DrawingToScreen(const DrawingCoords& coords)
 	return ret;
 }
 
-VertexData TransformUnit::ReadVertex(VertexReader& vreader)
-{
-	VertexData vertex;
-
-	float pos[3];
-	// VertexDecoder normally scales z, but we want it unscaled.
-	vreader.ReadPosThroughZ16(pos);
+// Vertices are transformed this many at a time, as arrays per component so the loops
+// below can use SIMD.
+enum { TRANSFORM_BATCH = 64 };
+
+struct TransformBatch {
+	float x[TRANSFORM_BATCH];
+	float y[TRANSFORM_BATCH];
+	float z[TRANSFORM_BATCH];
+	float w[TRANSFORM_BATCH];
+	float nx[TRANSFORM_BATCH];
+	float ny[TRANSFORM_BATCH];
+	float nz[TRANSFORM_BATCH];
+	float weights[8][TRANSFORM_BATCH];
+};
 
-	if (!gstate.isModeClear() && gstate.isTextureMapEnabled() && vreader.hasUV()) {
-		float uv[2];
-		vreader.ReadUV(uv);
-		vertex.texturecoords = Vec2<float>(uv[0], uv[1]);
+// out = m * in + m[9..11], with one of the 4x3 matrices from gstate.  Same operation order
+// as Mat3x3, so the result matches the per vertex functions above.  May be done in place.
+static inline void TransformBatch43(const float m[12], bool translate, const float *ix, const float *iy, const float *iz, float *ox, float *oy, float *oz, int count) {
+	const float tx = translate ? m[9] : 0.0f;
+	const float ty = translate ? m[10] : 0.0f;
+	const float tz = translate ? m[11] : 0.0f;
+	for (int i = 0; i < count; ++i) {
+		float x = m[0] * ix[i] + m[3] * iy[i] + m[6] * iz[i];
+		float y = m[1] * ix[i] + m[4] * iy[i] + m[7] * iz[i];
+		float z = m[2] * ix[i] + m[5] * iy[i] + m[8] * iz[i];
+		ox[i] = translate ? x + tx : x;
+		oy[i] = translate ? y + ty : y;
+		oz[i] = translate ? z + tz : z;
 	}
+}
 
-	if (vreader.hasNormal()) {
-		float normal[3];
-		vreader.ReadNrm(normal);
-		vertex.normal = Vec3<float>(normal[0], normal[1], normal[2]);
-
-		if (gstate.areNormalsReversed())
-			vertex.normal = -vertex.normal;
+static void SkinBatch(TransformBatch &b, int numBones, bool hasNormal, int count) {
+	float px[TRANSFORM_BATCH]{}, py[TRANSFORM_BATCH]{}, pz[TRANSFORM_BATCH]{};
+	float nx[TRANSFORM_BATCH]{}, ny[TRANSFORM_BATCH]{}, nz[TRANSFORM_BATCH]{};
+	for (int bone = 0; bone < numBones; ++bone) {
+		const float *m = &gstate.boneMatrix[12 * bone];
+		const float *w = b.weights[bone];
+		for (int i = 0; i < count; ++i) {
+			px[i] += (m[0] * b.x[i] + m[3] * b.y[i] + m[6] * b.z[i] + m[9]) * w[i];
+			py[i] += (m[1] * b.x[i] + m[4] * b.y[i] + m[7] * b.z[i] + m[10]) * w[i];
+			pz[i] += (m[2] * b.x[i] + m[5] * b.y[i] + m[8] * b.z[i] + m[11]) * w[i];
+		}
+		if (hasNormal) {
+			for (int i = 0; i < count; ++i) {
+				nx[i] += (m[0] * b.nx[i] + m[3] * b.ny[i] + m[6] * b.nz[i]) * w[i];
+				ny[i] += (m[1] * b.nx[i] + m[4] * b.ny[i] + m[7] * b.nz[i]) * w[i];
+				nz[i] += (m[2] * b.nx[i] + m[5] * b.ny[i] + m[8] * b.nz[i]) * w[i];
+			}
+		}
 	}
 
-	if (vertTypeIsSkinningEnabled(gstate.vertType) && !gstate.isModeThrough()) {
-		float W[8] = { 1.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
-		vreader.ReadWeights(W);
+	memcpy(b.x, px, sizeof(float) * count);
+	memcpy(b.y, py, sizeof(float) * count);
+	memcpy(b.z, pz, sizeof(float) * count);
+	if (hasNormal) {
+		memcpy(b.nx, nx, sizeof(float) * count);
+		memcpy(b.ny, ny, sizeof(float) * count);
+		memcpy(b.nz, nz, sizeof(float) * count);
+	}
+}
 
-		Vec3<float> tmppos(0.f, 0.f, 0.f);
-		Vec3<float> tmpnrm(0.f, 0.f, 0.f);
+// The batch version of ClipToScreenInternal().
+static void ClipToScreenBatch(const TransformBatch &b, VertexData *vertices, u8 *outside, int count) {
+	const float xScale = gstate.getViewportXScale();
+	const float xCenter = gstate.getViewportXCenter();
+	const float yScale = gstate.getViewportYScale();
+	const float yCenter = gstate.getViewportYCenter();
+	const float zScale = gstate.getViewportZScale();
+	const float zCenter = gstate.getViewportZCenter();
+	const bool depthClamp = gstate.isDepthClampEnabled();
 
-		for (int i = 0; i < vertTypeGetNumBoneWeights(gstate.vertType); ++i) {
-			Mat3x3<float> bone(&gstate.boneMatrix[12*i]);
-			tmppos += (bone * ModelCoords(pos[0], pos[1], pos[2]) + Vec3<float>(gstate.boneMatrix[12*i+9], gstate.boneMatrix[12*i+10], gstate.boneMatrix[12*i+11])) * W[i];
-			if (vreader.hasNormal())
-				tmpnrm += (bone * vertex.normal) * W[i];
-		}
+	const float SCREEN_BOUND = 4095.0f + (15.5f / 16.0f);
+	const float DEPTH_BOUND = 65535.5f;
 
-		pos[0] = tmppos.x;
-		pos[1] = tmppos.y;
-		pos[2] = tmppos.z;
-		if (vreader.hasNormal())
-			vertex.normal = tmpnrm;
+	float sx[TRANSFORM_BATCH], sy[TRANSFORM_BATCH], sz[TRANSFORM_BATCH];
+	for (int i = 0; i < count; ++i) {
+		sx[i] = b.x[i] * xScale / b.w[i] + xCenter;
+		sy[i] = b.y[i] * yScale / b.w[i] + yCenter;
+		sz[i] = b.z[i] * zScale / b.w[i] + zCenter;
 	}
 
-	if (vreader.hasColor0()) {
-		float col[4];
-		vreader.ReadColor0(col);
-		vertex.color0 = Vec4<int>(col[0]*255, col[1]*255, col[2]*255, col[3]*255);
+	if (depthClamp) {
+		for (int i = 0; i < count; ++i) {
+			bool clamped = sz[i] < 0.f || sz[i] > 65535.0f;
+			outside[i] = !clamped && (sx[i] >= SCREEN_BOUND || sy[i] >= SCREEN_BOUND || sx[i] < 0 || sy[i] < 0);
+			sz[i] = std::min(std::max(sz[i], 0.0f), 65535.0f);
+		}
 	} else {
-		vertex.color0 = Vec4<int>(gstate.getMaterialAmbientR(), gstate.getMaterialAmbientG(), gstate.getMaterialAmbientB(), gstate.getMaterialAmbientA());
+		for (int i = 0; i < count; ++i)
+			outside[i] = sx[i] > SCREEN_BOUND || sy[i] >= SCREEN_BOUND || sx[i] < 0 || sy[i] < 0 || sz[i] < 0 || sz[i] >= DEPTH_BOUND;
 	}
 
-	if (vreader.hasColor1()) {
-		float col[3];
-		vreader.ReadColor1(col);
-		vertex.color1 = Vec3<int>(col[0]*255, col[1]*255, col[2]*255);
-	} else {
-		vertex.color1 = Vec3<int>(0, 0, 0);
+	for (int i = 0; i < count; ++i) {
+		vertices[i].clippos = ClipCoords(b.x[i], b.y[i], b.z[i], b.w[i]);
+		vertices[i].screenpos = ScreenCoords(sx[i] * 16.0f + 0.375f, sy[i] * 16.0f + 0.375f, sz[i]);
 	}
+}
 
-	if (!gstate.isModeThrough()) {
-		vertex.modelpos = ModelCoords(pos[0], pos[1], pos[2]);
-		vertex.worldpos = WorldCoords(TransformUnit::ModelToWorld(vertex.modelpos));
-		ModelCoords viewpos = TransformUnit::WorldToView(vertex.worldpos);
-		vertex.clippos = ClipCoords(TransformUnit::ViewToClip(viewpos));
-		if (gstate.isFogEnabled()) {
-			float fog_end = getFloat24(gstate.fog1);
-			float fog_slope = getFloat24(gstate.fog2);
-			// Same fixup as in ShaderManagerGLES.cpp
-			if (my_isnanorinf(fog_end)) {
-				// Not really sure what a sensible value might be, but let's try 64k.
-				fog_end = std::signbit(fog_end) ? -65535.0f : 65535.0f;
+void TransformUnit::ReadVertices(VertexReader &vreader, int count, VertexData *vertices, u8 *outside) {
+	const bool throughMode = gstate.isModeThrough();
+	const bool readUV = !gstate.isModeClear() && gstate.isTextureMapEnabled() && vreader.hasUV();
+	const bool hasNormal = vreader.hasNormal();
+	const bool reverseNormals = gstate.areNormalsReversed();
+	const bool skinning = vertTypeIsSkinningEnabled(gstate.vertType) && !throughMode;
+	const int numBones = vertTypeGetNumBoneWeights(gstate.vertType);
+	const Vec4<int> materialAmbient(gstate.getMaterialAmbientR(), gstate.getMaterialAmbientG(), gstate.getMaterialAmbientB(), gstate.getMaterialAmbientA());
+
+	float fog_end = getFloat24(gstate.fog1);
+	float fog_slope = getFloat24(gstate.fog2);
+	// Same fixup as in ShaderManagerGLES.cpp
+	if (my_isnanorinf(fog_end)) {
+		// Not really sure what a sensible value might be, but let's try 64k.
+		fog_end = std::signbit(fog_end) ? -65535.0f : 65535.0f;
+	}
+	if (my_isnanorinf(fog_slope)) {
+		fog_slope = std::signbit(fog_slope) ? -65535.0f : 65535.0f;
+	}
+	const bool applyFog = gstate.isFogEnabled();
+
+	TransformBatch b;
+	for (int start = 0; start < count; start += TRANSFORM_BATCH) {
+		const int n = std::min(count - start, (int)TRANSFORM_BATCH);
+		VertexData *batch = vertices + start;
+
+		// Decoding can't be vectorized much, the format varies too much.
+		for (int i = 0; i < n; ++i) {
+			VertexData &vertex = batch[i];
+			vreader.Goto(start + i);
+
+			float pos[3];
+			// VertexDecoder normally scales z, but we want it unscaled.
+			vreader.ReadPosThroughZ16(pos);
+			b.x[i] = pos[0];
+			b.y[i] = pos[1];
+			b.z[i] = pos[2];
+
+			if (readUV) {
+				float uv[2];
+				vreader.ReadUV(uv);
+				vertex.texturecoords = Vec2<float>(uv[0], uv[1]);
+			} else {
+				vertex.texturecoords = Vec2<float>(0.0f, 0.0f);
 			}
-			if (my_isnanorinf(fog_slope)) {
-				fog_slope = std::signbit(fog_slope) ? -65535.0f : 65535.0f;
+
+			if (hasNormal) {
+				float normal[3];
+				vreader.ReadNrm(normal);
+				vertex.normal = Vec3<float>(normal[0], normal[1], normal[2]);
+				if (reverseNormals)
+					vertex.normal = -vertex.normal;
+				b.nx[i] = vertex.normal.x;
+				b.ny[i] = vertex.normal.y;
+				b.nz[i] = vertex.normal.z;
+			} else {
+				vertex.normal = Vec3<float>(0.0f, 0.0f, 0.0f);
+			}
+
+			if (skinning) {
+				float W[8] = { 1.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+				vreader.ReadWeights(W);
+				for (int j = 0; j < numBones; ++j)
+					b.weights[j][i] = W[j];
+			}
+
+			if (vreader.hasColor0()) {
+				float col[4];
+				vreader.ReadColor0(col);
+				vertex.color0 = Vec4<int>(col[0]*255, col[1]*255, col[2]*255, col[3]*255);
+			} else {
+				vertex.color0 = materialAmbient;
+			}
+
+			if (vreader.hasColor1()) {
+				float col[3];
+				vreader.ReadColor1(col);
+				vertex.color1 = Vec3<int>(col[0]*255, col[1]*255, col[2]*255);
+			} else {
+				vertex.color1 = Vec3<int>(0, 0, 0);
 			}
-			vertex.fogdepth = (viewpos.z + fog_end) * fog_slope;
-		} else {
-			vertex.fogdepth = 1.0f;
 		}
-		vertex.screenpos = ClipToScreenInternal(vertex.clippos, &outside_range_flag);
 
-		if (vreader.hasNormal()) {
-			vertex.worldnormal = TransformUnit::ModelToWorldNormal(vertex.normal);
-			vertex.worldnormal /= vertex.worldnormal.Length();
+		if (throughMode) {
+			for (int i = 0; i < n; ++i) {
+				VertexData &vertex = batch[i];
+				vertex.screenpos.x = (int)(b.x[i] * 16) + gstate.getOffsetX16();
+				vertex.screenpos.y = (int)(b.y[i] * 16) + gstate.getOffsetY16();
+				vertex.screenpos.z = b.z[i];
+				vertex.clippos.w = 1.f;
+				vertex.fogdepth = 1.f;
+				outside[start + i] = 0;
+			}
+			continue;
+		}
+
+		if (skinning) {
+			SkinBatch(b, numBones, hasNormal, n);
+			if (hasNormal) {
+				for (int i = 0; i < n; ++i)
+					batch[i].normal = Vec3<float>(b.nx[i], b.ny[i], b.nz[i]);
+			}
+		}
+
+		for (int i = 0; i < n; ++i)
+			batch[i].modelpos = ModelCoords(b.x[i], b.y[i], b.z[i]);
+
+		// Model to world, then world to view.
+		TransformBatch43(gstate.worldMatrix, true, b.x, b.y, b.z, b.x, b.y, b.z, n);
+		for (int i = 0; i < n; ++i)
+			batch[i].worldpos = WorldCoords(b.x[i], b.y[i], b.z[i]);
+		TransformBatch43(gstate.viewMatrix, true, b.x, b.y, b.z, b.x, b.y, b.z, n);
+
+		for (int i = 0; i < n; ++i)
+			batch[i].fogdepth = applyFog ? (b.z[i] + fog_end) * fog_slope : 1.0f;
+
+		// View to clip, with w = 1.
+		const float *p = gstate.projMatrix;
+		for (int i = 0; i < n; ++i) {
+			const float x = b.x[i], y = b.y[i], z = b.z[i];
+			b.x[i] = p[0] * x + p[4] * y + p[8] * z + p[12];
+			b.y[i] = p[1] * x + p[5] * y + p[9] * z + p[13];
+			b.z[i] = p[2] * x + p[6] * y + p[10] * z + p[14];
+			b.w[i] = p[3] * x + p[7] * y + p[11] * z + p[15];
+		}
+		ClipToScreenBatch(b, batch, outside + start, n);
+
+		if (hasNormal) {
+			TransformBatch43(gstate.worldMatrix, false, b.nx, b.ny, b.nz, b.nx, b.ny, b.nz, n);
+			for (int i = 0; i < n; ++i) {
+				batch[i].worldnormal = WorldCoords(b.nx[i], b.ny[i], b.nz[i]);
+				batch[i].worldnormal /= batch[i].worldnormal.Length();
+			}
 		} else {
-			vertex.worldnormal = Vec3<float>(0.0f, 0.0f, 1.0f);
+			for (int i = 0; i < n; ++i)
+				batch[i].worldnormal = Vec3<float>(0.0f, 0.0f, 1.0f);
 		}
 
 		// Time to generate some texture coords.  Lighting will handle shade mapping.
 		if (gstate.getUVGenMode() == GE_TEXMAP_TEXTURE_MATRIX) {
-			Vec3f source;
-			switch (gstate.getUVProjMode()) {
-			case GE_PROJMAP_POSITION:
-				source = vertex.modelpos;
-				break;
+			const GETexProjMapMode projMode = gstate.getUVProjMode();
+			Mat3x3<float> tgen(gstate.tgenMatrix);
+			const Vec3<float> tgenOffset(gstate.tgenMatrix[9], gstate.tgenMatrix[10], gstate.tgenMatrix[11]);
+			for (int i = 0; i < n; ++i) {
+				VertexData &vertex = batch[i];
+				Vec3f source;
+				switch (projMode) {
+				case GE_PROJMAP_POSITION:
+					source = vertex.modelpos;
+					break;
 
-			case GE_PROJMAP_UV:
-				source = Vec3f(vertex.texturecoords, 0.0f);
-				break;
+				case GE_PROJMAP_UV:
+					source = Vec3f(vertex.texturecoords, 0.0f);
+					break;
 
-			case GE_PROJMAP_NORMALIZED_NORMAL:
-				source = vertex.normal.NormalizedOr001(cpu_info.bSSE4_1);
-				break;
+				case GE_PROJMAP_NORMALIZED_NORMAL:
+					source = vertex.normal.NormalizedOr001(cpu_info.bSSE4_1);
+					break;
 
-			case GE_PROJMAP_NORMAL:
-				source = vertex.normal;
-				break;
+				case GE_PROJMAP_NORMAL:
+					source = vertex.normal;
+					break;
 
-			default:
-				source = Vec3f::AssignToAll(0.0f);
-				ERROR_LOG_REPORT(G3D, "Software: Unsupported UV projection mode %x", gstate.getUVProjMode());
-				break;
-			}
+				default:
+					source = Vec3f::AssignToAll(0.0f);
+					ERROR_LOG_REPORT(G3D, "Software: Unsupported UV projection mode %x", projMode);
+					break;
+				}
 
-			// TODO: What about uv scale and offset?
-			Mat3x3<float> tgen(gstate.tgenMatrix);
-			Vec3<float> stq = tgen * source + Vec3<float>(gstate.tgenMatrix[9], gstate.tgenMatrix[10], gstate.tgenMatrix[11]);
-			float z_recip = 1.0f / stq.z;
-			vertex.texturecoords = Vec2f(stq.x * z_recip, stq.y * z_recip);
+				// TODO: What about uv scale and offset?
+				Vec3<float> stq = tgen * source + tgenOffset;
+				float z_recip = 1.0f / stq.z;
+				vertex.texturecoords = Vec2f(stq.x * z_recip, stq.y * z_recip);
+			}
 		}
 
-		Lighting::Process(vertex, vreader.hasColor0());
-	} else {
-		vertex.screenpos.x = (int)(pos[0] * 16) + gstate.getOffsetX16();
-		vertex.screenpos.y = (int)(pos[1] * 16) + gstate.getOffsetY16();
-		vertex.screenpos.z = pos[2];
-		vertex.clippos.w = 1.f;
-		vertex.fogdepth = 1.f;
+		Lighting::Process(batch, n, vreader.hasColor0());
 	}
-
-	return vertex;
 }
 
 #define START_OPEN_U 1
@@ -323,6 +467,22 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 
 	VertexReader vreader(buf, vtxfmt, vertex_type);
 
+	// Transform every vertex in the range once, before assembling prims, so indexed
+	// meshes don't transform shared vertices again for each prim.
+	const int transformed_count = vertex_count > 0 ? index_upper_bound - index_lower_bound + 1 : 0;
+	if ((int)transformed_.size() < transformed_count) {
+		transformed_.resize(transformed_count);
+		transformed_outside_.resize(transformed_count);
+	}
+	ReadVertices(vreader, transformed_count, transformed_.data(), transformed_outside_.data());
+
+	auto readVertex = [&](int vtx) -> const VertexData & {
+		const int index = indices ? ConvertIndex(vtx) - index_lower_bound : vtx;
+		if (transformed_outside_[index])
+			outside_range_flag = true;
+		return transformed_[index];
+	};
+
 	static VertexData data[4];  // Normally max verts per prim is 3, but we temporarily need 4 to detect rectangles from strips.
 	// This is the index of the next vert in data (or higher, may need modulus.)
 	static int data_index = 0;
@@ -344,9 +504,6 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 	default: vtcs_per_prim = 0; break;
 	}
 
-	// TODO: Do this in two passes - first process the vertices (before indexing/stripping),
-	// then resolve the indices. This lets us avoid transforming shared vertices twice.
-
 	switch (prim_type) {
 	case GE_PRIM_POINTS:
 	case GE_PRIM_LINES:
@@ -354,13 +511,7 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 	case GE_PRIM_RECTANGLES:
 		{
 			for (int vtx = 0; vtx < vertex_count; ++vtx) {
-				if (indices) {
-					vreader.Goto(ConvertIndex(vtx) - index_lower_bound);
-				} else {
-					vreader.Goto(vtx);
-				}
-
-				data[data_index++] = ReadVertex(vreader);
+				data[data_index++] = readVertex(vtx);
 				if (data_index < vtcs_per_prim) {
 					// Keep reading.  Note: an incomplete prim will stay read for GE_PRIM_KEEP_PREVIOUS.
 					continue;
@@ -413,13 +564,7 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 			// If data_index is 1 or 2, etc., it means we're continuing a line strip.
 			int skip_count = data_index == 0 ? 1 : 0;
 			for (int vtx = 0; vtx < vertex_count; ++vtx) {
-				if (indices) {
-					vreader.Goto(ConvertIndex(vtx) - index_lower_bound);
-				} else {
-					vreader.Goto(vtx);
-				}
-
-				data[(data_index++) & 1] = ReadVertex(vreader);
+				data[(data_index++) & 1] = readVertex(vtx);
 				if (outside_range_flag) {
 					// Drop all primitives containing the current vertex
 					skip_count = 2;
@@ -446,13 +591,7 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 			// This is for Darkstalkers (and should speed up many 2D games).
 			if (vertex_count == 4 && gstate.isModeThrough()) {
 				for (int vtx = 0; vtx < 4; ++vtx) {
-					if (indices) {
-						vreader.Goto(ConvertIndex(vtx) - index_lower_bound);
-					}
-					else {
-						vreader.Goto(vtx);
-					}
-					data[vtx] = ReadVertex(vreader);
+					data[vtx] = readVertex(vtx);
 				}
 
 				// If a strip is effectively a rectangle, draw it as such!
@@ -463,14 +602,8 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 			}
 
 			for (int vtx = 0; vtx < vertex_count; ++vtx) {
-				if (indices) {
-					vreader.Goto(ConvertIndex(vtx) - index_lower_bound);
-				} else {
-					vreader.Goto(vtx);
-				}
-
 				int provoking_index = (data_index++) % 3;
-				data[provoking_index] = ReadVertex(vreader);
+				data[provoking_index] = readVertex(vtx);
 				if (outside_range_flag) {
 					// Drop all primitives containing the current vertex
 					skip_count = 2;
@@ -506,25 +639,14 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 
 			// Only read the central vertex if we're not continuing.
 			if (data_index == 0) {
-				if (indices) {
-					vreader.Goto(ConvertIndex(0) - index_lower_bound);
-				} else {
-					vreader.Goto(0);
-				}
-				data[0] = ReadVertex(vreader);
+				data[0] = readVertex(0);
 				data_index++;
 				start_vtx = 1;
 			}
 
 			for (int vtx = start_vtx; vtx < vertex_count; ++vtx) {
-				if (indices) {
-					vreader.Goto(ConvertIndex(vtx) - index_lower_bound);
-				} else {
-					vreader.Goto(vtx);
-				}
-
 				int provoking_index = 2 - ((data_index++) % 2);
-				data[provoking_index] = ReadVertex(vreader);
+				data[provoking_index] = readVertex(vtx);
 				if (outside_range_flag) {
 					// Drop all primitives containing the current vertex
 					skip_count = 2;
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "CommonTypes.h"
 #include "GPU/Common/DrawEngineCommon.h"
 #include "GPU/Common/GPUDebugInterface.h"
@@ -132,10 +134,16 @@ class TransformUnit {
 	void SubmitPrimitive(void* vertices, void* indices, GEPrimitiveType prim_type, int vertex_count, u32 vertex_type, int *bytesRead, SoftwareDrawEngine *drawEngine);
 
 	bool GetCurrentSimpleVertices(int count, std::vector<GPUDebugVertex> &vertices, std::vector<u16> &indices);
-	VertexData ReadVertex(VertexReader& vreader);
+	// Decodes and transforms the first count vertices of vreader, several at a time.
+	// outside is set for each vertex that should cull the prims using it.
+	void ReadVertices(VertexReader &vreader, int count, VertexData *vertices, u8 *outside);
 
 	bool outside_range_flag = false;
 	u8 *buf;
+
+private:
+	std::vector<VertexData> transformed_;
+	std::vector<u8> transformed_outside_;
 };
 
 class SoftwareDrawEngine : public DrawEngineCommon {
@@ -442,6 +442,7 @@ void TextureCacheVulkan::StartFrame() {
 
 	timesInvalidatedAllThisFrame_ = 0;
 	texelsScaledThisFrame_ = 0;
+	replacementTimeThisFrame_ = 0.0;
 
 	if (clearCacheNextFrame_) {
 		Clear(true);
@@ -767,7 +768,7 @@ void TextureCacheVulkan::BuildTexture(TexCacheEntry *const entry) {
 	u64 cachekey = replacer_.Enabled() ? entry->CacheKey() : 0;
 	int w = gstate.getTextureWidth(0);
 	int h = gstate.getTextureHeight(0);
-	ReplacedTexture &replaced = replacer_.FindReplacement(cachekey, entry->fullhash, w, h);
+	ReplacedTexture &replaced = FindReplacement(entry, w, h);
 	if (replaced.GetSize(0, w, h)) {
 		// We're replacing, so we won't scale.
 		scaleFactor = 1;
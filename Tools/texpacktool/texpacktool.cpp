@@ -0,0 +1,404 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+// Packs a texture replacement folder into a textures.pack, see Core/TextureReplacementPack.h.
+// Standalone on purpose, it only needs libpng, zlib and zstd.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <png.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+#include "Common/Data/Format/ZIMLoad.h"
+
+// Same layout as ReplacementPackHeader and ReplacementPackEntry, all little endian.
+static const int HEADER_SIZE = 32;
+static const int ENTRY_SIZE = 32;
+static const uint32_t PACK_VERSION = 1;
+
+enum {
+	TYPE_RGBA = 0,
+	TYPE_RGBA_ZSTD = 1,
+	TYPE_FILE = 2,
+	TYPE_FILE_ZSTD = 3,
+};
+
+// CheckAlphaResult.
+enum {
+	ALPHA_FULL = 0,
+	ALPHA_ANY = 4,
+};
+
+struct Entry {
+	std::string name;
+	uint64_t nameHash;
+	uint64_t offset;
+	uint32_t size;
+	uint32_t rawSize;
+	uint16_t w;
+	uint16_t h;
+	uint8_t type;
+	uint8_t alpha;
+};
+
+static void WriteLE16(uint8_t *p, uint16_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+}
+
+static void WriteLE32(uint8_t *p, uint32_t v) {
+	for (int i = 0; i < 4; ++i)
+		p[i] = (uint8_t)(v >> (i * 8));
+}
+
+static void WriteLE64(uint8_t *p, uint64_t v) {
+	WriteLE32(p, (uint32_t)v);
+	WriteLE32(p + 4, (uint32_t)(v >> 32));
+}
+
+static uint32_t ReadLE32(const uint8_t *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool ReadWholeFile(const std::string &filename, std::vector<uint8_t> &out) {
+	FILE *f = fopen(filename.c_str(), "rb");
+	if (!f)
+		return false;
+	fseeko(f, 0, SEEK_END);
+	out.resize((size_t)ftello(f));
+	fseeko(f, 0, SEEK_SET);
+	bool success = out.empty() || fread(&out[0], 1, out.size(), f) == out.size();
+	fclose(f);
+	return success;
+}
+
+static bool DecodePNG(const std::vector<uint8_t> &data, std::vector<uint8_t> &rgba, uint32_t &w, uint32_t &h) {
+	png_image png{};
+	png.version = PNG_IMAGE_VERSION;
+	if (!png_image_begin_read_from_memory(&png, &data[0], data.size())) {
+		fprintf(stderr, "%s\n", png.message);
+		return false;
+	}
+	png.format = PNG_FORMAT_RGBA;
+	w = png.width;
+	h = png.height;
+	rgba.resize((size_t)w * h * 4);
+	bool success = png_image_finish_read(&png, nullptr, &rgba[0], w * 4, nullptr) != 0;
+	if (!success)
+		fprintf(stderr, "%s\n", png.message);
+	png_image_free(&png);
+	return success;
+}
+
+// Only the first level of RGBA8888, the only kind PPSSPP replaces with.
+static bool DecodeZIM(const std::vector<uint8_t> &data, std::vector<uint8_t> &rgba, uint32_t &w, uint32_t &h) {
+	if (data.size() < 16 || memcmp(&data[0], "ZIMG", 4) != 0)
+		return false;
+	w = ReadLE32(&data[4]);
+	h = ReadLE32(&data[8]);
+	uint32_t flags = ReadLE32(&data[12]);
+	if ((flags & ZIM_FORMAT_MASK) != ZIM_RGBA8888) {
+		fprintf(stderr, "Only RGBA8888 ZIMs are supported\n");
+		return false;
+	}
+
+	// Mips may follow, so allow more data than the first level.
+	const size_t size = (size_t)w * h * 4;
+	std::vector<uint8_t> all;
+	if (flags & ZIM_ZSTD_COMPRESSED) {
+		unsigned long long total = ZSTD_getFrameContentSize(&data[16], data.size() - 16);
+		if (total == ZSTD_CONTENTSIZE_ERROR || total == ZSTD_CONTENTSIZE_UNKNOWN || total < size)
+			return false;
+		all.resize((size_t)total);
+		if (ZSTD_decompress(&all[0], all.size(), &data[16], data.size() - 16) != total)
+			return false;
+	} else if (flags & ZIM_ZLIB_COMPRESSED) {
+		z_stream z{};
+		if (inflateInit(&z) != Z_OK)
+			return false;
+		all.resize(size);
+		z.next_in = (Bytef *)&data[16];
+		z.avail_in = (uInt)(data.size() - 16);
+		z.next_out = &all[0];
+		z.avail_out = (uInt)size;
+		int status = inflate(&z, Z_SYNC_FLUSH);
+		inflateEnd(&z);
+		if ((status != Z_OK && status != Z_STREAM_END) || z.avail_out != 0)
+			return false;
+	} else {
+		if (data.size() - 16 < size)
+			return false;
+		all.assign(data.begin() + 16, data.begin() + 16 + size);
+	}
+	all.resize(size);
+	rgba.swap(all);
+	return true;
+}
+
+// Builds a ZIM the way the game side writes them, and checks DecodeZIM gets the pixels back.
+static bool SelfTest() {
+	const uint32_t w = 16, h = 8;
+	std::vector<uint8_t> rgba(w * h * 4);
+	for (size_t i = 0; i < rgba.size(); ++i)
+		rgba[i] = (uint8_t)(i * 7 + (i >> 5));
+
+	bool success = true;
+	const uint32_t compressions[] = { 0, ZIM_ZLIB_COMPRESSED, ZIM_ZSTD_COMPRESSED };
+	for (uint32_t compression : compressions) {
+		std::vector<uint8_t> zim(16);
+		memcpy(&zim[0], "ZIMG", 4);
+		WriteLE32(&zim[4], w);
+		WriteLE32(&zim[8], h);
+		WriteLE32(&zim[12], ZIM_RGBA8888 | ZIM_CLAMP | compression);
+
+		std::vector<uint8_t> payload;
+		if (compression == ZIM_ZLIB_COMPRESSED) {
+			uLongf size = compressBound((uLong)rgba.size());
+			payload.resize(size);
+			if (compress2(&payload[0], &size, &rgba[0], (uLong)rgba.size(), 6) != Z_OK)
+				return false;
+			payload.resize(size);
+		} else if (compression == ZIM_ZSTD_COMPRESSED) {
+			payload.resize(ZSTD_compressBound(rgba.size()));
+			size_t size = ZSTD_compress(&payload[0], payload.size(), &rgba[0], rgba.size(), 3);
+			if (ZSTD_isError(size))
+				return false;
+			payload.resize(size);
+		} else {
+			payload = rgba;
+		}
+		zim.insert(zim.end(), payload.begin(), payload.end());
+
+		std::vector<uint8_t> decoded;
+		uint32_t dw = 0, dh = 0;
+		if (!DecodeZIM(zim, decoded, dw, dh) || dw != w || dh != h || decoded != rgba) {
+			fprintf(stderr, "FAILED: ZIM round trip with flags %08x\n", compression);
+			success = false;
+		}
+	}
+	if (success)
+		fprintf(stderr, "Self test passed\n");
+	return success;
+}
+
+static void ListFiles(const std::string &base, const std::string &sub, std::vector<std::string> &files) {
+	DIR *dir = opendir((base + "/" + sub).c_str());
+	if (!dir)
+		return;
+	while (struct dirent *ent = readdir(dir)) {
+		const std::string name = ent->d_name;
+		if (name.empty() || name[0] == '.')
+			continue;
+		// Textures saved by PPSSPP, not part of the pack.
+		if (sub.empty() && name == "new")
+			continue;
+
+		const std::string rel = sub.empty() ? name : sub + "/" + name;
+		struct stat st;
+		if (stat((base + "/" + rel).c_str(), &st) != 0)
+			continue;
+		if (S_ISDIR(st.st_mode))
+			ListFiles(base, rel, files);
+		else if (S_ISREG(st.st_mode))
+			files.push_back(rel);
+	}
+	closedir(dir);
+}
+
+static std::string Extension(const std::string &name) {
+	size_t dot = name.find_last_of('.');
+	if (dot == std::string::npos)
+		return "";
+	std::string ext = name.substr(dot + 1);
+	std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+	return ext;
+}
+
+static void printusage() {
+	fprintf(stderr, "Usage: texpacktool texturesdir [outfile.pack] [-l=LEVEL] [-r]\n");
+	fprintf(stderr, "The default outfile is texturesdir/textures.pack.  LEVEL is the zstd level, default 9.\n");
+	fprintf(stderr, "-r stores images uncompressed, bigger but the fastest to load.\n");
+	fprintf(stderr, "texpacktool --selftest checks the image decoders and exits.\n");
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		fprintf(stderr, "ERROR: Not enough parameters.\n");
+		printusage();
+		return 1;
+	}
+	if (!strcmp(argv[1], "--selftest"))
+		return SelfTest() ? 0 : 1;
+	const std::string indir = argv[1];
+	std::string outfile = indir + "/textures.pack";
+
+	int level = 9;
+	bool raw = false;
+	for (int i = 2; i < argc; ++i) {
+		if (!strncmp(argv[i], "-l=", 3)) {
+			level = atoi(argv[i] + 3);
+		} else if (!strcmp(argv[i], "-r")) {
+			raw = true;
+		} else if (i == 2 && argv[i][0] != '-') {
+			outfile = argv[i];
+		} else {
+			fprintf(stderr, "ERROR: Unknown option %s\n", argv[i]);
+			printusage();
+			return 1;
+		}
+	}
+
+	std::vector<std::string> files;
+	ListFiles(indir, "", files);
+
+	FILE *out = fopen(outfile.c_str(), "wb");
+	if (!out) {
+		fprintf(stderr, "ERROR: Could not open %s for writing\n", outfile.c_str());
+		return 1;
+	}
+
+	// The header and index get filled in at the end, so leave room for the most entries.
+	std::vector<Entry> entries;
+	std::vector<uint8_t> index(files.size() * ENTRY_SIZE);
+	uint8_t hdr[HEADER_SIZE]{};
+	fwrite(hdr, 1, HEADER_SIZE, out);
+	fwrite(index.data(), 1, index.size(), out);
+	uint64_t pos = HEADER_SIZE + index.size();
+
+	ZSTD_CCtx *cctx = ZSTD_createCCtx();
+	std::vector<uint8_t> data, decoded, compressed;
+	uint64_t rawTotal = 0;
+	int result = 0;
+	for (size_t i = 0; i < files.size(); ++i) {
+		if ((i & 255) == 0 || i + 1 == files.size())
+			fprintf(stderr, "\r%d / %d files", (int)i + 1, (int)files.size());
+
+		const std::string &name = files[i];
+		const std::string ext = Extension(name);
+		const bool image = ext == "png" || ext == "zim";
+		if (!image && ext != "ini")
+			continue;
+		// Don't pack an older pack in the same folder.
+		if (indir + "/" + name == outfile)
+			continue;
+
+		if (!ReadWholeFile(indir + "/" + name, data)) {
+			fprintf(stderr, "ERROR: Could not read %s\n", name.c_str());
+			result = 1;
+			break;
+		}
+
+		Entry entry{};
+		entry.name = name;
+		entry.nameHash = XXH64(name.data(), name.size(), 0);
+		entry.type = TYPE_FILE;
+		if (image) {
+			uint32_t w = 0, h = 0;
+			bool decodedOK = ext == "png" ? DecodePNG(data, decoded, w, h) : DecodeZIM(data, decoded, w, h);
+			if (!decodedOK || w > 0xFFFF || h > 0xFFFF) {
+				fprintf(stderr, "WARNING: Skipping %s, could not decode it\n", name.c_str());
+				continue;
+			}
+			entry.type = TYPE_RGBA;
+			entry.w = (uint16_t)w;
+			entry.h = (uint16_t)h;
+			entry.alpha = ALPHA_FULL;
+			for (size_t p = 3; p < decoded.size(); p += 4) {
+				if (decoded[p] != 0xFF) {
+					entry.alpha = ALPHA_ANY;
+					break;
+				}
+			}
+			data.swap(decoded);
+		}
+		entry.rawSize = (uint32_t)data.size();
+
+		const uint8_t *src = data.data();
+		entry.size = entry.rawSize;
+		if ((!raw || !image) && !data.empty()) {
+			compressed.resize(ZSTD_compressBound(data.size()));
+			size_t size = ZSTD_compressCCtx(cctx, &compressed[0], compressed.size(), &data[0], data.size(), level);
+			// Not worth it otherwise, store it as is.
+			if (!ZSTD_isError(size) && size < data.size()) {
+				src = compressed.data();
+				entry.size = (uint32_t)size;
+				entry.type = image ? TYPE_RGBA_ZSTD : TYPE_FILE_ZSTD;
+			}
+		}
+
+		entry.offset = pos;
+		fwrite(src, 1, entry.size, out);
+		pos += entry.size;
+		rawTotal += entry.rawSize;
+		entries.push_back(entry);
+	}
+	fprintf(stderr, "\n");
+	ZSTD_freeCCtx(cctx);
+
+	std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+		return a.nameHash < b.nameHash;
+	});
+	for (size_t i = 0; i < entries.size(); ++i) {
+		if (i > 0 && entries[i].nameHash == entries[i - 1].nameHash) {
+			fprintf(stderr, "ERROR: %s and %s have the same name hash, rename one\n", entries[i - 1].name.c_str(), entries[i].name.c_str());
+			result = 1;
+		}
+
+		uint8_t *p = &index[i * ENTRY_SIZE];
+		WriteLE64(p + 0, entries[i].nameHash);
+		WriteLE64(p + 8, entries[i].offset);
+		WriteLE32(p + 16, entries[i].size);
+		WriteLE32(p + 20, entries[i].rawSize);
+		WriteLE16(p + 24, entries[i].w);
+		WriteLE16(p + 26, entries[i].h);
+		p[28] = entries[i].type;
+		p[29] = entries[i].alpha;
+	}
+
+	// Unused index slots (skipped files) stay zero, and are not counted.
+	memcpy(hdr, "PPTP", 4);
+	WriteLE32(hdr + 4, PACK_VERSION);
+	WriteLE32(hdr + 8, (uint32_t)entries.size());
+	WriteLE64(hdr + 16, HEADER_SIZE);
+	WriteLE64(hdr + 24, pos);
+	fseeko(out, 0, SEEK_SET);
+	fwrite(hdr, 1, HEADER_SIZE, out);
+	fwrite(index.data(), 1, index.size(), out);
+	if (fclose(out) != 0) {
+		fprintf(stderr, "ERROR: Could not write %s\n", outfile.c_str());
+		result = 1;
+	}
+
+	if (result == 0)
+		fprintf(stderr, "Packed %d files, %llu bytes (%llu decoded)\n", (int)entries.size(), (unsigned long long)pos, (unsigned long long)rawTotal);
+	else
+		remove(outfile.c_str());
+	return result;
+}
@@ -0,0 +1,296 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+// Converts an ISO or CSO image to ZCSO, see ZCSOFileBlockDevice in Core/FileSystems/BlockDevices.h.
+// Standalone on purpose, it only needs zlib and zstd.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <zlib.h>
+#include <zstd.h>
+
+// Same layout as CISO_H, all little endian.
+static const int HEADER_SIZE = 0x18;
+
+static void WriteLE32(uint8_t *p, uint32_t v) {
+	for (int i = 0; i < 4; ++i)
+		p[i] = (uint8_t)(v >> (i * 8));
+}
+
+static uint32_t ReadLE32(const uint8_t *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t ReadLE64(const uint8_t *p) {
+	return ReadLE32(p) | ((uint64_t)ReadLE32(p + 4) << 32);
+}
+
+static bool ReadAt(FILE *f, uint64_t pos, void *dst, size_t size) {
+	if (fseeko(f, (off_t)pos, SEEK_SET) != 0)
+		return false;
+	return fread(dst, 1, size, f) == size;
+}
+
+// Reads frames of an input image, plain ISO or CSO v1/v2 with deflate frames.
+class Input {
+public:
+	bool Open(const char *filename) {
+		f_ = fopen(filename, "rb");
+		if (!f_) {
+			fprintf(stderr, "ERROR: Could not open %s\n", filename);
+			return false;
+		}
+
+		uint8_t hdr[HEADER_SIZE]{};
+		if (fread(hdr, 1, HEADER_SIZE, f_) == HEADER_SIZE && !memcmp(hdr, "CISO", 4))
+			return OpenCSO(hdr);
+
+		fseeko(f_, 0, SEEK_END);
+		totalBytes_ = (uint64_t)ftello(f_);
+		return true;
+	}
+
+	~Input() {
+		if (f_)
+			fclose(f_);
+	}
+
+	uint64_t TotalBytes() const { return totalBytes_; }
+
+	// Reads size bytes at pos, which must be a multiple of size.  Zero pads past the end.
+	bool Read(uint64_t pos, uint8_t *dst, uint32_t size) {
+		memset(dst, 0, size);
+		uint32_t avail = (uint32_t)std::min((uint64_t)size, totalBytes_ - pos);
+		if (csoIndex_.empty())
+			return ReadAt(f_, pos, dst, avail);
+
+		// The output size may be smaller or larger than the CSO's, so copy from inside frames.
+		uint32_t done = 0;
+		while (done < avail) {
+			const uint32_t frame = (uint32_t)((pos + done) / csoFrameSize_);
+			const uint32_t offset = (uint32_t)((pos + done) % csoFrameSize_);
+			if (frame != csoCurrentFrame_) {
+				csoCurrentFrame_ = (uint32_t)-1;
+				if (!ReadCSOFrame(frame))
+					return false;
+				csoCurrentFrame_ = frame;
+			}
+			const uint32_t n = std::min(csoFrameSize_ - offset, avail - done);
+			memcpy(dst + done, &csoFrame_[offset], n);
+			done += n;
+		}
+		return true;
+	}
+
+private:
+	bool OpenCSO(const uint8_t *hdr) {
+		totalBytes_ = ReadLE64(hdr + 0x08);
+		csoFrameSize_ = ReadLE32(hdr + 0x10);
+		csoVer_ = hdr[0x14];
+		csoAlign_ = hdr[0x15];
+		if (csoFrameSize_ < 0x800 || (csoFrameSize_ & (csoFrameSize_ - 1)) != 0) {
+			fprintf(stderr, "ERROR: Unsupported CSO frame size %u\n", csoFrameSize_);
+			return false;
+		}
+
+		const uint32_t numFrames = (uint32_t)((totalBytes_ + csoFrameSize_ - 1) / csoFrameSize_);
+		const uint64_t headerEnd = csoVer_ > 1 ? ReadLE32(hdr + 0x04) : HEADER_SIZE;
+		std::vector<uint8_t> raw((numFrames + 1) * 4);
+		if (!ReadAt(f_, headerEnd, &raw[0], raw.size())) {
+			fprintf(stderr, "ERROR: Could not read the CSO index\n");
+			return false;
+		}
+		csoIndex_.resize(numFrames + 1);
+		for (uint32_t i = 0; i <= numFrames; ++i)
+			csoIndex_[i] = ReadLE32(&raw[i * 4]);
+		csoFrame_.resize(csoFrameSize_);
+		csoRead_.resize(csoFrameSize_ * 2 + (1 << csoAlign_));
+		return true;
+	}
+
+	bool ReadCSOFrame(uint32_t frame) {
+		const uint64_t pos = (uint64_t)(csoIndex_[frame] & 0x7FFFFFFF) << csoAlign_;
+		const uint64_t end = (uint64_t)(csoIndex_[frame + 1] & 0x7FFFFFFF) << csoAlign_;
+		const size_t size = (size_t)(end - pos);
+		if (end < pos || size > csoRead_.size() || !ReadAt(f_, pos, &csoRead_[0], size)) {
+			fprintf(stderr, "ERROR: Could not read CSO frame %u\n", frame);
+			return false;
+		}
+
+		bool plain = (csoIndex_[frame] & 0x80000000) != 0;
+		if (csoVer_ >= 2) {
+			// In v2, the high bit means LZ4 instead.
+			if (plain) {
+				fprintf(stderr, "ERROR: CSO frame %u uses LZ4, which is not supported\n", frame);
+				return false;
+			}
+			plain = size >= csoFrameSize_;
+		}
+		if (plain) {
+			memcpy(&csoFrame_[0], &csoRead_[0], std::min(size, (size_t)csoFrameSize_));
+			return true;
+		}
+
+		z_stream z{};
+		if (inflateInit2(&z, -15) != Z_OK)
+			return false;
+		z.next_in = &csoRead_[0];
+		z.avail_in = (uInt)size;
+		z.next_out = &csoFrame_[0];
+		z.avail_out = csoFrameSize_;
+		int status = inflate(&z, Z_FINISH);
+		inflateEnd(&z);
+		if (status != Z_STREAM_END) {
+			fprintf(stderr, "ERROR: Could not inflate CSO frame %u\n", frame);
+			return false;
+		}
+		return true;
+	}
+
+	FILE *f_ = nullptr;
+	uint64_t totalBytes_ = 0;
+	std::vector<uint32_t> csoIndex_;
+	std::vector<uint8_t> csoFrame_;
+	std::vector<uint8_t> csoRead_;
+	uint32_t csoFrameSize_ = 0;
+	// Which frame csoFrame_ holds, if any.
+	uint32_t csoCurrentFrame_ = (uint32_t)-1;
+	uint8_t csoVer_ = 0;
+	uint8_t csoAlign_ = 0;
+};
+
+static void printusage() {
+	fprintf(stderr, "Usage: zcsotool infile.iso|infile.cso outfile.zcso [-b=FRAMESIZE] [-l=LEVEL]\n");
+	fprintf(stderr, "FRAMESIZE is a power of two of at least 2048, default 16384.  LEVEL is the zstd level, default 12.\n");
+	fprintf(stderr, "Larger frames compress better, but make small random reads slower.\n");
+}
+
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		fprintf(stderr, "ERROR: Not enough parameters.\n");
+		printusage();
+		return 1;
+	}
+	const char *infile = argv[1];
+	const char *outfile = argv[2];
+
+	uint32_t frameSize = 16384;
+	int level = 12;
+	for (int i = 3; i < argc; ++i) {
+		if (!strncmp(argv[i], "-b=", 3)) {
+			frameSize = (uint32_t)atoi(argv[i] + 3);
+		} else if (!strncmp(argv[i], "-l=", 3)) {
+			level = atoi(argv[i] + 3);
+		} else {
+			fprintf(stderr, "ERROR: Unknown option %s\n", argv[i]);
+			printusage();
+			return 1;
+		}
+	}
+	if (frameSize < 0x800 || (frameSize & (frameSize - 1)) != 0 || frameSize > 0x100000) {
+		fprintf(stderr, "ERROR: Bad frame size %u\n", frameSize);
+		return 1;
+	}
+
+	Input input;
+	if (!input.Open(infile))
+		return 1;
+	const uint64_t totalBytes = input.TotalBytes();
+	const uint32_t numFrames = (uint32_t)((totalBytes + frameSize - 1) / frameSize);
+	const uint64_t indexEnd = HEADER_SIZE + (uint64_t)(numFrames + 1) * 4;
+
+	// Pick the smallest alignment that can address the output even if nothing compresses.
+	uint8_t align = 0;
+	while (((indexEnd + totalBytes + ((uint64_t)numFrames << align)) >> align) >= 0x80000000ULL)
+		++align;
+
+	FILE *out = fopen(outfile, "wb");
+	if (!out) {
+		fprintf(stderr, "ERROR: Could not open %s for writing\n", outfile);
+		return 1;
+	}
+
+	uint8_t hdr[HEADER_SIZE]{};
+	memcpy(hdr, "ZCSO", 4);
+	WriteLE32(hdr + 0x04, HEADER_SIZE);
+	WriteLE32(hdr + 0x08, (uint32_t)totalBytes);
+	WriteLE32(hdr + 0x0C, (uint32_t)(totalBytes >> 32));
+	WriteLE32(hdr + 0x10, frameSize);
+	hdr[0x14] = 1;
+	hdr[0x15] = align;
+	fwrite(hdr, 1, HEADER_SIZE, out);
+
+	// The index gets filled in at the end.
+	std::vector<uint8_t> index((numFrames + 1) * 4);
+	fwrite(&index[0], 1, index.size(), out);
+
+	std::vector<uint8_t> frame(frameSize);
+	std::vector<uint8_t> compressed(ZSTD_compressBound(frameSize));
+	// Enough zeros for the largest gap before an aligned frame.
+	const std::vector<uint8_t> padding((size_t)1 << align);
+	ZSTD_CCtx *cctx = ZSTD_createCCtx();
+	uint64_t pos = indexEnd;
+	int result = 0;
+	for (uint32_t i = 0; i < numFrames; ++i) {
+		const uint64_t padded = (pos + (1ULL << align) - 1) & ~((1ULL << align) - 1);
+		fwrite(&padding[0], 1, (size_t)(padded - pos), out);
+		pos = padded;
+
+		if (!input.Read((uint64_t)i * frameSize, &frame[0], frameSize)) {
+			fprintf(stderr, "ERROR: Could not read frame %u\n", i);
+			result = 1;
+			break;
+		}
+
+		size_t size = ZSTD_compressCCtx(cctx, &compressed[0], compressed.size(), &frame[0], frameSize, level);
+		uint32_t entry = (uint32_t)(pos >> align);
+		if (ZSTD_isError(size) || size >= frameSize) {
+			// Not worth it, store it as is.
+			fwrite(&frame[0], 1, frameSize, out);
+			pos += frameSize;
+			entry |= 0x80000000;
+		} else {
+			fwrite(&compressed[0], 1, size, out);
+			pos += size;
+		}
+		WriteLE32(&index[i * 4], entry);
+
+		if ((i & 1023) == 0 || i + 1 == numFrames)
+			fprintf(stderr, "\r%u / %u frames", i + 1, numFrames);
+	}
+	fprintf(stderr, "\n");
+	ZSTD_freeCCtx(cctx);
+
+	const uint64_t padded = (pos + (1ULL << align) - 1) & ~((1ULL << align) - 1);
+	fwrite(&padding[0], 1, (size_t)(padded - pos), out);
+	WriteLE32(&index[numFrames * 4], (uint32_t)(padded >> align));
+	fseeko(out, HEADER_SIZE, SEEK_SET);
+	fwrite(&index[0], 1, index.size(), out);
+	if (fclose(out) != 0) {
+		fprintf(stderr, "ERROR: Could not write %s\n", outfile);
+		result = 1;
+	}
+
+	if (result == 0)
+		fprintf(stderr, "Wrote %llu bytes, %.1f%% of the original\n", (unsigned long long)padded, totalBytes ? 100.0 * padded / totalBytes : 0.0);
+	return result;
+}
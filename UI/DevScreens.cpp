@@ -373,6 +373,7 @@ static const JitDisableFlag jitDisableFlags[] = {
 	{ MIPSComp::JitDisable::CACHE_POINTERS, "Cached pointers" },
 	{ MIPSComp::JitDisable::REGALLOC_GPR, "GPR Regalloc across instructions" },
 	{ MIPSComp::JitDisable::REGALLOC_FPR, "FPR Regalloc across instructions" },
+	{ MIPSComp::JitDisable::IR_TRACES, "IR traces" },
 };
 
 void JitDebugScreen::CreateViews() {
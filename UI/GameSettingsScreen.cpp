@@ -298,6 +298,9 @@ void GameSettingsScreen::CreateViews() {
 		});
 		softwareGPU->OnClick.Handle(this, &GameSettingsScreen::OnSoftwareRendering);
 		softwareGPU->SetEnabled(!PSP_IsInited());
+
+		CheckBox *softwareBinning = graphicsSettings->Add(new CheckBox(&g_Config.bSoftwareRendererBinning, gr->T("Multithreaded software rendering")));
+		softwareBinning->SetEnabledPtr(&g_Config.bSoftwareRendering);
 	}
 
 	graphicsSettings->Add(new ItemHeader(gr->T("Frame Rate Control")));
@@ -901,6 +904,10 @@ void GameSettingsScreen::CreateViews() {
 	lockedMhz->SetZeroLabel(sy->T("Auto"));
 	PopupSliderChoice *rewindFreq = systemSettings->Add(new PopupSliderChoice(&g_Config.iRewindFlipFrequency, 0, 1800, sy->T("Rewind Snapshot Frequency", "Rewind Snapshot Frequency (mem hog)"), screenManager(), sy->T("frames, 0:off")));
 	rewindFreq->SetZeroLabel(sy->T("Off"));
+	PopupSliderChoice *rewindMemory = systemSettings->Add(new PopupSliderChoice(&g_Config.iRewindMaxMemoryMB, 16, 1024, sy->T("Rewind Snapshot Memory"), screenManager(), sy->T("MB")));
+	rewindMemory->SetEnabledFunc([] {
+		return g_Config.iRewindFlipFrequency != 0;
+	});
 
 	systemSettings->Add(new ItemHeader(sy->T("PSP Memory Stick")));
 
@@ -982,6 +989,7 @@ void GameSettingsScreen::CreateViews() {
 #if PPSSPP_ARCH(AMD64)
 	systemSettings->Add(new CheckBox(&g_Config.bCacheFullIsoInRam, sy->T("Cache ISO in RAM", "Cache full ISO in RAM")))->SetEnabled(!PSP_IsInited());
 #endif
+	systemSettings->Add(new CheckBox(&g_Config.bDiscReadAhead, sy->T("Read ahead on streamed files")))->SetEnabled(!PSP_IsInited());
 
 	systemSettings->Add(new ItemHeader(sy->T("Cheats", "Cheats")));
 	CheckBox *enableCheats = systemSettings->Add(new CheckBox(&g_Config.bEnableCheats, sy->T("Enable Cheats")));
@@ -1637,6 +1645,7 @@ void DeveloperToolsScreen::CreateViews() {
 	list->Add(new ItemHeader(dev->T("Texture Replacement")));
 	list->Add(new CheckBox(&g_Config.bSaveNewTextures, dev->T("Save new textures")));
 	list->Add(new CheckBox(&g_Config.bReplaceTextures, dev->T("Replace textures")));
+	list->Add(new PopupSliderChoice(&g_Config.iReplacementTextureRAMBudget, 64, 4096, dev->T("Replacement texture RAM budget"), 64, screenManager(), "MB"));
 
 	// Makes it easy to get savestates out of an iOS device. The file listing shown in MacOS doesn't allow
 	// you to descend into directories.
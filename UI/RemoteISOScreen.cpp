@@ -246,7 +246,7 @@ bool RemoteISOConnectScreen::FindServer(std::string &resultHost, int &resultPort
 static bool LoadGameList(const Path &url, std::vector<Path> &games) {
 	PathBrowser browser(url);
 	std::vector<File::FileInfo> files;
-	browser.GetListing(files, "iso:cso:pbp:elf:prx:ppdmp:", &scanCancelled);
+	browser.GetListing(files, "iso:cso:zcso:pbp:elf:prx:ppdmp:", &scanCancelled);
 	if (scanCancelled) {
 		return false;
 	}
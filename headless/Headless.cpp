@@ -3,9 +3,11 @@
 // To build on non-windows systems, just run CMake in the SDL directory, it will build both a normal ppsspp and the headless version.
 
 #include "ppsspp_config.h"
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <limits>
+#include <vector>
 #if PPSSPP_PLATFORM(ANDROID)
 #include <jni.h>
 #endif
@@ -15,6 +17,7 @@
 #include "Common/System/System.h"
 
 #include "Common/CPUDetect.h"
+#include "Common/Data/Format/JSONWriter.h"
 #include "Common/File/VFS/VFS.h"
 #include "Common/File/VFS/AssetReader.h"
 #include "Common/File/FileUtil.h"
@@ -30,7 +33,10 @@
 #include "Core/HLE/sceUtility.h"
 #include "Core/Host.h"
 #include "Core/SaveState.h"
+#include "Core/MIPS/JitCommon/JitBlockCache.h"
+#include "Core/MIPS/JitCommon/JitCommon.h"
 #include "GPU/Common/FramebufferManagerCommon.h"
+#include "GPU/GPU.h"
 #include "Log.h"
 #include "LogManager.h"
 
@@ -126,12 +132,16 @@ int printUsage(const char *progname, const char *reason)
 	}
 #endif
 	fprintf(stderr, "  --timeout=SECONDS     abort test it if takes longer than SECONDS\n");
+	fprintf(stderr, "  --soft-binning        draw software gpu primitives in tiles, on threads\n");
 
 	fprintf(stderr, "  -v, --verbose         show the full passed/failed result\n");
 	fprintf(stderr, "  -i                    use the interpreter\n");
 	fprintf(stderr, "  --ir                  use ir interpreter\n");
 	fprintf(stderr, "  -j                    use jit (default)\n");
 	fprintf(stderr, "  -c, --compare         compare with output in file.expected\n");
+	fprintf(stderr, "  --ir-bench=SECONDS    time SECONDS of emulation with both ir interpreter modes\n");
+	fprintf(stderr, "  --bench=FRAMES        run FRAMES frames unthrottled and print timing stats as JSON\n");
+	fprintf(stderr, "  --trace=FILE          write profiler scopes as a Chrome trace (USE_PROFILER builds)\n");
 	fprintf(stderr, "\nSee headless.txt for details.\n");
 
 	return 1;
@@ -198,6 +208,7 @@ bool RunAutoTest(HeadlessHost *headlessHost, CoreParameter &coreParameter, bool
 		if (coreState == CORE_NEXTFRAME) {
 			coreState = CORE_RUNNING;
 			headlessHost->SwapBuffers();
+			PROFILE_END_FRAME();
 		}
 		if (coreState == CORE_STEPPING && !coreParameter.startBreak) {
 			break;
@@ -230,6 +241,177 @@ bool RunAutoTest(HeadlessHost *headlessHost, CoreParameter &coreParameter, bool
 	return passed;
 }
 
+// Runs for a fixed amount of emulated time, so both modes do the same work.  Returns wall time, or -1.
+static double RunBenchmark(HeadlessHost *headlessHost, CoreParameter &coreParameter, double emulatedSeconds)
+{
+	std::string error_string;
+	if (!PSP_Init(coreParameter, &error_string)) {
+		fprintf(stderr, "Failed to start '%s'. Error: %s\n", coreParameter.fileToStart.c_str(), error_string.c_str());
+		return -1.0;
+	}
+
+	host->BootDone();
+
+	PSP_BeginHostFrame();
+	if (coreParameter.graphicsContext && coreParameter.graphicsContext->GetDrawContext())
+		coreParameter.graphicsContext->GetDrawContext()->BeginFrame();
+
+	const u64 endUs = CoreTiming::GetGlobalTimeUs() + (u64)(emulatedSeconds * 1000000.0);
+	double start = time_now_d();
+	coreState = CORE_RUNNING;
+	while (coreState == CORE_RUNNING && CoreTiming::GetGlobalTimeUs() < endUs)
+	{
+		PSP_RunLoopFor(usToCycles(1000000 / 10));
+
+		if (coreState == CORE_NEXTFRAME) {
+			coreState = CORE_RUNNING;
+			headlessHost->SwapBuffers();
+			PROFILE_END_FRAME();
+		}
+	}
+	double elapsed = time_now_d() - start;
+	PSP_EndHostFrame();
+
+	if (coreParameter.graphicsContext && coreParameter.graphicsContext->GetDrawContext())
+		coreParameter.graphicsContext->GetDrawContext()->EndFrame();
+
+	PSP_Shutdown();
+	headlessHost->FlushDebugOutput();
+
+	return elapsed;
+}
+
+struct FrameBenchmarkResult {
+	std::vector<double> frameSeconds;
+	double elapsed = 0.0;
+	bool completed = false;
+	int blocksCompiled = 0;
+	s64 textureLookups = 0;
+	s64 textureCacheHits = 0;
+	s64 cachedVerts = 0;
+	s64 uncachedVerts = 0;
+};
+
+static int CurrentJitBlocks() {
+	JitBlockCacheDebugInterface *blocks = MIPSComp::jit ? MIPSComp::jit->GetBlockCacheDebugInterface() : nullptr;
+	return blocks ? blocks->GetNumBlocks() : 0;
+}
+
+// Runs until numFrames frames were presented, timing each one.  Returns false if it couldn't start.
+static bool RunFrameBenchmark(HeadlessHost *headlessHost, CoreParameter &coreParameter, int numFrames, double timeout, FrameBenchmarkResult *result)
+{
+	std::string error_string;
+	if (!PSP_Init(coreParameter, &error_string)) {
+		fprintf(stderr, "Failed to start '%s'. Error: %s\n", coreParameter.fileToStart.c_str(), error_string.c_str());
+		return false;
+	}
+
+	host->BootDone();
+
+	PSP_BeginHostFrame();
+	if (coreParameter.graphicsContext && coreParameter.graphicsContext->GetDrawContext())
+		coreParameter.graphicsContext->GetDrawContext()->BeginFrame();
+
+	// The stats are per frame, collect and reset them after each one so they can't overflow.
+	auto collectStats = [&]() {
+		result->textureLookups += gpuStats.numTextureLookups;
+		result->textureCacheHits += gpuStats.numTextureCacheHits;
+		result->cachedVerts += gpuStats.numCachedVertsDrawn;
+		result->uncachedVerts += gpuStats.numUncachedVertsDrawn;
+		gpuStats.ResetFrame();
+	};
+	gpuStats.ResetFrame();
+
+	// If the jit cache gets cleared, count what it had before.
+	int blocksBeforeClears = 0;
+	int lastBlocks = 0;
+
+	result->frameSeconds.reserve(numFrames);
+	const double start = time_now_d();
+	const double deadline = start + timeout;
+	double frameStart = start;
+	coreState = CORE_RUNNING;
+	while (coreState == CORE_RUNNING && (int)result->frameSeconds.size() < numFrames)
+	{
+		PSP_RunLoopFor(usToCycles(1000000 / 10));
+
+		if (coreState == CORE_NEXTFRAME) {
+			coreState = CORE_RUNNING;
+			headlessHost->SwapBuffers();
+			PROFILE_END_FRAME();
+
+			double now = time_now_d();
+			result->frameSeconds.push_back(now - frameStart);
+			frameStart = now;
+			collectStats();
+
+			int blocks = CurrentJitBlocks();
+			if (blocks < lastBlocks)
+				blocksBeforeClears += lastBlocks;
+			lastBlocks = blocks;
+		}
+		if (time_now_d() > deadline)
+			break;
+	}
+	result->elapsed = time_now_d() - start;
+	result->completed = (int)result->frameSeconds.size() >= numFrames;
+	collectStats();
+	result->blocksCompiled = blocksBeforeClears + std::max(lastBlocks, CurrentJitBlocks());
+	PSP_EndHostFrame();
+
+	if (coreParameter.graphicsContext && coreParameter.graphicsContext->GetDrawContext())
+		coreParameter.graphicsContext->GetDrawContext()->EndFrame();
+
+	PSP_Shutdown();
+	headlessHost->FlushDebugOutput();
+
+	return true;
+}
+
+static void WriteFrameBenchmarkJson(json::JsonWriter &writer, const CoreParameter &coreParameter, const FrameBenchmarkResult &result)
+{
+	static const char *const cpuNames[] = { "interpreter", "jit", "ir" };
+	static const char *const gpuNames[] = { "gles", "software", "directx9", "directx11", "vulkan" };
+
+	std::vector<double> sorted = result.frameSeconds;
+	std::sort(sorted.begin(), sorted.end());
+	// Nearest rank, in milliseconds.
+	auto percentile = [&](double p) {
+		if (sorted.empty())
+			return 0.0;
+		size_t rank = (size_t)(p * sorted.size() + 0.5);
+		return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)] * 1000.0;
+	};
+	auto writeRate = [&](const char *name, s64 hits, s64 total) {
+		if (total == 0)
+			writer.writeNull(name);
+		else
+			writer.writeFloat(name, (double)hits / (double)total);
+	};
+
+	const int frames = (int)result.frameSeconds.size();
+	writer.pushDict();
+	writer.writeString("file", coreParameter.fileToStart.ToVisualString());
+	writer.writeString("cpu", cpuNames[(int)coreParameter.cpuCore]);
+	writer.writeString("gpu", gpuNames[coreParameter.gpuCore]);
+	writer.writeInt("frames", frames);
+	writer.writeBool("completed", result.completed);
+	writer.writeFloat("seconds", result.elapsed);
+	writer.writeFloat("fps", result.elapsed > 0.0 ? frames / result.elapsed : 0.0);
+	writer.pushDict("frameMs");
+	writer.writeFloat("mean", frames ? result.elapsed * 1000.0 / frames : 0.0);
+	writer.writeFloat("p50", percentile(0.50));
+	writer.writeFloat("p90", percentile(0.90));
+	writer.writeFloat("p99", percentile(0.99));
+	writer.writeFloat("max", sorted.empty() ? 0.0 : sorted.back() * 1000.0);
+	writer.pop();
+	writer.writeInt("blocksCompiled", result.blocksCompiled);
+	// Null when the backend has no such cache (the software renderer has neither.)
+	writeRate("textureCacheHitRate", result.textureCacheHits, result.textureLookups);
+	writeRate("vertexCacheHitRate", result.cachedVerts, result.cachedVerts + result.uncachedVerts);
+	writer.pop();
+}
+
 int main(int argc, const char* argv[])
 {
 	PROFILE_INIT();
@@ -251,6 +433,10 @@ int main(int argc, const char* argv[])
 	const char *mountRoot = nullptr;
 	const char *screenshotFilename = nullptr;
 	float timeout = std::numeric_limits<float>::infinity();
+	double benchSeconds = 0.0;
+	int benchFrames = 0;
+	bool softBinning = false;
+	const char *traceFilename = nullptr;
 
 	for (int i = 1; i < argc; i++)
 	{
@@ -304,8 +490,16 @@ int main(int argc, const char* argv[])
 #endif
 		} else if (!strncmp(argv[i], "--screenshot=", strlen("--screenshot=")) && strlen(argv[i]) > strlen("--screenshot="))
 			screenshotFilename = argv[i] + strlen("--screenshot=");
+		else if (!strcmp(argv[i], "--soft-binning"))
+			softBinning = true;
 		else if (!strncmp(argv[i], "--timeout=", strlen("--timeout=")) && strlen(argv[i]) > strlen("--timeout="))
 			timeout = strtod(argv[i] + strlen("--timeout="), NULL);
+		else if (!strncmp(argv[i], "--ir-bench=", strlen("--ir-bench=")) && strlen(argv[i]) > strlen("--ir-bench="))
+			benchSeconds = strtod(argv[i] + strlen("--ir-bench="), NULL);
+		else if (!strncmp(argv[i], "--bench=", strlen("--bench=")) && strlen(argv[i]) > strlen("--bench="))
+			benchFrames = (int)strtol(argv[i] + strlen("--bench="), NULL, 10);
+		else if (!strncmp(argv[i], "--trace=", strlen("--trace=")) && strlen(argv[i]) > strlen("--trace="))
+			traceFilename = argv[i] + strlen("--trace=");
 		else if (!strncmp(argv[i], "--debugger=", strlen("--debugger=")) && strlen(argv[i]) > strlen("--debugger="))
 			debuggerPort = (int)strtoul(argv[i] + strlen("--debugger="), NULL, 10);
 		else if (!strcmp(argv[i], "--teamcity"))
@@ -378,6 +572,8 @@ int main(int argc, const char* argv[])
 	// Never report from tests.
 	g_Config.sReportHost = "";
 	g_Config.bAutoSaveSymbolMap = false;
+	g_Config.bIRDiskCache = false;
+	g_Config.bSoftwareRendererBinning = softBinning;
 	g_Config.iRenderingMode = FB_BUFFERED_MODE;
 	g_Config.bHardwareTransform = true;
 	g_Config.iAnisotropyLevel = 0;  // When testing mipmapping we really don't want this.
@@ -452,6 +648,46 @@ int main(int argc, const char* argv[])
 	if (stateToLoad != NULL)
 		SaveState::Load(Path(stateToLoad), -1);
 
+	if (traceFilename) {
+#ifdef USE_PROFILER
+		Profiler_StartTrace();
+#else
+		fprintf(stderr, "--trace needs a build with USE_PROFILER, ignoring it.\n");
+		traceFilename = nullptr;
+#endif
+	}
+
+	if (benchSeconds > 0.0) {
+		coreParameter.cpuCore = CPUCore::IR_JIT;
+		coreParameter.printfEmuLog = false;
+		for (size_t i = 0; i < testFilenames.size(); ++i) {
+			coreParameter.fileToStart = Path(testFilenames[i]);
+			g_Config.bIRThreadedInterpreter = false;
+			double switchTime = RunBenchmark(headlessHost, coreParameter, benchSeconds);
+			g_Config.bIRThreadedInterpreter = true;
+			double threadedTime = RunBenchmark(headlessHost, coreParameter, benchSeconds);
+			if (switchTime < 0.0 || threadedTime < 0.0)
+				continue;
+			printf("%s: switch %.3fs, threaded %.3fs (%.2fx)\n", testFilenames[i].c_str(), switchTime, threadedTime, threadedTime > 0.0 ? switchTime / threadedTime : 0.0);
+		}
+		testFilenames.clear();
+	}
+
+	if (benchFrames > 0) {
+		coreParameter.printfEmuLog = false;
+		json::JsonWriter writer;
+		writer.beginArray();
+		for (size_t i = 0; i < testFilenames.size(); ++i) {
+			coreParameter.fileToStart = Path(testFilenames[i]);
+			FrameBenchmarkResult result;
+			if (RunFrameBenchmark(headlessHost, coreParameter, benchFrames, timeout, &result))
+				WriteFrameBenchmarkJson(writer, coreParameter, result);
+		}
+		writer.end();
+		printf("%s\n", writer.str().c_str());
+		testFilenames.clear();
+	}
+
 	std::vector<std::string> failedTests;
 	std::vector<std::string> passedTests;
 	for (size_t i = 0; i < testFilenames.size(); ++i)
@@ -485,6 +721,14 @@ int main(int argc, const char* argv[])
 		}
 	}
 
+#ifdef USE_PROFILER
+	if (traceFilename) {
+		Profiler_StopTrace();
+		if (!Profiler_ExportTrace(Path(traceFilename)))
+			fprintf(stderr, "Failed to write the trace to %s\n", traceFilename);
+	}
+#endif
+
 	if (debuggerPort > 0) {
 		ShutdownWebServer();
 	}
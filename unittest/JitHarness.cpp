@@ -26,6 +26,7 @@
 #include "Core/Debugger/SymbolMap.h"
 #include "Core/MIPS/JitCommon/JitCommon.h"
 #include "Core/MIPS/JitCommon/JitBlockCache.h"
+#include "Core/MIPS/IR/IRJit.h"
 #include "Core/MIPS/MIPSCodeUtils.h"
 #include "Core/MIPS/MIPSDebugInterface.h"
 #include "Core/MIPS/MIPSAsm.h"
@@ -203,3 +204,79 @@ bool TestJit() {
 
 	return jit_speed >= interp_speed;
 }
+
+bool TestIRTraceInvalidate() {
+	SetupJitHarness();
+
+	const u32 addr = PSP_GetUserMemoryBase();
+	const u32 nextAddr = addr + 8;
+	const u32 firstOp = MIPS_MAKE_ADDIU(MIPS_REG_A0, MIPS_REG_A0, 1);
+	const u32 nextOp = MIPS_MAKE_ADDIU(MIPS_REG_A1, MIPS_REG_A1, 1);
+	Memory::Write_U32(firstOp, addr);
+	Memory::Write_U32(MIPS_MAKE_NOP(), addr + 4);
+	Memory::Write_U32(nextOp, nextAddr);
+	Memory::Write_U32(MIPS_MAKE_NOP(), nextAddr + 4);
+
+	std::vector<IRInst> insts;
+	insts.push_back(IRInst{ IROp::ExitToConst, { 0 }, 0, 0, nextAddr });
+
+	bool success = true;
+	// First the whole trace is invalidated, then only its second block.
+	for (int pass = 0; pass < 2; ++pass) {
+		// Two blocks and a trace formed over them, which takes over the first block's address.
+		MIPSComp::IRBlockCache cache;
+		int blockNums[2];
+		const u32 starts[2] = { addr, nextAddr };
+		for (int i = 0; i < 2; ++i) {
+			blockNums[i] = cache.AllocateBlock(starts[i]);
+			MIPSComp::IRBlock *b = cache.GetBlock(blockNums[i]);
+			b->SetInstructions(cache.GetArena(), insts);
+			b->SetOriginalSize(8);
+			cache.FinalizeBlock(blockNums[i]);
+		}
+
+		int traceNum = cache.AllocateBlock(addr);
+		MIPSComp::IRBlock *trace = cache.GetBlock(traceNum);
+		trace->SetInstructions(cache.GetArena(), insts);
+		trace->SetOriginalSize(8);
+		trace->AddTraceRange(addr, 8);
+		trace->AddTraceRange(nextAddr, 8);
+		cache.FinalizeBlock(traceNum);
+
+		if (Memory::Read_U32(addr) != (MIPS_EMUHACK_OPCODE | traceNum)) {
+			printf("Trace emuhack not written: %08x\n", Memory::Read_U32(addr));
+			success = false;
+		}
+		if (trace->GetOriginalFirstOp().encoding != firstOp) {
+			printf("Trace original op: %08x, expected %08x\n", trace->GetOriginalFirstOp().encoding, firstOp);
+			success = false;
+		}
+
+		if (pass == 0) {
+			// The first block is destroyed before the trace, it must not leave its emuhack behind.
+			cache.InvalidateICache(addr, 16);
+			if (Memory::Read_U32(addr) != firstOp) {
+				printf("After invalidate: %08x, expected %08x\n", Memory::Read_U32(addr), firstOp);
+				success = false;
+			}
+		} else {
+			// The first block is still good, so it should be reachable again.
+			cache.InvalidateICache(nextAddr, 8);
+			if (Memory::Read_U32(addr) != (MIPS_EMUHACK_OPCODE | blockNums[0])) {
+				printf("After partial invalidate: %08x, expected %08x\n", Memory::Read_U32(addr), MIPS_EMUHACK_OPCODE | blockNums[0]);
+				success = false;
+			}
+			cache.InvalidateICache(addr, 8);
+		}
+		if (Memory::Read_U32(nextAddr) != nextOp) {
+			printf("After invalidate: %08x, expected %08x\n", Memory::Read_U32(nextAddr), nextOp);
+			success = false;
+		}
+
+		cache.Clear();
+	}
+
+	DestroyJitHarness();
+
+	return success;
+}
@@ -0,0 +1,144 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Core/HW/PolyphaseResampler.h"
+#include "Core/Util/AudioFormat.h"
+#include "unittest/UnitTest.h"
+
+// Ratios seen in practice: 44.1 to 48 kHz, the same rate with drift, and 48 to 44.1 kHz.
+static const u32 ratios[] = { 0xEB33, 0x10000, 0x10080, 0x116A1 };
+
+static bool TestResamplerDC() {
+	// Once the window is full of a constant, each phase must give it back exactly.
+	std::vector<s16> in(2048 * 2);
+	for (size_t i = 0; i < in.size(); i += 2) {
+		in[i] = 12345;
+		in[i + 1] = -32768;
+	}
+	std::vector<s16> out(1024 * 2);
+	for (u32 ratio : ratios) {
+		PolyphaseResampler resampler;
+		resampler.SetRatio(ratio);
+		resampler.Push(in.data(), 2048);
+		int produced = resampler.Resample(out.data(), 1024);
+		EXPECT_EQ_INT(produced, 1024);
+		for (int i = PolyphaseResampler::TAPS; i < produced; ++i) {
+			if (out[i * 2] != 12345 || out[i * 2 + 1] != -32768) {
+				printf("DC mismatch: ratio=%05x at %d: %d %d\n", ratio, i, out[i * 2], out[i * 2 + 1]);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static bool TestResamplerBlocks() {
+	// Splitting the stream into odd blocks must not change a single sample.
+	const int inFrames = 4000;
+	std::vector<s16> in(inFrames * 2);
+	for (s16 &s : in)
+		s = (s16)rand();
+
+	for (u32 ratio : ratios) {
+		const int outFrames = 3000;
+		std::vector<s16> whole(outFrames * 2), split(outFrames * 2);
+
+		PolyphaseResampler resampler;
+		resampler.SetRatio(ratio);
+		resampler.Push(in.data(), inFrames);
+		EXPECT_EQ_INT(resampler.Resample(whole.data(), outFrames), outFrames);
+
+		resampler.Clear();
+		int pushed = 0;
+		int produced = 0;
+		while (produced < outFrames) {
+			const int block = std::min(1 + rand() % 300, outFrames - produced);
+			const int needed = resampler.InputNeeded(block);
+			EXPECT_TRUE(pushed + needed <= inFrames);
+			resampler.Push(&in[pushed * 2], needed);
+			pushed += needed;
+			EXPECT_EQ_INT(resampler.Resample(&split[produced * 2], block), block);
+			produced += block;
+		}
+		EXPECT_EQ_INT(resampler.InputNeeded(0), 0);
+
+		for (int i = 0; i < outFrames * 2; ++i) {
+			if (whole[i] != split[i]) {
+				printf("Block mismatch: ratio=%05x at %d: %d vs %d\n", ratio, i, whole[i], split[i]);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static bool TestResamplerUnderrun() {
+	PolyphaseResampler resampler;
+	std::vector<s16> in(64 * 2, 1000);
+	std::vector<s16> out(256 * 2);
+	resampler.Push(in.data(), 64);
+	int produced = resampler.Resample(out.data(), 256);
+	EXPECT_TRUE(produced < 256);
+	EXPECT_EQ_INT(resampler.LastFrame()[0], out[produced * 2 - 2]);
+	EXPECT_EQ_INT(resampler.LastFrame()[1], out[produced * 2 - 1]);
+	return true;
+}
+
+static bool TestMixKernels() {
+	// Odd sizes and offsets, to cover the tails.
+	const int size = 1031;
+	std::vector<s16> in(size + 8);
+	std::vector<s32> mix(size + 8), expected(size + 8);
+	for (size_t i = 0; i < in.size(); ++i) {
+		in[i] = (s16)rand();
+		mix[i] = expected[i] = ((s32)rand() << 4) - (1 << 18);
+	}
+
+	for (int offset = 0; offset < 3; ++offset) {
+		MixS16ToS32(&mix[offset], &in[offset], size - offset);
+		for (int i = offset; i < size; ++i)
+			expected[i] += in[i];
+	}
+	for (int i = 0; i < size + 8; ++i) {
+		if (mix[i] != expected[i]) {
+			printf("Mix mismatch at %d: %d vs %d\n", i, mix[i], expected[i]);
+			return false;
+		}
+	}
+
+	std::vector<s16> clamped(size + 8);
+	for (int offset = 0; offset < 3; ++offset) {
+		ClampS32ToS16(&clamped[offset], &mix[offset], size - offset);
+		for (int i = offset; i < size; ++i) {
+			if (clamped[i] != clamp_s16(mix[i])) {
+				printf("Clamp mismatch: offset=%d at %d: %d vs %d\n", offset, i, clamped[i], clamp_s16(mix[i]));
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool TestAudioResampler() {
+	srand(1234);
+	return TestResamplerDC() && TestResamplerBlocks() && TestResamplerUnderrun() && TestMixKernels();
+}
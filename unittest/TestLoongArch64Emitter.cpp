@@ -0,0 +1,107 @@
+#include "Common/LoongArch64Emitter.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "UnitTest.h"
+
+// There's no LoongArch disassembler in the tree, so compare against encodings from the GNU assembler.
+static bool CheckLast(LoongArch64Gen::LoongArch64Emitter &emit, u32 expected) {
+	u32 instr;
+	memcpy(&instr, emit.GetCodePointer() - 4, 4);
+	EXPECT_EQ_HEX(instr, expected);
+	return true;
+}
+
+static bool CheckAt(const u32 *code, int index, u32 expected) {
+	EXPECT_EQ_HEX(code[index], expected);
+	return true;
+}
+
+bool TestLoongArch64Emitter() {
+	using namespace LoongArch64Gen;
+
+	u32 code[512];
+	LoongArch64Emitter emitter((u8 *)code);
+
+	emitter.JR(R_RA);
+	RET(CheckLast(emitter, 0x4C000020));
+	emitter.NOP();
+	RET(CheckLast(emitter, 0x03400000));
+	emitter.BREAK(0);
+	RET(CheckLast(emitter, 0x002A0000));
+	emitter.MOVE(A0, A1);
+	RET(CheckLast(emitter, 0x001500A4));
+
+	emitter.ADDI_D(R_SP, R_SP, -16);
+	RET(CheckLast(emitter, 0x02FFC063));
+	emitter.ST_D(R_RA, R_SP, 8);
+	RET(CheckLast(emitter, 0x29C02061));
+	emitter.LD_D(R_RA, R_SP, 8);
+	RET(CheckLast(emitter, 0x28C02061));
+	emitter.ADD_D(A0, A1, A2);
+	RET(CheckLast(emitter, 0x001098A4));
+	emitter.LU12I_W(T0, 0x12345);
+	RET(CheckLast(emitter, 0x142468AC));
+	emitter.ORI(T0, T0, 0x678);
+	RET(CheckLast(emitter, 0x0399E18C));
+	emitter.SLLI_W(A0, A0, 2);
+	RET(CheckLast(emitter, 0x00408884));
+	emitter.BSTRPICK_D(A0, A1, 31, 0);
+	RET(CheckLast(emitter, 0x00DF00A4));
+
+	emitter.FADD_S(F0, F1, F2);
+	RET(CheckLast(emitter, 0x01008820));
+	emitter.FMADD_S(F0, F1, F2, F3);
+	RET(CheckLast(emitter, 0x08118820));
+	emitter.MOVGR2FR_W(F0, A0);
+	RET(CheckLast(emitter, 0x0114A480));
+	emitter.FCMP_COND_S(FCC0, F0, F1, FCOND_CLT);
+	RET(CheckLast(emitter, 0x0C110400));
+
+	emitter.VADD(32, V0, V1, V2);
+	RET(CheckLast(emitter, 0x700B0820));
+	emitter.VFADD_S(V0, V1, V2);
+	RET(CheckLast(emitter, 0x71308820));
+	emitter.VSLLI(32, V0, V1, 3);
+	RET(CheckLast(emitter, 0x732C8C20));
+	emitter.VREPLVEI(32, V0, V1, 2);
+	RET(CheckLast(emitter, 0x72F7E820));
+	emitter.VLD(V0, A0, 16);
+	RET(CheckLast(emitter, 0x2C004080));
+
+	emitter.SetCodePointer((u8 *)code, (u8 *)code);
+	emitter.MOVI2R(A0, (u32)0x12345678);
+	RET(CheckAt(code, 0, 0x142468A4));
+	RET(CheckAt(code, 1, 0x0399E084));
+	EXPECT_EQ_INT((int)(emitter.GetCodePointer() - (const u8 *)code), 8);
+
+	emitter.SetCodePointer((u8 *)code, (u8 *)code);
+	emitter.MOVI2R(A0, (u64)0x123456789ABCDEF0ULL);
+	RET(CheckAt(code, 0, 0x153579A4));
+	RET(CheckAt(code, 1, 0x03BBC084));
+	RET(CheckAt(code, 2, 0x168ACF04));
+	RET(CheckAt(code, 3, 0x03048C84));
+	EXPECT_EQ_INT((int)(emitter.GetCodePointer() - (const u8 *)code), 16);
+
+	// Small negative values shouldn't need more than one instruction.
+	emitter.SetCodePointer((u8 *)code, (u8 *)code);
+	emitter.MOVI2R(A0, (s64)-1);
+	EXPECT_EQ_INT((int)(emitter.GetCodePointer() - (const u8 *)code), 4);
+
+	// Branch offsets are in words, relative to the branch itself.
+	emitter.SetCodePointer((u8 *)code, (u8 *)code);
+	FixupBranch skip = emitter.BEQ(A0, A1);
+	emitter.NOP();
+	emitter.SetJumpTarget(skip);
+	RET(CheckAt(code, 0, 0x58000885));
+
+	emitter.B((const void *)&code[1]);
+	RET(CheckAt(code, 2, 0x53FFFFFF));
+
+	FixupBranch far = emitter.BEQZ(A0);
+	emitter.SetJumpTarget(far, (const u8 *)far.ptr + 0x40000);
+	RET(CheckAt(code, 3, 0x40000081));
+
+	return true;
+}
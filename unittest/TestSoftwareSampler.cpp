@@ -0,0 +1,114 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "GPU/GPUState.h"
+#include "GPU/Software/Sampler.h"
+#include "unittest/UnitTest.h"
+
+extern u32 clut[4096];
+
+static const int TEX_SIZE = 64;
+
+// Compares the portable sampler against the generic one, which is the reference.
+static bool TestSamplerFormat(GETextureFormat fmt, bool swizzle, u32 clutformat, bool sharedClut, const u8 *tptr) {
+	gstate.texformat = fmt;
+	gstate.texmode = (swizzle ? 1 : 0) | (sharedClut ? 0 : 0x100);
+	gstate.clutformat = clutformat;
+
+	SamplerID id;
+	id.texfmt = fmt;
+	id.swizzle = swizzle;
+	Sampler::NearestFunc nearest = Sampler::GetNearestPortableFunc(id);
+	Sampler::LinearFunc linear = Sampler::GetLinearPortableFunc(id);
+	Sampler::NearestFunc refNearest = Sampler::GetNearestGenericFunc();
+	Sampler::LinearFunc refLinear = Sampler::GetLinearGenericFunc();
+	EXPECT_TRUE(nearest != nullptr && linear != nullptr);
+
+	for (int i = 0; i < 2000; ++i) {
+		int u[4], v[4];
+		for (int j = 0; j < 4; ++j) {
+			u[j] = rand() % TEX_SIZE;
+			v[j] = rand() % TEX_SIZE;
+		}
+		int frac_u = rand() & 0xFF;
+		int frac_v = rand() & 0xFF;
+		int level = rand() & 7;
+
+		u32 expected = refNearest(u[0], v[0], tptr, TEX_SIZE, level);
+		u32 actual = nearest(u[0], v[0], tptr, TEX_SIZE, level);
+		if (expected != actual) {
+			printf("Nearest mismatch: fmt=%d swz=%d clut=%08x at %d,%d: %08x vs %08x\n", fmt, swizzle, clutformat, u[0], v[0], expected, actual);
+			return false;
+		}
+
+		expected = refLinear(u, v, frac_u, frac_v, tptr, TEX_SIZE, level);
+		actual = linear(u, v, frac_u, frac_v, tptr, TEX_SIZE, level);
+		if (expected != actual) {
+			printf("Linear mismatch: fmt=%d swz=%d clut=%08x frac=%d,%d: %08x vs %08x\n", fmt, swizzle, clutformat, frac_u, frac_v, expected, actual);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool TestSoftwareSampler() {
+	srand(1234);
+
+	std::vector<u8> texture(TEX_SIZE * TEX_SIZE * 4);
+	for (u8 &b : texture)
+		b = (u8)rand();
+	for (int i = 0; i < 4096; ++i)
+		clut[i] = ((u32)rand() << 16) ^ (u32)rand();
+
+	// Format, shift, mask, start.
+	static const u32 clutModes[] = {
+		0xC500FF00,
+		0xC500FF00 | (3 << 2) | (2 << 16),
+		0xC5003F00 | (4 << 2) | (31 << 16),
+		0xC500F000 | (1 << 2),
+	};
+
+	static const GETextureFormat formats[] = {
+		GE_TFMT_5650, GE_TFMT_5551, GE_TFMT_4444, GE_TFMT_8888,
+		GE_TFMT_CLUT4, GE_TFMT_CLUT8, GE_TFMT_CLUT16, GE_TFMT_CLUT32,
+	};
+
+	for (GETextureFormat fmt : formats) {
+		for (int swizzle = 0; swizzle < 2; ++swizzle) {
+			if (fmt < GE_TFMT_CLUT4) {
+				if (!TestSamplerFormat(fmt, swizzle != 0, 0, true, texture.data()))
+					return false;
+				continue;
+			}
+			for (u32 mode : clutModes) {
+				for (u32 clutfmt = 0; clutfmt < 4; ++clutfmt) {
+					if (!TestSamplerFormat(fmt, swizzle != 0, mode | clutfmt, true, texture.data()))
+						return false;
+					if (fmt == GE_TFMT_CLUT4 && !TestSamplerFormat(fmt, swizzle != 0, mode | clutfmt, false, texture.data()))
+						return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,237 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Common/Data/Convert/ColorConv.h"
+#include "Common/TimeUtil.h"
+#include "GPU/GPUState.h"
+#include "GPU/Common/TextureDecoder.h"
+#include "unittest/UnitTest.h"
+
+// Checks the vectorized texture decoders bit for bit against the scalar ones, and prints how
+// much faster they are on a 512x512 texture.
+
+static const int BENCH_SIZE = 512;
+static const int BENCH_LOOPS = 20;
+
+template <typename F>
+static double TimeLoops(F func) {
+	double start = time_now_d();
+	for (int i = 0; i < BENCH_LOOPS; ++i)
+		func();
+	return time_now_d() - start;
+}
+
+static void PrintSpeedup(const char *name, double scalar, double simd) {
+	printf("  %s: %.3f ms -> %.3f ms (%.2fx)\n", name, scalar * 1000.0 / BENCH_LOOPS, simd * 1000.0 / BENCH_LOOPS, simd > 0.0 ? scalar / simd : 0.0);
+}
+
+static void ReferenceRGB565(u32 *dst, const u16 *src, u32 n) {
+	for (u32 i = 0; i < n; ++i)
+		dst[i] = Convert5To8(src[i] & 0x1F) | (Convert6To8((src[i] >> 5) & 0x3F) << 8) | (Convert5To8(src[i] >> 11) << 16) | 0xFF000000;
+}
+
+static void ReferenceRGBA5551(u32 *dst, const u16 *src, u32 n) {
+	for (u32 i = 0; i < n; ++i)
+		dst[i] = Convert5To8(src[i] & 0x1F) | (Convert5To8((src[i] >> 5) & 0x1F) << 8) | (Convert5To8((src[i] >> 10) & 0x1F) << 16) | ((src[i] >> 15) ? 0xFF000000 : 0);
+}
+
+static void ReferenceRGBA4444(u32 *dst, const u16 *src, u32 n) {
+	for (u32 i = 0; i < n; ++i)
+		dst[i] = Convert4To8(src[i] & 0xF) | (Convert4To8((src[i] >> 4) & 0xF) << 8) | (Convert4To8((src[i] >> 8) & 0xF) << 16) | ((u32)Convert4To8(src[i] >> 12) << 24);
+}
+
+static bool TestConvert16To8888() {
+	const int count = BENCH_SIZE * BENCH_SIZE;
+	std::vector<u16> src(count + 8);
+	for (u16 &c : src)
+		c = (u16)rand();
+	std::vector<u32> expected(count + 8), actual(count + 8);
+
+	typedef void (*ConvertFunc)(u32 *dst, const u16 *src, u32 numPixels);
+	static const ConvertFunc funcs[] = { &ConvertRGB565ToRGBA8888, &ConvertRGBA5551ToRGBA8888, &ConvertRGBA4444ToRGBA8888 };
+	static const ConvertFunc refs[] = { &ReferenceRGB565, &ReferenceRGBA5551, &ReferenceRGBA4444 };
+	for (int f = 0; f < 3; ++f) {
+		// Odd offsets and lengths, so the unaligned paths and the tails are covered too.
+		for (int offset = 0; offset < 3; ++offset) {
+			const int n = 1027 - offset;
+			refs[f](&expected[0], &src[offset], n);
+			funcs[f](&actual[offset], &src[offset], n);
+			for (int i = 0; i < n; ++i) {
+				if (expected[i] != actual[offset + i]) {
+					printf("16 to 8888 mismatch: func=%d offset=%d at %d: %08x vs %08x\n", f, offset, i, expected[i], actual[offset + i]);
+					return false;
+				}
+			}
+		}
+	}
+
+	// Unaligned on purpose, these used to fall back to a byte at a time.
+	double scalar = TimeLoops([&] { ReferenceRGB565(&expected[0], &src[1], count); });
+	double simd = TimeLoops([&] { ConvertRGB565ToRGBA8888(&actual[0], &src[1], count); });
+	PrintSpeedup("565 to 8888", scalar, simd);
+	return true;
+}
+
+template <typename Block, typename Single, typename Row>
+static bool TestDXTFormat(const char *name, Single single, Row row) {
+	const int blocksPerRow = BENCH_SIZE / 4;
+	std::vector<Block> blocks(blocksPerRow * blocksPerRow);
+	u8 *raw = (u8 *)blocks.data();
+	for (size_t i = 0; i < blocks.size() * sizeof(Block); ++i)
+		raw[i] = (u8)rand();
+	// Make sure both color and alpha modes are common.
+	for (size_t i = 0; i < blocks.size(); i += 3) {
+		DXT1Block *color = (DXT1Block *)&blocks[i];
+		color->color2 = color->color1;
+	}
+
+	std::vector<u32> expected(BENCH_SIZE * BENCH_SIZE), actual(BENCH_SIZE * BENCH_SIZE);
+	auto decodeSingle = [&] {
+		for (int by = 0; by < blocksPerRow; ++by) {
+			for (int bx = 0; bx < blocksPerRow; ++bx)
+				single(&expected[by * 4 * BENCH_SIZE + bx * 4], &blocks[by * blocksPerRow + bx], BENCH_SIZE, 4);
+		}
+	};
+	auto decodeRow = [&](int count) {
+		for (int by = 0; by < blocksPerRow; ++by)
+			row(&actual[by * 4 * BENCH_SIZE], &blocks[by * blocksPerRow], count, BENCH_SIZE, 4);
+	};
+
+	decodeSingle();
+	// Not a multiple of four blocks, to cover the tail too.
+	decodeRow(blocksPerRow - 1);
+	for (int y = 0; y < BENCH_SIZE; ++y) {
+		for (int x = 0; x < BENCH_SIZE - 4; ++x) {
+			if (expected[y * BENCH_SIZE + x] != actual[y * BENCH_SIZE + x]) {
+				printf("%s mismatch at %d,%d: %08x vs %08x\n", name, x, y, expected[y * BENCH_SIZE + x], actual[y * BENCH_SIZE + x]);
+				return false;
+			}
+		}
+	}
+
+	double scalar = TimeLoops(decodeSingle);
+	double simd = TimeLoops([&] { decodeRow(blocksPerRow); });
+	PrintSpeedup(name, scalar, simd);
+	return true;
+}
+
+static bool TestDXT() {
+	bool success = TestDXTFormat<DXT1Block>("DXT1", [](u32 *dst, const DXT1Block *src, int pitch, int height) {
+		DecodeDXT1Block(dst, src, pitch, height, false);
+	}, [](u32 *dst, const DXT1Block *src, int count, int pitch, int height) {
+		DecodeDXT1Blocks(dst, src, count, pitch, height, false);
+	});
+	success = success && TestDXTFormat<DXT1Block>("DXT1 no alpha", [](u32 *dst, const DXT1Block *src, int pitch, int height) {
+		DecodeDXT1Block(dst, src, pitch, height, true);
+	}, [](u32 *dst, const DXT1Block *src, int count, int pitch, int height) {
+		DecodeDXT1Blocks(dst, src, count, pitch, height, true);
+	});
+	success = success && TestDXTFormat<DXT3Block>("DXT3", &DecodeDXT3Block, &DecodeDXT3Blocks);
+	success = success && TestDXTFormat<DXT5Block>("DXT5", &DecodeDXT5Block, &DecodeDXT5Blocks);
+	return success;
+}
+
+template <typename ClutT, typename PairT>
+static bool TestClut4Pairs(const ClutT *clut) {
+	const int w = BENCH_SIZE;
+	std::vector<u8> indexed(w * BENCH_SIZE / 2);
+	for (u8 &i : indexed)
+		i = (u8)rand();
+	std::vector<ClutT> expected(w * BENCH_SIZE), actual(w * BENCH_SIZE);
+
+	PairT pairs[256];
+	BuildClut4Pairs(pairs, clut);
+	auto decodeSingle = [&] {
+		for (int y = 0; y < BENCH_SIZE; ++y)
+			DeIndexTexture4(&expected[y * w], &indexed[y * w / 2], w, clut);
+	};
+	auto decodePairs = [&] {
+		for (int y = 0; y < BENCH_SIZE; ++y)
+			DeIndexTexture4Pairs((u8 *)&actual[y * w], &indexed[y * w / 2], w, pairs);
+	};
+
+	decodeSingle();
+	decodePairs();
+	for (int i = 0; i < w * BENCH_SIZE; ++i) {
+		if (expected[i] != actual[i]) {
+			printf("CLUT4 mismatch: clutformat=%08x size=%d at %d: %08x vs %08x\n", gstate.clutformat, (int)sizeof(ClutT), i, (u32)expected[i], (u32)actual[i]);
+			return false;
+		}
+	}
+
+	if (gstate.isClutIndexSimple()) {
+		double scalar = TimeLoops(decodeSingle);
+		double simd = TimeLoops(decodePairs);
+		PrintSpeedup(sizeof(ClutT) == 2 ? "CLUT4 16-bit" : "CLUT4 32-bit", scalar, simd);
+	}
+	return true;
+}
+
+static bool TestClut8(const u32 *clut) {
+	const int n = 4099;
+	std::vector<u8> indexed(n);
+	for (u8 &i : indexed)
+		i = (u8)rand();
+	std::vector<u32> actual(n);
+	DeIndexTexture(actual.data(), indexed.data(), n, clut);
+	for (int i = 0; i < n; ++i) {
+		u32 expected = clut[gstate.transformClutIndex(indexed[i])];
+		if (expected != actual[i]) {
+			printf("CLUT8 mismatch: clutformat=%08x at %d: %08x vs %08x\n", gstate.clutformat, i, expected, actual[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool TestTextureDecoder() {
+	srand(4321);
+	printf("Texture decode, scalar vs vectorized:\n");
+
+	if (!TestConvert16To8888() || !TestDXT())
+		return false;
+
+	// The CLUT can be indexed up to 1024 bytes past the start.
+	std::vector<u32> clut32(512);
+	std::vector<u16> clut16(512);
+	for (size_t i = 0; i < clut32.size(); ++i) {
+		clut32[i] = ((u32)rand() << 16) ^ (u32)rand();
+		clut16[i] = (u16)rand();
+	}
+
+	// Format, shift, mask, start.
+	static const u32 clutModes[] = {
+		0xC500FF00,
+		0xC500FF00 | (3 << 2) | (2 << 16),
+		0xC5003F00 | (4 << 2) | (31 << 16),
+		0xC500F000 | (1 << 2),
+	};
+	for (u32 mode : clutModes) {
+		gstate.clutformat = mode | GE_CMODE_32BIT_ABGR8888;
+		if (!TestClut4Pairs<u32, u64>(clut32.data()) || !TestClut8(clut32.data()))
+			return false;
+		gstate.clutformat = mode | GE_CMODE_16BIT_ABGR4444;
+		if (!TestClut4Pairs<u16, u32>(clut16.data()))
+			return false;
+	}
+
+	return true;
+}
@@ -55,6 +55,8 @@
 #include "Core/Config.h"
 #include "Core/FileSystems/ISOFileSystem.h"
 #include "Core/MemMap.h"
+#include "Core/MIPS/MIPS.h"
+#include "Core/MIPS/IR/IRInterpreter.h"
 #include "Core/MIPS/MIPSVFPUUtils.h"
 #include "GPU/Common/TextureDecoder.h"
 
@@ -659,6 +661,63 @@ static bool TestAndroidContentURI() {
 	return true;
 }
 
+static bool TestIRThreaded() {
+	static const IRInst block[] = {
+		{ IROp::SetConst, { 1 }, 0, 0, 0x80000010 },
+		{ IROp::SetConst, { 2 }, 0, 0, 7 },
+		{ IROp::AddConst, { 3 }, 1, 0, 0x100 },
+		{ IROp::Sub, { 4 }, 3, 2, 0 },
+		{ IROp::SarImm, { 5 }, 1, 4, 0 },
+		{ IROp::Slt, { 6 }, 1, 2, 0 },
+		{ IROp::Mult, { 0 }, 5, 2, 0 },
+		{ IROp::Madd, { 0 }, 2, 2, 0 },
+		{ IROp::MfLo, { 7 }, 0, 0, 0 },
+		{ IROp::MfHi, { 8 }, 0, 0, 0 },
+		{ IROp::SetConstF, { 0 }, 0, 0, 0x7f800000 },
+		{ IROp::SetConstF, { 1 }, 0, 0, 0 },
+		{ IROp::FMul, { 2 }, 0, 1, 0 },
+		{ IROp::FMovFromGPR, { 3 }, 2, 0, 0 },
+		{ IROp::FCvtSW, { 3 }, 3, 0, 0 },
+		{ IROp::FMovToGPR, { 9 }, 2, 0, 0 },
+		{ IROp::ExitToConstIfEq, { 0 }, 1, 2, 0x08800000 },
+		{ IROp::Downcount, { 0 }, 0, 0, 20 },
+		{ IROp::ExitToConst, { 0 }, 0, 0, 0x08804000 },
+	};
+	const int count = (int)ARRAY_SIZE(block);
+
+	MIPSState *mips = currentMIPS;
+	memset(mips->r, 0, sizeof(mips->r));
+	memset(mips->f, 0, sizeof(mips->f));
+	mips->lo = 0;
+	mips->hi = 0;
+	mips->downcount = 100;
+	u32 expectedPC = IRInterpret(mips, block, count);
+	u32 expectedR[32], expectedF[32];
+	memcpy(expectedR, mips->r, sizeof(expectedR));
+	memcpy(expectedF, mips->f, sizeof(expectedF));
+	u32 expectedLo = mips->lo, expectedHi = mips->hi;
+	int expectedDowncount = mips->downcount;
+
+	IRThreadedInst threaded[ARRAY_SIZE(block)];
+	IRCompileThreaded(block, count, threaded);
+	memset(mips->r, 0, sizeof(mips->r));
+	memset(mips->f, 0, sizeof(mips->f));
+	mips->lo = 0;
+	mips->hi = 0;
+	mips->downcount = 100;
+	u32 pc = IRInterpretThreaded(mips, threaded);
+
+	EXPECT_EQ_HEX(pc, expectedPC);
+	EXPECT_EQ_INT(mips->downcount, expectedDowncount);
+	EXPECT_EQ_HEX(mips->lo, expectedLo);
+	EXPECT_EQ_HEX(mips->hi, expectedHi);
+	for (int i = 0; i < 32; ++i) {
+		EXPECT_EQ_HEX(mips->r[i], expectedR[i]);
+		EXPECT_EQ_HEX(mips->fi[i], expectedF[i]);
+	}
+	return true;
+}
+
 typedef bool (*TestFunc)();
 struct TestItem {
 	const char *name;
@@ -670,8 +729,12 @@ struct TestItem {
 bool TestArmEmitter();
 bool TestArm64Emitter();
 bool TestX64Emitter();
+bool TestLoongArch64Emitter();
 bool TestShaderGenerators();
 bool TestThreadManager();
+bool TestSoftwareSampler();
+bool TestTextureDecoder();
+bool TestAudioResampler();
 
 TestItem availableTests[] = {
 #if PPSSPP_ARCH(ARM64) || PPSSPP_ARCH(AMD64) || PPSSPP_ARCH(X86)
@@ -683,6 +746,7 @@ TestItem availableTests[] = {
 #if PPSSPP_ARCH(AMD64) || PPSSPP_ARCH(X86)
 	TEST_ITEM(X64Emitter),
 #endif
+	TEST_ITEM(LoongArch64Emitter),
 	TEST_ITEM(VertexJit),
 	TEST_ITEM(Asin),
 	TEST_ITEM(SinCos),
@@ -690,6 +754,8 @@ TestItem availableTests[] = {
 	TEST_ITEM(MathUtil),
 	TEST_ITEM(Parsers),
 	TEST_ITEM(Jit),
+	TEST_ITEM(IRThreaded),
+	TEST_ITEM(IRTraceInvalidate),
 	TEST_ITEM(MatrixTranspose),
 	TEST_ITEM(ParseLBN),
 	TEST_ITEM(QuickTexHash),
@@ -699,6 +765,9 @@ TestItem availableTests[] = {
 	TEST_ITEM(Path),
 	TEST_ITEM(AndroidContentURI),
 	TEST_ITEM(ThreadManager),
+	TEST_ITEM(SoftwareSampler),
+	TEST_ITEM(TextureDecoder),
+	TEST_ITEM(AudioResampler),
 };
 
 int main(int argc, const char *argv[]) {